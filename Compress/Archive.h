@@ -0,0 +1,164 @@
+// EasyCpp - Archive : Helpers Shared by the Tar and Zip Readers
+// Copyright (C) 2025  C14147
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+/**
+ * @file EasyCpp/Compress/Archive.h
+ * @brief This file holds what Tarfile.h and Zipfile.h share for extraction: turning a
+ *        member name into a path below the destination directory, and writing member data
+ *        either from memory or, on Linux, with copy_file_range() straight from the archive
+ *        file so the bytes never pass through user space.
+ */
+#pragma once
+#define _EASYCPP_ARCHIVE_VERSION "1.0.0"
+
+#include <FileOperator/FileOperator.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace easycpp {
+    namespace archive {
+        namespace detail {
+            /**
+             * @brief Map a member name to a path inside root the way zipfile does: a drive
+             * letter is dropped, and so are empty, "." and ".." components, so nothing is
+             * written outside root.
+             * @param root The destination directory.
+             * @param name The member name; both '/' and '\\' separate components.
+             * @return The path, or root itself if nothing is left of the name.
+             */
+            inline std::filesystem::path member_path(const std::filesystem::path& root, std::string_view name) {
+                if (name.size() >= 2 && name[1] == ':' && ((name[0] | 0x20) >= 'a' && (name[0] | 0x20) <= 'z')) name.remove_prefix(2);
+                std::filesystem::path path = root;
+                size_t start = 0;
+                while (start <= name.size()) {
+                    size_t end = name.find_first_of("/\\", start);
+                    if (end == std::string_view::npos) end = name.size();
+                    std::string_view part = name.substr(start, end - start);
+                    if (!part.empty() && part != "." && part != "..") path /= std::string(part);
+                    start = end + 1;
+                }
+                return path;
+            }
+
+            /**
+             * @brief Refuse a target below a symbolic link. Otherwise a link to a directory
+             * outside root, planted by the archive or already there, would be written through.
+             * @param module The prefix of the error message.
+             * @throws std::invalid_argument if a directory between root and target is a link.
+             */
+            inline void check_parents(const std::filesystem::path& root, const std::filesystem::path& target, const char* module) {
+                std::filesystem::path relative = target.lexically_relative(root);
+                std::filesystem::path current = root;
+                for (auto it = relative.begin(); it != relative.end() && std::next(it) != relative.end(); ++it) {
+                    current /= *it;
+                    if (std::filesystem::is_symlink(current)) {
+                        throw std::invalid_argument(std::string(module) + ": '" + target.string() + "' is below the symbolic link '" + current.string() + "'");
+                    }
+                }
+            }
+
+            /**
+             * @brief Create every parent directory of the given files once, before they are
+             * written from several threads.
+             * @param files The file paths.
+             */
+            inline void make_parents(const std::vector<std::filesystem::path>& files) {
+                std::vector<std::filesystem::path> parents;
+                parents.reserve(files.size());
+                for (const auto& file : files) parents.push_back(file.parent_path());
+                std::sort(parents.begin(), parents.end());
+                parents.erase(std::unique(parents.begin(), parents.end()), parents.end());
+                for (const auto& parent : parents) {
+                    if (!parent.empty()) std::filesystem::create_directories(parent);
+                }
+            }
+
+            /**
+             * @brief Keep only the last member written to each path, as extracting in order
+             * would, so that no two threads write the same file.
+             * @param paths The target path of every member, in archive order.
+             * @return The indices of the members to write, in archive order.
+             */
+            inline std::vector<size_t> last_writers(const std::vector<std::filesystem::path>& paths) {
+                std::unordered_map<std::string, size_t> last;
+                last.reserve(paths.size());
+                for (size_t i = 0; i < paths.size(); ++i) last[paths[i].string()] = i;
+                std::vector<size_t> indices;
+                indices.reserve(last.size());
+                for (size_t i = 0; i < paths.size(); ++i) {
+                    if (last[paths[i].string()] == i) indices.push_back(i);
+                }
+                return indices;
+            }
+
+            /**
+             * @class OutputFile
+             * @brief A file being extracted, written through FileOperator.
+             */
+            class OutputFile {
+            private:
+                std::unique_ptr<File> file;
+
+            public:
+                explicit OutputFile(const std::filesystem::path& path) : file(open(path.string().c_str(), WRITE_B)) {}
+
+                void write(const char* data, size_t size) {
+                    if (size) file->write(data, size);
+                }
+
+                /**
+                 * @brief Write bytes that are stored verbatim in the archive. On Linux they are
+                 * copied by the kernel from source (the archive, opened read-only) and data
+                 * is only read if copy_file_range() is unavailable or refused.
+                 * @param source A descriptor of the archive file, or -1.
+                 * @param offset The position of the bytes in the archive file.
+                 * @param data The same bytes, as mapped in memory.
+                 */
+                void copy_range(int source, uint64_t offset, std::string_view data) {
+#ifdef __linux__
+                    if (source >= 0 && !data.empty()) {
+                        int target = fileno(file->file);
+                        off64_t position = (off64_t) offset;
+                        size_t left = data.size();
+                        while (left > 0) {
+                            ssize_t copied = ::copy_file_range(source, &position, target, nullptr, left, 0);
+                            if (copied <= 0) break;
+                            left -= (size_t) copied;
+                        }
+                        if (!left) return;
+                        // Start over through the stdio stream; it has not buffered anything yet.
+                        if (ftruncate(target, 0) != 0 || lseek(target, 0, SEEK_SET) != 0) throw FileWriteError(file->filename);
+                    }
+#else
+                    (void) source;
+                    (void) offset;
+#endif
+                    write(data.data(), data.size());
+                }
+            };
+        }
+    }
+}
@@ -0,0 +1,93 @@
+// EasyCpp - Base64 : Base64 Encoding
+// Copyright (C) 2025  C14147
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+/**
+ * @file EasyCpp/Compress/Base64.h
+ * @brief This file implements standard (RFC 4648) Base64 encoding and decoding, like Python's
+ *        base64.b64encode and base64.b64decode.
+ */
+#pragma once
+
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+namespace easycpp {
+    namespace base64 {
+        /**
+         * @brief Encode bytes as Base64 with '=' padding.
+         * @param data The bytes.
+         * @return The encoded text.
+         */
+        inline std::string b64encode(std::string_view data) {
+            static constexpr char ALPHABET[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+            std::string out;
+            out.reserve((data.size() + 2) / 3 * 4);
+            const unsigned char* p = reinterpret_cast<const unsigned char*>(data.data());
+            size_t i = 0;
+            for (; i + 3 <= data.size(); i += 3) {
+                uint32_t v = (uint32_t) p[i] << 16 | (uint32_t) p[i + 1] << 8 | p[i + 2];
+                out += ALPHABET[v >> 18];
+                out += ALPHABET[(v >> 12) & 63];
+                out += ALPHABET[(v >> 6) & 63];
+                out += ALPHABET[v & 63];
+            }
+            if (i < data.size()) {
+                uint32_t v = (uint32_t) p[i] << 16 | (i + 1 < data.size() ? (uint32_t) p[i + 1] << 8 : 0);
+                out += ALPHABET[v >> 18];
+                out += ALPHABET[(v >> 12) & 63];
+                out += i + 1 < data.size() ? ALPHABET[(v >> 6) & 63] : '=';
+                out += '=';
+            }
+            return out;
+        }
+
+        /**
+         * @brief Decode Base64 text. Whitespace is skipped; padding is optional.
+         * @param text The encoded text.
+         * @return The decoded bytes.
+         * @throws std::invalid_argument if the text contains other characters.
+         */
+        inline std::string b64decode(std::string_view text) {
+            static const auto table = [] {
+                struct Table { int8_t value[256]; } t{};
+                for (int c = 0; c < 256; ++c) t.value[c] = -1;
+                const char* alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+                for (int i = 0; i < 64; ++i) t.value[(unsigned char) alphabet[i]] = (int8_t) i;
+                return t;
+            }();
+            std::string out;
+            out.reserve(text.size() / 4 * 3);
+            uint32_t bits = 0;
+            int count = 0;
+            for (char c : text) {
+                if (c == '=') break;
+                if (c == ' ' || c == '\n' || c == '\r' || c == '\t') continue;
+                int8_t value = table.value[(unsigned char) c];
+                if (value < 0) throw std::invalid_argument("b64decode: invalid character");
+                bits = bits << 6 | (uint32_t) value;
+                count += 6;
+                if (count >= 8) {
+                    count -= 8;
+                    out += (char) (bits >> count);
+                }
+            }
+            return out;
+        }
+    }
+}
@@ -0,0 +1,516 @@
+// EasyCpp - Tarfile : Tar Archive Reader
+// Copyright (C) 2025  C14147
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+/**
+ * @file EasyCpp/Compress/Tarfile.h
+ * @brief This file implements a reader for tar archives modelled on Python's tarfile module.
+ *        The archive is memory-mapped and only the 512-byte headers are read to index it, so
+ *        member data is never touched until it is asked for and then returned as a view into
+ *        the mapping. ustar, GNU (long names, base-256 sizes) and pax headers are understood.
+ *        A gzip-compressed archive is decompressed into memory once instead.
+ *        extractall() writes the files on a thread pool, using copy_file_range() on Linux.
+ */
+#pragma once
+#define _EASYCPP_TARFILE_VERSION "1.0.0"
+
+#include <Compress/Archive.h>
+#include <Compress/Zlib.h>
+#include <FileOperator/FileOperator.h>
+#include <Profile/Profile.h>
+#include <Threading/ThreadPool.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace easycpp {
+    namespace tarfile {
+        inline constexpr char REGTYPE = '0';
+        inline constexpr char AREGTYPE = '\0';
+        inline constexpr char LNKTYPE = '1';
+        inline constexpr char SYMTYPE = '2';
+        inline constexpr char CHRTYPE = '3';
+        inline constexpr char BLKTYPE = '4';
+        inline constexpr char DIRTYPE = '5';
+        inline constexpr char FIFOTYPE = '6';
+        inline constexpr char CONTTYPE = '7';
+
+        /**
+         * @struct TarInfo
+         * @brief The header of one archive member.
+         */
+        struct TarInfo {
+            std::string name;
+            std::string linkname;
+            std::string uname;
+            std::string gname;
+            uint64_t size = 0;
+            int64_t mtime = 0;
+            uint32_t mode = 0;
+            uint64_t uid = 0;
+            uint64_t gid = 0;
+            char type = REGTYPE;
+            uint64_t offset = 0;       // Position of the header in the archive
+            uint64_t offset_data = 0;  // Position of the data in the archive
+
+            bool isfile() const { return type == REGTYPE || type == AREGTYPE || type == CONTTYPE; }
+            bool isreg() const { return isfile(); }
+            bool isdir() const { return type == DIRTYPE; }
+            bool issym() const { return type == SYMTYPE; }
+            bool islnk() const { return type == LNKTYPE; }
+        };
+
+        namespace detail {
+            inline constexpr size_t BLOCK = 512;
+
+            inline std::string_view field(const char* header, size_t offset, size_t length) {
+                const char* begin = header + offset;
+                const void* nul = memchr(begin, '\0', length);
+                return std::string_view(begin, nul ? (size_t) ((const char*) nul - begin) : length);
+            }
+
+            // An octal number padded with spaces or NULs, or GNU base-256 when the high bit of
+            // the first byte is set.
+            inline int64_t number(const char* header, size_t offset, size_t length) {
+                const unsigned char* p = reinterpret_cast<const unsigned char*>(header + offset);
+                if (p[0] & 0x80) {
+                    uint64_t value = p[0] == 0xFF ? ~(uint64_t) 0 : 0;
+                    for (size_t i = 1; i < length; ++i) value = value << 8 | p[i];
+                    return (int64_t) value;
+                }
+                size_t i = 0;
+                while (i < length && p[i] == ' ') ++i;
+                int64_t value = 0;
+                for (; i < length && p[i] >= '0' && p[i] <= '7'; ++i) value = value * 8 + (p[i] - '0');
+                if (i < length && p[i] != ' ' && p[i] != '\0') throw std::invalid_argument("tarfile: invalid number field");
+                return value;
+            }
+
+            // The stored checksum may have been computed with signed or unsigned bytes.
+            inline bool checksum_ok(const char* header) {
+                int64_t stored = number(header, 148, 8);
+                int64_t unsigned_sum = 8 * ' ', signed_sum = 8 * ' ';
+                for (size_t i = 0; i < BLOCK; ++i) {
+                    if (i >= 148 && i < 156) continue;
+                    unsigned_sum += (unsigned char) header[i];
+                    signed_sum += (signed char) header[i];
+                }
+                return stored == unsigned_sum || stored == signed_sum;
+            }
+
+            inline bool is_zero_block(const char* header) {
+                for (size_t i = 0; i < BLOCK; ++i) {
+                    if (header[i]) return false;
+                }
+                return true;
+            }
+
+            // Records of the form "<length> <key>=<value>\n".
+            inline void parse_pax(std::string_view data, std::unordered_map<std::string, std::string>& headers) {
+                size_t position = 0;
+                while (position < data.size()) {
+                    size_t space = data.find(' ', position);
+                    if (space == std::string_view::npos) break;
+                    size_t length = 0;
+                    for (size_t i = position; i < space; ++i) {
+                        if (data[i] < '0' || data[i] > '9') throw std::invalid_argument("tarfile: invalid pax header");
+                        length = length * 10 + (size_t) (data[i] - '0');
+                    }
+                    if (length == 0 || position + length > data.size() || data[position + length - 1] != '\n') {
+                        throw std::invalid_argument("tarfile: invalid pax header");
+                    }
+                    std::string_view record = data.substr(space + 1, position + length - 1 - (space + 1));
+                    size_t equals = record.find('=');
+                    if (equals == std::string_view::npos) throw std::invalid_argument("tarfile: invalid pax header");
+                    headers[std::string(record.substr(0, equals))] = std::string(record.substr(equals + 1));
+                    position += length;
+                }
+            }
+
+            inline uint64_t parse_decimal(const std::string& text) {
+                uint64_t value = 0;
+                for (char c : text) {
+                    if (c < '0' || c > '9') break;
+                    value = value * 10 + (uint64_t) (c - '0');
+                }
+                return value;
+            }
+
+            // Decompress a gzip file; only the first member is read, as tar.gz has one.
+            inline std::string gunzip(std::string_view data) {
+                const unsigned char* p = reinterpret_cast<const unsigned char*>(data.data());
+                if (data.size() < 18 || p[2] != 8) throw std::invalid_argument("tarfile: invalid gzip header");
+                uint8_t flags = p[3];
+                size_t position = 10;
+                auto need = [&](size_t n) {
+                    if (position > data.size() || data.size() - position < n) throw std::invalid_argument("tarfile: truncated gzip header");
+                };
+                if (flags & 4) {
+                    need(2);
+                    position += 2 + (p[position] | (size_t) p[position + 1] << 8);
+                }
+                for (uint8_t flag : {(uint8_t) 8, (uint8_t) 16}) {
+                    if (!(flags & flag)) continue;
+                    need(1);
+                    const void* nul = memchr(data.data() + position, '\0', data.size() - position);
+                    if (!nul) throw std::invalid_argument("tarfile: truncated gzip header");
+                    position = (size_t) ((const char*) nul - data.data()) + 1;
+                }
+                if (flags & 2) position += 2;
+                need(8);
+                uint32_t expected_size = (uint32_t) p[data.size() - 4] | (uint32_t) p[data.size() - 3] << 8 |
+                                         (uint32_t) p[data.size() - 2] << 16 | (uint32_t) p[data.size() - 1] << 24;
+                std::string out;
+                out.reserve(std::max<size_t>(expected_size, data.size()));
+                size_t consumed = position + zlib::detail::inflate(p + position, data.size() - position, out);
+                if (data.size() - consumed < 8) throw std::invalid_argument("tarfile: truncated gzip stream");
+                const unsigned char* trailer = p + consumed;
+                uint32_t crc = (uint32_t) trailer[0] | (uint32_t) trailer[1] << 8 | (uint32_t) trailer[2] << 16 | (uint32_t) trailer[3] << 24;
+                if (zlib::crc32(out.data(), out.size()) != crc) throw std::invalid_argument("tarfile: gzip CRC mismatch");
+                return out;
+            }
+
+            // Whether path, with every symbolic link resolved, lies inside root.
+            inline bool is_within(const std::filesystem::path& root, const std::filesystem::path& path) {
+                std::filesystem::path base = std::filesystem::weakly_canonical(root);
+                std::filesystem::path resolved = std::filesystem::weakly_canonical(path);
+                if (base.filename().empty()) base = base.parent_path();
+                auto [end, ignored] = std::mismatch(base.begin(), base.end(), resolved.begin(), resolved.end());
+                return end == base.end();
+            }
+        }
+
+        /**
+         * @class TarFile
+         * @brief A tar archive opened for reading. Members and their data stay valid as long
+         * as the TarFile lives.
+         */
+        class TarFile {
+        private:
+            std::unique_ptr<MappedFile> mapping;
+            std::string inflated;  // The tar stream of a gzip-compressed archive
+            std::string_view data;
+            int source = -1;  // Descriptor for copy_file_range(), -1 if the data is not the file
+            std::vector<TarInfo> members;
+            std::unordered_map<std::string_view, size_t> index;
+
+            void scan() {
+                std::unordered_map<std::string, std::string> global, pax;
+                std::string long_name, long_link;
+                bool have_name = false, have_link = false;
+                size_t position = 0;
+                while (data.size() - position >= detail::BLOCK) {
+                    const char* header = data.data() + position;
+                    if (detail::is_zero_block(header)) break;
+                    if (!detail::checksum_ok(header)) {
+                        throw std::invalid_argument("tarfile: bad checksum in header at offset " + std::to_string(position));
+                    }
+                    char type = header[156];
+                    uint64_t size = (uint64_t) detail::number(header, 124, 12);
+                    size_t start = position + detail::BLOCK;
+                    if (size > data.size() - start) throw std::invalid_argument("tarfile: unexpected end of data");
+                    std::string_view content = data.substr(start, (size_t) size);
+                    size_t next = start + (size_t) ((size + detail::BLOCK - 1) / detail::BLOCK * detail::BLOCK);
+
+                    // Extended headers describe the member whose header follows them.
+                    if (type == 'L' || type == 'K') {
+                        std::string text(detail::field(content.data(), 0, content.size()));
+                        if (type == 'L') long_name = std::move(text), have_name = true;
+                        else long_link = std::move(text), have_link = true;
+                        position = next;
+                        continue;
+                    }
+                    if (type == 'x' || type == 'g' || type == 'X') {
+                        detail::parse_pax(content, type == 'g' ? global : pax);
+                        position = next;
+                        continue;
+                    }
+
+                    TarInfo info;
+                    std::string_view name = detail::field(header, 0, 100);
+                    std::string_view prefix = detail::field(header, 345, 155);
+                    bool posix = std::string_view(header + 257, 6) == std::string_view("ustar\0", 6);
+                    info.name = posix && !prefix.empty() ? std::string(prefix) + "/" + std::string(name) : std::string(name);
+                    info.linkname = detail::field(header, 157, 100);
+                    info.uname = detail::field(header, 265, 32);
+                    info.gname = detail::field(header, 297, 32);
+                    info.mode = (uint32_t) detail::number(header, 100, 8);
+                    info.uid = (uint64_t) detail::number(header, 108, 8);
+                    info.gid = (uint64_t) detail::number(header, 116, 8);
+                    info.mtime = detail::number(header, 136, 12);
+                    info.size = size;
+                    info.type = type;
+                    info.offset = position;
+                    info.offset_data = start;
+                    if (have_name) info.name = std::move(long_name), have_name = false;
+                    if (have_link) info.linkname = std::move(long_link), have_link = false;
+
+                    for (auto* headers : {&global, &pax}) {
+                        for (const auto& [key, value] : *headers) {
+                            if (key == "path") info.name = value;
+                            else if (key == "linkpath") info.linkname = value;
+                            else if (key == "uname") info.uname = value;
+                            else if (key == "gname") info.gname = value;
+                            else if (key == "uid") info.uid = detail::parse_decimal(value);
+                            else if (key == "gid") info.gid = detail::parse_decimal(value);
+                            else if (key == "mtime") info.mtime = (int64_t) detail::parse_decimal(value);
+                            else if (key == "size") info.size = detail::parse_decimal(value);
+                        }
+                    }
+                    pax.clear();
+                    if (info.size != size) {
+                        if (info.size > data.size() - start) throw std::invalid_argument("tarfile: unexpected end of data");
+                        next = start + (size_t) ((info.size + detail::BLOCK - 1) / detail::BLOCK * detail::BLOCK);
+                    }
+                    // Links, directories and devices have no data whatever the size field says.
+                    if (type >= LNKTYPE && type <= FIFOTYPE) next = start;
+                    if ((type == REGTYPE || type == AREGTYPE) && !info.name.empty() && info.name.back() == '/') info.type = DIRTYPE;
+                    if (info.isdir()) {
+                        while (info.name.size() > 1 && info.name.back() == '/') info.name.pop_back();
+                    }
+                    members.push_back(std::move(info));
+                    position = next;
+                }
+                if (data.size() < detail::BLOCK) throw std::invalid_argument("tarfile: truncated header");
+                index.reserve(members.size());
+                for (size_t i = 0; i < members.size(); ++i) index[members[i].name] = i;
+            }
+
+            /**
+             * @brief Create a link member. As with Python's "data" filter, symbolic links must be
+             * relative and resolve inside root, and hard links must refer to a file inside root.
+             * @throws std::invalid_argument if the link would reach outside root.
+             */
+            void extract_special(const TarInfo& member, const std::filesystem::path& target,
+                                 const std::filesystem::path& root) const {
+                if (!member.issym() && !member.islnk()) throw std::invalid_argument("tarfile: '" + member.name + "' is not a link");
+                archive::detail::check_parents(root, target, "tarfile");
+                std::filesystem::path link = member.issym() ? std::filesystem::path(member.linkname)
+                                                            : archive::detail::member_path(root, member.linkname);
+                if (member.issym() && (link.is_absolute() || link.has_root_name() || link.has_root_directory())) {
+                    throw std::invalid_argument("tarfile: symbolic link '" + member.name + "' is absolute");
+                }
+                if (!detail::is_within(root, member.issym() ? target.parent_path() / link : link)) {
+                    throw std::invalid_argument("tarfile: link '" + member.name + "' points outside the destination");
+                }
+                std::error_code error;
+                std::filesystem::remove(target, error);
+                if (member.issym()) {
+                    std::filesystem::create_symlink(link, target);
+                } else {
+                    if (std::filesystem::exists(link)) {
+                        std::filesystem::create_hard_link(link, target);
+                    } else {
+                        write_file(getmember(member.linkname), target);
+                    }
+                }
+            }
+
+            void write_file(const TarInfo& member, const std::filesystem::path& target) const {
+                std::string_view content = extractfile(member);
+                // Replace a link at the target instead of writing through it.
+                if (std::filesystem::is_symlink(target)) std::filesystem::remove(target);
+                {
+                    archive::detail::OutputFile file(target);
+                    file.copy_range(source, member.offset_data, content);
+                }
+                std::error_code error;
+                std::filesystem::permissions(target, (std::filesystem::perms) (member.mode & 0777), error);
+            }
+
+        public:
+            /**
+             * @brief Open an archive. Plain tar files are mapped; gzip-compressed ones are
+             * decompressed into memory.
+             * @param filename The archive path.
+             * @throws std::invalid_argument if the file is not a valid tar archive.
+             */
+            explicit TarFile(const char* filename) : mapping(std::make_unique<MappedFile>(filename)) {
+                data = std::string_view(mapping->data, mapping->size);
+                if (data.size() >= 2 && (unsigned char) data[0] == 0x1F && (unsigned char) data[1] == 0x8B) {
+                    inflated = detail::gunzip(data);
+                    data = inflated;
+                    mapping.reset();
+                } else {
+#ifdef __linux__
+                    source = ::open(filename, O_RDONLY | O_CLOEXEC);
+#endif
+                }
+                if (data.empty()) throw std::invalid_argument("tarfile: empty file");
+                scan();
+            }
+
+            TarFile(TarFile&& other) noexcept
+                : mapping(std::move(other.mapping)), inflated(std::move(other.inflated)),
+                  data(inflated.empty() ? other.data : std::string_view(inflated)), source(other.source),
+                  members(std::move(other.members)), index(std::move(other.index)) {
+                other.source = -1;
+            }
+
+            TarFile(const TarFile&) = delete;
+            TarFile& operator=(const TarFile&) = delete;
+            TarFile& operator=(TarFile&&) = delete;
+
+            ~TarFile() {
+#ifdef __linux__
+                if (source >= 0) ::close(source);
+#endif
+            }
+
+            /**
+             * @brief Get the members in archive order.
+             * @return The members.
+             */
+            const std::vector<TarInfo>& getmembers() const { return members; }
+
+            /**
+             * @brief Get the member names in archive order.
+             * @return Views of the names.
+             */
+            std::vector<std::string_view> getnames() const {
+                std::vector<std::string_view> names;
+                names.reserve(members.size());
+                for (const TarInfo& member : members) names.push_back(member.name);
+                return names;
+            }
+
+            /**
+             * @brief Check whether a member exists.
+             * @param name The member name.
+             * @return True if there is a member with this name.
+             */
+            bool contains(std::string_view name) const {
+                return index.count(name) || (!name.empty() && name.back() == '/' && index.count(name.substr(0, name.size() - 1)));
+            }
+
+            /**
+             * @brief Find a member. If the name occurs more than once, the last one is returned.
+             * @param name The member name.
+             * @return The member.
+             * @throws std::out_of_range if there is no such member.
+             */
+            const TarInfo& getmember(std::string_view name) const {
+                auto it = index.find(name);
+                if (it == index.end() && !name.empty() && name.back() == '/') it = index.find(name.substr(0, name.size() - 1));
+                if (it == index.end()) throw std::out_of_range("tarfile: no member named '" + std::string(name) + "'");
+                return members[it->second];
+            }
+
+            /**
+             * @brief Get the data of a regular file, or of the file a hard link refers to,
+             * without copying it.
+             * @param member The member.
+             * @return A view into the archive.
+             * @throws std::invalid_argument if the member is not a regular file or hard link.
+             */
+            std::string_view extractfile(const TarInfo& member) const {
+                if (member.islnk()) return extractfile(getmember(member.linkname));
+                if (!member.isfile()) throw std::invalid_argument("tarfile: '" + member.name + "' is not a regular file");
+                return data.substr((size_t) member.offset_data, (size_t) member.size);
+            }
+
+            std::string_view extractfile(std::string_view name) const { return extractfile(getmember(name)); }
+
+            /**
+             * @brief Extract one member below path. Leading '/', drive letters and ".."
+             * components of the name are dropped, members below a symbolic link are refused,
+             * and setuid, setgid and sticky bits are cleared. Devices and FIFOs are refused.
+             * @param member The member.
+             * @param path The destination directory.
+             * @throws std::invalid_argument if the member would be written outside path, or is
+             * a device or FIFO.
+             */
+            void extract(const TarInfo& member, const char* path = ".") const {
+                std::filesystem::path target = archive::detail::member_path(path, member.name);
+                archive::detail::check_parents(path, target, "tarfile");
+                if (member.isdir()) {
+                    std::filesystem::create_directories(target);
+                    return;
+                }
+                if (!member.isfile() && !member.issym() && !member.islnk()) {
+                    throw std::invalid_argument("tarfile: '" + member.name + "' is a device or FIFO");
+                }
+                if (target.has_parent_path()) std::filesystem::create_directories(target.parent_path());
+                if (member.isfile()) write_file(member, target);
+                else extract_special(member, target, path);
+            }
+
+            void extract(std::string_view name, const char* path = ".") const { extract(getmember(name), path); }
+
+            /**
+             * @brief Extract every member below path. Directories are created first, then the
+             * regular files are written in parallel (largest first) and finally the links.
+             * Devices and FIFOs are skipped. Members are checked as by extract().
+             * @param path The destination directory.
+             * @param pool The pool that writes the files.
+             * @throws std::invalid_argument if a member would be written outside path.
+             */
+            void extractall(const char* path = ".", ThreadPool& pool = ThreadPool::global()) const {
+                profile::Span span("tarfile.extractall");
+                std::filesystem::path root(path);
+                std::vector<std::filesystem::path> targets;
+                targets.reserve(members.size());
+                for (const TarInfo& member : members) targets.push_back(archive::detail::member_path(root, member.name));
+                std::vector<size_t> order = archive::detail::last_writers(targets);
+
+                std::vector<std::filesystem::path> files;
+                std::vector<size_t> regular, links;
+                for (size_t i : order) {
+                    const TarInfo& member = members[i];
+                    archive::detail::check_parents(root, targets[i], "tarfile");
+                    if (member.isdir()) std::filesystem::create_directories(targets[i]);
+                    else if (member.isfile()) regular.push_back(i), files.push_back(targets[i]);
+                    else if (member.issym() || member.islnk()) links.push_back(i), files.push_back(targets[i]);
+                }
+                archive::detail::make_parents(files);
+                std::stable_sort(regular.begin(), regular.end(), [&](size_t a, size_t b) { return members[a].size > members[b].size; });
+                pool.parallel_for(0, regular.size(), [&](size_t i) { write_file(members[regular[i]], targets[regular[i]]); });
+                for (size_t i : links) extract_special(members[i], targets[i], root);
+            }
+        };
+
+        /**
+         * @brief Open a tar archive for reading.
+         * @param filename The archive path, plain or gzip-compressed.
+         * @return The archive.
+         */
+        inline TarFile open(const char* filename) {
+            return TarFile(filename);
+        }
+
+        /**
+         * @brief Check whether a file is a tar archive, by validating its first header.
+         * @param filename The file path.
+         * @return True if the file can be opened as an archive.
+         */
+        inline bool is_tarfile(const char* filename) {
+            try {
+                TarFile archive(filename);
+                return true;
+            } catch (const std::exception&) {
+                return false;
+            }
+        }
+    }
+}
@@ -0,0 +1,495 @@
+// EasyCpp - Zipfile : Zip Archive Reader
+// Copyright (C) 2025  C14147
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+/**
+ * @file EasyCpp/Compress/Zipfile.h
+ * @brief This file implements a reader for zip archives modelled on Python's zipfile module.
+ *        The archive is memory-mapped and indexed from its central directory alone (ZIP64
+ *        included), so no member data is read until it is asked for. Stored members can be
+ *        viewed in place; deflated ones are decoded by ZipExtFile a chunk at a time with the
+ *        inflater of Zlib.h. extractall() writes the files on a thread pool, stored members
+ *        with copy_file_range() on Linux.
+ */
+#pragma once
+#define _EASYCPP_ZIPFILE_VERSION "1.0.0"
+
+#include <Compress/Archive.h>
+#include <Compress/Zlib.h>
+#include <FileOperator/FileOperator.h>
+#include <Profile/Profile.h>
+#include <Threading/ThreadPool.h>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace easycpp {
+    namespace zipfile {
+        inline constexpr int ZIP_STORED = 0;
+        inline constexpr int ZIP_DEFLATED = 8;
+
+        /**
+         * @struct ZipInfo
+         * @brief The central directory entry of one member. The views point into the archive.
+         */
+        struct ZipInfo {
+            std::string_view filename;
+            std::string_view comment;
+            std::string_view extra;
+            std::array<int, 6> date_time{};  // Year, month, day, hour, minute, second
+            int compress_type = ZIP_STORED;
+            int create_system = 0;
+            uint16_t flag_bits = 0;
+            uint32_t external_attr = 0;
+            uint32_t CRC = 0;
+            uint64_t compress_size = 0;
+            uint64_t file_size = 0;
+            uint64_t header_offset = 0;
+
+            bool is_dir() const { return !filename.empty() && filename.back() == '/'; }
+        };
+
+        namespace detail {
+            inline uint16_t read16(const char* p) {
+                const unsigned char* u = reinterpret_cast<const unsigned char*>(p);
+                return (uint16_t) (u[0] | u[1] << 8);
+            }
+
+            inline uint32_t read32(const char* p) {
+                return read16(p) | (uint32_t) read16(p + 2) << 16;
+            }
+
+            inline uint64_t read64(const char* p) {
+                return read32(p) | (uint64_t) read32(p + 4) << 32;
+            }
+
+            inline constexpr uint32_t LOCAL_HEADER = 0x04034B50;
+            inline constexpr uint32_t CENTRAL_HEADER = 0x02014B50;
+            inline constexpr uint32_t END_RECORD = 0x06054B50;
+            inline constexpr uint32_t END_RECORD64 = 0x06064B50;
+            inline constexpr uint32_t END_LOCATOR64 = 0x07064B50;
+
+            [[noreturn]] inline void bad_zip(const char* message) {
+                throw std::invalid_argument(std::string("zipfile: ") + message);
+            }
+        }
+
+        /**
+         * @class ZipExtFile
+         * @brief Reads the data of one member front to back. Deflated data is decoded 64 KiB
+         * at a time, and the CRC-32 is checked when the last byte has been read.
+         */
+        class ZipExtFile {
+        private:
+            const ZipInfo* info;
+            std::string_view raw;  // The member data as stored in the archive
+            std::unique_ptr<zlib::detail::Inflater> inflater;
+            uint64_t produced = 0;
+            uint32_t crc = 0;
+
+        public:
+            ZipExtFile(const ZipInfo& info, std::string_view raw) : info(&info), raw(raw) {
+                if (info.compress_type == ZIP_DEFLATED) {
+                    // Deflate expands by at most 1032:1 (a 258-byte match in two bits).
+                    if (info.file_size / 1032 > raw.size()) {
+                        throw std::invalid_argument("zipfile: data of '" + std::string(info.filename) + "' is truncated");
+                    }
+                    inflater = std::make_unique<zlib::detail::Inflater>(reinterpret_cast<const unsigned char*>(raw.data()), raw.size());
+                } else if (raw.size() != info.file_size) {
+                    throw std::invalid_argument("zipfile: sizes of stored member '" + std::string(info.filename) + "' differ");
+                }
+            }
+
+            /**
+             * @brief Read up to size bytes.
+             * @param buffer The destination.
+             * @param size The capacity of buffer.
+             * @return The number of bytes stored, 0 at the end of the member.
+             * @throws std::invalid_argument if the data is corrupt or fails the CRC check.
+             */
+            size_t read(char* buffer, size_t size) {
+                size_t n;
+                if (inflater) {
+                    n = inflater->read(buffer, size);
+                    if (!n && produced != info->file_size) {
+                        throw std::invalid_argument("zipfile: data of '" + std::string(info->filename) + "' is truncated");
+                    }
+                } else {
+                    n = (size_t) std::min<uint64_t>(size, info->file_size - produced);
+                    memcpy(buffer, raw.data() + produced, n);
+                }
+                if (n) {
+                    crc = zlib::crc32(buffer, n, crc);
+                    produced += n;
+                    if (produced > info->file_size) {
+                        throw std::invalid_argument("zipfile: data of '" + std::string(info->filename) + "' is too long");
+                    }
+                    if (produced == info->file_size && crc != info->CRC) {
+                        throw std::invalid_argument("zipfile: Bad CRC-32 for file '" + std::string(info->filename) + "'");
+                    }
+                }
+                return n;
+            }
+
+            /**
+             * @brief Read the rest of the member.
+             * @return The bytes not read yet.
+             */
+            std::string read() {
+                std::string out((size_t) (info->file_size - produced), '\0');
+                size_t done = 0;
+                while (done < out.size()) {
+                    size_t n = read(out.data() + done, out.size() - done);
+                    if (!n) break;
+                    done += n;
+                }
+                out.resize(done);
+                // A stream longer than file_size is corrupt; ask for one more byte to find out.
+                char extra;
+                if (inflater && read(&extra, 1)) throw std::invalid_argument("zipfile: data of '" + std::string(info->filename) + "' is too long");
+                return out;
+            }
+
+            /**
+             * @brief Get the number of bytes read so far.
+             * @return The position in the uncompressed data.
+             */
+            uint64_t tell() const { return produced; }
+        };
+
+        /**
+         * @class ZipFile
+         * @brief A zip archive opened for reading. Members and views stay valid as long as the
+         * ZipFile lives.
+         */
+        class ZipFile {
+        private:
+            std::unique_ptr<MappedFile> mapping;
+            std::string_view data;
+            std::string_view archive_comment;
+            int source = -1;  // Descriptor for copy_file_range()
+            std::vector<ZipInfo> members;
+            std::unordered_map<std::string_view, size_t> index;
+
+            void read_central_directory() {
+                using namespace detail;
+                if (data.size() < 22) bad_zip("File is not a zip file");
+                // The end record sits in the last 64 KiB + 22 bytes, after an optional comment.
+                size_t lowest = data.size() > 22 + 65535 ? data.size() - 22 - 65535 : 0;
+                size_t end = data.size() - 22;
+                for (;; --end) {
+                    if (read32(data.data() + end) == END_RECORD && end + 22 + read16(data.data() + end + 20) <= data.size()) break;
+                    if (end == lowest) bad_zip("File is not a zip file");
+                }
+                const char* record = data.data() + end;
+                archive_comment = std::string_view(record + 22, read16(record + 20));
+                uint64_t count = read16(record + 10);
+                uint64_t directory_size = read32(record + 12);
+                uint64_t directory_offset = read32(record + 16);
+                size_t directory_end = end;
+                if (end >= 20 && read32(data.data() + end - 20) == END_LOCATOR64) {
+                    uint64_t offset = read64(data.data() + end - 20 + 8);
+                    // The ZIP64 end record directly precedes the locator; prepended data moves it.
+                    size_t position = end - 20 >= 56 ? end - 20 - 56 : 0;
+                    if (offset + 56 <= data.size() && read32(data.data() + offset) == END_RECORD64) position = (size_t) offset;
+                    if (read32(data.data() + position) != END_RECORD64) bad_zip("corrupt ZIP64 end of central directory");
+                    const char* record64 = data.data() + position;
+                    count = read64(record64 + 32);
+                    directory_size = read64(record64 + 40);
+                    directory_offset = read64(record64 + 48);
+                    directory_end = position;
+                }
+                // Bytes prepended to the archive (a self-extractor stub) shift every offset.
+                if (directory_size + directory_offset > directory_end) bad_zip("central directory is out of range");
+                uint64_t concat = directory_end - directory_size - directory_offset;
+
+                members.reserve((size_t) std::min<uint64_t>(count, directory_size / 46));
+                size_t position = (size_t) (directory_offset + concat);
+                size_t stop = position + (size_t) directory_size;
+                while (position < stop) {
+                    if (stop - position < 46 || read32(data.data() + position) != CENTRAL_HEADER) bad_zip("bad magic number in central directory");
+                    const char* entry = data.data() + position;
+                    size_t name_length = read16(entry + 28), extra_length = read16(entry + 30), comment_length = read16(entry + 32);
+                    if (stop - position - 46 < name_length + extra_length + comment_length) bad_zip("central directory entry is truncated");
+                    ZipInfo info;
+                    info.create_system = (uint8_t) entry[5];
+                    info.flag_bits = read16(entry + 8);
+                    info.compress_type = read16(entry + 10);
+                    uint16_t time = read16(entry + 12), date = read16(entry + 14);
+                    info.date_time = {(date >> 9) + 1980, (date >> 5) & 15, date & 31, time >> 11, (time >> 5) & 63, (time & 31) * 2};
+                    info.CRC = read32(entry + 16);
+                    info.compress_size = read32(entry + 20);
+                    info.file_size = read32(entry + 24);
+                    info.external_attr = read32(entry + 38);
+                    info.header_offset = read32(entry + 42);
+                    info.filename = std::string_view(entry + 46, name_length);
+                    info.extra = std::string_view(entry + 46 + name_length, extra_length);
+                    info.comment = std::string_view(entry + 46 + name_length + extra_length, comment_length);
+
+                    // The ZIP64 extra field holds the 64-bit values of the fields saturated above.
+                    for (size_t at = 0; at + 4 <= info.extra.size();) {
+                        uint16_t id = read16(info.extra.data() + at), length = read16(info.extra.data() + at + 2);
+                        if (at + 4 + length > info.extra.size()) break;
+                        if (id == 1) {
+                            const char* field = info.extra.data() + at + 4;
+                            size_t left = length;
+                            for (uint64_t* value : {&info.file_size, &info.compress_size, &info.header_offset}) {
+                                if (*value != 0xFFFFFFFF) continue;
+                                if (left < 8) bad_zip("corrupt ZIP64 extra field");
+                                *value = read64(field);
+                                field += 8;
+                                left -= 8;
+                            }
+                        }
+                        at += 4 + length;
+                    }
+                    info.header_offset += concat;
+                    members.push_back(info);
+                    position += 46 + name_length + extra_length + comment_length;
+                }
+                index.reserve(members.size());
+                for (size_t i = 0; i < members.size(); ++i) index[members[i].filename] = i;
+            }
+
+            // The member data, located through its local header.
+            std::string_view raw(const ZipInfo& info) const {
+                using namespace detail;
+                if (info.header_offset > data.size() || data.size() - info.header_offset < 30 ||
+                    read32(data.data() + info.header_offset) != LOCAL_HEADER) {
+                    bad_zip("bad magic number for file header");
+                }
+                const char* header = data.data() + info.header_offset;
+                uint64_t start = info.header_offset + 30 + read16(header + 26) + read16(header + 28);
+                if (start > data.size() || data.size() - start < info.compress_size) bad_zip("member data is out of range");
+                return data.substr((size_t) start, (size_t) info.compress_size);
+            }
+
+            void check_supported(const ZipInfo& info) const {
+                if (info.flag_bits & 1) throw std::invalid_argument("zipfile: '" + std::string(info.filename) + "' is encrypted");
+                if (info.compress_type != ZIP_STORED && info.compress_type != ZIP_DEFLATED) {
+                    throw std::invalid_argument("zipfile: compression method " + std::to_string(info.compress_type) + " is not supported");
+                }
+            }
+
+            void write_file(const ZipInfo& info, const std::filesystem::path& target) const {
+                check_supported(info);
+                // Replace a link at the target instead of writing through it.
+                if (std::filesystem::is_symlink(target)) std::filesystem::remove(target);
+                archive::detail::OutputFile file(target);
+                std::string_view stored = raw(info);
+                if (info.compress_type == ZIP_STORED) {
+                    if (stored.size() != info.file_size) bad_zip_size(info);
+                    file.copy_range(source, (uint64_t) (stored.data() - data.data()), stored);
+                    return;
+                }
+                ZipExtFile reader(info, stored);
+                std::unique_ptr<char[]> buffer(new char[1 << 18]);
+                while (size_t n = reader.read(buffer.get(), 1 << 18)) file.write(buffer.get(), n);
+            }
+
+            [[noreturn]] static void bad_zip_size(const ZipInfo& info) {
+                throw std::invalid_argument("zipfile: sizes of stored member '" + std::string(info.filename) + "' differ");
+            }
+
+        public:
+            /**
+             * @brief Open an archive and read its central directory.
+             * @param filename The archive path.
+             * @throws std::invalid_argument if the file is not a valid zip archive.
+             */
+            explicit ZipFile(const char* filename) : mapping(std::make_unique<MappedFile>(filename)) {
+                data = std::string_view(mapping->data, mapping->size);
+                read_central_directory();
+#ifdef __linux__
+                source = ::open(filename, O_RDONLY | O_CLOEXEC);
+#endif
+            }
+
+            ZipFile(ZipFile&& other) noexcept
+                : mapping(std::move(other.mapping)), data(other.data), archive_comment(other.archive_comment), source(other.source),
+                  members(std::move(other.members)), index(std::move(other.index)) {
+                other.source = -1;
+            }
+
+            ZipFile(const ZipFile&) = delete;
+            ZipFile& operator=(const ZipFile&) = delete;
+            ZipFile& operator=(ZipFile&&) = delete;
+
+            ~ZipFile() {
+#ifdef __linux__
+                if (source >= 0) ::close(source);
+#endif
+            }
+
+            /**
+             * @brief Get the entries of the central directory in order.
+             * @return The entries.
+             */
+            const std::vector<ZipInfo>& infolist() const { return members; }
+
+            /**
+             * @brief Get the member names in order.
+             * @return Views of the names.
+             */
+            std::vector<std::string_view> namelist() const {
+                std::vector<std::string_view> names;
+                names.reserve(members.size());
+                for (const ZipInfo& member : members) names.push_back(member.filename);
+                return names;
+            }
+
+            /**
+             * @brief Get the archive comment.
+             * @return A view of the comment.
+             */
+            std::string_view comment() const { return archive_comment; }
+
+            /**
+             * @brief Check whether a member exists.
+             * @param name The member name.
+             * @return True if there is a member with this name.
+             */
+            bool contains(std::string_view name) const { return index.count(name) != 0; }
+
+            /**
+             * @brief Find a member. If the name occurs more than once, the last one is returned.
+             * @param name The member name.
+             * @return The entry.
+             * @throws std::out_of_range if there is no such member.
+             */
+            const ZipInfo& getinfo(std::string_view name) const {
+                auto it = index.find(name);
+                if (it == index.end()) throw std::out_of_range("zipfile: There is no item named '" + std::string(name) + "' in the archive");
+                return members[it->second];
+            }
+
+            /**
+             * @brief Open a member for reading.
+             * @param info The entry.
+             * @return A reader over the uncompressed data.
+             * @throws std::invalid_argument if the member is encrypted or uses another method.
+             */
+            ZipExtFile open(const ZipInfo& info) const {
+                check_supported(info);
+                return ZipExtFile(info, raw(info));
+            }
+
+            ZipExtFile open(std::string_view name) const { return open(getinfo(name)); }
+
+            /**
+             * @brief Read a whole member, checking its CRC-32.
+             * @param name The member name.
+             * @return The uncompressed data.
+             */
+            std::string read(std::string_view name) const { return open(name).read(); }
+
+            /**
+             * @brief Get the data of a stored member without copying it. The CRC-32 is not
+             * checked.
+             * @param info The entry.
+             * @return A view into the archive.
+             * @throws std::invalid_argument if the member is compressed.
+             */
+            std::string_view view(const ZipInfo& info) const {
+                if (info.compress_type != ZIP_STORED || (info.flag_bits & 1)) {
+                    throw std::invalid_argument("zipfile: '" + std::string(info.filename) + "' is not stored uncompressed");
+                }
+                std::string_view stored = raw(info);
+                if (stored.size() != info.file_size) bad_zip_size(info);
+                return stored;
+            }
+
+            std::string_view view(std::string_view name) const { return view(getinfo(name)); }
+
+            /**
+             * @brief Extract one member below path. Drive letters, empty, "." and ".."
+             * components of the name are dropped, and members below a symbolic link are refused.
+             * @param info The entry.
+             * @param path The destination directory.
+             * @throws std::invalid_argument if the member would be written outside path.
+             */
+            void extract(const ZipInfo& info, const char* path = ".") const {
+                std::filesystem::path target = archive::detail::member_path(path, info.filename);
+                archive::detail::check_parents(path, target, "zipfile");
+                if (info.is_dir()) {
+                    std::filesystem::create_directories(target);
+                    return;
+                }
+                if (target.has_parent_path()) std::filesystem::create_directories(target.parent_path());
+                write_file(info, target);
+            }
+
+            void extract(std::string_view name, const char* path = ".") const { extract(getinfo(name), path); }
+
+            /**
+             * @brief Extract every member below path. Directories are created first, then the
+             * files are written in parallel, largest first. Deflated members are checked
+             * against their CRC-32; stored members are copied without reading them. Members
+             * are checked as by extract().
+             * @param path The destination directory.
+             * @param pool The pool that writes the files.
+             * @throws std::invalid_argument if a member would be written outside path.
+             */
+            void extractall(const char* path = ".", ThreadPool& pool = ThreadPool::global()) const {
+                profile::Span span("zipfile.extractall");
+                std::filesystem::path root(path);
+                std::vector<std::filesystem::path> targets;
+                targets.reserve(members.size());
+                for (const ZipInfo& member : members) targets.push_back(archive::detail::member_path(root, member.filename));
+                std::vector<size_t> order = archive::detail::last_writers(targets);
+
+                std::vector<std::filesystem::path> files;
+                std::vector<size_t> regular;
+                for (size_t i : order) {
+                    archive::detail::check_parents(root, targets[i], "zipfile");
+                    if (members[i].is_dir()) {
+                        std::filesystem::create_directories(targets[i]);
+                    } else {
+                        regular.push_back(i);
+                        files.push_back(targets[i]);
+                    }
+                }
+                archive::detail::make_parents(files);
+                std::stable_sort(regular.begin(), regular.end(),
+                                 [&](size_t a, size_t b) { return members[a].compress_size > members[b].compress_size; });
+                pool.parallel_for(0, regular.size(), [&](size_t i) { write_file(members[regular[i]], targets[regular[i]]); });
+            }
+        };
+
+        /**
+         * @brief Check whether a file is a zip archive, by looking for its end record.
+         * @param filename The file path.
+         * @return True if the central directory can be read.
+         */
+        inline bool is_zipfile(const char* filename) {
+            try {
+                ZipFile archive(filename);
+                return true;
+            } catch (const std::exception&) {
+                return false;
+            }
+        }
+    }
+}
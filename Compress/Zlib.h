@@ -0,0 +1,617 @@
+// EasyCpp - Zlib : Deflate Compression and Checksums
+// Copyright (C) 2025  C14147
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+/**
+ * @file EasyCpp/Compress/Zlib.h
+ * @brief This file implements the parts of Python's zlib module EasyCpp needs without linking
+ *        against zlib: crc32, adler32, a raw deflate encoder (LZ77 with fixed Huffman codes, or
+ *        stored blocks at level 0), a complete inflate decoder, and the zlib container
+ *        (compress/decompress). Output is readable by any zlib; any zlib stream can be decoded.
+ */
+#pragma once
+#define _EASYCPP_ZLIB_VERSION "1.0.0"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace easycpp {
+    namespace zlib {
+        /**
+         * @brief Compute the Adler-32 checksum.
+         * @param data The bytes.
+         * @param size The number of bytes.
+         * @param adler The checksum of the preceding bytes, for incremental use.
+         * @return The checksum.
+         */
+        inline uint32_t adler32(const void* data, size_t size, uint32_t adler = 1) {
+            const unsigned char* p = static_cast<const unsigned char*>(data);
+            uint32_t a = adler & 0xFFFF, b = adler >> 16;
+            while (size > 0) {
+                // 5552 is the largest block for which b cannot overflow 32 bits before the modulo.
+                size_t block = std::min<size_t>(size, 5552);
+                size -= block;
+                while (block--) {
+                    a += *p++;
+                    b += a;
+                }
+                a %= 65521;
+                b %= 65521;
+            }
+            return (b << 16) | a;
+        }
+
+        /**
+         * @brief Compute the CRC-32 (IEEE 802.3) checksum used by zip, gzip and png.
+         * @param data The bytes.
+         * @param size The number of bytes.
+         * @param crc The checksum of the preceding bytes, for incremental use.
+         * @return The checksum.
+         */
+        inline uint32_t crc32(const void* data, size_t size, uint32_t crc = 0) {
+            // Slicing-by-8 tables: eight bytes per step instead of one.
+            static const auto tables = [] {
+                std::vector<uint32_t> t(8 * 256);
+                for (uint32_t i = 0; i < 256; ++i) {
+                    uint32_t c = i;
+                    for (int k = 0; k < 8; ++k) c = (c >> 1) ^ (0xEDB88320U & (0U - (c & 1)));
+                    t[i] = c;
+                }
+                for (uint32_t i = 0; i < 256; ++i) {
+                    for (int s = 1; s < 8; ++s) t[s * 256 + i] = (t[(s - 1) * 256 + i] >> 8) ^ t[t[(s - 1) * 256 + i] & 0xFF];
+                }
+                return t;
+            }();
+            const uint32_t* t = tables.data();
+            const unsigned char* p = static_cast<const unsigned char*>(data);
+            crc = ~crc;
+            while (size >= 8) {
+                uint32_t one = crc ^ ((uint32_t) p[0] | (uint32_t) p[1] << 8 | (uint32_t) p[2] << 16 | (uint32_t) p[3] << 24);
+                crc = t[7 * 256 + (one & 0xFF)] ^ t[6 * 256 + ((one >> 8) & 0xFF)] ^ t[5 * 256 + ((one >> 16) & 0xFF)] ^ t[4 * 256 + (one >> 24)]
+                    ^ t[3 * 256 + p[4]] ^ t[2 * 256 + p[5]] ^ t[1 * 256 + p[6]] ^ t[p[7]];
+                p += 8;
+                size -= 8;
+            }
+            while (size--) crc = (crc >> 8) ^ t[(crc ^ *p++) & 0xFF];
+            return ~crc;
+        }
+
+        namespace detail {
+            static constexpr uint16_t LENGTH_BASE[29] = {3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+                                                         35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+            static constexpr uint8_t LENGTH_EXTRA[29] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+                                                         3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+            static constexpr uint16_t DIST_BASE[30] = {1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+                                                       257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577};
+            static constexpr uint8_t DIST_EXTRA[30] = {0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+                                                       7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+
+            inline uint32_t reverse_bits(uint32_t code, int length) {
+                uint32_t result = 0;
+                for (int i = 0; i < length; ++i, code >>= 1) result = (result << 1) | (code & 1);
+                return result;
+            }
+
+            class BitWriter {
+            public:
+                std::string& out;
+                uint64_t buffer = 0;
+                int count = 0;
+
+                explicit BitWriter(std::string& out) : out(out) {}
+
+                void put(uint32_t bits, int length) {
+                    buffer |= (uint64_t) bits << count;
+                    count += length;
+                    while (count >= 8) {
+                        out += (char) (buffer & 0xFF);
+                        buffer >>= 8;
+                        count -= 8;
+                    }
+                }
+
+                // Huffman codes are stored most significant bit first.
+                void put_code(uint32_t code, int length) { put(reverse_bits(code, length), length); }
+
+                void flush() {
+                    if (count > 0) out += (char) (buffer & 0xFF);
+                    buffer = 0;
+                    count = 0;
+                }
+            };
+
+            inline void put_literal(BitWriter& writer, unsigned symbol) {
+                if (symbol < 144) writer.put_code(0x30 + symbol, 8);
+                else if (symbol < 256) writer.put_code(0x190 + symbol - 144, 9);
+                else if (symbol < 280) writer.put_code(symbol - 256, 7);
+                else writer.put_code(0xC0 + symbol - 280, 8);
+            }
+
+            inline void put_match(BitWriter& writer, unsigned length, unsigned distance) {
+                int code = 28;
+                while (LENGTH_BASE[code] > length) --code;
+                put_literal(writer, 257 + code);
+                writer.put(length - LENGTH_BASE[code], LENGTH_EXTRA[code]);
+                code = 29;
+                while (DIST_BASE[code] > distance) --code;
+                writer.put_code(code, 5);
+                writer.put(distance - DIST_BASE[code], DIST_EXTRA[code]);
+            }
+
+            class BitReader {
+            public:
+                const unsigned char* cursor;
+                const unsigned char* end;
+                uint64_t buffer = 0;
+                int count = 0;
+                int overrun = 0;  // Zero bytes appended past the end of the input
+
+                BitReader(const unsigned char* data, size_t size) : cursor(data), end(data + size) {}
+
+                void refill() {
+                    while (count <= 56) {
+                        uint64_t byte = 0;
+                        if (cursor < end) byte = *cursor++;
+                        else if (++overrun > 8) throw std::invalid_argument("zlib: truncated deflate stream");
+                        buffer |= byte << count;
+                        count += 8;
+                    }
+                }
+
+                uint32_t get(int length) {
+                    if (length == 0) return 0;
+                    if (count < length) refill();
+                    uint32_t bits = (uint32_t) (buffer & ((1ULL << length) - 1));
+                    buffer >>= length;
+                    count -= length;
+                    return bits;
+                }
+
+                void align() {
+                    int drop = count % 8;
+                    buffer >>= drop;
+                    count -= drop;
+                }
+
+                // Bytes of real input consumed so far.
+                size_t consumed(const unsigned char* start) const {
+                    return (size_t) (cursor - start) - (size_t) (count / 8 - overrun);
+                }
+            };
+
+            class Huffman {
+            public:
+                static constexpr int FAST_BITS = 10;
+
+                uint16_t fast[1 << FAST_BITS];  // length << 9 | symbol, 0 when the code is longer
+                uint16_t count[16];
+                uint16_t symbol[320];
+
+                void build(const uint8_t* lengths, int n) {
+                    std::memset(count, 0, sizeof(count));
+                    std::memset(fast, 0, sizeof(fast));
+                    for (int i = 0; i < n; ++i) ++count[lengths[i]];
+                    count[0] = 0;
+                    int left = 1;
+                    for (int length = 1; length < 16; ++length) {
+                        left = (left << 1) - count[length];
+                        if (left < 0) throw std::invalid_argument("zlib: over-subscribed Huffman code");
+                    }
+                    uint16_t offset[16] = {0};
+                    uint32_t next_code[16] = {0};
+                    uint32_t code = 0;
+                    for (int length = 1; length < 16; ++length) {
+                        offset[length] = (uint16_t) (offset[length - 1] + count[length - 1]);
+                        code = (code + count[length - 1]) << 1;
+                        next_code[length] = code;
+                    }
+                    for (int i = 0; i < n; ++i) {
+                        int length = lengths[i];
+                        if (!length) continue;
+                        symbol[offset[length]++] = (uint16_t) i;
+                        if (length <= FAST_BITS) {
+                            uint32_t reversed = reverse_bits(next_code[length], length);
+                            for (uint32_t slot = reversed; slot < (1u << FAST_BITS); slot += 1u << length) {
+                                fast[slot] = (uint16_t) (length << 9 | i);
+                            }
+                        }
+                        ++next_code[length];
+                    }
+                }
+
+                int decode(BitReader& reader) const {
+                    if (reader.count < 15) reader.refill();
+                    uint16_t entry = fast[reader.buffer & ((1u << FAST_BITS) - 1)];
+                    if (entry) {
+                        int length = entry >> 9;
+                        reader.buffer >>= length;
+                        reader.count -= length;
+                        return entry & 0x1FF;
+                    }
+                    // Canonical decoding, one bit at a time, for codes longer than FAST_BITS.
+                    int code = 0, first = 0, index = 0;
+                    for (int length = 1; length < 16; ++length) {
+                        code |= (int) reader.get(1);
+                        int n = count[length];
+                        if (code - n < first) return symbol[index + (code - first)];
+                        index += n;
+                        first = (first + n) << 1;
+                        code <<= 1;
+                    }
+                    throw std::invalid_argument("zlib: invalid Huffman code");
+                }
+            };
+
+            // Decode symbols until the end of the block (returns true) or until out holds at
+            // least `limit` bytes (returns false; a match may overshoot by up to 257 bytes).
+            inline bool inflate_block(BitReader& reader, std::string& out, const Huffman& literals, const Huffman& distances,
+                                      size_t limit = SIZE_MAX) {
+                while (out.size() < limit) {
+                    int symbol = literals.decode(reader);
+                    if (symbol < 256) {
+                        out += (char) symbol;
+                        continue;
+                    }
+                    if (symbol == 256) return true;
+                    symbol -= 257;
+                    if (symbol >= 29) throw std::invalid_argument("zlib: invalid length code");
+                    size_t length = LENGTH_BASE[symbol] + reader.get(LENGTH_EXTRA[symbol]);
+                    int code = distances.decode(reader);
+                    if (code >= 30) throw std::invalid_argument("zlib: invalid distance code");
+                    size_t distance = DIST_BASE[code] + reader.get(DIST_EXTRA[code]);
+                    if (distance > out.size()) throw std::invalid_argument("zlib: distance too far back");
+                    size_t from = out.size() - distance;
+                    if (distance >= length) {
+                        out.append(out, from, length);
+                    } else {
+                        // Overlapping copy repeats the last `distance` bytes.
+                        out.reserve(out.size() + length);
+                        for (size_t i = 0; i < length; ++i) out += out[from + i];
+                    }
+                }
+                return false;
+            }
+
+            inline const Huffman* fixed_tables() {
+                static const auto tables = [] {
+                    std::vector<Huffman> tables(2);
+                    uint8_t lengths[288];
+                    std::fill(lengths, lengths + 144, 8);
+                    std::fill(lengths + 144, lengths + 256, 9);
+                    std::fill(lengths + 256, lengths + 280, 7);
+                    std::fill(lengths + 280, lengths + 288, 8);
+                    tables[0].build(lengths, 288);
+                    std::fill(lengths, lengths + 30, 5);
+                    tables[1].build(lengths, 30);
+                    return tables;
+                }();
+                return tables.data();
+            }
+
+            inline void read_dynamic_tables(BitReader& reader, Huffman& literals, Huffman& distances) {
+                static constexpr uint8_t ORDER[19] = {16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15};
+                int literal_count = (int) reader.get(5) + 257;
+                int distance_count = (int) reader.get(5) + 1;
+                int code_count = (int) reader.get(4) + 4;
+                if (literal_count > 286 || distance_count > 30) throw std::invalid_argument("zlib: bad dynamic block header");
+                uint8_t lengths[320] = {0};
+                for (int i = 0; i < code_count; ++i) lengths[ORDER[i]] = (uint8_t) reader.get(3);
+                Huffman code_lengths;
+                code_lengths.build(lengths, 19);
+                std::memset(lengths, 0, sizeof(lengths));
+                for (int i = 0; i < literal_count + distance_count;) {
+                    int symbol = code_lengths.decode(reader);
+                    if (symbol < 16) {
+                        lengths[i++] = (uint8_t) symbol;
+                        continue;
+                    }
+                    uint8_t value = 0;
+                    int repeat;
+                    if (symbol == 16) {
+                        if (i == 0) throw std::invalid_argument("zlib: repeat with no previous length");
+                        value = lengths[i - 1];
+                        repeat = 3 + (int) reader.get(2);
+                    } else if (symbol == 17) {
+                        repeat = 3 + (int) reader.get(3);
+                    } else {
+                        repeat = 11 + (int) reader.get(7);
+                    }
+                    if (i + repeat > literal_count + distance_count) throw std::invalid_argument("zlib: too many code lengths");
+                    while (repeat--) lengths[i++] = value;
+                }
+                if (lengths[256] == 0) throw std::invalid_argument("zlib: missing end-of-block code");
+                literals.build(lengths, literal_count);
+                distances.build(lengths + literal_count, distance_count);
+            }
+
+            // Read the LEN/NLEN header of a stored block and return LEN.
+            inline uint32_t stored_length(BitReader& reader) {
+                reader.align();
+                uint32_t length = reader.get(16);
+                uint32_t inverse = reader.get(16);
+                if ((length ^ 0xFFFF) != inverse) throw std::invalid_argument("zlib: corrupt stored block");
+                if (reader.overrun && length > (uint32_t) (reader.count / 8 - reader.overrun)) {
+                    throw std::invalid_argument("zlib: truncated stored block");
+                }
+                return length;
+            }
+
+            // Copy `length` bytes of a stored block: whole bytes still held in the bit buffer
+            // first, then directly from the input.
+            inline void copy_stored(BitReader& reader, std::string& out, size_t length) {
+                while (length > 0 && reader.count >= 8) {
+                    out += (char) reader.get(8);
+                    --length;
+                }
+                if ((size_t) (reader.end - reader.cursor) < length) throw std::invalid_argument("zlib: truncated stored block");
+                out.append(reinterpret_cast<const char*>(reader.cursor), length);
+                reader.cursor += length;
+            }
+
+            inline size_t inflate(const unsigned char* data, size_t size, std::string& out) {
+                BitReader reader(data, size);
+                bool last = false;
+                while (!last) {
+                    last = reader.get(1);
+                    uint32_t type = reader.get(2);
+                    if (type == 0) {
+                        copy_stored(reader, out, stored_length(reader));
+                    } else if (type == 1) {
+                        const Huffman* fixed = fixed_tables();
+                        inflate_block(reader, out, fixed[0], fixed[1]);
+                    } else if (type == 2) {
+                        Huffman literals, distances;
+                        read_dynamic_tables(reader, literals, distances);
+                        inflate_block(reader, out, literals, distances);
+                    } else {
+                        throw std::invalid_argument("zlib: invalid block type");
+                    }
+                }
+                if (reader.overrun * 8 > reader.count) throw std::invalid_argument("zlib: truncated deflate stream");
+                return reader.consumed(data);
+            }
+
+            /**
+             * @class Inflater
+             * @brief Decodes a raw deflate stream held in memory a piece at a time, so the
+             * output never has to exist in full. Only the last 32 KiB of output (the deflate
+             * window) are kept besides the bytes not yet read.
+             */
+            class Inflater {
+            private:
+                static constexpr size_t WINDOW = 32768;
+                static constexpr size_t CHUNK = 65536;
+
+                BitReader reader;
+                const unsigned char* start;
+                std::string window;  // Decoded bytes; [position, size) are not read yet
+                size_t position = 0;
+                Huffman literals, distances;
+                const Huffman* tables = nullptr;
+                uint32_t stored_left = 0;
+                int type = -1;  // Type of the current block, -1 between blocks
+                bool last = false;
+                bool finished = false;
+
+                void decode_more() {
+                    if (position > 2 * WINDOW) {
+                        window.erase(0, position - WINDOW);
+                        position = WINDOW;
+                    }
+                    size_t limit = window.size() + CHUNK;
+                    while (window.size() < limit && !finished) {
+                        if (type < 0) {
+                            if (last) {
+                                if (reader.overrun * 8 > reader.count) throw std::invalid_argument("zlib: truncated deflate stream");
+                                finished = true;
+                                break;
+                            }
+                            last = reader.get(1);
+                            type = (int) reader.get(2);
+                            if (type == 0) {
+                                stored_left = stored_length(reader);
+                            } else if (type == 1) {
+                                tables = fixed_tables();
+                            } else if (type == 2) {
+                                read_dynamic_tables(reader, literals, distances);
+                                tables = nullptr;
+                            } else {
+                                throw std::invalid_argument("zlib: invalid block type");
+                            }
+                        }
+                        if (type == 0) {
+                            size_t length = std::min<size_t>(stored_left, limit - window.size());
+                            copy_stored(reader, window, length);
+                            stored_left -= (uint32_t) length;
+                            if (!stored_left) type = -1;
+                        } else if (tables ? inflate_block(reader, window, tables[0], tables[1], limit)
+                                          : inflate_block(reader, window, literals, distances, limit)) {
+                            type = -1;
+                        }
+                    }
+                }
+
+            public:
+                Inflater(const unsigned char* data, size_t size) : reader(data, size), start(data) {}
+
+                /**
+                 * @brief Decode up to size bytes.
+                 * @param buffer The destination.
+                 * @param size The capacity of buffer.
+                 * @return The number of bytes stored, 0 once the stream has ended.
+                 * @throws std::invalid_argument if the stream is corrupt or truncated.
+                 */
+                size_t read(char* buffer, size_t size) {
+                    size_t done = 0;
+                    while (done < size) {
+                        if (position == window.size()) {
+                            if (finished) break;
+                            decode_more();
+                            continue;
+                        }
+                        size_t n = std::min(size - done, window.size() - position);
+                        std::memcpy(buffer + done, window.data() + position, n);
+                        position += n;
+                        done += n;
+                    }
+                    return done;
+                }
+
+                bool eof() const { return finished && position == window.size(); }
+
+                // Bytes of compressed input consumed so far.
+                size_t consumed() const { return reader.consumed(start); }
+            };
+        }
+
+        /**
+         * @brief Compress to a raw deflate stream (no zlib header), as used inside zip files.
+         * @param data The bytes to compress.
+         * @param level 0 stores the data uncompressed; 1 to 9 trade speed for ratio.
+         * @return The compressed stream.
+         */
+        inline std::string deflate(std::string_view data, int level = 6) {
+            std::string out;
+            detail::BitWriter writer(out);
+            if (level <= 0) {
+                size_t position = 0;
+                do {
+                    size_t length = std::min<size_t>(data.size() - position, 65535);
+                    writer.put(position + length == data.size() ? 1 : 0, 1);
+                    writer.put(0, 2);
+                    writer.flush();
+                    writer.put((uint32_t) length, 16);
+                    writer.put((uint32_t) length ^ 0xFFFF, 16);
+                    out.append(data.data() + position, length);
+                    position += length;
+                } while (position < data.size());
+                return out;
+            }
+
+            // One fixed-Huffman block with greedy LZ77 matching over hash chains.
+            constexpr size_t WINDOW = 32768, HASH_SIZE = 1 << 15, MIN_MATCH = 3, MAX_MATCH = 258;
+            const int max_chain = 4 << std::min(level, 9);
+            const unsigned char* p = reinterpret_cast<const unsigned char*>(data.data());
+            const size_t n = data.size();
+            std::vector<int64_t> head(HASH_SIZE, -1);
+            std::vector<int64_t> previous(std::min(n, WINDOW), -1);
+            auto hash3 = [&](size_t i) {
+                return (((uint32_t) p[i] << 16 | (uint32_t) p[i + 1] << 8 | p[i + 2]) * 2654435761U) >> 17;
+            };
+            auto insert = [&](size_t i) {
+                if (i + MIN_MATCH > n) return;
+                uint32_t h = hash3(i);
+                previous[i % WINDOW] = head[h];
+                head[h] = (int64_t) i;
+            };
+
+            writer.put(1, 1);
+            writer.put(1, 2);
+            size_t i = 0;
+            while (i < n) {
+                size_t best_length = 0, best_distance = 0;
+                if (i + MIN_MATCH <= n) {
+                    int64_t candidate = head[hash3(i)];
+                    const size_t limit = std::min(MAX_MATCH, n - i);
+                    for (int chain = 0; candidate >= 0 && i - (size_t) candidate <= WINDOW && chain < max_chain; ++chain) {
+                        const unsigned char* a = p + candidate;
+                        const unsigned char* b = p + i;
+                        if (a[best_length] == b[best_length]) {
+                            size_t length = 0;
+                            while (length < limit && a[length] == b[length]) ++length;
+                            if (length > best_length) {
+                                best_length = length;
+                                best_distance = i - (size_t) candidate;
+                                if (length == limit) break;
+                            }
+                        }
+                        int64_t next = previous[(size_t) candidate % WINDOW];
+                        if (next >= candidate) break;
+                        candidate = next;
+                    }
+                }
+                if (best_length >= MIN_MATCH) {
+                    detail::put_match(writer, (unsigned) best_length, (unsigned) best_distance);
+                    for (size_t j = 0; j < best_length; ++j) insert(i + j);
+                    i += best_length;
+                } else {
+                    detail::put_literal(writer, p[i]);
+                    insert(i);
+                    ++i;
+                }
+            }
+            detail::put_literal(writer, 256);
+            writer.flush();
+            // Incompressible input costs about 5% with fixed codes; stored blocks cost 5 bytes per 64 KiB.
+            if (out.size() > n + 5 * (n / 65535 + 1)) return deflate(data, 0);
+            return out;
+        }
+
+        /**
+         * @brief Decompress a raw deflate stream.
+         * @param data The compressed stream.
+         * @param size_hint The expected decompressed size, used to reserve memory.
+         * @return The decompressed bytes.
+         * @throws std::invalid_argument if the stream is corrupt or truncated.
+         */
+        inline std::string inflate(std::string_view data, size_t size_hint = 0) {
+            std::string out;
+            out.reserve(size_hint ? size_hint : data.size() * 3);
+            detail::inflate(reinterpret_cast<const unsigned char*>(data.data()), data.size(), out);
+            return out;
+        }
+
+        /**
+         * @brief Compress to a zlib stream (header, deflate data, Adler-32 trailer).
+         * @param data The bytes to compress.
+         * @param level The compression level, 0 to 9.
+         * @return The zlib stream.
+         */
+        inline std::string compress(std::string_view data, int level = 6) {
+            std::string out = "\x78\x9c";
+            out += deflate(data, level);
+            uint32_t checksum = adler32(data.data(), data.size());
+            for (int shift = 24; shift >= 0; shift -= 8) out += (char) (checksum >> shift);
+            return out;
+        }
+
+        /**
+         * @brief Decompress a zlib stream.
+         * @param data The zlib stream.
+         * @param size_hint The expected decompressed size, used to reserve memory.
+         * @return The decompressed bytes.
+         * @throws std::invalid_argument if the header, data or checksum is invalid.
+         */
+        inline std::string decompress(std::string_view data, size_t size_hint = 0) {
+            const unsigned char* p = reinterpret_cast<const unsigned char*>(data.data());
+            if (data.size() < 6 || (p[0] & 0x0F) != 8 || ((p[0] << 8) | p[1]) % 31 != 0 || (p[1] & 0x20)) {
+                throw std::invalid_argument("zlib: invalid zlib header");
+            }
+            std::string out;
+            out.reserve(size_hint ? size_hint : data.size() * 3);
+            size_t consumed = 2 + detail::inflate(p + 2, data.size() - 2, out);
+            if (data.size() - consumed < 4) throw std::invalid_argument("zlib: missing checksum");
+            uint32_t expected = (uint32_t) p[consumed] << 24 | (uint32_t) p[consumed + 1] << 16 | (uint32_t) p[consumed + 2] << 8 | p[consumed + 3];
+            if (adler32(out.data(), out.size()) != expected) throw std::invalid_argument("zlib: checksum mismatch");
+            return out;
+        }
+    }
+}
@@ -0,0 +1,645 @@
+// EasyCpp - Config : Zero-Copy Configuration Documents
+// Copyright (C) 2025  C14147
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+/**
+ * @file EasyCpp/Config/Config.h
+ * @brief This file implements the document model shared by the INI (configparser), TOML and
+ *        YAML loaders. Parsing only finds token boundaries: keys and scalars are string views
+ *        into the source buffer (a loaded string or a memory-mapped file), and escapes, line
+ *        joining and number conversion happen when a value is read with as_string(), as_int(),
+ *        as_double() or as_bool(). Tables keep their keys in file order.
+ */
+#pragma once
+#define _EASYCPP_CONFIG_VERSION "1.0.0"
+
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <deque>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <FileOperator/FileOperator.h>
+
+namespace easycpp {
+    namespace config {
+        enum class Type : uint8_t { NONE, STRING, INTEGER, FLOAT, BOOLEAN, DATETIME, TABLE, ARRAY };
+
+        /**
+         * @brief How the text of a scalar is turned into a string on access.
+         */
+        enum class Style : uint8_t {
+            RAW,            // The text as is
+            ESCAPED,        // Backslash escapes (TOML basic strings)
+            DOUBLE_QUOTED,  // YAML double-quoted: backslash escapes, line breaks fold
+            SINGLE_QUOTED,  // YAML single-quoted: '' is a quote, line breaks fold
+            JOINED,         // INI continuation lines: each line stripped, joined with '\n'
+            FOLDED,         // YAML multi-line plain scalar: line breaks fold to spaces
+            LITERAL_BLOCK,  // YAML '|' block scalar
+            FOLDED_BLOCK    // YAML '>' block scalar
+        };
+
+        class Document;
+
+        /**
+         * @class Value
+         * @brief A node of a configuration document: a scalar, a table (ordered key-value pairs)
+         * or an array. Values are owned by their Document and are not copyable.
+         */
+        class Value {
+        public:
+            using Item = std::pair<std::string_view, Value*>;
+
+        private:
+            friend class Document;
+
+            Type kind;
+            Style style = Style::RAW;
+            bool plain = false;     // Untyped scalar (INI, YAML plain): the type is resolved from the text
+            uint8_t chomp = 0;      // Block scalars: 0 clip, 1 strip, 2 keep
+            uint8_t flags = 0;      // Parser bookkeeping (e.g. TOML table defined by a header)
+            uint16_t indent = 0;    // Block scalars: indentation removed from each line
+            std::string_view text;
+            std::vector<Item> table_items;
+            std::vector<Value*> array_items;
+            std::unique_ptr<std::unordered_map<std::string_view, size_t>> index;  // Built for large tables
+
+            static constexpr size_t INDEX_THRESHOLD = 12;
+
+            static Type resolve(std::string_view s) {
+                // YAML 1.2 core schema, plus the YAML 1.1 booleans yes/no/on/off.
+                if (s.empty() || s == "~" || s == "null" || s == "Null" || s == "NULL") return Type::NONE;
+                if (parse_bool(s, nullptr)) return Type::BOOLEAN;
+                int64_t integer;
+                if (parse_int(s, &integer)) return Type::INTEGER;
+                double real;
+                if (parse_double(s, &real)) return Type::FLOAT;
+                return Type::STRING;
+            }
+
+        public:
+            explicit Value(Type kind) : kind(kind) {}
+
+            Value(const Value&) = delete;
+            Value& operator=(const Value&) = delete;
+
+            static bool parse_bool(std::string_view s, bool* result) {
+                static constexpr std::string_view TRUE_WORDS[] = {"true", "yes", "on", "1"};
+                static constexpr std::string_view FALSE_WORDS[] = {"false", "no", "off", "0"};
+                auto equal = [](std::string_view a, std::string_view b) {
+                    if (a.size() != b.size()) return false;
+                    for (size_t i = 0; i < a.size(); ++i) {
+                        char c = a[i];
+                        if (c >= 'A' && c <= 'Z') c = (char) (c - 'A' + 'a');
+                        if (c != b[i]) return false;
+                    }
+                    return true;
+                };
+                for (std::string_view word : TRUE_WORDS) {
+                    if (equal(s, word)) {
+                        if (result) *result = true;
+                        return result || word != "1";
+                    }
+                }
+                for (std::string_view word : FALSE_WORDS) {
+                    if (equal(s, word)) {
+                        if (result) *result = false;
+                        return result || word != "0";
+                    }
+                }
+                return false;
+            }
+
+            static bool parse_int(std::string_view s, int64_t* result) {
+                char digits[72];
+                size_t n = 0;
+                bool negative = false;
+                if (!s.empty() && (s[0] == '+' || s[0] == '-')) {
+                    negative = s[0] == '-';
+                    s.remove_prefix(1);
+                }
+                int base = 10;
+                if (s.size() > 2 && s[0] == '0' && (s[1] == 'x' || s[1] == 'o' || s[1] == 'b')) {
+                    base = s[1] == 'x' ? 16 : s[1] == 'o' ? 8 : 2;
+                    s.remove_prefix(2);
+                }
+                if (s.empty() || s.front() == '_' || s.back() == '_') return false;
+                if (negative) digits[n++] = '-';
+                for (char c : s) {
+                    if (c == '_') continue;
+                    if (n + 1 >= sizeof(digits)) return false;
+                    digits[n++] = c;
+                }
+                int64_t value;
+                auto [end, error] = std::from_chars(digits, digits + n, value, base);
+                if (error != std::errc() || end != digits + n) return false;
+                *result = value;
+                return true;
+            }
+
+            static bool parse_double(std::string_view s, double* result) {
+                std::string_view body = s;
+                bool negative = false;
+                if (!body.empty() && (body[0] == '+' || body[0] == '-')) {
+                    negative = body[0] == '-';
+                    body.remove_prefix(1);
+                }
+                if (!body.empty() && body[0] == '.' && body.size() > 1 && (body[1] < '0' || body[1] > '9')) body.remove_prefix(1);  // YAML .inf
+                if (body == "inf" || body == "Inf" || body == "INF") {
+                    *result = negative ? -std::numeric_limits<double>::infinity() : std::numeric_limits<double>::infinity();
+                    return true;
+                }
+                if (body == "nan" || body == "NaN" || body == "NAN") {
+                    *result = std::numeric_limits<double>::quiet_NaN();
+                    return true;
+                }
+                char digits[128];
+                size_t n = 0;
+                for (char c : s) {
+                    if (c == '_') continue;
+                    if (n + 1 >= sizeof(digits)) return false;
+                    digits[n++] = c;
+                }
+                const char* begin = digits + (n && digits[0] == '+' ? 1 : 0);
+                if (begin == digits + n) return false;
+                auto [end, error] = std::from_chars(begin, digits + n, *result);
+                return error == std::errc() && end == digits + n;
+            }
+
+            /**
+             * @brief Get the type. Untyped scalars (INI values, YAML plain scalars) are resolved
+             * from their text: null, booleans, integers and floats, otherwise a string.
+             * @return The type.
+             */
+            Type type() const { return plain ? resolve(text) : kind; }
+
+            bool is_null() const { return type() == Type::NONE; }
+            bool is_table() const { return kind == Type::TABLE; }
+            bool is_array() const { return kind == Type::ARRAY; }
+            bool is_scalar() const { return kind != Type::TABLE && kind != Type::ARRAY; }
+
+            /**
+             * @brief Get the number of entries of a table or elements of an array.
+             * @return The size, 0 for scalars.
+             */
+            size_t size() const { return kind == Type::TABLE ? table_items.size() : array_items.size(); }
+
+            /**
+             * @brief Look up a key of a table.
+             * @param key The key.
+             * @return The value, or nullptr if absent or if this is not a table.
+             */
+            const Value* get(std::string_view key) const {
+                if (index) {
+                    auto found = index->find(key);
+                    return found == index->end() ? nullptr : table_items[found->second].second;
+                }
+                for (const Item& item : table_items) {
+                    if (item.first == key) return item.second;
+                }
+                return nullptr;
+            }
+
+            Value* get(std::string_view key) { return const_cast<Value*>(static_cast<const Value*>(this)->get(key)); }
+
+            bool contains(std::string_view key) const { return get(key) != nullptr; }
+
+            /**
+             * @brief Look up a key of a table.
+             * @param key The key.
+             * @return The value.
+             * @throws std::out_of_range if the key is absent.
+             */
+            const Value& operator[](std::string_view key) const {
+                const Value* value = get(key);
+                if (!value) throw std::out_of_range("config: no key '" + std::string(key) + "'");
+                return *value;
+            }
+
+            const Value& operator[](const char* key) const { return (*this)[std::string_view(key)]; }
+
+            /**
+             * @brief Get an element of an array.
+             * @param i The index.
+             * @return The element.
+             * @throws std::out_of_range if the index is out of range.
+             */
+            const Value& operator[](size_t i) const {
+                if (i >= array_items.size()) throw std::out_of_range("config: array index out of range");
+                return *array_items[i];
+            }
+
+            const Value& operator[](int i) const { return (*this)[(size_t) i]; }
+
+            const std::vector<Item>& items() const { return table_items; }
+            const std::vector<Value*>& elements() const { return array_items; }
+
+            /**
+             * @brief Get the source text of a scalar, without quotes, escapes undecoded.
+             * @return A view into the source buffer.
+             */
+            std::string_view raw() const { return text; }
+
+            /**
+             * @brief Get a scalar as a string, decoding escapes and joining lines as needed.
+             * @return The string.
+             */
+            std::string as_string() const;
+
+            /**
+             * @brief Get a scalar as an integer (decimal, 0x, 0o or 0b, with optional '_' separators).
+             * @return The integer.
+             * @throws std::invalid_argument if the value is not an integer.
+             */
+            int64_t as_int() const {
+                int64_t result;
+                if (is_scalar() && parse_int(style == Style::RAW ? text : std::string_view(as_string()), &result)) return result;
+                throw std::invalid_argument("config: '" + std::string(text) + "' is not an integer");
+            }
+
+            /**
+             * @brief Get a scalar as a floating-point number; integers convert.
+             * @return The number.
+             * @throws std::invalid_argument if the value is not a number.
+             */
+            double as_double() const {
+                double result;
+                if (is_scalar() && parse_double(style == Style::RAW ? text : std::string_view(as_string()), &result)) return result;
+                throw std::invalid_argument("config: '" + std::string(text) + "' is not a number");
+            }
+
+            /**
+             * @brief Get a scalar as a boolean: true/yes/on/1 or false/no/off/0, ignoring case.
+             * @return The boolean.
+             * @throws std::invalid_argument if the value is not a boolean.
+             */
+            bool as_bool() const {
+                bool result;
+                if (is_scalar() && parse_bool(text, &result)) return result;
+                throw std::invalid_argument("config: '" + std::string(text) + "' is not a boolean");
+            }
+
+            template<typename T>
+            T as() const {
+                if constexpr (std::is_same_v<T, bool>) return as_bool();
+                else if constexpr (std::is_integral_v<T>) return (T) as_int();
+                else if constexpr (std::is_floating_point_v<T>) return (T) as_double();
+                else return T(as_string());
+            }
+
+            /**
+             * @brief Get the value of a key converted to T, or a fallback if the key is absent.
+             * @param key The key.
+             * @param fallback The fallback.
+             * @return The value.
+             */
+            template<typename T>
+            T value_or(std::string_view key, T fallback) const {
+                const Value* value = get(key);
+                return value && !value->is_null() ? value->as<T>() : fallback;
+            }
+
+            std::string value_or(std::string_view key, const char* fallback) const {
+                return value_or<std::string>(key, std::string(fallback));
+            }
+
+            /**
+             * @brief Append a key to a table. The caller checks for duplicates with get().
+             */
+            void add(std::string_view key, Value* value) {
+                table_items.emplace_back(key, value);
+                if (index) {
+                    index->emplace(key, table_items.size() - 1);
+                } else if (table_items.size() > INDEX_THRESHOLD) {
+                    index = std::make_unique<std::unordered_map<std::string_view, size_t>>();
+                    for (size_t i = 0; i < table_items.size(); ++i) index->emplace(table_items[i].first, i);
+                }
+            }
+
+            /**
+             * @brief Set a key of a table, replacing the value in place if the key exists.
+             */
+            void set(std::string_view key, Value* value) {
+                if (index) {
+                    auto found = index->find(key);
+                    if (found != index->end()) {
+                        table_items[found->second].second = value;
+                        return;
+                    }
+                } else {
+                    for (Item& item : table_items) {
+                        if (item.first == key) {
+                            item.second = value;
+                            return;
+                        }
+                    }
+                }
+                add(key, value);
+            }
+
+            void append(Value* value) { array_items.push_back(value); }
+
+            // Parser access to scalar details.
+            void set_text(std::string_view source, Style how = Style::RAW) {
+                text = source;
+                style = how;
+            }
+            void set_plain(bool untyped) { plain = untyped; }
+            void set_block(uint16_t block_indent, uint8_t block_chomp) {
+                indent = block_indent;
+                chomp = block_chomp;
+            }
+            uint8_t& parser_flags() { return flags; }
+        };
+
+        namespace detail {
+            inline void append_utf8(std::string& out, uint32_t code) {
+                if (code < 0x80) {
+                    out += (char) code;
+                } else if (code < 0x800) {
+                    out += (char) (0xC0 | (code >> 6));
+                    out += (char) (0x80 | (code & 0x3F));
+                } else if (code < 0x10000) {
+                    out += (char) (0xE0 | (code >> 12));
+                    out += (char) (0x80 | ((code >> 6) & 0x3F));
+                    out += (char) (0x80 | (code & 0x3F));
+                } else {
+                    out += (char) (0xF0 | (code >> 18));
+                    out += (char) (0x80 | ((code >> 12) & 0x3F));
+                    out += (char) (0x80 | ((code >> 6) & 0x3F));
+                    out += (char) (0x80 | (code & 0x3F));
+                }
+            }
+
+            // Whether code can be encoded in UTF-8: not a surrogate and not above U+10FFFF.
+            inline bool is_scalar_value(uint32_t code) { return code < 0xD800 || (code > 0xDFFF && code <= 0x10FFFF); }
+
+            inline bool is_blank(char c) { return c == ' ' || c == '\t'; }
+
+            // Fold a line break inside a flow scalar: the break and surrounding blanks become one
+            // space, or n - 1 newlines when n line breaks are adjacent. Returns the new position.
+            inline size_t fold_break(std::string_view s, size_t i, std::string& out) {
+                while (!out.empty() && is_blank(out.back())) out.pop_back();
+                size_t breaks = 0;
+                while (i < s.size() && (s[i] == '\n' || s[i] == '\r' || is_blank(s[i]))) {
+                    if (s[i] == '\n') ++breaks;
+                    ++i;
+                }
+                if (breaks <= 1) out += ' ';
+                else out.append(breaks - 1, '\n');
+                return i;
+            }
+
+            inline std::string decode_escapes(std::string_view s, bool fold) {
+                std::string out;
+                out.reserve(s.size());
+                for (size_t i = 0; i < s.size();) {
+                    char c = s[i];
+                    if (fold && (c == '\n' || c == '\r')) {
+                        i = fold_break(s, i, out);
+                        continue;
+                    }
+                    if (c != '\\' || i + 1 >= s.size()) {
+                        out += c;
+                        ++i;
+                        continue;
+                    }
+                    char e = s[i + 1];
+                    i += 2;
+                    switch (e) {
+                        case 'b': out += '\b'; break;
+                        case 't': case '\t': out += '\t'; break;
+                        case 'n': out += '\n'; break;
+                        case 'f': out += '\f'; break;
+                        case 'r': out += '\r'; break;
+                        case 'e': out += '\x1b'; break;
+                        case '0': out += '\0'; break;
+                        case 'a': out += '\a'; break;
+                        case 'v': out += '\v'; break;
+                        case '"': out += '"'; break;
+                        case '\'': out += '\''; break;
+                        case '/': out += '/'; break;
+                        case '\\': out += '\\'; break;
+                        case ' ': out += ' '; break;
+                        case 'N': append_utf8(out, 0x85); break;
+                        case '_': append_utf8(out, 0xA0); break;
+                        case 'L': append_utf8(out, 0x2028); break;
+                        case 'P': append_utf8(out, 0x2029); break;
+                        case 'x': case 'u': case 'U': {
+                            size_t width = e == 'x' ? 2 : e == 'u' ? 4 : 8;
+                            uint32_t code = 0;
+                            if (i + width > s.size() || std::from_chars(s.data() + i, s.data() + i + width, code, 16).ptr != s.data() + i + width) {
+                                throw std::invalid_argument("config: invalid \\" + std::string(1, e) + " escape");
+                            }
+                            if (!is_scalar_value(code)) throw std::invalid_argument("config: \\" + std::string(1, e) + " escape is not a Unicode scalar value");
+                            append_utf8(out, code);
+                            i += width;
+                            break;
+                        }
+                        case '\n': case '\r': {
+                            // Line-ending backslash: drop the break and the leading blanks of the next lines.
+                            while (i < s.size() && (s[i] == '\n' || s[i] == '\r' || is_blank(s[i]))) ++i;
+                            break;
+                        }
+                        default: {
+                            // "\   \n" in TOML multi-line strings is also a line-ending backslash.
+                            size_t j = i - 1;
+                            while (j < s.size() && is_blank(s[j])) ++j;
+                            if (is_blank(e) && j < s.size() && (s[j] == '\n' || s[j] == '\r')) {
+                                i = j;
+                                while (i < s.size() && (s[i] == '\n' || s[i] == '\r' || is_blank(s[i]))) ++i;
+                                break;
+                            }
+                            throw std::invalid_argument("config: invalid escape \\" + std::string(1, e));
+                        }
+                    }
+                }
+                return out;
+            }
+
+            inline std::string_view strip(std::string_view s) {
+                while (!s.empty() && (is_blank(s.front()) || s.front() == '\r' || s.front() == '\n')) s.remove_prefix(1);
+                while (!s.empty() && (is_blank(s.back()) || s.back() == '\r' || s.back() == '\n')) s.remove_suffix(1);
+                return s;
+            }
+
+            inline std::string decode_block(std::string_view s, size_t indent, bool folded, uint8_t chomp) {
+                std::vector<std::string_view> lines;
+                for (size_t start = 0; start < s.size();) {
+                    size_t end = s.find('\n', start);
+                    if (end == std::string_view::npos) end = s.size();
+                    std::string_view line = s.substr(start, end - start);
+                    if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+                    lines.push_back(line.size() > indent ? line.substr(indent) : std::string_view());
+                    start = end + 1;
+                }
+                size_t trailing = 0;
+                while (!lines.empty() && lines.back().empty()) {
+                    lines.pop_back();
+                    ++trailing;
+                }
+                // Between two lines that are neither empty nor more indented, a '>' block folds the
+                // line break to a space; otherwise every break is kept.
+                std::string out;
+                size_t empties = 0;
+                bool started = false, previous_normal = false;
+                for (std::string_view line : lines) {
+                    if (line.empty()) {
+                        ++empties;
+                        continue;
+                    }
+                    bool normal = !is_blank(line[0]);
+                    if (!started) out.append(empties, '\n');
+                    else if (folded && previous_normal && normal) empties ? (void) out.append(empties, '\n') : (void) (out += ' ');
+                    else out.append(empties + 1, '\n');
+                    out.append(line);
+                    started = true;
+                    previous_normal = normal;
+                    empties = 0;
+                }
+                if (!started) return chomp == 2 ? std::string(trailing, '\n') : std::string();
+                if (chomp == 0) out += '\n';
+                else if (chomp == 2) out.append(trailing + 1, '\n');
+                return out;
+            }
+        }
+
+        inline std::string Value::as_string() const {
+            switch (style) {
+                case Style::RAW: return std::string(text);
+                case Style::ESCAPED: return detail::decode_escapes(text, false);
+                case Style::DOUBLE_QUOTED: return detail::decode_escapes(text, true);
+                case Style::SINGLE_QUOTED: {
+                    std::string out;
+                    for (size_t i = 0; i < text.size();) {
+                        if (text[i] == '\'' && i + 1 < text.size() && text[i + 1] == '\'') {
+                            out += '\'';
+                            i += 2;
+                        } else if (text[i] == '\n' || text[i] == '\r') {
+                            i = detail::fold_break(text, i, out);
+                        } else {
+                            out += text[i++];
+                        }
+                    }
+                    return out;
+                }
+                case Style::JOINED: {
+                    std::string out;
+                    for (size_t start = 0; start <= text.size();) {
+                        size_t end = text.find('\n', start);
+                        if (end == std::string_view::npos) end = text.size();
+                        if (start) out += '\n';
+                        out.append(detail::strip(text.substr(start, end - start)));
+                        start = end + 1;
+                    }
+                    while (!out.empty() && (out.back() == '\n' || detail::is_blank(out.back()))) out.pop_back();
+                    return out;
+                }
+                case Style::FOLDED: {
+                    std::string out;
+                    for (size_t i = 0; i < text.size();) {
+                        if (text[i] == '\n' || text[i] == '\r') i = detail::fold_break(text, i, out);
+                        else out += text[i++];
+                    }
+                    return out;
+                }
+                case Style::LITERAL_BLOCK: return detail::decode_block(text, indent, false, chomp);
+                case Style::FOLDED_BLOCK: return detail::decode_block(text, indent, true, chomp);
+            }
+            return std::string(text);
+        }
+
+        /**
+         * @class Document
+         * @brief Owns the source buffers of a parsed configuration and all of its values.
+         * Values and views stay valid while the Document lives, including after it is moved.
+         */
+        class Document {
+        private:
+            std::vector<std::unique_ptr<std::string>> buffers;
+            std::vector<std::unique_ptr<MappedFile>> mappings;
+            std::deque<Value> arena;
+            std::deque<std::string> decoded;
+            Value* top;
+
+        public:
+            Document() : top(make(Type::TABLE)) {}
+
+            Document(const Document&) = delete;
+            Document& operator=(const Document&) = delete;
+            Document(Document&&) = default;
+            Document& operator=(Document&&) = default;
+
+            /**
+             * @brief Take ownership of a source text.
+             * @param text The text.
+             * @return A view of the stored text, stable for the life of the Document.
+             */
+            std::string_view add_source(std::string text) {
+                buffers.push_back(std::make_unique<std::string>(std::move(text)));
+                return *buffers.back();
+            }
+
+            /**
+             * @brief Memory-map a source file.
+             * @param filename The file.
+             * @return A view of the file contents.
+             * @throws FileNotExistError if the file does not exist.
+             */
+            std::string_view add_file(const char* filename) {
+                mappings.push_back(std::make_unique<MappedFile>(filename));
+                const MappedFile& file = *mappings.back();
+                file.will_need(0, file.size, true);
+                return std::string_view(file.data ? file.data : "", file.size);
+            }
+
+            /**
+             * @brief Store a string that is not in the source (a decoded or normalized key).
+             * @return A stable view of it.
+             */
+            std::string_view keep(std::string text) {
+                decoded.push_back(std::move(text));
+                return decoded.back();
+            }
+
+            Value* make(Type kind) { return &arena.emplace_back(kind); }
+
+            Value* make_scalar(Type kind, std::string_view text, Style style = Style::RAW, bool plain = false) {
+                Value* value = make(kind);
+                value->set_text(text, style);
+                value->set_plain(plain);
+                return value;
+            }
+
+            const Value& root() const { return *top; }
+            Value& root() { return *top; }
+            void set_root(Value* value) { top = value; }
+
+            const Value& operator[](std::string_view key) const { return (*top)[key]; }
+            const Value& operator[](const char* key) const { return (*top)[std::string_view(key)]; }
+            bool contains(std::string_view key) const { return top->contains(key); }
+            const Value* get(std::string_view key) const { return top->get(key); }
+        };
+    }
+}
@@ -0,0 +1,378 @@
+// EasyCpp - ConfigParser : INI Configuration Files
+// Copyright (C) 2025  C14147
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+/**
+ * @file EasyCpp/Config/ConfigParser.h
+ * @brief This file implements an INI reader with the semantics of Python's
+ *        configparser.ConfigParser: a DEFAULT section, '=' and ':' delimiters, '#' and ';'
+ *        comment lines, indented continuation lines, case-insensitive option names and
+ *        %(name)s interpolation. Sections and values are views into the loaded text.
+ */
+#pragma once
+
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include <Config/Config.h>
+
+namespace easycpp {
+    namespace configparser {
+        using config::Document;
+        using config::Style;
+        using config::Type;
+        using config::Value;
+
+        /**
+         * @class ConfigParser
+         * @brief Reads INI files. Several files may be read into one parser; later values
+         * override earlier ones.
+         */
+        class ConfigParser {
+        private:
+            static constexpr int MAX_INTERPOLATION_DEPTH = 10;
+
+            Document doc;
+            Value* defaults;
+            std::string default_section;
+
+            static std::string_view strip(std::string_view s) { return config::detail::strip(s); }
+
+            static bool has_upper(std::string_view s) {
+                for (char c : s) {
+                    if (c >= 'A' && c <= 'Z') return true;
+                }
+                return false;
+            }
+
+            static std::string lower(std::string_view s) {
+                std::string out(s);
+                for (char& c : out) {
+                    if (c >= 'A' && c <= 'Z') c = (char) (c - 'A' + 'a');
+                }
+                return out;
+            }
+
+            // Option names are case-insensitive: only names with capitals need a stored copy.
+            std::string_view option_name(std::string_view name) { return has_upper(name) ? doc.keep(lower(name)) : name; }
+
+            [[noreturn]] static void fail(const std::string& source, size_t line, const std::string& message) {
+                throw std::invalid_argument("configparser: " + source + ", line " + std::to_string(line) + ": " + message);
+            }
+
+            void parse(std::string_view s, const std::string& source) {
+                Value* section = nullptr;
+                std::string_view section_name;
+                Value* option = nullptr;            // The value being continued
+                size_t option_indent = SIZE_MAX;
+                size_t blanks = 0;                  // Blank lines since the last line of the value
+                bool commented = false;             // Comment lines since the last line of the value
+                bool copied = false;                // Comment lines inside the value: the lines are joined into a copy
+                std::string joined;
+                std::vector<std::string_view> seen_sections;
+                std::unordered_set<std::string> seen_options;
+
+                auto finish_option = [&] {
+                    if (option && copied) option->set_text(doc.keep(std::move(joined)), Style::JOINED);
+                    option = nullptr;
+                    blanks = 0;
+                    commented = copied = false;
+                };
+
+                size_t line_number = 0;
+                size_t start = s.size() >= 3 && s.substr(0, 3) == "\xEF\xBB\xBF" ? 3 : 0;
+                while (start < s.size()) {
+                    ++line_number;
+                    size_t end = s.find('\n', start);
+                    if (end == std::string_view::npos) end = s.size();
+                    std::string_view line = s.substr(start, end - start);
+                    start = end + 1;
+
+                    std::string_view content = strip(line);
+                    if (content.empty()) {
+                        blanks += option != nullptr;
+                        continue;
+                    }
+                    if (content[0] == '#' || content[0] == ';') {
+                        commented = option != nullptr;
+                        continue;
+                    }
+
+                    size_t indent = 0;
+                    while (indent < line.size() && config::detail::is_blank(line[indent])) ++indent;
+                    if (option && indent > option_indent) {
+                        // Blank lines stay in a continued value; comment lines are dropped from it.
+                        if (commented && !copied) {
+                            joined = std::string(option->raw());
+                            copied = true;
+                        }
+                        if (copied) {
+                            joined.append(blanks + 1, '\n');
+                            joined.append(content);
+                        } else {
+                            const char* begin = option->raw().data();
+                            option->set_text(std::string_view(begin, (size_t) (line.data() + line.size() - begin)), Style::JOINED);
+                        }
+                        blanks = 0;
+                        commented = false;
+                        continue;
+                    }
+                    finish_option();
+                    option_indent = indent;
+
+                    if (content[0] == '[') {
+                        size_t close = content.rfind(']');
+                        if (close == std::string_view::npos || close < 2) fail(source, line_number, "invalid section header");
+                        section_name = content.substr(1, close - 1);
+                        if (section_name == default_section) {
+                            section = defaults;
+                            continue;
+                        }
+                        for (std::string_view seen : seen_sections) {
+                            if (seen == section_name) fail(source, line_number, "section '" + std::string(section_name) + "' already exists");
+                        }
+                        seen_sections.push_back(section_name);
+                        section = doc.root().get(section_name);
+                        if (!section) {
+                            section = doc.make(Type::TABLE);
+                            doc.root().add(section_name, section);
+                        }
+                        continue;
+                    }
+                    if (!section) fail(source, line_number, "file contains no section headers");
+
+                    size_t delimiter = content.find_first_of("=:");
+                    if (delimiter == std::string_view::npos) fail(source, line_number, "no '=' or ':' in '" + std::string(content) + "'");
+                    std::string_view name = strip(content.substr(0, delimiter));
+                    if (name.empty()) fail(source, line_number, "empty option name");
+                    name = option_name(name);
+                    if (!seen_options.insert(std::string(section_name) + '\0' + std::string(name)).second) {
+                        fail(source, line_number, "option '" + std::string(name) + "' in section '" + std::string(section_name) +
+                                                  "' already exists");
+                    }
+                    std::string_view text = strip(content.substr(delimiter + 1));
+                    if (text.empty()) text = std::string_view(content.data() + content.size(), 0);
+                    option = doc.make_scalar(Type::STRING, text, Style::RAW, true);
+                    section->set(name, option);
+                }
+                finish_option();
+            }
+
+            const Value* lookup(std::string_view section, std::string_view option) const {
+                std::string name;
+                if (has_upper(option)) {
+                    name = lower(option);
+                    option = name;
+                }
+                if (section != default_section) {
+                    const Value* table = doc.root().get(section);
+                    if (!table) throw std::out_of_range("configparser: no section '" + std::string(section) + "'");
+                    if (const Value* value = table->get(option)) return value;
+                }
+                return defaults->get(option);
+            }
+
+            std::string interpolate(std::string_view section, std::string_view option, std::string value, int depth) const {
+                if (value.find('%') == std::string::npos) return value;
+                if (depth > MAX_INTERPOLATION_DEPTH) {
+                    throw std::invalid_argument("configparser: interpolation of '" + std::string(option) + "' in section '" +
+                                                std::string(section) + "' is too deep");
+                }
+                std::string out;
+                for (size_t i = 0; i < value.size();) {
+                    size_t percent = value.find('%', i);
+                    if (percent == std::string::npos) {
+                        out.append(value, i, std::string::npos);
+                        break;
+                    }
+                    out.append(value, i, percent - i);
+                    if (percent + 1 < value.size() && value[percent + 1] == '%') {
+                        out += '%';
+                        i = percent + 2;
+                        continue;
+                    }
+                    size_t close = value.find(")s", percent);
+                    if (percent + 1 >= value.size() || value[percent + 1] != '(' || close == std::string::npos) {
+                        throw std::invalid_argument("configparser: bad interpolation in '" + std::string(option) + "': '" +
+                                                    value.substr(percent) + "'");
+                    }
+                    std::string name = value.substr(percent + 2, close - percent - 2);
+                    const Value* reference = lookup(section, name);
+                    if (!reference) {
+                        throw std::out_of_range("configparser: '" + std::string(option) + "' in section '" + std::string(section) +
+                                                "' refers to missing option '" + name + "'");
+                    }
+                    out += interpolate(section, name, reference->as_string(), depth + 1);
+                    i = close + 2;
+                }
+                return out;
+            }
+
+            template<typename T, typename Convert>
+            T get_as(std::string_view section, std::string_view option, const char* what, Convert convert) const {
+                std::string text = get(section, option);
+                T result;
+                if (!convert(strip(text), &result)) {
+                    throw std::invalid_argument("configparser: '" + text + "' is not " + what);
+                }
+                return result;
+            }
+
+        public:
+            /**
+             * @brief Construct an empty parser.
+             * @param default_section The name of the section whose options every section inherits.
+             */
+            explicit ConfigParser(std::string default_section = "DEFAULT") :
+                defaults(doc.make(Type::TABLE)), default_section(std::move(default_section)) {}
+
+            /**
+             * @brief Read an INI file. The file is memory-mapped and stays mapped while the
+             * parser lives.
+             * @param filename The file.
+             * @return False if the file does not exist, like Python's read() skipping it.
+             * @throws std::invalid_argument if the file is malformed.
+             */
+            bool read(const char* filename) {
+                if (!is_exist(filename)) return false;
+                parse(doc.add_file(filename), filename);
+                return true;
+            }
+
+            /**
+             * @brief Read INI text.
+             * @param text The text.
+             * @param source The name used in error messages.
+             * @throws std::invalid_argument if the text is malformed.
+             */
+            void read_string(std::string text, const std::string& source = "<string>") { parse(doc.add_source(std::move(text)), source); }
+
+            /**
+             * @brief Get the section names in file order, excluding the default section.
+             */
+            std::vector<std::string_view> sections() const {
+                std::vector<std::string_view> names;
+                for (const Value::Item& item : doc.root().items()) names.push_back(item.first);
+                return names;
+            }
+
+            bool has_section(std::string_view section) const { return doc.root().contains(section); }
+
+            bool has_option(std::string_view section, std::string_view option) const {
+                if (section != default_section && !has_section(section)) return false;
+                return lookup(section, option) != nullptr;
+            }
+
+            /**
+             * @brief Get the option names of a section, including inherited defaults.
+             * @throws std::out_of_range if the section does not exist.
+             */
+            std::vector<std::string_view> options(std::string_view section) const {
+                const Value* table = doc.root().get(section);
+                if (!table) throw std::out_of_range("configparser: no section '" + std::string(section) + "'");
+                std::vector<std::string_view> names;
+                for (const Value::Item& item : table->items()) names.push_back(item.first);
+                for (const Value::Item& item : defaults->items()) {
+                    if (!table->contains(item.first)) names.push_back(item.first);
+                }
+                return names;
+            }
+
+            /**
+             * @brief Get the interpolated (name, value) pairs of a section, including defaults.
+             */
+            std::vector<std::pair<std::string_view, std::string>> items(std::string_view section) const {
+                const Value* table = doc.root().get(section);
+                if (!table) throw std::out_of_range("configparser: no section '" + std::string(section) + "'");
+                std::vector<std::pair<std::string_view, std::string>> result;
+                for (const Value::Item& item : defaults->items()) result.emplace_back(item.first, get(section, item.first));
+                for (const Value::Item& item : table->items()) {
+                    if (!defaults->contains(item.first)) result.emplace_back(item.first, get(section, item.first));
+                }
+                return result;
+            }
+
+            /**
+             * @brief Get the options of a section as a config::Value table, without defaults or
+             * interpolation.
+             * @throws std::out_of_range if the section does not exist.
+             */
+            const Value& section(std::string_view name) const { return name == default_section ? *defaults : doc.root()[name]; }
+
+            const Value& defaults_section() const { return *defaults; }
+
+            /**
+             * @brief Get an option value.
+             * @param section The section.
+             * @param option The option; case-insensitive.
+             * @param raw Skip %(name)s interpolation.
+             * @return The value.
+             * @throws std::out_of_range if the section or option does not exist.
+             */
+            std::string get(std::string_view section, std::string_view option, bool raw = false) const {
+                const Value* value = lookup(section, option);
+                if (!value) {
+                    throw std::out_of_range("configparser: no option '" + std::string(option) + "' in section '" + std::string(section) + "'");
+                }
+                return raw ? value->as_string() : interpolate(section, option, value->as_string(), 1);
+            }
+
+            /**
+             * @brief Get an option value, or a fallback if the section or option does not exist.
+             */
+            std::string get(std::string_view section, std::string_view option, const std::string& fallback) const {
+                return has_option(section, option) ? get(section, option) : fallback;
+            }
+
+            std::string get(std::string_view section, std::string_view option, const char* fallback) const {
+                return get(section, option, std::string(fallback));
+            }
+
+            int64_t getint(std::string_view section, std::string_view option) const {
+                return get_as<int64_t>(section, option, "an integer", Value::parse_int);
+            }
+
+            int64_t getint(std::string_view section, std::string_view option, int64_t fallback) const {
+                return has_option(section, option) ? getint(section, option) : fallback;
+            }
+
+            double getfloat(std::string_view section, std::string_view option) const {
+                return get_as<double>(section, option, "a number", Value::parse_double);
+            }
+
+            double getfloat(std::string_view section, std::string_view option, double fallback) const {
+                return has_option(section, option) ? getfloat(section, option) : fallback;
+            }
+
+            /**
+             * @brief Get an option as a boolean: 1/yes/true/on or 0/no/false/off, ignoring case.
+             * @throws std::invalid_argument if the value is not a boolean.
+             */
+            bool getboolean(std::string_view section, std::string_view option) const {
+                return get_as<bool>(section, option, "a boolean", Value::parse_bool);
+            }
+
+            bool getboolean(std::string_view section, std::string_view option, bool fallback) const {
+                return has_option(section, option) ? getboolean(section, option) : fallback;
+            }
+        };
+    }
+}
@@ -0,0 +1,528 @@
+// EasyCpp - Toml : TOML Loader
+// Copyright (C) 2025  C14147
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+/**
+ * @file EasyCpp/Config/Toml.h
+ * @brief This file implements a TOML 1.0 loader, like Python's tomllib. The document is parsed
+ *        in place into a config::Document; strings keep their escapes until as_string() is
+ *        called. Inline tables may span lines and end with a comma, as in TOML 1.1.
+ */
+#pragma once
+
+#include <charconv>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <stdexcept>
+
+#include <Config/Config.h>
+
+namespace easycpp {
+    namespace toml {
+        using config::Document;
+        using config::Style;
+        using config::Type;
+        using config::Value;
+
+        namespace detail {
+            class Parser {
+            private:
+                enum : uint8_t { DEFINED = 1, DOTTED = 2, FROZEN = 4, TABLE_ARRAY = 8 };
+
+                Document& doc;
+                std::string_view s;
+                size_t i = 0;
+
+                [[noreturn]] void fail(const std::string& message) const {
+                    size_t line = 1;
+                    for (size_t k = 0; k < i && k < s.size(); ++k) line += s[k] == '\n';
+                    throw std::invalid_argument("toml: line " + std::to_string(line) + ": " + message);
+                }
+
+                bool at_end() const { return i >= s.size(); }
+                char peek(size_t ahead = 0) const { return i + ahead < s.size() ? s[i + ahead] : '\0'; }
+
+                void skip_blanks() {
+                    while (i < s.size() && (s[i] == ' ' || s[i] == '\t')) ++i;
+                }
+
+                void skip_comment() {
+                    if (peek() == '#') {
+                        while (i < s.size() && s[i] != '\n') ++i;
+                    }
+                }
+
+                // Skip whitespace, newlines and comments.
+                void skip_space() {
+                    for (;;) {
+                        skip_blanks();
+                        skip_comment();
+                        if (peek() == '\n') ++i;
+                        else if (peek() == '\r' && peek(1) == '\n') i += 2;
+                        else return;
+                    }
+                }
+
+                void expect_line_end() {
+                    skip_blanks();
+                    skip_comment();
+                    if (at_end()) return;
+                    if (peek() == '\n') ++i;
+                    else if (peek() == '\r' && peek(1) == '\n') i += 2;
+                    else fail(std::string("unexpected '") + peek() + "' after value");
+                }
+
+                static bool is_bare(char c) {
+                    return (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z') || (c >= '0' && c <= '9') || c == '_' || c == '-';
+                }
+
+                // Find the end of a basic string starting after its opening quote; returns the content.
+                std::string_view scan_basic(bool multiline, bool* escaped) {
+                    size_t start = i;
+                    *escaped = false;
+                    while (i < s.size()) {
+                        char c = s[i];
+                        if (c == '\\') {
+                            *escaped = true;
+                            // Check Unicode escapes here, since the text is only decoded on access.
+                            char e = peek(1);
+                            if (e == 'u' || e == 'U') {
+                                size_t width = e == 'u' ? 4 : 8;
+                                uint32_t code = 0;
+                                const char* digits = s.data() + i + 2;
+                                if (i + 2 + width > s.size() || std::from_chars(digits, digits + width, code, 16).ptr != digits + width ||
+                                    !config::detail::is_scalar_value(code)) {
+                                    fail("invalid \\" + std::string(1, e) + " escape");
+                                }
+                            }
+                            i += 2;
+                            continue;
+                        }
+                        if (c == '"') {
+                            if (!multiline) return s.substr(start, i++ - start);
+                            if (peek(1) == '"' && peek(2) == '"') {
+                                // Up to two quotes may precede the closing delimiter.
+                                size_t end = i;
+                                while (peek(3) == '"' && i - end < 2) ++i;
+                                std::string_view content = s.substr(start, i - start);
+                                i += 3;
+                                return content;
+                            }
+                        }
+                        if (c == '\n' && !multiline) fail("newline in string");
+                        ++i;
+                    }
+                    fail("unterminated string");
+                }
+
+                std::string_view scan_literal(bool multiline) {
+                    size_t start = i;
+                    while (i < s.size()) {
+                        char c = s[i];
+                        if (c == '\'') {
+                            if (!multiline) return s.substr(start, i++ - start);
+                            if (peek(1) == '\'' && peek(2) == '\'') {
+                                size_t end = i;
+                                while (peek(3) == '\'' && i - end < 2) ++i;
+                                std::string_view content = s.substr(start, i - start);
+                                i += 3;
+                                return content;
+                            }
+                        }
+                        if (c == '\n' && !multiline) fail("newline in string");
+                        ++i;
+                    }
+                    fail("unterminated string");
+                }
+
+                void skip_first_newline() {
+                    if (peek() == '\n') ++i;
+                    else if (peek() == '\r' && peek(1) == '\n') i += 2;
+                }
+
+                std::string_view parse_simple_key() {
+                    char c = peek();
+                    if (c == '"') {
+                        ++i;
+                        bool escaped;
+                        std::string_view key = scan_basic(false, &escaped);
+                        return escaped ? doc.keep(config::detail::decode_escapes(key, false)) : key;
+                    }
+                    if (c == '\'') {
+                        ++i;
+                        return scan_literal(false);
+                    }
+                    size_t start = i;
+                    while (i < s.size() && is_bare(s[i])) ++i;
+                    if (i == start) fail("expected a key");
+                    return s.substr(start, i - start);
+                }
+
+                // Parse a possibly dotted key; the parts are stored in `parts`.
+                void parse_key(std::vector<std::string_view>& parts) {
+                    parts.clear();
+                    for (;;) {
+                        skip_blanks();
+                        parts.push_back(parse_simple_key());
+                        skip_blanks();
+                        if (peek() != '.') return;
+                        ++i;
+                    }
+                }
+
+                Value* parse_value() {
+                    char c = peek();
+                    if (c == '"') {
+                        bool escaped;
+                        if (peek(1) == '"' && peek(2) == '"') {
+                            i += 3;
+                            skip_first_newline();
+                            std::string_view text = scan_basic(true, &escaped);
+                            return doc.make_scalar(Type::STRING, text, escaped ? Style::ESCAPED : Style::RAW);
+                        }
+                        ++i;
+                        std::string_view text = scan_basic(false, &escaped);
+                        return doc.make_scalar(Type::STRING, text, escaped ? Style::ESCAPED : Style::RAW);
+                    }
+                    if (c == '\'') {
+                        if (peek(1) == '\'' && peek(2) == '\'') {
+                            i += 3;
+                            skip_first_newline();
+                            return doc.make_scalar(Type::STRING, scan_literal(true));
+                        }
+                        ++i;
+                        return doc.make_scalar(Type::STRING, scan_literal(false));
+                    }
+                    if (c == '[') return parse_array();
+                    if (c == '{') return parse_inline_table();
+                    return parse_atom();
+                }
+
+                Value* parse_atom() {
+                    size_t start = i;
+                    auto is_atom = [](char c) {
+                        return (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z') || (c >= '0' && c <= '9') || c == '_' || c == '-' ||
+                               c == '+' || c == '.' || c == ':';
+                    };
+                    while (i < s.size() && is_atom(s[i])) ++i;
+                    // A date and a time may be separated by a space.
+                    if (i - start == 10 && s[start + 4] == '-' && peek() == ' ' && peek(1) >= '0' && peek(1) <= '9') {
+                        ++i;
+                        while (i < s.size() && is_atom(s[i])) ++i;
+                    }
+                    std::string_view token = s.substr(start, i - start);
+                    if (token.empty()) fail(at_end() ? "expected a value" : std::string("unexpected '") + peek() + "'");
+                    if (token == "true" || token == "false") return doc.make_scalar(Type::BOOLEAN, token);
+                    if (token.find(':') != std::string_view::npos ||
+                        (token.size() >= 10 && token[4] == '-' && token[7] == '-' && token[0] >= '0' && token[0] <= '9')) {
+                        if (!is_datetime(token)) fail("invalid date or time '" + std::string(token) + "'");
+                        return doc.make_scalar(Type::DATETIME, token);
+                    }
+                    return parse_number(token);
+                }
+
+                static bool is_digit(char c, int base) {
+                    if (base == 16) return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F');
+                    return c >= '0' && c < (char) ('0' + base);
+                }
+
+                // Whether s is one or more digits with every '_' between two digits.
+                static bool is_digit_run(std::string_view s, int base) {
+                    if (s.empty()) return false;
+                    for (size_t k = 0; k < s.size(); ++k) {
+                        if (s[k] == '_') {
+                            if (k == 0 || k + 1 == s.size() || s[k + 1] == '_') return false;
+                        } else if (!is_digit(s[k], base)) {
+                            return false;
+                        }
+                    }
+                    return true;
+                }
+
+                // The type comes from the token's syntax, so an integer that does not fit in 64 bits
+                // is an error rather than a float.
+                Value* parse_number(std::string_view token) {
+                    auto invalid = [&]() { fail("invalid value '" + std::string(token) + "'"); };
+                    bool sign = token[0] == '+' || token[0] == '-';
+                    std::string_view body = sign ? token.substr(1) : token;
+                    if (body == "inf" || body == "nan") return doc.make_scalar(Type::FLOAT, token);
+                    int64_t integer;
+                    if (body.size() > 2 && body[0] == '0' && (body[1] == 'x' || body[1] == 'o' || body[1] == 'b')) {
+                        if (sign) fail("sign on a prefixed integer '" + std::string(token) + "'");
+                        if (!is_digit_run(body.substr(2), body[1] == 'x' ? 16 : body[1] == 'o' ? 8 : 2)) invalid();
+                        if (!Value::parse_int(token, &integer)) fail("integer '" + std::string(token) + "' out of range");
+                        return doc.make_scalar(Type::INTEGER, token);
+                    }
+                    size_t point = body.find_first_of(".eE");
+                    std::string_view whole = body.substr(0, point);
+                    if (!is_digit_run(whole, 10)) invalid();
+                    if (whole.size() > 1 && whole[0] == '0') fail("leading zero in '" + std::string(token) + "'");
+                    if (point == std::string_view::npos) {
+                        if (!Value::parse_int(token, &integer)) fail("integer '" + std::string(token) + "' out of range");
+                        return doc.make_scalar(Type::INTEGER, token);
+                    }
+                    std::string_view rest = body.substr(point);
+                    if (rest[0] == '.') {
+                        size_t exponent = rest.find_first_of("eE");
+                        if (!is_digit_run(rest.substr(1, exponent == std::string_view::npos ? exponent : exponent - 1), 10)) invalid();
+                        rest = exponent == std::string_view::npos ? std::string_view() : rest.substr(exponent);
+                    }
+                    if (!rest.empty()) {
+                        rest.remove_prefix(1);
+                        if (!rest.empty() && (rest[0] == '+' || rest[0] == '-')) rest.remove_prefix(1);
+                        if (!is_digit_run(rest, 10)) invalid();
+                    }
+                    double real;
+                    if (!Value::parse_double(token, &real)) fail("float '" + std::string(token) + "' out of range");
+                    return doc.make_scalar(Type::FLOAT, token);
+                }
+
+                // Read count digits at s[k] as a number between low and high.
+                static bool field(std::string_view s, size_t& k, size_t count, int low, int high, int* value = nullptr) {
+                    if (k + count > s.size()) return false;
+                    int number = 0;
+                    for (size_t end = k + count; k < end; ++k) {
+                        if (s[k] < '0' || s[k] > '9') return false;
+                        number = number * 10 + (s[k] - '0');
+                    }
+                    if (value) *value = number;
+                    return number >= low && number <= high;
+                }
+
+                static bool separator(std::string_view s, size_t& k, char c) {
+                    if (k >= s.size() || s[k] != c) return false;
+                    ++k;
+                    return true;
+                }
+
+                // HH:MM:SS with an optional fraction, starting at s[k].
+                static bool is_time(std::string_view s, size_t& k) {
+                    if (!field(s, k, 2, 0, 23) || !separator(s, k, ':') || !field(s, k, 2, 0, 59) || !separator(s, k, ':') ||
+                        !field(s, k, 2, 0, 59)) {
+                        return false;
+                    }
+                    if (k < s.size() && s[k] == '.') {
+                        size_t start = ++k;
+                        while (k < s.size() && s[k] >= '0' && s[k] <= '9') ++k;
+                        if (k == start) return false;
+                    }
+                    return true;
+                }
+
+                // A local date, local time, local date-time or offset date-time, as in RFC 3339.
+                static bool is_datetime(std::string_view s) {
+                    size_t k = 0;
+                    if (s.size() > 2 && s[2] == ':') return is_time(s, k) && k == s.size();
+                    int year, month;
+                    if (!field(s, k, 4, 0, 9999, &year) || !separator(s, k, '-') || !field(s, k, 2, 1, 12, &month) || !separator(s, k, '-')) {
+                        return false;
+                    }
+                    static constexpr int DAYS[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+                    bool leap = year % 4 == 0 && (year % 100 != 0 || year % 400 == 0);
+                    if (!field(s, k, 2, 1, DAYS[month - 1] + (month == 2 && leap ? 1 : 0))) return false;
+                    if (k == s.size()) return true;
+                    if (s[k] != 'T' && s[k] != 't' && s[k] != ' ') return false;
+                    ++k;
+                    if (!is_time(s, k)) return false;
+                    if (k == s.size()) return true;
+                    if ((s[k] == 'Z' || s[k] == 'z') && k + 1 == s.size()) return true;
+                    if (s[k] != '+' && s[k] != '-') return false;
+                    ++k;
+                    return field(s, k, 2, 0, 23) && separator(s, k, ':') && field(s, k, 2, 0, 59) && k == s.size();
+                }
+
+                Value* parse_array() {
+                    ++i;
+                    Value* array = doc.make(Type::ARRAY);
+                    array->parser_flags() = FROZEN;
+                    for (;;) {
+                        skip_space();
+                        if (peek() == ']') {
+                            ++i;
+                            return array;
+                        }
+                        array->append(parse_value());
+                        skip_space();
+                        if (peek() == ',') {
+                            ++i;
+                        } else if (peek() == ']') {
+                            ++i;
+                            return array;
+                        } else {
+                            fail("expected ',' or ']' in array");
+                        }
+                    }
+                }
+
+                Value* parse_inline_table() {
+                    ++i;
+                    Value* table = doc.make(Type::TABLE);
+                    std::vector<std::string_view> parts;
+                    for (;;) {
+                        skip_space();
+                        if (peek() == '}') {
+                            ++i;
+                            break;
+                        }
+                        parse_key(parts);
+                        if (peek() != '=') fail("expected '=' after key");
+                        ++i;
+                        skip_blanks();
+                        assign(table, parts, parse_value());
+                        skip_space();
+                        if (peek() == ',') {
+                            ++i;
+                        } else if (peek() == '}') {
+                            ++i;
+                            break;
+                        } else {
+                            fail("expected ',' or '}' in inline table");
+                        }
+                    }
+                    freeze(table);
+                    return table;
+                }
+
+                static void freeze(Value* value) {
+                    value->parser_flags() |= FROZEN;
+                    for (const Value::Item& item : value->items()) {
+                        if (item.second->is_table()) freeze(item.second);
+                    }
+                }
+
+                static std::string dotted(const std::vector<std::string_view>& parts, size_t count) {
+                    std::string name;
+                    for (size_t k = 0; k < count; ++k) {
+                        if (k) name += '.';
+                        name.append(parts[k]);
+                    }
+                    return name;
+                }
+
+                // Assign a dotted key in a table, creating the intermediate tables.
+                void assign(Value* table, const std::vector<std::string_view>& parts, Value* value) {
+                    for (size_t k = 0; k + 1 < parts.size(); ++k) {
+                        Value* next = table->get(parts[k]);
+                        if (!next) {
+                            next = doc.make(Type::TABLE);
+                            next->parser_flags() = DOTTED;
+                            table->add(parts[k], next);
+                        } else if (!next->is_table() || (next->parser_flags() & (FROZEN | DEFINED)) || !(next->parser_flags() & DOTTED)) {
+                            fail("cannot extend '" + dotted(parts, k + 1) + "' with a dotted key");
+                        }
+                        table = next;
+                    }
+                    if (table->get(parts.back())) fail("duplicate key '" + dotted(parts, parts.size()) + "'");
+                    table->add(parts.back(), value);
+                }
+
+                Value* open_header(const std::vector<std::string_view>& parts, bool array_of_tables) {
+                    Value* table = &doc.root();
+                    for (size_t k = 0; k + 1 < parts.size(); ++k) {
+                        Value* next = table->get(parts[k]);
+                        if (!next) {
+                            next = doc.make(Type::TABLE);
+                            table->add(parts[k], next);
+                        } else if (next->is_array() && (next->parser_flags() & TABLE_ARRAY)) {
+                            next = next->elements().back();
+                        } else if (!next->is_table() || (next->parser_flags() & FROZEN)) {
+                            fail("'" + dotted(parts, k + 1) + "' is not a table");
+                        }
+                        table = next;
+                    }
+                    std::string_view last = parts.back();
+                    Value* existing = table->get(last);
+                    if (array_of_tables) {
+                        if (!existing) {
+                            existing = doc.make(Type::ARRAY);
+                            existing->parser_flags() = TABLE_ARRAY;
+                            table->add(last, existing);
+                        } else if (!existing->is_array() || !(existing->parser_flags() & TABLE_ARRAY)) {
+                            fail("'" + dotted(parts, parts.size()) + "' is not an array of tables");
+                        }
+                        Value* element = doc.make(Type::TABLE);
+                        element->parser_flags() = DEFINED;
+                        existing->append(element);
+                        return element;
+                    }
+                    if (!existing) {
+                        existing = doc.make(Type::TABLE);
+                        table->add(last, existing);
+                    } else if (!existing->is_table() || (existing->parser_flags() & (DEFINED | DOTTED | FROZEN))) {
+                        fail("table '" + dotted(parts, parts.size()) + "' is defined twice");
+                    }
+                    existing->parser_flags() |= DEFINED;
+                    return existing;
+                }
+
+            public:
+                Parser(Document& doc, std::string_view source) : doc(doc), s(source) {
+                    if (s.size() >= 3 && s.substr(0, 3) == "\xEF\xBB\xBF") i = 3;
+                }
+
+                void parse() {
+                    Value* current = &doc.root();
+                    std::vector<std::string_view> parts;
+                    for (;;) {
+                        skip_space();
+                        if (at_end()) return;
+                        if (peek() == '[') {
+                            bool array_of_tables = peek(1) == '[';
+                            i += array_of_tables ? 2 : 1;
+                            parse_key(parts);
+                            if (peek() != ']' || (array_of_tables && peek(1) != ']')) fail("expected ']' after table name");
+                            i += array_of_tables ? 2 : 1;
+                            current = open_header(parts, array_of_tables);
+                        } else {
+                            parse_key(parts);
+                            if (peek() != '=') fail("expected '=' after key");
+                            ++i;
+                            skip_blanks();
+                            assign(current, parts, parse_value());
+                        }
+                        expect_line_end();
+                    }
+                }
+            };
+        }
+
+        /**
+         * @brief Parse a TOML document.
+         * @param text The document.
+         * @return The parsed document; its root is a table.
+         * @throws std::invalid_argument if the document is not valid TOML.
+         */
+        inline Document loads(std::string text) {
+            Document doc;
+            detail::Parser(doc, doc.add_source(std::move(text))).parse();
+            return doc;
+        }
+
+        /**
+         * @brief Parse a TOML file. The file is memory-mapped and stays mapped while the
+         * Document lives.
+         * @param filename The file.
+         * @return The parsed document; its root is a table.
+         * @throws std::invalid_argument if the document is not valid TOML.
+         */
+        inline Document load(const char* filename) {
+            Document doc;
+            detail::Parser(doc, doc.add_file(filename)).parse();
+            return doc;
+        }
+    }
+}
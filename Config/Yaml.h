@@ -0,0 +1,474 @@
+// EasyCpp - Yaml : YAML Loader
+// Copyright (C) 2025  C14147
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+/**
+ * @file EasyCpp/Config/Yaml.h
+ * @brief This file implements a loader for the subset of YAML used by configuration files, like
+ *        PyYAML's safe_load: block mappings and sequences, flow collections, plain, quoted and
+ *        block (| and >) scalars, anchors, aliases and merge keys (<<). Only the first document
+ *        of a stream is loaded. Tags are ignored except !!str; complex keys (?) are not supported.
+ */
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+#include <Config/Config.h>
+
+namespace easycpp {
+    namespace yaml {
+        using config::Document;
+        using config::Style;
+        using config::Type;
+        using config::Value;
+
+        namespace detail {
+            class Parser {
+            private:
+                Document& doc;
+                std::string_view s;
+                size_t i = 0;
+                std::unordered_map<std::string_view, Value*> anchors;
+
+                [[noreturn]] void fail(const std::string& message) const {
+                    size_t line = 1;
+                    for (size_t k = 0; k < i && k < s.size(); ++k) line += s[k] == '\n';
+                    throw std::invalid_argument("yaml: line " + std::to_string(line) + ": " + message);
+                }
+
+                bool at_end() const { return i >= s.size(); }
+                char peek(size_t ahead = 0) const { return i + ahead < s.size() ? s[i + ahead] : '\0'; }
+
+                static bool is_break(char c) { return c == '\n' || c == '\r' || c == '\0'; }
+                static bool is_space(char c) { return c == ' ' || c == '\t' || is_break(c); }
+
+                int column(size_t pos) const {
+                    if (pos == 0) return 0;
+                    size_t newline = s.rfind('\n', pos - 1);
+                    return (int) (newline == std::string_view::npos ? pos : pos - newline - 1);
+                }
+
+                void skip_blanks() {
+                    while (i < s.size() && (s[i] == ' ' || s[i] == '\t')) ++i;
+                }
+
+                void skip_line() {
+                    while (i < s.size() && s[i] != '\n') ++i;
+                    if (i < s.size()) ++i;
+                }
+
+                // Skip blanks, comments and line breaks.
+                void skip_space() {
+                    for (;;) {
+                        skip_blanks();
+                        if (peek() == '#') skip_line();
+                        else if (peek() == '\n' || peek() == '\r') ++i;
+                        else return;
+                    }
+                }
+
+                bool at_document_marker() const {
+                    if (column(i) != 0 || i + 3 > s.size()) return false;
+                    std::string_view marker = s.substr(i, 3);
+                    return (marker == "---" || marker == "...") && (i + 3 == s.size() || is_space(s[i + 3]));
+                }
+
+                bool at_sequence_entry() const { return peek() == '-' && is_space(peek(1)); }
+
+                // A ':' that ends a key: followed by a space or the end of the line.
+                bool at_value_indicator() const { return peek() == ':' && is_space(peek(1)); }
+
+                Value* null_value() { return doc.make_scalar(Type::NONE, std::string_view()); }
+
+                std::string_view scan_single_quoted(bool* multiline) {
+                    size_t start = ++i;
+                    *multiline = false;
+                    for (;;) {
+                        if (at_end()) fail("unterminated single-quoted scalar");
+                        if (s[i] == '\'') {
+                            if (peek(1) != '\'') break;
+                            *multiline = true;
+                            i += 2;
+                            continue;
+                        }
+                        if (s[i] == '\n') *multiline = true;
+                        ++i;
+                    }
+                    return s.substr(start, i++ - start);
+                }
+
+                std::string_view scan_double_quoted(bool* escaped) {
+                    size_t start = ++i;
+                    *escaped = false;
+                    for (;;) {
+                        if (at_end()) fail("unterminated double-quoted scalar");
+                        if (s[i] == '"') break;
+                        if (s[i] == '\\' || s[i] == '\n') {
+                            *escaped = true;
+                            i += s[i] == '\\' ? 2 : 1;
+                            continue;
+                        }
+                        ++i;
+                    }
+                    return s.substr(start, i++ - start);
+                }
+
+                Value* quoted_scalar() {
+                    bool special;
+                    if (peek() == '\'') {
+                        std::string_view text = scan_single_quoted(&special);
+                        return doc.make_scalar(Type::STRING, text, special ? Style::SINGLE_QUOTED : Style::RAW);
+                    }
+                    std::string_view text = scan_double_quoted(&special);
+                    return doc.make_scalar(Type::STRING, text, special ? Style::DOUBLE_QUOTED : Style::RAW);
+                }
+
+                // The text of a plain scalar up to the end of the line, a ": " or a " #".
+                std::string_view scan_plain_line(bool flow) {
+                    size_t start = i;
+                    while (i < s.size() && !is_break(s[i])) {
+                        char c = s[i];
+                        if (c == ':' && (is_space(peek(1)) || (flow && (peek(1) == ',' || peek(1) == ']' || peek(1) == '}')))) break;
+                        if (c == '#' && i > start && (s[i - 1] == ' ' || s[i - 1] == '\t')) break;
+                        if (flow && (c == ',' || c == '[' || c == ']' || c == '{' || c == '}')) break;
+                        ++i;
+                    }
+                    size_t end = i;
+                    while (end > start && (s[end - 1] == ' ' || s[end - 1] == '\t')) --end;
+                    return s.substr(start, end - start);
+                }
+
+                // Extend a plain scalar over the following lines indented more than `parent`.
+                Value* plain_scalar(std::string_view first, int parent) {
+                    size_t end = (size_t) (first.data() + first.size() - s.data());
+                    bool folded = false;
+                    for (;;) {
+                        skip_blanks();
+                        if (!is_break(peek()) || at_end()) break;
+                        size_t save = i;
+                        skip_line();
+                        while (!at_end()) {
+                            skip_blanks();
+                            if (peek() == '\n' || peek() == '\r') skip_line();
+                            else break;
+                        }
+                        if (at_end() || peek() == '#' || column(i) <= parent || at_document_marker()) {
+                            i = save;
+                            break;
+                        }
+                        std::string_view line = scan_plain_line(false);
+                        if (line.empty() || at_value_indicator()) {
+                            i = save;
+                            break;
+                        }
+                        end = (size_t) (line.data() + line.size() - s.data());
+                        folded = true;
+                    }
+                    size_t start = (size_t) (first.data() - s.data());
+                    return doc.make_scalar(Type::STRING, s.substr(start, end - start), folded ? Style::FOLDED : Style::RAW, true);
+                }
+
+                Value* block_scalar(int parent) {
+                    bool folded = s[i++] == '>';
+                    uint8_t chomp = 0;
+                    int explicit_indent = 0;
+                    for (int k = 0; k < 2; ++k) {
+                        if (peek() == '-' || peek() == '+') chomp = s[i++] == '-' ? 1 : 2;
+                        else if (peek() >= '1' && peek() <= '9') explicit_indent = s[i++] - '0';
+                    }
+                    skip_blanks();
+                    if (peek() == '#') {
+                        while (!at_end() && s[i] != '\n') ++i;
+                    }
+                    if (!is_break(peek())) fail("unexpected text after block scalar indicator");
+                    skip_line();
+                    size_t start = i;
+                    int indent = explicit_indent ? (parent < 0 ? 0 : parent) + explicit_indent : -1;
+                    size_t end = start;
+                    while (!at_end()) {
+                        size_t line_start = i;
+                        skip_blanks();
+                        bool blank = peek() == '\n' || peek() == '\r' || at_end();
+                        int line_indent = (int) (i - line_start);
+                        if (!blank) {
+                            if (indent < 0) indent = line_indent > parent ? line_indent : parent + 1;
+                            if (line_indent < indent) {
+                                i = line_start;
+                                break;
+                            }
+                        }
+                        skip_line();
+                        end = i;
+                    }
+                    i = end;
+                    Value* value = doc.make_scalar(Type::STRING, s.substr(start, end - start), folded ? Style::FOLDED_BLOCK : Style::LITERAL_BLOCK);
+                    value->set_block((uint16_t) (indent < 0 ? 0 : indent), chomp);
+                    return value;
+                }
+
+                Value* alias() {
+                    size_t start = ++i;
+                    while (i < s.size() && !is_space(s[i]) && s[i] != ',' && s[i] != ']' && s[i] != '}') ++i;
+                    auto found = anchors.find(s.substr(start, i - start));
+                    if (found == anchors.end()) fail("unknown alias '" + std::string(s.substr(start, i - start)) + "'");
+                    return found->second;
+                }
+
+                // Parse anchors and tags before a node. Returns true if the node is tagged !!str.
+                bool properties(std::string_view* anchor) {
+                    bool force_string = false;
+                    for (;;) {
+                        if (peek() != '&' && peek() != '!') return force_string;
+                        bool is_anchor = peek() == '&';
+                        size_t start = ++i;
+                        while (i < s.size() && !is_space(s[i]) && s[i] != ',' && s[i] != ']' && s[i] != '}') ++i;
+                        std::string_view name = s.substr(start, i - start);
+                        if (is_anchor) *anchor = name;
+                        else if (name == "!str" || name == "<tag:yaml.org,2002:str>") force_string = true;
+                        skip_blanks();
+                    }
+                }
+
+                Value* finish(Value* value, std::string_view anchor, bool force_string) {
+                    if (force_string && value->is_scalar()) value->set_plain(false);
+                    if (!anchor.empty()) anchors[anchor] = value;
+                    return value;
+                }
+
+                std::string_view key_text(Value* key) {
+                    if (!key->is_scalar()) fail("only scalar keys are supported");
+                    std::string decoded = key->as_string();
+                    return decoded == key->raw() ? key->raw() : doc.keep(std::move(decoded));
+                }
+
+                // Parse a block node whose parent collection is at column `parent`. A sequence may
+                // start at the parent's column when it is the value of a mapping key.
+                Value* block_node(int parent, bool sequence_at_parent) {
+                    skip_space();
+                    if (at_end() || at_document_marker()) return null_value();
+                    int col = column(i);
+                    if (col < parent || (col == parent && !(sequence_at_parent && at_sequence_entry()))) return null_value();
+                    std::string_view anchor;
+                    bool force_string = properties(&anchor);
+                    if (is_break(peek()) || peek() == '#') return finish(block_node(parent, sequence_at_parent), anchor, force_string);
+                    return finish(block_content(parent, column(i)), anchor, force_string);
+                }
+
+                Value* block_content(int parent, int col) {
+                    char c = peek();
+                    if (c == '*') return alias();
+                    if (at_sequence_entry()) return block_sequence(col);
+                    if (c == '|' || c == '>') return block_scalar(parent);
+                    if (c == '[' || c == '{') return flow_node();
+                    if (c == '?' && is_space(peek(1))) fail("complex keys are not supported");
+                    Value* scalar;
+                    std::string_view first;
+                    if (c == '"' || c == '\'') {
+                        scalar = quoted_scalar();
+                    } else {
+                        first = scan_plain_line(false);
+                        scalar = doc.make_scalar(Type::STRING, first, Style::RAW, true);
+                    }
+                    skip_blanks();
+                    if (at_value_indicator()) return block_mapping(col, scalar);
+                    if (c == '"' || c == '\'') return scalar;
+                    return plain_scalar(first, parent);
+                }
+
+                Value* block_sequence(int indent) {
+                    Value* sequence = doc.make(Type::ARRAY);
+                    for (;;) {
+                        ++i;
+                        sequence->append(block_node(indent, false));
+                        skip_space();
+                        if (at_end() || at_document_marker()) break;
+                        int col = column(i);
+                        if (col < indent) break;
+                        if (col > indent) fail("bad indentation of a sequence entry");
+                        if (!at_sequence_entry()) break;
+                    }
+                    return sequence;
+                }
+
+                Value* block_mapping(int indent, Value* first_key) {
+                    Value* mapping = doc.make(Type::TABLE);
+                    std::vector<Value*> merges;
+                    Value* key = first_key;
+                    for (;;) {
+                        ++i;  // ':'
+                        bool merge = key->raw() == "<<" && key->type() == Type::STRING;
+                        std::string_view name = key_text(key);
+                        Value* value = block_node(indent, true);
+                        if (merge) merges.push_back(value);
+                        else mapping->set(name, value);
+                        skip_space();
+                        if (at_end() || at_document_marker()) break;
+                        int col = column(i);
+                        if (col < indent) break;
+                        if (col > indent || at_sequence_entry()) fail("bad indentation of a mapping entry");
+                        if (peek() == '"' || peek() == '\'') key = quoted_scalar();
+                        else if (peek() == '?' && is_space(peek(1))) fail("complex keys are not supported");
+                        else key = doc.make_scalar(Type::STRING, scan_plain_line(false), Style::RAW, true);
+                        skip_blanks();
+                        if (!at_value_indicator()) fail("expected ':' after a mapping key");
+                    }
+                    return merge_into(mapping, merges);
+                }
+
+                // Merge keys: the entries of the merged mappings come first; keys the mapping
+                // defines itself override them.
+                Value* merge_into(Value* mapping, const std::vector<Value*>& merges) {
+                    if (merges.empty()) return mapping;
+                    Value* merged = doc.make(Type::TABLE);
+                    for (Value* merge : merges) {
+                        const std::vector<Value*>* sources = merge->is_array() ? &merge->elements() : nullptr;
+                        size_t count = sources ? sources->size() : 1;
+                        for (size_t k = 0; k < count; ++k) {
+                            Value* source = sources ? (*sources)[k] : merge;
+                            if (!source->is_table()) fail("merge key value is not a mapping");
+                            for (const Value::Item& item : source->items()) {
+                                if (!merged->contains(item.first)) merged->add(item.first, item.second);
+                            }
+                        }
+                    }
+                    for (const Value::Item& item : mapping->items()) merged->set(item.first, item.second);
+                    return merged;
+                }
+
+                Value* flow_node() {
+                    skip_space();
+                    std::string_view anchor;
+                    bool force_string = properties(&anchor);
+                    skip_space();
+                    char c = peek();
+                    Value* value;
+                    if (c == '[') value = flow_sequence();
+                    else if (c == '{') value = flow_mapping();
+                    else if (c == '*') value = alias();
+                    else if (c == '"' || c == '\'') value = quoted_scalar();
+                    else if (c == ',' || c == ']' || c == '}' || c == ':') value = null_value();
+                    else value = doc.make_scalar(Type::STRING, scan_plain_line(true), Style::RAW, true);
+                    return finish(value, anchor, force_string);
+                }
+
+                bool at_flow_value_indicator() const {
+                    return peek() == ':' && (is_space(peek(1)) || peek(1) == ',' || peek(1) == ']' || peek(1) == '}');
+                }
+
+                Value* flow_sequence() {
+                    ++i;
+                    Value* sequence = doc.make(Type::ARRAY);
+                    for (;;) {
+                        skip_space();
+                        if (at_end()) fail("unterminated flow sequence");
+                        if (peek() == ']') break;
+                        Value* entry = flow_node();
+                        skip_space();
+                        if (at_flow_value_indicator()) {
+                            // A single-pair mapping: [a: 1]
+                            ++i;
+                            skip_space();
+                            Value* pair = doc.make(Type::TABLE);
+                            pair->add(key_text(entry), peek() == ',' || peek() == ']' ? null_value() : flow_node());
+                            entry = pair;
+                            skip_space();
+                        }
+                        sequence->append(entry);
+                        if (peek() == ',') ++i;
+                        else if (peek() != ']') fail("expected ',' or ']' in a flow sequence");
+                    }
+                    ++i;
+                    return sequence;
+                }
+
+                Value* flow_mapping() {
+                    ++i;
+                    Value* mapping = doc.make(Type::TABLE);
+                    std::vector<Value*> merges;
+                    for (;;) {
+                        skip_space();
+                        if (at_end()) fail("unterminated flow mapping");
+                        if (peek() == '}') break;
+                        Value* key = flow_node();
+                        skip_space();
+                        Value* value;
+                        if (at_flow_value_indicator() || (peek() == ':' && !key->raw().empty())) {
+                            ++i;
+                            skip_space();
+                            value = peek() == ',' || peek() == '}' ? null_value() : flow_node();
+                            skip_space();
+                        } else {
+                            value = null_value();
+                        }
+                        if (key->raw() == "<<" && key->type() == Type::STRING) merges.push_back(value);
+                        else mapping->set(key_text(key), value);
+                        if (peek() == ',') ++i;
+                        else if (peek() != '}') fail("expected ',' or '}' in a flow mapping");
+                    }
+                    ++i;
+                    return merge_into(mapping, merges);
+                }
+
+            public:
+                Parser(Document& doc, std::string_view source) : doc(doc), s(source) {
+                    if (s.size() >= 3 && s.substr(0, 3) == "\xEF\xBB\xBF") i = 3;
+                }
+
+                void parse() {
+                    for (;;) {
+                        skip_space();
+                        if (peek() == '%' && column(i) == 0) skip_line();
+                        else break;
+                    }
+                    if (at_document_marker() && s[i] == '-') i += 3;
+                    Value* root = block_node(-1, false);
+                    skip_space();
+                    if (!at_end() && !at_document_marker()) fail("unexpected content");
+                    doc.set_root(root);
+                }
+            };
+        }
+
+        /**
+         * @brief Parse the first document of a YAML stream.
+         * @param text The stream.
+         * @return The parsed document; its root may be a mapping, a sequence or a scalar.
+         * @throws std::invalid_argument if the document is malformed or uses unsupported syntax.
+         */
+        inline Document safe_load(std::string text) {
+            Document doc;
+            detail::Parser(doc, doc.add_source(std::move(text))).parse();
+            return doc;
+        }
+
+        /**
+         * @brief Parse the first document of a YAML file. The file is memory-mapped and stays
+         * mapped while the Document lives.
+         * @param filename The file.
+         * @return The parsed document.
+         * @throws std::invalid_argument if the document is malformed or uses unsupported syntax.
+         */
+        inline Document safe_load_file(const char* filename) {
+            Document doc;
+            detail::Parser(doc, doc.add_file(filename)).parse();
+            return doc;
+        }
+    }
+}
@@ -0,0 +1,123 @@
+// EasyCpp - Csv : CSV File Reading
+// Copyright (C) 2025  C14147
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+/**
+ * @file EasyCpp/Csv/Csv.h
+ * @brief This file implements a CSV reader similar to Python's csv.reader.
+ *        It follows RFC 4180: fields may be quoted, quotes inside quoted fields are doubled,
+ *        and quoted fields may contain delimiters and line breaks.
+ */
+#pragma once
+#define _EASYCPP_CSV_VERSION "1.0.0"
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace easycpp {
+    namespace csv {
+        /**
+         * @class reader
+         * @brief Iterates over the rows of CSV text held in memory.
+         * The text must outlive the reader.
+         */
+        class reader {
+        private:
+            std::string_view text;
+            size_t pos = 0;
+            char delimiter;
+            char quotechar;
+
+            bool read_row(std::vector<std::string>& row, std::vector<bool>* quoted_fields) {
+                row.clear();
+                if (quoted_fields) quoted_fields->clear();
+                if (pos >= text.size()) return false;
+                std::string field;
+                bool quoted = false;
+                bool was_quoted = false;
+                while (pos < text.size()) {
+                    char c = text[pos++];
+                    if (quoted) {
+                        if (c == quotechar) {
+                            if (pos < text.size() && text[pos] == quotechar) {
+                                field += quotechar;
+                                ++pos;
+                            } else {
+                                quoted = false;
+                            }
+                        } else {
+                            field += c;
+                        }
+                    } else if (c == quotechar && field.empty() && !was_quoted) {
+                        quoted = was_quoted = true;
+                    } else if (c == delimiter) {
+                        row.push_back(std::move(field));
+                        if (quoted_fields) quoted_fields->push_back(was_quoted);
+                        field.clear();
+                        was_quoted = false;
+                    } else if (c == '\n' || c == '\r') {
+                        if (c == '\r' && pos < text.size() && text[pos] == '\n') ++pos;
+                        break;
+                    } else {
+                        field += c;
+                    }
+                }
+                row.push_back(std::move(field));
+                if (quoted_fields) quoted_fields->push_back(was_quoted);
+                return true;
+            }
+
+        public:
+            /**
+             * @brief Construct a reader over CSV text.
+             * @param text The CSV content.
+             * @param delimiter The field separator. Defaults to ','.
+             * @param quotechar The quote character. Defaults to '"'.
+             */
+            explicit reader(std::string_view text, char delimiter = ',', char quotechar = '"')
+                : text(text), delimiter(delimiter), quotechar(quotechar) {}
+
+            /**
+             * @brief Get the number of bytes consumed so far.
+             * @return The offset of the next row in the text.
+             */
+            size_t offset() const {
+                return pos;
+            }
+
+            /**
+             * @brief Read the next row.
+             * @param row Receives the fields of the row. Its previous content is replaced.
+             * @return false when there are no more rows.
+             */
+            bool next(std::vector<std::string>& row) {
+                return read_row(row, nullptr);
+            }
+
+            /**
+             * @brief Read the next row and report which fields were enclosed in quotes, e.g. to
+             * keep "007" a string when inferring types.
+             * @param row Receives the fields of the row. Its previous content is replaced.
+             * @param quoted Receives, for each field, whether it was quoted.
+             * @return false when there are no more rows.
+             */
+            bool next(std::vector<std::string>& row, std::vector<bool>& quoted) {
+                return read_row(row, &quoted);
+            }
+        };
+    }
+}
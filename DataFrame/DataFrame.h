@@ -0,0 +1,1178 @@
+// EasyCpp - DataFrame : A Columnar Table Similar to pandas.DataFrame
+// Copyright (C) 2025  C14147
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+/**
+ * @file EasyCpp/DataFrame/DataFrame.h
+ * @brief This file implements DataFrame, a table of typed columns similar to pandas.DataFrame.
+ *        Numeric columns are stored in NDArrays (int64 or float64), string columns are
+ *        dictionary encoded (int32 codes into a shared dictionary). Tables can be loaded from
+ *        CSV and JSON Lines, and support filter, select, sort, group-by aggregation through a
+ *        parallel partitioned hash aggregate, and hash joins.
+ */
+#pragma once
+#define _EASYCPP_DATAFRAME_VERSION "1.0.0"
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <limits>
+#include <memory>
+#include <ostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <Csv/Csv.h>
+#include <FileOperator/FileOperator.h>
+#include <NDArray/NDArray.h>
+#include <Threading/ThreadPool.h>
+
+namespace easycpp {
+    /**
+     * @class Column
+     * @brief One typed column of a DataFrame.
+     * INT64 and FLOAT64 columns keep their values in an NDArray. STRING columns keep int32 codes
+     * into a dictionary of distinct values; the code -1 marks a missing value. Missing numbers are
+     * NaN, so an integer column with missing values is stored as FLOAT64.
+     */
+    class Column {
+    public:
+        enum Kind { INT64, FLOAT64, STRING };
+
+    private:
+        Kind type = FLOAT64;
+        NDArray values;
+        std::shared_ptr<const std::vector<std::string>> dict;
+
+    public:
+        Column() {}
+
+        /**
+         * @brief Create an int64 column.
+         * @param data The values.
+         * @return The new column.
+         */
+        static Column from_int64(const std::vector<int64_t>& data) {
+            Column column;
+            column.type = INT64;
+            column.values = NDArray::from_vector(data);
+            return column;
+        }
+
+        /**
+         * @brief Create a float64 column.
+         * @param data The values. NaN marks a missing value.
+         * @return The new column.
+         */
+        static Column from_float64(const std::vector<double>& data) {
+            Column column;
+            column.type = FLOAT64;
+            column.values = NDArray::from_vector(data);
+            return column;
+        }
+
+        /**
+         * @brief Create a dictionary-encoded string column.
+         * @param data The values.
+         * @return The new column.
+         */
+        static Column from_strings(const std::vector<std::string>& data) {
+            auto dictionary = std::make_shared<std::vector<std::string>>();
+            std::unordered_map<std::string_view, int32_t> lookup;
+            std::vector<int32_t> codes;
+            codes.reserve(data.size());
+            for (const std::string& value : data) {
+                auto it = lookup.find(value);
+                if (it == lookup.end()) {
+                    it = lookup.emplace(value, (int32_t) dictionary->size()).first;
+                    dictionary->push_back(value);
+                }
+                codes.push_back(it->second);
+            }
+            return from_codes(NDArray::from_vector(codes), std::move(dictionary));
+        }
+
+        /**
+         * @brief Create a string column from codes and an existing dictionary.
+         * @param codes An int32 NDArray of codes, -1 for missing values.
+         * @param dictionary The distinct values the codes refer to.
+         * @return The new column.
+         */
+        static Column from_codes(NDArray codes, std::shared_ptr<const std::vector<std::string>> dictionary) {
+            if (codes.dtype() != DType::INT32) throw std::invalid_argument("Column: codes must be int32");
+            Column column;
+            column.type = STRING;
+            column.values = std::move(codes);
+            column.dict = std::move(dictionary);
+            return column;
+        }
+
+        Kind kind() const { return type; }
+        bool is_numeric() const { return type != STRING; }
+        size_t size() const { return values.size(); }
+
+        /**
+         * @brief Get the underlying array: int64 values, float64 values or int32 codes.
+         * @return The array.
+         */
+        const NDArray& array() const { return values; }
+
+        /**
+         * @brief Get the dictionary of a string column.
+         * @return The distinct values.
+         * @throws std::logic_error if the column is numeric.
+         */
+        const std::vector<std::string>& dictionary() const {
+            if (type != STRING) throw std::logic_error("Column: numeric columns have no dictionary");
+            return *dict;
+        }
+
+        std::shared_ptr<const std::vector<std::string>> shared_dictionary() const { return dict; }
+
+        const int64_t* int64_data() const { return values.data<int64_t>(); }
+        const double* float64_data() const { return values.data<double>(); }
+        const int32_t* codes() const { return values.data<int32_t>(); }
+
+        /**
+         * @brief Get a numeric value as a double.
+         * @param row The row index.
+         * @return The value, NaN if missing.
+         */
+        double number(size_t row) const {
+            if (type == INT64) return (double) int64_data()[row];
+            if (type == FLOAT64) return float64_data()[row];
+            throw std::logic_error("Column: string column has no numeric value");
+        }
+
+        /**
+         * @brief Get the value of a string column.
+         * @param row The row index.
+         * @return A view of the value, empty if missing.
+         */
+        std::string_view string(size_t row) const {
+            int32_t code = codes()[row];
+            return code < 0 ? std::string_view() : std::string_view((*dict)[code]);
+        }
+
+        /**
+         * @brief Check whether a value is missing.
+         * @param row The row index.
+         * @return true for NaN numbers and missing strings.
+         */
+        bool is_null(size_t row) const {
+            if (type == INT64) return false;
+            if (type == FLOAT64) return std::isnan(float64_data()[row]);
+            return codes()[row] < 0;
+        }
+
+        /**
+         * @brief Gather rows into a new column.
+         * @param rows The row indices. -1 produces a missing value.
+         * @return The new column.
+         */
+        Column take(const std::vector<int64_t>& rows) const {
+            bool has_null = std::find(rows.begin(), rows.end(), -1) != rows.end();
+            if (type == INT64 && !has_null) {
+                std::vector<int64_t> out(rows.size());
+                const int64_t* in = int64_data();
+                for (size_t i = 0; i < rows.size(); ++i) out[i] = in[rows[i]];
+                return from_int64(out);
+            }
+            if (type == STRING) {
+                std::vector<int32_t> out(rows.size());
+                const int32_t* in = codes();
+                for (size_t i = 0; i < rows.size(); ++i) out[i] = rows[i] < 0 ? -1 : in[rows[i]];
+                return from_codes(NDArray::from_vector(out), dict);
+            }
+            std::vector<double> out(rows.size());
+            for (size_t i = 0; i < rows.size(); ++i) {
+                out[i] = rows[i] < 0 ? std::numeric_limits<double>::quiet_NaN() : number((size_t) rows[i]);
+            }
+            return from_float64(out);
+        }
+
+        /**
+         * @brief Format a value for printing.
+         * @param row The row index.
+         * @return The text of the value, "NaN" or "None" if missing.
+         */
+        std::string repr(size_t row) const {
+            if (type == INT64) return std::to_string(int64_data()[row]);
+            if (type == STRING) return is_null(row) ? "None" : std::string(string(row));
+            double value = float64_data()[row];
+            if (std::isnan(value)) return "NaN";
+            std::ostringstream os;
+            os << value;
+            return os.str();
+        }
+
+        /**
+         * @brief Compute the sort rank of every dictionary entry of a string column.
+         * Comparing ranks is equivalent to comparing the strings.
+         * @return The rank of each dictionary code.
+         */
+        std::vector<int32_t> dictionary_ranks() const {
+            const std::vector<std::string>& words = dictionary();
+            std::vector<int32_t> order(words.size());
+            for (size_t i = 0; i < order.size(); ++i) order[i] = (int32_t) i;
+            std::sort(order.begin(), order.end(), [&](int32_t a, int32_t b) { return words[a] < words[b]; });
+            std::vector<int32_t> ranks(words.size());
+            for (size_t i = 0; i < order.size(); ++i) ranks[order[i]] = (int32_t) i;
+            return ranks;
+        }
+    };
+
+    /**
+     * @brief The aggregations GroupBy::agg() can compute.
+     */
+    enum class Agg { SUM, MEAN, MIN, MAX, COUNT };
+
+    class GroupBy;
+
+    /**
+     * @class DataFrame
+     * @brief A table of named, equally long columns.
+     * Copies share the column buffers, and every operation returns a new DataFrame.
+     */
+    class DataFrame {
+        friend class GroupBy;
+
+    private:
+        std::vector<std::string> names;
+        std::vector<Column> cols;
+        size_t rows = 0;
+
+        /**
+         * @brief Collects raw cells of one column while a file is parsed, then picks its type.
+         */
+        struct ColumnBuilder {
+            enum : uint8_t { RAW, MISSING, QUOTED };
+            std::vector<std::string> cells;
+            std::vector<uint8_t> flags;
+
+            void add(std::string cell, uint8_t flag) {
+                cells.push_back(std::move(cell));
+                flags.push_back(flag);
+            }
+
+            Column finish() const {
+                bool all_int = true, all_number = true, any_missing = false;
+                for (size_t i = 0; i < cells.size() && all_number; ++i) {
+                    if (flags[i] == MISSING) {
+                        any_missing = true;
+                        continue;
+                    }
+                    int64_t integer;
+                    double real;
+                    if (flags[i] == QUOTED) {
+                        all_int = all_number = false;
+                    } else if (!parse_int64(cells[i], integer)) {
+                        all_int = false;
+                        if (!parse_double(cells[i], real)) all_number = false;
+                    }
+                }
+                if (all_int && !any_missing) {
+                    std::vector<int64_t> data(cells.size());
+                    for (size_t i = 0; i < cells.size(); ++i) parse_int64(cells[i], data[i]);
+                    return Column::from_int64(data);
+                }
+                if (all_number) {
+                    std::vector<double> data(cells.size(), std::numeric_limits<double>::quiet_NaN());
+                    for (size_t i = 0; i < cells.size(); ++i) {
+                        if (flags[i] != MISSING) parse_double(cells[i], data[i]);
+                    }
+                    return Column::from_float64(data);
+                }
+                auto dictionary = std::make_shared<std::vector<std::string>>();
+                std::unordered_map<std::string_view, int32_t> lookup;
+                std::vector<int32_t> codes(cells.size(), -1);
+                for (size_t i = 0; i < cells.size(); ++i) {
+                    if (flags[i] == MISSING) continue;
+                    auto it = lookup.find(cells[i]);
+                    if (it == lookup.end()) {
+                        it = lookup.emplace(cells[i], (int32_t) dictionary->size()).first;
+                        dictionary->push_back(cells[i]);
+                    }
+                    codes[i] = it->second;
+                }
+                return Column::from_codes(NDArray::from_vector(codes), std::move(dictionary));
+            }
+        };
+
+        static std::string_view trim(std::string_view text) {
+            while (!text.empty() && (text.front() == ' ' || text.front() == '\t')) text.remove_prefix(1);
+            while (!text.empty() && (text.back() == ' ' || text.back() == '\t')) text.remove_suffix(1);
+            return text;
+        }
+
+        static bool parse_int64(std::string_view text, int64_t& out) {
+            text = trim(text);
+            if (!text.empty() && text.front() == '+') text.remove_prefix(1);
+            auto result = std::from_chars(text.data(), text.data() + text.size(), out);
+            return !text.empty() && result.ec == std::errc() && result.ptr == text.data() + text.size();
+        }
+
+        static bool parse_double(std::string_view text, double& out) {
+            text = trim(text);
+            if (!text.empty() && text.front() == '+') text.remove_prefix(1);
+            auto result = std::from_chars(text.data(), text.data() + text.size(), out);
+            return !text.empty() && result.ec == std::errc() && result.ptr == text.data() + text.size();
+        }
+
+        static std::string read_file(const char* filename) {
+            File* file = open(filename, READ);
+            char* content = file->read_();
+            std::string text(content);
+            free(content);
+            delete file;
+            return text;
+        }
+
+        /**
+         * @brief A minimal JSON reader for the flat objects of a JSON Lines file.
+         */
+        struct JsonCursor {
+            std::string_view text;
+            size_t pos = 0;
+
+            [[noreturn]] void fail() const {
+                throw std::invalid_argument("DataFrame: invalid JSON at offset " + std::to_string(pos));
+            }
+
+            void skip_space() {
+                while (pos < text.size() && (text[pos] == ' ' || text[pos] == '\t' || text[pos] == '\r' || text[pos] == '\n')) ++pos;
+            }
+
+            bool consume(char c) {
+                skip_space();
+                if (pos < text.size() && text[pos] == c) {
+                    ++pos;
+                    return true;
+                }
+                return false;
+            }
+
+            static void append_utf8(std::string& out, uint32_t cp) {
+                if (cp < 0x80) {
+                    out += (char) cp;
+                } else if (cp < 0x800) {
+                    out += (char) (0xC0 | (cp >> 6));
+                    out += (char) (0x80 | (cp & 0x3F));
+                } else if (cp < 0x10000) {
+                    out += (char) (0xE0 | (cp >> 12));
+                    out += (char) (0x80 | ((cp >> 6) & 0x3F));
+                    out += (char) (0x80 | (cp & 0x3F));
+                } else {
+                    out += (char) (0xF0 | (cp >> 18));
+                    out += (char) (0x80 | ((cp >> 12) & 0x3F));
+                    out += (char) (0x80 | ((cp >> 6) & 0x3F));
+                    out += (char) (0x80 | (cp & 0x3F));
+                }
+            }
+
+            uint32_t hex4() {
+                if (pos + 4 > text.size()) fail();
+                uint32_t value = 0;
+                for (int i = 0; i < 4; ++i) {
+                    char c = text[pos++];
+                    value <<= 4;
+                    if (c >= '0' && c <= '9') value |= (uint32_t) (c - '0');
+                    else if (c >= 'a' && c <= 'f') value |= (uint32_t) (c - 'a' + 10);
+                    else if (c >= 'A' && c <= 'F') value |= (uint32_t) (c - 'A' + 10);
+                    else fail();
+                }
+                return value;
+            }
+
+            std::string string() {
+                if (!consume('"')) fail();
+                std::string out;
+                while (pos < text.size() && text[pos] != '"') {
+                    char c = text[pos++];
+                    if (c != '\\') {
+                        out += c;
+                        continue;
+                    }
+                    if (pos >= text.size()) fail();
+                    c = text[pos++];
+                    switch (c) {
+                        case 'b': out += '\b'; break;
+                        case 'f': out += '\f'; break;
+                        case 'n': out += '\n'; break;
+                        case 'r': out += '\r'; break;
+                        case 't': out += '\t'; break;
+                        case 'u': {
+                            uint32_t cp = hex4();
+                            if (cp >= 0xD800 && cp < 0xDC00 && text.substr(pos, 2) == "\\u") {
+                                pos += 2;
+                                cp = 0x10000 + ((cp - 0xD800) << 10) + (hex4() - 0xDC00);
+                            }
+                            append_utf8(out, cp);
+                            break;
+                        }
+                        default: out += c; break;
+                    }
+                }
+                if (pos >= text.size()) fail();
+                ++pos;
+                return out;
+            }
+
+            // Nested arrays and objects are kept as their JSON text.
+            std::string nested() {
+                size_t start = pos;
+                int depth = 0;
+                bool in_string = false;
+                for (; pos < text.size(); ++pos) {
+                    char c = text[pos];
+                    if (in_string) {
+                        if (c == '\\') ++pos;
+                        else if (c == '"') in_string = false;
+                    } else if (c == '"') {
+                        in_string = true;
+                    } else if (c == '{' || c == '[') {
+                        ++depth;
+                    } else if ((c == '}' || c == ']') && --depth == 0) {
+                        ++pos;
+                        return std::string(text.substr(start, pos - start));
+                    }
+                }
+                fail();
+            }
+
+            void value(std::string& out, uint8_t& flag) {
+                skip_space();
+                if (pos >= text.size()) fail();
+                char c = text[pos];
+                if (c == '"') {
+                    out = string();
+                    flag = ColumnBuilder::QUOTED;
+                } else if (c == '{' || c == '[') {
+                    out = nested();
+                    flag = ColumnBuilder::QUOTED;
+                } else if (text.substr(pos, 4) == "true") {
+                    pos += 4;
+                    out = "1";
+                    flag = ColumnBuilder::RAW;
+                } else if (text.substr(pos, 5) == "false") {
+                    pos += 5;
+                    out = "0";
+                    flag = ColumnBuilder::RAW;
+                } else if (text.substr(pos, 4) == "null") {
+                    pos += 4;
+                    out.clear();
+                    flag = ColumnBuilder::MISSING;
+                } else {
+                    size_t start = pos;
+                    while (pos < text.size() && std::strchr("+-0123456789.eE", text[pos])) ++pos;
+                    if (pos == start) fail();
+                    out = std::string(text.substr(start, pos - start));
+                    flag = ColumnBuilder::RAW;
+                }
+            }
+        };
+
+        size_t index_of(const std::string& name) const {
+            for (size_t i = 0; i < names.size(); ++i) {
+                if (names[i] == name) return i;
+            }
+            throw std::out_of_range("DataFrame: no column named '" + name + "'");
+        }
+
+        static uint64_t mix(uint64_t x) {
+            x ^= x >> 33;
+            x *= 0xff51afd7ed558ccdULL;
+            x ^= x >> 33;
+            x *= 0xc4ceb9fe1a85ec53ULL;
+            x ^= x >> 33;
+            return x;
+        }
+
+        static int64_t float_key(double value) {
+            if (value == 0.0) value = 0.0;  // -0.0 and 0.0 form one group
+            if (std::isnan(value)) value = std::numeric_limits<double>::quiet_NaN();
+            int64_t bits;
+            std::memcpy(&bits, &value, sizeof(bits));
+            return bits;
+        }
+
+        /**
+         * @brief Encode a column as int64 keys for hashing: values, float bit patterns or codes.
+         */
+        static std::vector<int64_t> encode_keys(const Column& column) {
+            std::vector<int64_t> keys(column.size());
+            if (column.kind() == Column::INT64) {
+                if (!keys.empty()) std::memcpy(keys.data(), column.int64_data(), keys.size() * sizeof(int64_t));
+            } else if (column.kind() == Column::FLOAT64) {
+                for (size_t i = 0; i < keys.size(); ++i) keys[i] = float_key(column.float64_data()[i]);
+            } else {
+                for (size_t i = 0; i < keys.size(); ++i) keys[i] = column.codes()[i];
+            }
+            return keys;
+        }
+
+        /**
+         * @brief Compare two rows of a column for sorting; missing values go last.
+         * @param ranks The dictionary ranks of a string column, empty for numeric columns.
+         */
+        static int compare_rows(const Column& column, const std::vector<int32_t>& ranks, size_t a, size_t b) {
+            bool null_a = column.is_null(a), null_b = column.is_null(b);
+            if (null_a || null_b) return (int) null_a - (int) null_b;
+            if (column.kind() == Column::INT64) {
+                int64_t x = column.int64_data()[a], y = column.int64_data()[b];
+                return x < y ? -1 : (x > y ? 1 : 0);
+            }
+            if (column.kind() == Column::FLOAT64) {
+                double x = column.float64_data()[a], y = column.float64_data()[b];
+                return x < y ? -1 : (x > y ? 1 : 0);
+            }
+            int32_t x = ranks[column.codes()[a]], y = ranks[column.codes()[b]];
+            return x < y ? -1 : (x > y ? 1 : 0);
+        }
+
+    public:
+        /**
+         * @brief Default constructor. Initializes an empty table.
+         */
+        DataFrame() {}
+
+        /**
+         * @brief Append a column.
+         * @param name The column name.
+         * @param column The column. Its length must match the existing columns.
+         * @throws std::invalid_argument on a duplicate name or a length mismatch.
+         */
+        void add_column(const std::string& name, Column column) {
+            if (std::find(names.begin(), names.end(), name) != names.end()) {
+                throw std::invalid_argument("DataFrame: duplicate column '" + name + "'");
+            }
+            if (!cols.empty() && column.size() != rows) {
+                throw std::invalid_argument("DataFrame: column '" + name + "' has the wrong length");
+            }
+            rows = column.size();
+            names.push_back(name);
+            cols.push_back(std::move(column));
+        }
+
+        size_t num_rows() const { return rows; }
+        size_t num_columns() const { return cols.size(); }
+        const std::vector<std::string>& columns() const { return names; }
+
+        bool has_column(const std::string& name) const {
+            return std::find(names.begin(), names.end(), name) != names.end();
+        }
+
+        /**
+         * @brief Access a column by name.
+         * @param name The column name.
+         * @return The column.
+         * @throws std::out_of_range if there is no such column.
+         */
+        const Column& operator[](const std::string& name) const {
+            return cols[index_of(name)];
+        }
+
+        /**
+         * @brief Parse CSV text whose first row holds the column names.
+         * Column types are inferred: int64 if every cell is an integer, float64 if every cell is
+         * a number (empty cells become NaN), string otherwise (empty cells become missing).
+         * Quoted cells such as "007" are strings. Blank lines are skipped, except in a
+         * single-column table, where they are rows with a missing value.
+         * @param text The CSV content.
+         * @param delimiter The field separator.
+         * @return The table.
+         */
+        static DataFrame from_csv(std::string_view text, char delimiter = ',') {
+            csv::reader reader(text, delimiter);
+            std::vector<std::string> header, row;
+            std::vector<bool> quoted;
+            if (!reader.next(header)) return DataFrame();
+            std::vector<ColumnBuilder> builders(header.size());
+            while (reader.next(row, quoted)) {
+                if (row.size() == 1 && row[0].empty() && !quoted[0] && header.size() > 1) continue;
+                for (size_t i = 0; i < builders.size(); ++i) {
+                    if (i < row.size() && !row[i].empty()) builders[i].add(std::move(row[i]), quoted[i] ? ColumnBuilder::QUOTED : ColumnBuilder::RAW);
+                    else builders[i].add(std::string(), ColumnBuilder::MISSING);
+                }
+            }
+            DataFrame frame;
+            for (size_t i = 0; i < header.size(); ++i) frame.add_column(header[i], builders[i].finish());
+            return frame;
+        }
+
+        /**
+         * @brief Load a CSV file through FileOperator, see from_csv().
+         * @param filename The path of the file.
+         * @param delimiter The field separator.
+         * @return The table.
+         */
+        static DataFrame read_csv(const char* filename, char delimiter = ',') {
+            return from_csv(read_file(filename), delimiter);
+        }
+
+        /**
+         * @brief Parse JSON Lines text: one flat JSON object per line.
+         * Columns appear in order of their first occurrence; keys missing from a line are missing
+         * values, and a key repeated within a line keeps its last value. true/false become 1/0,
+         * nested arrays and objects are kept as JSON text.
+         * @param text The JSON Lines content.
+         * @return The table.
+         * @throws std::invalid_argument on malformed JSON.
+         */
+        static DataFrame from_json_lines(std::string_view text) {
+            std::vector<std::string> header;
+            std::unordered_map<std::string, size_t> lookup;
+            std::vector<ColumnBuilder> builders;
+            size_t count = 0;
+            JsonCursor cursor{text};
+            std::string key, value;
+            while (true) {
+                cursor.skip_space();
+                if (cursor.pos >= text.size()) break;
+                if (!cursor.consume('{')) cursor.fail();
+                if (!cursor.consume('}')) {
+                    do {
+                        cursor.skip_space();
+                        key = cursor.string();
+                        if (!cursor.consume(':')) cursor.fail();
+                        uint8_t flag;
+                        cursor.value(value, flag);
+                        auto it = lookup.find(key);
+                        if (it == lookup.end()) {
+                            it = lookup.emplace(key, builders.size()).first;
+                            header.push_back(key);
+                            builders.emplace_back();
+                        }
+                        ColumnBuilder& builder = builders[it->second];
+                        while (builder.cells.size() < count) builder.add(std::string(), ColumnBuilder::MISSING);
+                        if (builder.cells.size() == count) {
+                            builder.add(std::move(value), flag);
+                        } else {
+                            // A repeated key: the last value wins, as with json.loads.
+                            builder.cells.back() = std::move(value);
+                            builder.flags.back() = flag;
+                        }
+                    } while (cursor.consume(','));
+                    if (!cursor.consume('}')) cursor.fail();
+                }
+                ++count;
+            }
+            DataFrame frame;
+            for (size_t i = 0; i < header.size(); ++i) {
+                while (builders[i].cells.size() < count) builders[i].add(std::string(), ColumnBuilder::MISSING);
+                frame.add_column(header[i], builders[i].finish());
+            }
+            return frame;
+        }
+
+        /**
+         * @brief Load a JSON Lines file through FileOperator, see from_json_lines().
+         * @param filename The path of the file.
+         * @return The table.
+         */
+        static DataFrame read_json_lines(const char* filename) {
+            return from_json_lines(read_file(filename));
+        }
+
+        /**
+         * @brief Gather rows into a new table.
+         * @param indices The row indices, in output order.
+         * @return The new table.
+         */
+        DataFrame take(const std::vector<int64_t>& indices) const {
+            DataFrame frame;
+            for (size_t i = 0; i < cols.size(); ++i) frame.add_column(names[i], cols[i].take(indices));
+            frame.rows = indices.size();
+            return frame;
+        }
+
+        /**
+         * @brief Get the first n rows.
+         * @param n The number of rows.
+         * @return The new table.
+         */
+        DataFrame head(size_t n = 5) const {
+            std::vector<int64_t> indices(std::min(n, rows));
+            for (size_t i = 0; i < indices.size(); ++i) indices[i] = (int64_t) i;
+            return take(indices);
+        }
+
+        /**
+         * @brief Keep only the named columns, in the given order.
+         * @param columns The column names.
+         * @return The new table, sharing the column data.
+         */
+        DataFrame select(const std::vector<std::string>& columns) const {
+            DataFrame frame;
+            for (const std::string& name : columns) frame.add_column(name, (*this)[name]);
+            frame.rows = rows;
+            return frame;
+        }
+
+        /**
+         * @brief Keep the rows whose mask entry is true.
+         * @param mask One flag per row.
+         * @return The new table.
+         * @throws std::invalid_argument if the mask has the wrong length.
+         */
+        DataFrame filter(const std::vector<bool>& mask) const {
+            if (mask.size() != rows) throw std::invalid_argument("DataFrame: mask has the wrong length");
+            std::vector<int64_t> indices;
+            for (size_t i = 0; i < rows; ++i) {
+                if (mask[i]) indices.push_back((int64_t) i);
+            }
+            return take(indices);
+        }
+
+        /**
+         * @brief Keep the rows for which predicate(value of column) is true.
+         * The predicate takes a double for numeric columns and a std::string_view for string columns.
+         * @param column The column name.
+         * @param predicate The row condition.
+         * @return The new table.
+         */
+        template<typename Fn>
+        DataFrame filter(const std::string& column, Fn predicate) const {
+            const Column& values = (*this)[column];
+            std::vector<int64_t> indices;
+            if constexpr (std::is_invocable_r_v<bool, Fn&, double>) {
+                for (size_t i = 0; i < rows; ++i) {
+                    if (predicate(values.number(i))) indices.push_back((int64_t) i);
+                }
+            } else {
+                // Evaluate the predicate once per distinct string instead of once per row.
+                const std::vector<std::string>& words = values.dictionary();
+                std::vector<uint8_t> keep(words.size());
+                for (size_t i = 0; i < words.size(); ++i) keep[i] = predicate(std::string_view(words[i])) ? 1 : 0;
+                bool keep_missing = predicate(std::string_view());
+                const int32_t* codes = values.codes();
+                for (size_t i = 0; i < rows; ++i) {
+                    if (codes[i] < 0 ? keep_missing : keep[codes[i]]) indices.push_back((int64_t) i);
+                }
+            }
+            return take(indices);
+        }
+
+        /**
+         * @brief Sort the rows by a column. The sort is stable and missing values go last.
+         * @param column The column name.
+         * @param ascending The sort direction.
+         * @return The new table.
+         */
+        DataFrame sort_values(const std::string& column, bool ascending = true) const {
+            const Column& values = (*this)[column];
+            std::vector<int32_t> ranks;
+            if (values.kind() == Column::STRING) ranks = values.dictionary_ranks();
+            std::vector<int64_t> indices(rows);
+            for (size_t i = 0; i < rows; ++i) indices[i] = (int64_t) i;
+            std::stable_sort(indices.begin(), indices.end(), [&](int64_t a, int64_t b) {
+                bool null_a = values.is_null((size_t) a), null_b = values.is_null((size_t) b);
+                if (null_a || null_b) return !null_a && null_b;
+                int order = compare_rows(values, ranks, (size_t) a, (size_t) b);
+                return ascending ? order < 0 : order > 0;
+            });
+            return take(indices);
+        }
+
+        /**
+         * @brief Group the rows by the values of one or more key columns.
+         * @param keys The key column names.
+         * @param pool The pool the aggregation runs on.
+         * @return A GroupBy object; call agg(), sum(), mean(), ... on it.
+         */
+        GroupBy groupby(std::vector<std::string> keys, ThreadPool& pool = ThreadPool::global()) const;
+
+        /**
+         * @brief Join with another table on equal key columns using a hash join.
+         * The hash table is built on the right table and probed in parallel with the left rows,
+         * so the output follows the order of the left table. Missing keys never match. Other
+         * columns that exist in both tables get the suffixes "_x" and "_y", like pandas.merge.
+         * @param right The right table.
+         * @param on The key column names, present in both tables.
+         * @param how "inner" or "left".
+         * @param pool The pool the probe runs on.
+         * @return The joined table.
+         * @throws std::invalid_argument for an unknown join type or incompatible key columns.
+         */
+        DataFrame merge(const DataFrame& right, const std::vector<std::string>& on, const std::string& how = "inner",
+                        ThreadPool& pool = ThreadPool::global()) const {
+            if (how != "inner" && how != "left") throw std::invalid_argument("DataFrame: how must be 'inner' or 'left'");
+            bool keep_unmatched = how == "left";
+            size_t width = on.size();
+            std::vector<std::vector<int64_t>> left_keys(width), right_keys(width);
+            std::vector<uint8_t> left_valid(rows, 1), right_valid(right.rows, 1);
+            for (size_t k = 0; k < width; ++k) {
+                const Column& a = (*this)[on[k]];
+                const Column& b = right[on[k]];
+                left_keys[k].resize(rows);
+                right_keys[k].resize(right.rows);
+                if (a.kind() == Column::STRING && b.kind() == Column::STRING) {
+                    // Translate the right codes into the left dictionary.
+                    std::unordered_map<std::string_view, int32_t> lookup;
+                    const std::vector<std::string>& words = a.dictionary();
+                    for (size_t i = 0; i < words.size(); ++i) lookup.emplace(words[i], (int32_t) i);
+                    const std::vector<std::string>& other = b.dictionary();
+                    std::vector<int32_t> translate(other.size(), -1);
+                    for (size_t i = 0; i < other.size(); ++i) {
+                        auto it = lookup.find(other[i]);
+                        if (it != lookup.end()) translate[i] = it->second;
+                    }
+                    for (size_t i = 0; i < rows; ++i) {
+                        left_keys[k][i] = a.codes()[i];
+                        if (a.codes()[i] < 0) left_valid[i] = 0;
+                    }
+                    for (size_t i = 0; i < right.rows; ++i) {
+                        int32_t code = b.codes()[i];
+                        right_keys[k][i] = code < 0 ? -1 : translate[code];
+                        if (right_keys[k][i] < 0) right_valid[i] = 0;
+                    }
+                } else if (a.is_numeric() && b.is_numeric()) {
+                    bool exact = a.kind() == Column::INT64 && b.kind() == Column::INT64;
+                    for (size_t i = 0; i < rows; ++i) {
+                        left_keys[k][i] = exact ? a.int64_data()[i] : float_key(a.number(i));
+                        if (a.is_null(i)) left_valid[i] = 0;
+                    }
+                    for (size_t i = 0; i < right.rows; ++i) {
+                        right_keys[k][i] = exact ? b.int64_data()[i] : float_key(b.number(i));
+                        if (b.is_null(i)) right_valid[i] = 0;
+                    }
+                } else {
+                    throw std::invalid_argument("DataFrame: cannot join string and numeric column '" + on[k] + "'");
+                }
+            }
+            auto hash_row = [width](const std::vector<std::vector<int64_t>>& keys, size_t row) {
+                uint64_t h = 0x9E3779B97F4A7C15ULL;
+                for (size_t k = 0; k < width; ++k) h = mix(h ^ (uint64_t) keys[k][row]);
+                return h;
+            };
+
+            // Build: open addressing table of chain heads; chains keep the right rows in order.
+            size_t capacity = 16;
+            while (capacity < right.rows * 2) capacity <<= 1;
+            std::vector<int64_t> heads(capacity, -1);
+            std::vector<int64_t> next(right.rows, -1);
+            for (size_t r = right.rows; r-- > 0;) {
+                if (!right_valid[r]) continue;
+                size_t slot = hash_row(right_keys, r) & (capacity - 1);
+                while (true) {
+                    int64_t head = heads[slot];
+                    if (head < 0) {
+                        heads[slot] = (int64_t) r;
+                        break;
+                    }
+                    bool equal = true;
+                    for (size_t k = 0; k < width && equal; ++k) equal = right_keys[k][head] == right_keys[k][r];
+                    if (equal) {
+                        next[r] = head;
+                        heads[slot] = (int64_t) r;
+                        break;
+                    }
+                    slot = (slot + 1) & (capacity - 1);
+                }
+            }
+
+            // Probe: each chunk of left rows collects its matches, chunks are concatenated in order.
+            size_t chunks = std::max<size_t>(1, std::min(pool.size() * 4, rows / 4096));
+            std::vector<std::vector<std::pair<int64_t, int64_t>>> matches(chunks);
+            pool.parallel_for(0, chunks, [&](size_t c) {
+                size_t begin = rows * c / chunks, end = rows * (c + 1) / chunks;
+                for (size_t l = begin; l < end; ++l) {
+                    int64_t found = -1;
+                    if (left_valid[l]) {
+                        size_t slot = hash_row(left_keys, l) & (capacity - 1);
+                        for (int64_t head; (head = heads[slot]) >= 0; slot = (slot + 1) & (capacity - 1)) {
+                            bool equal = true;
+                            for (size_t k = 0; k < width && equal; ++k) equal = right_keys[k][head] == left_keys[k][l];
+                            if (equal) {
+                                found = head;
+                                break;
+                            }
+                        }
+                    }
+                    if (found < 0 && keep_unmatched) matches[c].emplace_back((int64_t) l, -1);
+                    for (int64_t r = found; r >= 0; r = next[r]) matches[c].emplace_back((int64_t) l, r);
+                }
+            });
+            std::vector<int64_t> left_rows, right_rows;
+            for (const auto& chunk : matches) {
+                for (const auto& match : chunk) {
+                    left_rows.push_back(match.first);
+                    right_rows.push_back(match.second);
+                }
+            }
+
+            DataFrame frame;
+            auto is_key = [&](const std::string& name) { return std::find(on.begin(), on.end(), name) != on.end(); };
+            for (size_t i = 0; i < cols.size(); ++i) {
+                std::string name = names[i];
+                if (!is_key(name) && right.has_column(name)) name += "_x";
+                frame.add_column(name, cols[i].take(left_rows));
+            }
+            for (size_t i = 0; i < right.cols.size(); ++i) {
+                const std::string& name = right.names[i];
+                if (is_key(name)) continue;
+                frame.add_column(has_column(name) ? name + "_y" : name, right.cols[i].take(right_rows));
+            }
+            frame.rows = left_rows.size();
+            return frame;
+        }
+
+        /**
+         * @brief Print the first rows of the table with aligned columns.
+         * @param os The output stream.
+         * @param frame The table to be printed.
+         * @return The output stream after printing the table.
+         */
+        friend std::ostream& operator<<(std::ostream& os, const DataFrame& frame) {
+            const size_t shown = std::min<size_t>(frame.rows, 20);
+            std::vector<size_t> widths(frame.cols.size());
+            for (size_t c = 0; c < frame.cols.size(); ++c) {
+                widths[c] = frame.names[c].size();
+                for (size_t r = 0; r < shown; ++r) widths[c] = std::max(widths[c], frame.cols[c].repr(r).size());
+            }
+            for (size_t c = 0; c < frame.cols.size(); ++c) os << (c ? "  " : "") << std::setw((int) widths[c]) << frame.names[c];
+            os << "\n";
+            for (size_t r = 0; r < shown; ++r) {
+                for (size_t c = 0; c < frame.cols.size(); ++c) {
+                    os << (c ? "  " : "") << std::setw((int) widths[c]) << frame.cols[c].repr(r);
+                }
+                os << "\n";
+            }
+            if (shown < frame.rows) os << "...\n";
+            os << "[" << frame.rows << " rows x " << frame.cols.size() << " columns]";
+            return os;
+        }
+    };
+
+    /**
+     * @class GroupBy
+     * @brief The result of DataFrame::groupby(). Aggregations produce one row per distinct key,
+     * sorted by the key columns (missing keys last), like pandas with sort=True.
+     */
+    class GroupBy {
+    private:
+        DataFrame frame;
+        std::vector<std::string> keys;
+        ThreadPool* pool;
+
+        struct Accumulator {
+            double sum = 0.0;
+            int64_t integer_sum = 0;
+            int64_t count = 0;
+            double min = std::numeric_limits<double>::infinity();
+            double max = -std::numeric_limits<double>::infinity();
+            int64_t integer_min = std::numeric_limits<int64_t>::max();
+            int64_t integer_max = std::numeric_limits<int64_t>::min();
+        };
+
+        static const char* agg_name(Agg agg) {
+            switch (agg) {
+                case Agg::SUM: return "sum";
+                case Agg::MEAN: return "mean";
+                case Agg::MIN: return "min";
+                case Agg::MAX: return "max";
+                default: return "count";
+            }
+        }
+
+    public:
+        GroupBy(DataFrame frame, std::vector<std::string> keys, ThreadPool& pool)
+            : frame(std::move(frame)), keys(std::move(keys)), pool(&pool) {}
+
+        /**
+         * @brief Compute aggregations per group.
+         * The rows are hashed on their keys and scattered into partitions in parallel; every
+         * partition is then aggregated by one task with its own hash table, so no locks are needed.
+         * Output columns are the keys followed by "<column>_<agg>" for every requested aggregation.
+         * Aggregations skip missing values. String columns only support COUNT.
+         * @param specs Pairs of column name and aggregation.
+         * @return One row per group.
+         * @throws std::invalid_argument for SUM/MEAN/MIN/MAX on a string column.
+         */
+        DataFrame agg(const std::vector<std::pair<std::string, Agg>>& specs) const {
+            const size_t rows = frame.num_rows();
+            const size_t width = keys.size();
+            std::vector<const Column*> key_columns;
+            std::vector<std::vector<int64_t>> key_values;
+            for (const std::string& key : keys) {
+                key_columns.push_back(&frame[key]);
+                key_values.push_back(DataFrame::encode_keys(frame[key]));
+            }
+            std::vector<const Column*> inputs;
+            for (const auto& spec : specs) {
+                const Column& column = frame[spec.first];
+                if (!column.is_numeric() && spec.second != Agg::COUNT) {
+                    throw std::invalid_argument(std::string("GroupBy: cannot compute ") + agg_name(spec.second) +
+                                                " of string column '" + spec.first + "'");
+                }
+                inputs.push_back(&column);
+            }
+
+            // Phase 1: hash every row and scatter the row indices by partition.
+            const size_t chunks = std::max<size_t>(1, std::min(pool->size() + 1, rows / 16384));
+            size_t partitions = 1;
+            while (partitions < chunks * 2 && chunks > 1) partitions <<= 1;
+            std::vector<uint64_t> hashes(rows);
+            std::vector<std::vector<size_t>> histogram(chunks, std::vector<size_t>(partitions, 0));
+            pool->parallel_for(0, chunks, [&](size_t c) {
+                size_t begin = rows * c / chunks, end = rows * (c + 1) / chunks;
+                for (size_t r = begin; r < end; ++r) {
+                    uint64_t h = 0x9E3779B97F4A7C15ULL;
+                    for (size_t k = 0; k < width; ++k) h = DataFrame::mix(h ^ (uint64_t) key_values[k][r]);
+                    hashes[r] = h;
+                    ++histogram[c][h >> 32 & (partitions - 1)];
+                }
+            });
+            std::vector<size_t> partition_begin(partitions + 1, 0);
+            std::vector<std::vector<size_t>> offsets(chunks, std::vector<size_t>(partitions));
+            for (size_t p = 0, total = 0; p < partitions; ++p) {
+                partition_begin[p] = total;
+                for (size_t c = 0; c < chunks; ++c) {
+                    offsets[c][p] = total;
+                    total += histogram[c][p];
+                }
+                partition_begin[p + 1] = total;
+            }
+            std::vector<size_t> scattered(rows);
+            pool->parallel_for(0, chunks, [&](size_t c) {
+                size_t begin = rows * c / chunks, end = rows * (c + 1) / chunks;
+                for (size_t r = begin; r < end; ++r) scattered[offsets[c][hashes[r] >> 32 & (partitions - 1)]++] = r;
+            });
+
+            // Phase 2: aggregate every partition independently.
+            struct Partition {
+                std::vector<size_t> first_rows;
+                std::vector<Accumulator> accumulators;
+            };
+            std::vector<Partition> results(partitions);
+            pool->parallel_for(0, partitions, [&](size_t p) {
+                Partition& part = results[p];
+                size_t begin = partition_begin[p], end = partition_begin[p + 1];
+                size_t capacity = 16;
+                while (capacity < (end - begin) * 2) capacity <<= 1;
+                std::vector<int64_t> table(capacity, -1);
+                for (size_t i = begin; i < end; ++i) {
+                    size_t r = scattered[i];
+                    size_t slot = (size_t) hashes[r] & (capacity - 1);
+                    int64_t group;
+                    while (true) {
+                        group = table[slot];
+                        if (group < 0) {
+                            group = (int64_t) part.first_rows.size();
+                            table[slot] = group;
+                            part.first_rows.push_back(r);
+                            part.accumulators.resize(part.accumulators.size() + specs.size());
+                            break;
+                        }
+                        size_t first = part.first_rows[group];
+                        bool equal = hashes[first] == hashes[r];
+                        for (size_t k = 0; k < width && equal; ++k) equal = key_values[k][first] == key_values[k][r];
+                        if (equal) break;
+                        slot = (slot + 1) & (capacity - 1);
+                    }
+                    Accumulator* acc = &part.accumulators[(size_t) group * specs.size()];
+                    for (size_t s = 0; s < specs.size(); ++s) {
+                        const Column& column = *inputs[s];
+                        if (column.is_null(r)) continue;
+                        ++acc[s].count;
+                        if (column.kind() == Column::INT64) {
+                            int64_t value = column.int64_data()[r];
+                            acc[s].integer_sum += value;
+                            acc[s].integer_min = std::min(acc[s].integer_min, value);
+                            acc[s].integer_max = std::max(acc[s].integer_max, value);
+                        } else if (column.kind() == Column::FLOAT64) {
+                            double value = column.float64_data()[r];
+                            acc[s].sum += value;
+                            acc[s].min = std::min(acc[s].min, value);
+                            acc[s].max = std::max(acc[s].max, value);
+                        }
+                    }
+                }
+            });
+
+            // Phase 3: order the groups by key and build the output columns.
+            std::vector<std::pair<size_t, size_t>> groups;  // (partition, group)
+            for (size_t p = 0; p < partitions; ++p) {
+                for (size_t g = 0; g < results[p].first_rows.size(); ++g) groups.emplace_back(p, g);
+            }
+            std::vector<std::vector<int32_t>> ranks(width);
+            for (size_t k = 0; k < width; ++k) {
+                if (key_columns[k]->kind() == Column::STRING) ranks[k] = key_columns[k]->dictionary_ranks();
+            }
+            std::sort(groups.begin(), groups.end(), [&](const auto& a, const auto& b) {
+                size_t ra = results[a.first].first_rows[a.second], rb = results[b.first].first_rows[b.second];
+                for (size_t k = 0; k < width; ++k) {
+                    int order = DataFrame::compare_rows(*key_columns[k], ranks[k], ra, rb);
+                    if (order) return order < 0;
+                }
+                return false;
+            });
+
+            std::vector<int64_t> first_rows;
+            first_rows.reserve(groups.size());
+            for (const auto& group : groups) first_rows.push_back((int64_t) results[group.first].first_rows[group.second]);
+            DataFrame output;
+            for (size_t k = 0; k < width; ++k) output.add_column(keys[k], key_columns[k]->take(first_rows));
+            for (size_t s = 0; s < specs.size(); ++s) {
+                bool integer = inputs[s]->kind() == Column::INT64;
+                Agg agg = specs[s].second;
+                std::vector<int64_t> integers;
+                std::vector<double> reals;
+                for (const auto& group : groups) {
+                    const Accumulator& acc = results[group.first].accumulators[group.second * specs.size() + s];
+                    const double nan = std::numeric_limits<double>::quiet_NaN();
+                    if (agg == Agg::COUNT) {
+                        integers.push_back(acc.count);
+                    } else if (agg == Agg::MEAN) {
+                        double sum = integer ? (double) acc.integer_sum : acc.sum;
+                        reals.push_back(acc.count ? sum / (double) acc.count : nan);
+                    } else if (integer) {
+                        integers.push_back(agg == Agg::SUM ? acc.integer_sum : (agg == Agg::MIN ? acc.integer_min : acc.integer_max));
+                    } else if (agg == Agg::SUM) {
+                        reals.push_back(acc.sum);
+                    } else {
+                        reals.push_back(acc.count ? (agg == Agg::MIN ? acc.min : acc.max) : nan);
+                    }
+                }
+                std::string name = specs[s].first + "_" + agg_name(agg);
+                if (agg == Agg::COUNT || (integer && agg != Agg::MEAN)) output.add_column(name, Column::from_int64(integers));
+                else output.add_column(name, Column::from_float64(reals));
+            }
+            return output;
+        }
+
+        DataFrame sum(const std::string& column) const { return agg({{column, Agg::SUM}}); }
+        DataFrame mean(const std::string& column) const { return agg({{column, Agg::MEAN}}); }
+        DataFrame min(const std::string& column) const { return agg({{column, Agg::MIN}}); }
+        DataFrame max(const std::string& column) const { return agg({{column, Agg::MAX}}); }
+        DataFrame count(const std::string& column) const { return agg({{column, Agg::COUNT}}); }
+    };
+
+    inline GroupBy DataFrame::groupby(std::vector<std::string> keys, ThreadPool& pool) const {
+        for (const std::string& key : keys) index_of(key);
+        return GroupBy(*this, std::move(keys), pool);
+    }
+}
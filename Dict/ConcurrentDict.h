@@ -0,0 +1,725 @@
+// EasyCpp - ConcurrentDict : A Scalable Concurrent Hash Map
+// Copyright (C) 2025  C14147
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+/**
+ * @file EasyCpp/Dict/ConcurrentDict.h
+ * @brief This file implements ConcurrentDict, a hash map shared by many threads:
+ *        - reads take no lock and write nothing shared. They walk immutable nodes that
+ *          writers publish with release stores, and memory is reclaimed with epochs: an
+ *          unlinked node is freed only once every thread that could still see it has left
+ *          its read section;
+ *        - writes lock one of a fixed set of striped locks (threading::Lock) chosen by the
+ *          low bits of the key hash, so writers of different stripes never contend;
+ *        - the table doubles incrementally. A new table is linked behind the old one and
+ *          writers move a few buckets each until the old table is empty; buckets that have
+ *          moved are marked so readers follow on to the new table. No operation waits for
+ *          a resize to finish;
+ *        - get_or_insert_with() and compute() run atomically under the stripe lock.
+ *        Keys may be integers, enums, std::string or std::string_view (string-keyed dicts
+ *        accept any string-like lookup), or any type with std::hash and operator==.
+ */
+#pragma once
+#define _EASYCPP_CONCURRENTDICT_VERSION "1.0.0"
+
+#include <String/Hash.h>
+#include <Threading/Threading.h>
+#include <Tracemalloc/Tracemalloc.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace easycpp {
+    namespace concurrentdict {
+        namespace detail {
+            constexpr size_t SCAN_INTERVAL = 64;
+
+            /**
+             * @brief One thread's slot in the epoch domain: 0 while the thread is outside any
+             * read section, otherwise the global epoch it observed on entry. Slots are never
+             * freed; a slot released by an exiting thread is reused by the next new thread.
+             */
+            struct alignas(threading::detail::CACHE_LINE) Participant {
+                std::atomic<uint64_t> epoch{0};
+                std::atomic<bool> in_use{true};
+                Participant* next = nullptr;
+            };
+
+            struct Retired {
+                void* pointer;
+                void (*destroy)(void*);
+                uint64_t epoch;
+            };
+
+            /**
+             * @brief The process-wide epoch domain shared by every ConcurrentDict. It is leaked
+             * on purpose so that threads exiting during static destruction can still use it.
+             */
+            struct Domain {
+                std::atomic<uint64_t> epoch{1};
+                std::atomic<Participant*> participants{nullptr};
+                std::mutex orphans_lock;
+                std::vector<Retired> orphans;
+            };
+
+            inline Domain& domain() {
+                static Domain* instance = new Domain();
+                return *instance;
+            }
+
+            inline Participant* acquire_participant() {
+                Domain& d = domain();
+                for (Participant* p = d.participants.load(std::memory_order_acquire); p; p = p->next) {
+                    bool expected = false;
+                    if (!p->in_use.load(std::memory_order_relaxed) && p->in_use.compare_exchange_strong(expected, true)) return p;
+                }
+                Participant* p = new Participant();
+                p->next = d.participants.load(std::memory_order_relaxed);
+                while (!d.participants.compare_exchange_weak(p->next, p, std::memory_order_release, std::memory_order_relaxed)) {}
+                return p;
+            }
+
+            /**
+             * @brief Advance the global epoch if every active thread has observed the current one.
+             * @return The global epoch after the attempt.
+             */
+            inline uint64_t try_advance() {
+                Domain& d = domain();
+                uint64_t current = d.epoch.load(std::memory_order_seq_cst);
+                for (Participant* p = d.participants.load(std::memory_order_acquire); p; p = p->next) {
+                    uint64_t seen = p->epoch.load(std::memory_order_seq_cst);
+                    if (seen != 0 && seen != current) return current;
+                }
+                d.epoch.compare_exchange_strong(current, current + 1, std::memory_order_seq_cst);
+                return d.epoch.load(std::memory_order_seq_cst);
+            }
+
+            // Free the entries retired at least two epochs ago; no reader can still hold them.
+            inline void reclaim(std::vector<Retired>& list, uint64_t epoch) {
+                size_t kept = 0;
+                for (size_t i = 0; i < list.size(); ++i) {
+                    if (list[i].epoch + 2 <= epoch) list[i].destroy(list[i].pointer);
+                    else list[kept++] = list[i];
+                }
+                list.resize(kept);
+            }
+
+            struct ThreadState {
+                Participant* participant = nullptr;
+                unsigned depth = 0;
+                size_t retired_since_scan = 0;
+                std::vector<Retired> limbo;
+
+                ~ThreadState() {
+                    if (participant == nullptr) return;
+                    Domain& d = domain();
+                    uint64_t epoch = try_advance();
+                    reclaim(limbo, epoch);
+                    if (!limbo.empty()) {
+                        std::lock_guard<std::mutex> lock(d.orphans_lock);
+                        d.orphans.insert(d.orphans.end(), limbo.begin(), limbo.end());
+                    }
+                    participant->epoch.store(0, std::memory_order_release);
+                    participant->in_use.store(false, std::memory_order_release);
+                }
+            };
+
+            inline ThreadState& thread_state() {
+                static thread_local ThreadState state;
+                if (state.participant == nullptr) state.participant = acquire_participant();
+                return state;
+            }
+
+            /**
+             * @class Guard
+             * @brief A read section. Nodes reachable while it is alive stay allocated. Guards nest.
+             */
+            class Guard {
+            private:
+                ThreadState& state;
+
+                static bool equal_or_update(const std::atomic<uint64_t>& global, uint64_t& epoch) {
+                    uint64_t current = global.load(std::memory_order_seq_cst);
+                    if (current == epoch) return true;
+                    epoch = current;
+                    return false;
+                }
+
+            public:
+                Guard() : state(thread_state()) {
+                    if (state.depth++ == 0) {
+                        // Announce the current epoch; retry if it advanced meanwhile, since the
+                        // advance may have skipped this thread and freed what it is about to read.
+                        std::atomic<uint64_t>& global = domain().epoch;
+                        uint64_t epoch = global.load(std::memory_order_seq_cst);
+                        do {
+                            state.participant->epoch.store(epoch, std::memory_order_seq_cst);
+                        } while (!equal_or_update(global, epoch));
+                    }
+                }
+
+                ~Guard() {
+                    if (--state.depth == 0) state.participant->epoch.store(0, std::memory_order_release);
+                }
+
+                Guard(const Guard&) = delete;
+                Guard& operator=(const Guard&) = delete;
+            };
+
+            /**
+             * @brief Free an object once no read section can still reach it. The caller must have
+             * unlinked it already.
+             */
+            template<typename T>
+            void retire(T* pointer) {
+                ThreadState& state = thread_state();
+                Domain& d = domain();
+                state.limbo.push_back({pointer, [](void* p) { delete static_cast<T*>(p); }, d.epoch.load(std::memory_order_seq_cst)});
+                if (++state.retired_since_scan < SCAN_INTERVAL) return;
+                state.retired_since_scan = 0;
+                uint64_t epoch = try_advance();
+                reclaim(state.limbo, epoch);
+                std::unique_lock<std::mutex> lock(d.orphans_lock, std::try_to_lock);
+                if (lock.owns_lock() && !d.orphans.empty()) reclaim(d.orphans, epoch);
+            }
+
+            template<typename K>
+            constexpr bool string_key = std::is_same_v<K, std::string> || std::is_same_v<K, std::string_view>;
+
+            template<typename K, typename Q>
+            concept lookup_key = (string_key<K> && std::is_convertible_v<const Q&, std::string_view>)
+                || (!string_key<K> && std::is_convertible_v<const Q&, const K&>);
+
+            template<typename K, typename Q>
+            decltype(auto) lookup_view(const Q& key) {
+                if constexpr (string_key<K>) return std::string_view(key);
+                else if constexpr (std::is_same_v<Q, K>) return key;
+                else return static_cast<K>(key);
+            }
+
+            template<typename K, typename Q>
+            uint64_t key_hash(const Q& key) {
+                if constexpr (string_key<K>) {
+                    return hash(std::string_view(key));
+                } else if constexpr (std::is_integral_v<K> || std::is_enum_v<K>) {
+                    uint64_t bits;
+                    if constexpr (std::is_enum_v<K>) bits = (uint64_t) static_cast<std::underlying_type_t<K>>(key);
+                    else bits = (uint64_t) key;
+                    return hash_mix(bits ^ 0x9E3779B97F4A7C15ULL);
+                } else {
+                    return hash_mix((uint64_t) std::hash<K>()(key));
+                }
+            }
+
+            inline size_t round_up_power_of_two(size_t n) {
+                size_t result = 1;
+                while (result < n) result <<= 1;
+                return result;
+            }
+        }
+    }
+
+    /**
+     * @class ConcurrentDict
+     * @brief A hash map for caches shared by many threads, with lock-free reads, striped writes
+     * and incremental resizing. Values are copied out on read, so a reader never observes a
+     * value while it is being replaced.
+     * @tparam K The key type.
+     * @tparam V The value type; it must be copy constructible.
+     *
+     * items(), keys() and values() are weakly consistent: each key present throughout the
+     * call is reported exactly once, and concurrent changes may or may not be seen.
+     */
+    template<typename K, typename V>
+    class ConcurrentDict {
+    private:
+        struct Node {
+            uint64_t hash;
+            K key;
+            V value;
+            std::atomic<Node*> next;
+
+            Node(uint64_t hash, K key, V value, Node* next) : hash(hash), key(std::move(key)), value(std::move(value)), next(next) {
+                tracemalloc::detail::allocated(this, sizeof(Node), "Dict");
+            }
+            ~Node() { tracemalloc::detail::freed(this); }
+        };
+
+        struct Table {
+            size_t mask;
+            std::unique_ptr<std::atomic<Node*>[]> buckets;
+            std::atomic<Table*> next{nullptr};
+            std::atomic<size_t> cursor{0};   // next bucket to hand out for migration
+            std::atomic<size_t> moved{0};    // buckets migrated so far
+
+            explicit Table(size_t size) : mask(size - 1), buckets(new std::atomic<Node*>[size]()) {
+                tracemalloc::detail::allocated(buckets.get(), size * sizeof(std::atomic<Node*>), "Dict");
+            }
+            ~Table() { tracemalloc::detail::freed(buckets.get()); }
+            size_t size() const { return mask + 1; }
+        };
+
+        struct Stripe {
+            threading::Lock lock;
+            std::atomic<size_t> count{0};
+        };
+
+        static constexpr size_t MIGRATION_BATCH = 16;
+
+        // Marks an old-table bucket whose nodes have moved to the next table. Never dereferenced.
+        static Node* moved_marker() { return reinterpret_cast<Node*>(uintptr_t(1)); }
+
+        std::atomic<Table*> root;
+        std::unique_ptr<Stripe[]> stripes;
+        size_t stripe_mask;
+
+        Stripe& stripe_of(uint64_t h) const { return stripes[h & stripe_mask]; }
+
+        /**
+         * @brief Copy the nodes of an old bucket into the next table, then mark the bucket as
+         * moved. The caller holds the bucket's stripe lock, which also covers its destination
+         * buckets because the stripe count divides every table size.
+         */
+        void migrate(Table* table, size_t index) {
+            Table* next = table->next.load(std::memory_order_acquire);
+            std::atomic<Node*>& bucket = table->buckets[index];
+            Node* head = bucket.load(std::memory_order_acquire);
+            // The bucket splits into two destinations that nothing else writes yet. The trailing
+            // run of nodes bound for one destination is linked there as is; the nodes before it
+            // are copied, because readers of the old bucket still walk their next pointers.
+            Node* run = head;
+            for (Node* node = head; node; node = node->next.load(std::memory_order_relaxed)) {
+                if ((node->hash & next->mask) != (run->hash & next->mask)) run = node;
+            }
+            if (run) next->buckets[run->hash & next->mask].store(run, std::memory_order_release);
+            for (Node* node = head; node != run; node = node->next.load(std::memory_order_relaxed)) {
+                std::atomic<Node*>& target = next->buckets[node->hash & next->mask];
+                target.store(new Node(node->hash, node->key, node->value, target.load(std::memory_order_relaxed)), std::memory_order_release);
+            }
+            bucket.store(moved_marker(), std::memory_order_release);
+            for (Node* node = head; node != run;) {
+                Node* following = node->next.load(std::memory_order_relaxed);
+                concurrentdict::detail::retire(node);
+                node = following;
+            }
+            if (table->moved.fetch_add(1, std::memory_order_acq_rel) + 1 == table->size()) {
+                Table* expected = table;
+                if (root.compare_exchange_strong(expected, next, std::memory_order_acq_rel)) concurrentdict::detail::retire(table);
+            }
+        }
+
+        /**
+         * @brief Move a batch of old buckets forward, if a resize is in progress. Called by
+         * writers after they release their own stripe lock.
+         */
+        void help_resize() {
+            concurrentdict::detail::Guard guard;
+            Table* table = root.load(std::memory_order_acquire);
+            if (table->next.load(std::memory_order_acquire) == nullptr) return;
+            size_t first = table->cursor.fetch_add(MIGRATION_BATCH, std::memory_order_relaxed);
+            size_t last = std::min(first + MIGRATION_BATCH, table->size());
+            for (size_t index = first; index < last; ++index) {
+                Stripe& stripe = stripes[index & stripe_mask];
+                std::lock_guard<threading::Lock> lock(stripe.lock);
+                if (table->buckets[index].load(std::memory_order_acquire) != moved_marker()) migrate(table, index);
+            }
+        }
+
+        /**
+         * @brief Start doubling the table if the stripe that just grew is over its share.
+         * @return True if a resize is in progress.
+         */
+        bool maybe_grow(const Stripe& stripe) {
+            Table* table = root.load(std::memory_order_acquire);
+            if (table->next.load(std::memory_order_acquire) != nullptr) return true;
+            if (stripe.count.load(std::memory_order_relaxed) <= (table->mask + 1) / (stripe_mask + 1)) return false;
+            Table* bigger = new Table(table->size() * 2);
+            Table* expected = nullptr;
+            if (!table->next.compare_exchange_strong(expected, bigger, std::memory_order_acq_rel)) delete bigger;
+            return true;
+        }
+
+        /**
+         * @brief Find the table that holds a hash's bucket for writing, migrating the bucket
+         * first if a resize is in progress. The caller holds the stripe lock.
+         */
+        Table* writable_table(uint64_t h) {
+            Table* table = root.load(std::memory_order_acquire);
+            while (true) {
+                size_t index = h & table->mask;
+                if (table->buckets[index].load(std::memory_order_acquire) == moved_marker()) {
+                    table = table->next.load(std::memory_order_acquire);
+                    continue;
+                }
+                Table* next = table->next.load(std::memory_order_acquire);
+                if (next == nullptr) return table;
+                migrate(table, index);
+                table = next;
+            }
+        }
+
+        template<typename Q>
+        const Node* find_node(const Q& key, uint64_t h) const {
+            Table* table = root.load(std::memory_order_acquire);
+            while (true) {
+                Node* node = table->buckets[h & table->mask].load(std::memory_order_acquire);
+                if (node == moved_marker()) {
+                    table = table->next.load(std::memory_order_acquire);
+                    continue;
+                }
+                for (; node; node = node->next.load(std::memory_order_acquire)) {
+                    if (node->hash == h && node->key == key) return node;
+                }
+                return nullptr;
+            }
+        }
+
+        /**
+         * @brief Locate the link that points at a key's node (or the bucket's terminating null)
+         * in a writable bucket. The caller holds the stripe lock.
+         */
+        template<typename Q>
+        std::atomic<Node*>* find_link(Table* table, const Q& key, uint64_t h) {
+            std::atomic<Node*>* link = &table->buckets[h & table->mask];
+            for (Node* node = link->load(std::memory_order_relaxed); node; node = link->load(std::memory_order_relaxed)) {
+                if (node->hash == h && node->key == key) return link;
+                link = &node->next;
+            }
+            return link;
+        }
+
+        /**
+         * @brief Run an update on a key's link under its stripe lock, then help a pending resize.
+         * @param update Called as update(table, link, node) where node is the key's node or
+         * nullptr; it returns the change in size (-1, 0 or 1) and the result to hand back.
+         */
+        template<typename Q, typename Update>
+        auto locked_update(const Q& key, Update&& update) {
+            uint64_t h = concurrentdict::detail::key_hash<K>(key);
+            Stripe& stripe = stripe_of(h);
+            concurrentdict::detail::Guard guard;
+            bool resizing;
+            auto result = [&] {
+                std::lock_guard<threading::Lock> lock(stripe.lock);
+                Table* table = writable_table(h);
+                std::atomic<Node*>* link = find_link(table, key, h);
+                auto [delta, value] = update(link, link->load(std::memory_order_relaxed), h);
+                if (delta != 0) stripe.count.store(stripe.count.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+                resizing = delta > 0 ? maybe_grow(stripe) : root.load(std::memory_order_acquire)->next.load(std::memory_order_acquire) != nullptr;
+                return std::move(value);
+            }();
+            if (resizing) help_resize();
+            return result;
+        }
+
+        // Replace a node in place: readers see either the old node or the new one.
+        static void replace(std::atomic<Node*>* link, Node* node, V value) {
+            Node* fresh = new Node(node->hash, node->key, std::move(value), node->next.load(std::memory_order_relaxed));
+            link->store(fresh, std::memory_order_release);
+            concurrentdict::detail::retire(node);
+        }
+
+        static void unlink(std::atomic<Node*>* link, Node* node) {
+            link->store(node->next.load(std::memory_order_relaxed), std::memory_order_release);
+            concurrentdict::detail::retire(node);
+        }
+
+        static void free_chain(Node* node) {
+            while (node && node != moved_marker()) {
+                Node* next = node->next.load(std::memory_order_relaxed);
+                delete node;
+                node = next;
+            }
+        }
+
+        template<typename Visit>
+        void visit(Visit&& visit) const {
+            concurrentdict::detail::Guard guard;
+            Table* table = root.load(std::memory_order_acquire);
+            // Buckets of the previous table seen as moved; only their destinations are read in
+            // the next table, so a node being copied across is never reported twice.
+            std::vector<bool> moved;
+            size_t previous_mask = 0;
+            bool first = true;
+            while (table) {
+                std::vector<bool> moved_here(table->size(), false);
+                bool any_moved = false;
+                for (size_t index = 0; index < table->size(); ++index) {
+                    if (!first && !moved[index & previous_mask]) continue;
+                    Node* node = table->buckets[index].load(std::memory_order_acquire);
+                    if (node == moved_marker()) {
+                        moved_here[index] = any_moved = true;
+                        continue;
+                    }
+                    for (; node; node = node->next.load(std::memory_order_acquire)) visit(*node);
+                }
+                if (!any_moved) break;
+                moved.swap(moved_here);
+                previous_mask = table->mask;
+                first = false;
+                table = table->next.load(std::memory_order_acquire);
+            }
+        }
+
+    public:
+        using key_type = K;
+        using mapped_type = V;
+
+        /**
+         * @brief Construct an empty ConcurrentDict.
+         * @param capacity The expected number of keys; the table starts large enough for them.
+         * @param concurrency The number of lock stripes, rounded up to a power of two. 0 picks
+         * four per hardware thread, at least 64.
+         */
+        explicit ConcurrentDict(size_t capacity = 0, size_t concurrency = 0) {
+            if (concurrency == 0) concurrency = std::max<size_t>(64, 4 * (size_t) std::thread::hardware_concurrency());
+            size_t stripe_count = concurrentdict::detail::round_up_power_of_two(std::min<size_t>(concurrency, 1 << 16));
+            stripes.reset(new Stripe[stripe_count]);
+            stripe_mask = stripe_count - 1;
+            size_t size = concurrentdict::detail::round_up_power_of_two(std::max(stripe_count, capacity + capacity / 3));
+            root.store(new Table(size), std::memory_order_release);
+        }
+
+        ConcurrentDict(std::initializer_list<std::pair<K, V>> init) : ConcurrentDict(init.size()) {
+            for (const auto& [key, value] : init) set(key, value);
+        }
+
+        ConcurrentDict(const ConcurrentDict&) = delete;
+        ConcurrentDict& operator=(const ConcurrentDict&) = delete;
+
+        /**
+         * @brief Destroy the dict. No other thread may be using it.
+         */
+        ~ConcurrentDict() {
+            Table* table = root.load(std::memory_order_acquire);
+            while (table) {
+                for (size_t index = 0; index < table->size(); ++index) free_chain(table->buckets[index].load(std::memory_order_relaxed));
+                Table* next = table->next.load(std::memory_order_relaxed);
+                delete table;
+                table = next;
+            }
+        }
+
+        /**
+         * @brief Look up a key without locking.
+         * @return A copy of the value, or std::nullopt if the key is absent.
+         */
+        template<typename Q> requires concurrentdict::detail::lookup_key<K, Q>
+        std::optional<V> get(const Q& key) const {
+            decltype(auto) view = concurrentdict::detail::lookup_view<K>(key);
+            concurrentdict::detail::Guard guard;
+            const Node* node = find_node(view, concurrentdict::detail::key_hash<K>(view));
+            if (node == nullptr) return std::nullopt;
+            return node->value;
+        }
+
+        /**
+         * @brief Look up a key, returning a default if it is absent.
+         */
+        template<typename Q> requires concurrentdict::detail::lookup_key<K, Q>
+        V get(const Q& key, V fallback) const {
+            std::optional<V> value = get(key);
+            return value ? std::move(*value) : std::move(fallback);
+        }
+
+        /**
+         * @brief Look up a key.
+         * @throw std::out_of_range If the key is absent.
+         */
+        template<typename Q> requires concurrentdict::detail::lookup_key<K, Q>
+        V at(const Q& key) const {
+            std::optional<V> value = get(key);
+            if (!value) throw std::out_of_range("ConcurrentDict: key not found");
+            return std::move(*value);
+        }
+
+        template<typename Q> requires concurrentdict::detail::lookup_key<K, Q>
+        bool contains(const Q& key) const {
+            decltype(auto) view = concurrentdict::detail::lookup_view<K>(key);
+            concurrentdict::detail::Guard guard;
+            return find_node(view, concurrentdict::detail::key_hash<K>(view)) != nullptr;
+        }
+
+        /**
+         * @brief Insert or replace a value.
+         */
+        void set(const K& key, V value) {
+            locked_update(key, [&](std::atomic<Node*>* link, Node* node, uint64_t h) {
+                if (node) {
+                    replace(link, node, std::move(value));
+                    return std::pair<int, bool>(0, false);
+                }
+                link->store(new Node(h, key, std::move(value), nullptr), std::memory_order_release);
+                return std::pair<int, bool>(1, true);
+            });
+        }
+
+        /**
+         * @brief Insert a value if the key is absent.
+         * @return True if the value was inserted.
+         */
+        bool insert(const K& key, V value) {
+            return locked_update(key, [&](std::atomic<Node*>* link, Node* node, uint64_t h) {
+                if (node) return std::pair<int, bool>(0, false);
+                link->store(new Node(h, key, std::move(value), nullptr), std::memory_order_release);
+                return std::pair<int, bool>(1, true);
+            });
+        }
+
+        /**
+         * @brief Get a key's value, creating it with make() if the key is absent. make() runs at
+         * most once per insertion, under the key's stripe lock, so it must not use this dict.
+         * @param key The key.
+         * @param make Called with no arguments; returns the value to insert.
+         * @return A copy of the value now stored.
+         */
+        template<typename Make>
+        V get_or_insert_with(const K& key, Make&& make) {
+            if (std::optional<V> value = get(key)) return std::move(*value);
+            return locked_update(key, [&](std::atomic<Node*>* link, Node* node, uint64_t h) {
+                if (node) return std::pair<int, V>(0, node->value);
+                Node* fresh = new Node(h, key, make(), nullptr);
+                link->store(fresh, std::memory_order_release);
+                return std::pair<int, V>(1, fresh->value);
+            });
+        }
+
+        /**
+         * @brief Atomically recompute a key's value under its stripe lock, which must not be used
+         * to access this dict.
+         * @param key The key.
+         * @param compute Called with a pointer to the current value, or nullptr if the key is
+         * absent; returns the new value, or std::nullopt to remove the key.
+         * @return The new value, or std::nullopt if the key is now absent.
+         */
+        template<typename Compute>
+        std::optional<V> compute(const K& key, Compute&& compute) {
+            return locked_update(key, [&](std::atomic<Node*>* link, Node* node, uint64_t h) {
+                std::optional<V> result = compute(node ? &node->value : static_cast<const V*>(nullptr));
+                if (!result) {
+                    if (node) unlink(link, node);
+                    return std::pair<int, std::optional<V>>(node ? -1 : 0, std::nullopt);
+                }
+                if (node) {
+                    replace(link, node, *result);
+                    return std::pair<int, std::optional<V>>(0, std::move(result));
+                }
+                link->store(new Node(h, key, *result, nullptr), std::memory_order_release);
+                return std::pair<int, std::optional<V>>(1, std::move(result));
+            });
+        }
+
+        /**
+         * @brief Remove a key and return its value.
+         * @return The removed value, or std::nullopt if the key was absent.
+         */
+        template<typename Q> requires concurrentdict::detail::lookup_key<K, Q>
+        std::optional<V> pop(const Q& key) {
+            decltype(auto) view = concurrentdict::detail::lookup_view<K>(key);
+            return locked_update(view, [&](std::atomic<Node*>* link, Node* node, uint64_t) {
+                if (node == nullptr) return std::pair<int, std::optional<V>>(0, std::nullopt);
+                std::optional<V> value = node->value;
+                unlink(link, node);
+                return std::pair<int, std::optional<V>>(-1, std::move(value));
+            });
+        }
+
+        /**
+         * @brief Remove a key.
+         * @return True if the key was present.
+         */
+        template<typename Q> requires concurrentdict::detail::lookup_key<K, Q>
+        bool erase(const Q& key) {
+            return pop(key).has_value();
+        }
+
+        /**
+         * @brief Remove every key. Concurrent readers see either the old or the empty table.
+         */
+        void clear() {
+            for (size_t i = 0; i <= stripe_mask; ++i) stripes[i].lock.acquire();
+            Table* table = root.load(std::memory_order_acquire);
+            Table* empty = new Table(stripe_mask + 1);
+            root.store(empty, std::memory_order_release);
+            while (table) {
+                // Readers still on the last old table follow its moved buckets on to the empty
+                // one; on failure the exchange loads the table that follows.
+                Table* next = nullptr;
+                table->next.compare_exchange_strong(next, empty, std::memory_order_acq_rel);
+                for (size_t index = 0; index < table->size(); ++index) {
+                    // Mark every old bucket as moved so a late migration helper leaves it alone.
+                    Node* node = table->buckets[index].exchange(moved_marker(), std::memory_order_acq_rel);
+                    while (node && node != moved_marker()) {
+                        Node* following = node->next.load(std::memory_order_relaxed);
+                        concurrentdict::detail::retire(node);
+                        node = following;
+                    }
+                }
+                concurrentdict::detail::retire(table);
+                table = next;
+            }
+            for (size_t i = 0; i <= stripe_mask; ++i) {
+                stripes[i].count.store(0, std::memory_order_relaxed);
+                stripes[i].lock.release();
+            }
+        }
+
+        /**
+         * @brief The number of keys. Exact when no write is in progress.
+         */
+        size_t size() const {
+            size_t total = 0;
+            for (size_t i = 0; i <= stripe_mask; ++i) total += stripes[i].count.load(std::memory_order_relaxed);
+            return total;
+        }
+
+        bool empty() const { return size() == 0; }
+
+        /**
+         * @brief A weakly consistent snapshot of the key/value pairs.
+         */
+        std::vector<std::pair<K, V>> items() const {
+            std::vector<std::pair<K, V>> result;
+            visit([&](const Node& node) { result.emplace_back(node.key, node.value); });
+            return result;
+        }
+
+        std::vector<K> keys() const {
+            std::vector<K> result;
+            visit([&](const Node& node) { result.push_back(node.key); });
+            return result;
+        }
+
+        std::vector<V> values() const {
+            std::vector<V> result;
+            visit([&](const Node& node) { result.push_back(node.value); });
+            return result;
+        }
+    };
+}
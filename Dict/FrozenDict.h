@@ -0,0 +1,487 @@
+// EasyCpp - FrozenDict : Immutable Dictionaries with Minimal Perfect Hashing
+// Copyright (C) 2025  C14147
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+/**
+ * @file EasyCpp/Dict/FrozenDict.h
+ * @brief This file implements FrozenDict, a read-only dictionary for lookup tables that are
+ *        built once and queried often (routing tables, code tables). The keys are laid out with
+ *        a minimal perfect hash in the style of CHD: each key hashes to a small bucket, and each
+ *        bucket stores a 32-bit pilot that sends its keys to distinct slots of a table with
+ *        exactly one slot per key. The key/value pairs live contiguously in slot order, so a
+ *        lookup is one hash, one pilot read, one probe and one key compare, with no chains and
+ *        no empty slots.
+ *        StaticFrozenDict is the same table built at compile time by make_frozen_dict() for
+ *        literal tables; its lookups are constexpr as well.
+ *        Keys may be integers, enums, std::string or std::string_view. String-keyed tables can be
+ *        queried with any string-like value without building a std::string.
+ */
+#pragma once
+#define _EASYCPP_FROZENDICT_VERSION "1.0.0"
+
+#include <String/Hash.h>
+#include <Tracemalloc/Tracemalloc.h>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <initializer_list>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace easycpp {
+    namespace frozendict {
+        namespace detail {
+            /// Pilot flag for single-key buckets, whose pilot stores the slot directly.
+            constexpr uint32_t DIRECT = 0x80000000u;
+            constexpr uint32_t MAX_PILOT = 1u << 20;
+            constexpr uint64_t MAX_SEEDS = 64;
+            constexpr uint64_t PILOT_MUL = 0x9E3779B97F4A7C15ULL;
+
+            template<typename K>
+            constexpr bool string_key = std::is_same_v<K, std::string> || std::is_same_v<K, std::string_view>;
+
+            template<typename K>
+            constexpr bool integer_key = std::is_integral_v<K> || std::is_enum_v<K>;
+
+            /**
+             * @brief Hash a key. Strings hash by their characters, so std::string and
+             * std::string_view keys agree.
+             */
+            inline constexpr uint64_t key_hash(std::string_view key, uint64_t seed) {
+                return hash(key, seed);
+            }
+
+            template<typename T> requires integer_key<T>
+            constexpr uint64_t key_hash(T key, uint64_t seed) {
+                uint64_t bits;
+                if constexpr (std::is_enum_v<T>) bits = (uint64_t) static_cast<std::underlying_type_t<T>>(key);
+                else bits = (uint64_t) key;
+                return hash_mix(bits ^ hash_mix(seed ^ PILOT_MUL));
+            }
+
+            /**
+             * @brief Map the low 32 bits of x onto [0, n) without a division.
+             */
+            constexpr size_t reduce(uint64_t x, size_t n) {
+                return (size_t) ((uint64_t) (uint32_t) x * (uint64_t) n >> 32);
+            }
+
+            /// About three keys per bucket: 1.33 bytes of pilots per key, and quick pilot searches.
+            constexpr size_t bucket_count(size_t n) {
+                return n / 3 + 1;
+            }
+
+            constexpr size_t bucket_of(uint64_t h, size_t buckets) {
+                return reduce(h >> 32, buckets);
+            }
+
+            constexpr size_t slot_of(uint64_t h, uint32_t pilot, size_t n) {
+                if (pilot & DIRECT) return pilot & ~DIRECT;
+                return reduce(hash_mix(h ^ ((uint64_t) (pilot + 1) * PILOT_MUL)), n);
+            }
+
+            /**
+             * @brief Find the slot of a key, or n if the table is empty.
+             */
+            constexpr size_t probe(uint64_t h, const uint32_t* pilots, size_t buckets, size_t n) {
+                if (n == 0) return 0;
+                return slot_of(h, pilots[bucket_of(h, buckets)], n);
+            }
+
+            /**
+             * @brief Try to place every key with one seed. The buckets are placed largest first;
+             * a bucket gets the first pilot that sends all its keys to free slots, and single-key
+             * buckets, which come last, take the remaining free slots directly.
+             * @param hashes The key hashes under this seed.
+             * @param pilots Receives one pilot per bucket.
+             * @param order Receives, for each slot, the index of the key placed there.
+             * @return The bucket that could not be placed, or the number of buckets on success.
+             */
+            constexpr size_t place(const std::vector<uint64_t>& hashes, std::vector<uint32_t>& pilots, std::vector<uint32_t>& order) {
+                size_t n = hashes.size();
+                size_t buckets = pilots.size();
+                std::vector<uint32_t> start(buckets + 1, 0);
+                for (uint64_t h : hashes) ++start[bucket_of(h, buckets) + 1];
+                for (size_t b = 0; b < buckets; ++b) start[b + 1] += start[b];
+                std::vector<uint32_t> members(n);
+                std::vector<uint32_t> cursor(start.begin(), start.end() - 1);
+                for (size_t i = 0; i < n; ++i) members[cursor[bucket_of(hashes[i], buckets)]++] = (uint32_t) i;
+
+                std::vector<uint32_t> by_size(buckets);
+                for (size_t b = 0; b < buckets; ++b) by_size[b] = (uint32_t) b;
+                std::sort(by_size.begin(), by_size.end(), [&](uint32_t a, uint32_t b) {
+                    uint32_t size_a = start[a + 1] - start[a], size_b = start[b + 1] - start[b];
+                    return size_a != size_b ? size_a > size_b : a < b;
+                });
+
+                constexpr uint32_t FREE = 0xFFFFFFFFu;
+                order.assign(n, FREE);
+                std::vector<size_t> slots;
+                size_t next_free = 0;
+                for (uint32_t b : by_size) {
+                    size_t first = start[b], size = start[b + 1] - first;
+                    if (size == 0) break;
+                    if (size == 1) {
+                        while (order[next_free] != FREE) ++next_free;
+                        order[next_free] = members[first];
+                        pilots[b] = DIRECT | (uint32_t) next_free;
+                        continue;
+                    }
+                    bool placed = false;
+                    for (uint32_t pilot = 0; pilot < MAX_PILOT && !placed; ++pilot) {
+                        slots.clear();
+                        placed = true;
+                        for (size_t i = first; i < first + size && placed; ++i) {
+                            size_t slot = slot_of(hashes[members[i]], pilot, n);
+                            placed = order[slot] == FREE && std::find(slots.begin(), slots.end(), slot) == slots.end();
+                            slots.push_back(slot);
+                        }
+                        if (!placed) continue;
+                        for (size_t i = 0; i < size; ++i) order[slots[i]] = members[first + i];
+                        pilots[b] = pilot;
+                    }
+                    if (!placed) {
+                        order.assign(n, FREE);
+                        return b;
+                    }
+                }
+                return buckets;
+            }
+
+            /**
+             * @brief Build the layout for n keys.
+             * @param n The number of keys.
+             * @param key_at Returns the i-th key.
+             * @param pilots Receives bucket_count(n) pilots.
+             * @param order Receives, for each slot, the index of the key placed there.
+             * @return The seed the keys must be hashed with.
+             * @throw std::invalid_argument If a key occurs twice.
+             * @throw std::length_error If there are too many keys.
+             */
+            template<typename KeyAt>
+            constexpr uint64_t build(size_t n, const KeyAt& key_at, std::vector<uint32_t>& pilots, std::vector<uint32_t>& order) {
+                if (n >= DIRECT) throw std::length_error("FrozenDict: too many keys");
+                pilots.assign(bucket_count(n), 0);
+                std::vector<uint64_t> hashes(n);
+                for (uint64_t seed = 0; seed < MAX_SEEDS; ++seed) {
+                    for (size_t i = 0; i < n; ++i) hashes[i] = key_hash(key_at(i), seed);
+                    size_t failed = place(hashes, pilots, order);
+                    if (failed == pilots.size()) return seed;
+                    // A bucket nearly always fails because two of its keys are equal; otherwise
+                    // their full 64-bit hashes collided and another seed separates them.
+                    std::vector<size_t> keys;
+                    for (size_t i = 0; i < n; ++i) {
+                        if (bucket_of(hashes[i], pilots.size()) != failed) continue;
+                        for (size_t j : keys) {
+                            if (key_at(i) == key_at(j)) throw std::invalid_argument("FrozenDict: duplicate key");
+                        }
+                        keys.push_back(i);
+                    }
+                }
+                throw std::runtime_error("FrozenDict: cannot build the perfect hash");
+            }
+
+            /**
+             * @brief The key lookups a table accepts: any string-like value for string keys, the
+             * key type itself otherwise.
+             */
+            template<typename K, typename Q>
+            concept lookup_key = (string_key<K> && std::is_convertible_v<const Q&, std::string_view>)
+                || (!string_key<K> && std::is_convertible_v<const Q&, K>);
+
+            template<typename K, typename Q>
+            constexpr auto lookup_view(const Q& key) {
+                if constexpr (string_key<K>) return std::string_view(key);
+                else return static_cast<K>(key);
+            }
+        }
+    }
+
+    /**
+     * @class FrozenDict
+     * @brief An immutable dictionary built once into a minimal perfect hash table.
+     * @tparam K The key type: an integer, an enum, std::string or std::string_view.
+     * @tparam V The value type.
+     *
+     * Iteration visits the items in slot order, which is unrelated to insertion order.
+     */
+    template<typename K, typename V>
+    class FrozenDict {
+        static_assert(frozendict::detail::string_key<K> || frozendict::detail::integer_key<K>,
+                      "FrozenDict: keys must be integers, enums, std::string or std::string_view");
+
+    public:
+        using key_type = K;
+        using mapped_type = V;
+        using value_type = std::pair<K, V>;
+        using const_iterator = const value_type*;
+
+    private:
+        std::vector<value_type> items;
+        std::vector<uint32_t> pilots;
+        uint64_t seed = 0;
+
+        // Report the slot and pilot tables to tracemalloc under "Dict", as containers do.
+        void track() const {
+            tracemalloc::detail::allocated(items.data(), items.capacity() * sizeof(value_type), "Dict");
+            tracemalloc::detail::allocated(pilots.data(), pilots.capacity() * sizeof(uint32_t), "Dict");
+        }
+
+        void untrack() const {
+            tracemalloc::detail::freed(items.data());
+            tracemalloc::detail::freed(pilots.data());
+        }
+
+    public:
+        /**
+         * @brief Construct an empty FrozenDict.
+         */
+        FrozenDict() = default;
+
+        FrozenDict(const FrozenDict& other) : items(other.items), pilots(other.pilots), seed(other.seed) {
+            track();
+        }
+
+        // The tables move with their buffers, so their traces stay valid.
+        FrozenDict(FrozenDict&& other) noexcept = default;
+
+        FrozenDict& operator=(const FrozenDict& other) {
+            if (this != &other) *this = FrozenDict(other);
+            return *this;
+        }
+
+        FrozenDict& operator=(FrozenDict&& other) noexcept {
+            if (this != &other) {
+                untrack();
+                items = std::move(other.items);
+                pilots = std::move(other.pilots);
+                seed = other.seed;
+            }
+            return *this;
+        }
+
+        ~FrozenDict() {
+            untrack();
+        }
+
+        /**
+         * @brief Build a FrozenDict from a range of key/value pairs.
+         * @param first The first pair.
+         * @param last One past the last pair.
+         * @throw std::invalid_argument If a key occurs twice.
+         */
+        template<typename It>
+        FrozenDict(It first, It last) {
+            std::vector<value_type> input;
+            for (; first != last; ++first) input.emplace_back(first->first, first->second);
+            std::vector<uint32_t> order;
+            seed = frozendict::detail::build(input.size(), [&](size_t i) -> const K& { return input[i].first; }, pilots, order);
+            items.reserve(input.size());
+            for (uint32_t index : order) items.push_back(std::move(input[index]));
+            track();
+        }
+
+        /**
+         * @brief Build a FrozenDict from key/value pairs.
+         * @param init The pairs, e.g. {{"GET", 1}, {"POST", 2}}.
+         * @throw std::invalid_argument If a key occurs twice.
+         */
+        FrozenDict(std::initializer_list<value_type> init) : FrozenDict(init.begin(), init.end()) {}
+
+        /**
+         * @brief Build a FrozenDict from a map, e.g. a std::unordered_map or std::map.
+         * @param map The map.
+         */
+        template<typename Map> requires requires (const Map& m) { std::begin(m)->first; std::begin(m)->second; }
+        explicit FrozenDict(const Map& map) : FrozenDict(std::begin(map), std::end(map)) {}
+
+        /**
+         * @brief Find an item.
+         * @param key The key.
+         * @return An iterator to the item, or end() if the key is absent.
+         */
+        template<typename Q> requires frozendict::detail::lookup_key<K, Q>
+        const_iterator find(const Q& key) const {
+            auto view = frozendict::detail::lookup_view<K>(key);
+            size_t slot = frozendict::detail::probe(frozendict::detail::key_hash(view, seed), pilots.data(), pilots.size(), items.size());
+            if (slot < items.size() && items[slot].first == view) return items.data() + slot;
+            return end();
+        }
+
+        /**
+         * @brief Check whether a key is present.
+         */
+        template<typename Q> requires frozendict::detail::lookup_key<K, Q>
+        bool contains(const Q& key) const {
+            return find(key) != end();
+        }
+
+        /**
+         * @brief Get the value of a key.
+         * @throw std::out_of_range If the key is absent.
+         */
+        template<typename Q> requires frozendict::detail::lookup_key<K, Q>
+        const V& at(const Q& key) const {
+            const_iterator it = find(key);
+            if (it == end()) throw std::out_of_range("FrozenDict: key not found");
+            return it->second;
+        }
+
+        template<typename Q> requires frozendict::detail::lookup_key<K, Q>
+        const V& operator[](const Q& key) const {
+            return at(key);
+        }
+
+        /**
+         * @brief Get the value of a key, or a default if the key is absent.
+         */
+        template<typename Q> requires frozendict::detail::lookup_key<K, Q>
+        V get(const Q& key, V fallback = V()) const {
+            const_iterator it = find(key);
+            return it == end() ? fallback : it->second;
+        }
+
+        size_t size() const { return items.size(); }
+        bool empty() const { return items.empty(); }
+
+        /**
+         * @brief The keys, in slot order.
+         */
+        std::vector<K> keys() const {
+            std::vector<K> result;
+            result.reserve(items.size());
+            for (const value_type& item : items) result.push_back(item.first);
+            return result;
+        }
+
+        /**
+         * @brief The values, in slot order.
+         */
+        std::vector<V> values() const {
+            std::vector<V> result;
+            result.reserve(items.size());
+            for (const value_type& item : items) result.push_back(item.second);
+            return result;
+        }
+
+        /**
+         * @brief The approximate memory footprint in bytes, excluding heap memory owned by the
+         * keys and values.
+         */
+        size_t memory_usage() const {
+            return sizeof(*this) + items.capacity() * sizeof(value_type) + pilots.capacity() * sizeof(uint32_t);
+        }
+
+        const_iterator begin() const { return items.data(); }
+        const_iterator end() const { return items.data() + items.size(); }
+    };
+
+    /**
+     * @class StaticFrozenDict
+     * @brief A FrozenDict of N literal items whose table is built at compile time; create one with
+     * make_frozen_dict(). Lookups are constexpr too.
+     * @tparam K The key type: an integer, an enum or std::string_view.
+     * @tparam V The value type, which must be a literal type.
+     * @tparam N The number of items.
+     */
+    template<typename K, typename V, size_t N>
+    class StaticFrozenDict {
+        static_assert(!std::is_same_v<K, std::string>, "StaticFrozenDict: use std::string_view keys");
+        static_assert(frozendict::detail::string_key<K> || frozendict::detail::integer_key<K>,
+                      "StaticFrozenDict: keys must be integers, enums or std::string_view");
+
+    public:
+        using key_type = K;
+        using mapped_type = V;
+        using value_type = std::pair<K, V>;
+        using const_iterator = const value_type*;
+
+        std::array<value_type, N> items{};
+        std::array<uint32_t, frozendict::detail::bucket_count(N)> pilots{};
+        uint64_t seed = 0;
+
+        /**
+         * @brief Build the table; use make_frozen_dict() in a constant expression.
+         * @throw std::invalid_argument If a key occurs twice (a compile error in a constant expression).
+         */
+        constexpr explicit StaticFrozenDict(const value_type (&input)[N]) {
+            std::vector<uint32_t> pilot_list, order;
+            seed = frozendict::detail::build(N, [&](size_t i) -> const K& { return input[i].first; }, pilot_list, order);
+            for (size_t b = 0; b < pilots.size(); ++b) pilots[b] = pilot_list[b];
+            for (size_t slot = 0; slot < N; ++slot) items[slot] = input[order[slot]];
+        }
+
+        template<typename Q> requires frozendict::detail::lookup_key<K, Q>
+        constexpr const_iterator find(const Q& key) const {
+            auto view = frozendict::detail::lookup_view<K>(key);
+            size_t slot = frozendict::detail::probe(frozendict::detail::key_hash(view, seed), pilots.data(), pilots.size(), N);
+            if (slot < N && items[slot].first == view) return items.data() + slot;
+            return end();
+        }
+
+        template<typename Q> requires frozendict::detail::lookup_key<K, Q>
+        constexpr bool contains(const Q& key) const {
+            return find(key) != end();
+        }
+
+        /**
+         * @brief Get the value of a key.
+         * @throw std::out_of_range If the key is absent.
+         */
+        template<typename Q> requires frozendict::detail::lookup_key<K, Q>
+        constexpr const V& at(const Q& key) const {
+            const_iterator it = find(key);
+            if (it == end()) throw std::out_of_range("StaticFrozenDict: key not found");
+            return it->second;
+        }
+
+        template<typename Q> requires frozendict::detail::lookup_key<K, Q>
+        constexpr const V& operator[](const Q& key) const {
+            return at(key);
+        }
+
+        template<typename Q> requires frozendict::detail::lookup_key<K, Q>
+        constexpr V get(const Q& key, V fallback = V()) const {
+            const_iterator it = find(key);
+            return it == end() ? fallback : it->second;
+        }
+
+        constexpr size_t size() const { return N; }
+        constexpr bool empty() const { return N == 0; }
+        constexpr const_iterator begin() const { return items.data(); }
+        constexpr const_iterator end() const { return items.data() + N; }
+    };
+
+    /**
+     * @brief Build a StaticFrozenDict, at compile time when used in a constant expression:
+     * @code
+     * constexpr auto methods = easycpp::make_frozen_dict<std::string_view, int>({{"GET", 1}, {"POST", 2}});
+     * static_assert(methods.at("POST") == 2);
+     * @endcode
+     * @param items The key/value pairs.
+     * @return The table.
+     */
+    template<typename K, typename V, size_t N>
+    constexpr StaticFrozenDict<K, V, N> make_frozen_dict(const std::pair<K, V> (&items)[N]) {
+        return StaticFrozenDict<K, V, N>(items);
+    }
+}
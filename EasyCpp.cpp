@@ -0,0 +1,63 @@
+// EasyCpp - Library Translation Unit
+// Copyright (C) 2025  C14147
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+/**
+ * @file EasyCpp/EasyCpp.cpp
+ * @brief The single translation unit of libeasycpp. It compiles {fmt} once and
+ *        provides the common String::format instantiations declared extern in String.h.
+ *        Build it through CMakeLists.txt; consumers then define EASYCPP_LIBRARY.
+ */
+#ifndef EASYCPP_LIBRARY
+#define EASYCPP_LIBRARY
+#endif
+#define IMPORT_EASYCPP_ALL
+#include "EasyCpp.h"
+
+#include <Packages/fmt/format-inl.h>
+
+FMT_BEGIN_NAMESPACE
+namespace detail {
+    // Same explicit instantiations as {fmt}'s own src/format.cc.
+    template FMT_API auto dragonbox::to_decimal(float x) noexcept -> dragonbox::decimal_fp<float>;
+    template FMT_API auto dragonbox::to_decimal(double x) noexcept -> dragonbox::decimal_fp<double>;
+
+#if FMT_USE_LOCALE
+    template FMT_API locale_ref::locale_ref(const std::locale& loc);
+    template FMT_API auto locale_ref::get<std::locale>() const -> std::locale;
+#endif
+
+    template FMT_API auto thousands_sep_impl(locale_ref) -> thousands_sep_result<char>;
+    template FMT_API auto decimal_point_impl(locale_ref) -> char;
+    template FMT_API void buffer<char>::append(const char*, const char*);
+    template FMT_API void vformat_to(buffer<char>&, string_view, typename vformat_args<>::type, locale_ref);
+
+    template FMT_API auto thousands_sep_impl(locale_ref) -> thousands_sep_result<wchar_t>;
+    template FMT_API auto decimal_point_impl(locale_ref) -> wchar_t;
+    template FMT_API void buffer<wchar_t>::append(const wchar_t*, const wchar_t*);
+}
+FMT_END_NAMESPACE
+
+namespace easycpp {
+    template String String::format<int>(const int&) const;
+    template String String::format<long long>(const long long&) const;
+    template String String::format<size_t>(const size_t&) const;
+    template String String::format<double>(const double&) const;
+    template String String::format<const char*>(const char* const&) const;
+    template String String::format<String>(const String&) const;
+    template String String::format<std::string>(const std::string&) const;
+    template String String::format<const char*, const char*>(const char* const&, const char* const&) const;
+}
@@ -0,0 +1,281 @@
+// EasyCpp - C++20 Module Interface
+// Copyright (C) 2025  C14147
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+/**
+ * @file EasyCpp/EasyCpp.cppm
+ * @brief Optional C++20 module interface. `import easycpp;` parses the headers once per
+ *        build instead of once per translation unit. Macros (WRITE, READ, str, ...) are not
+ *        exported by modules; use the string literals they stand for.
+ *        Enable it with -DEASYCPP_BUILD_MODULE=ON.
+ */
+module;
+
+#ifndef EASYCPP_LIBRARY
+#define EASYCPP_LIBRARY
+#endif
+#define IMPORT_EASYCPP_ALL
+#include "EasyCpp.h"
+
+export module easycpp;
+
+export namespace easycpp {
+    // Compress
+    namespace zlib {
+        using easycpp::zlib::adler32;
+        using easycpp::zlib::crc32;
+        using easycpp::zlib::deflate;
+        using easycpp::zlib::inflate;
+        using easycpp::zlib::compress;
+        using easycpp::zlib::decompress;
+    }
+    namespace base64 {
+        using easycpp::base64::b64encode;
+        using easycpp::base64::b64decode;
+    }
+    namespace tarfile {
+        using easycpp::tarfile::TarInfo;
+        using easycpp::tarfile::TarFile;
+        using easycpp::tarfile::open;
+        using easycpp::tarfile::is_tarfile;
+    }
+    namespace zipfile {
+        using easycpp::zipfile::ZIP_STORED;
+        using easycpp::zipfile::ZIP_DEFLATED;
+        using easycpp::zipfile::ZipInfo;
+        using easycpp::zipfile::ZipExtFile;
+        using easycpp::zipfile::ZipFile;
+        using easycpp::zipfile::is_zipfile;
+    }
+
+    // Config
+    namespace config {
+        using easycpp::config::Type;
+        using easycpp::config::Style;
+        using easycpp::config::Value;
+        using easycpp::config::Document;
+    }
+    namespace configparser {
+        using easycpp::configparser::ConfigParser;
+    }
+    namespace toml {
+        using easycpp::toml::loads;
+        using easycpp::toml::load;
+    }
+    namespace yaml {
+        using easycpp::yaml::safe_load;
+        using easycpp::yaml::safe_load_file;
+    }
+
+    // Csv
+    namespace csv {
+        using easycpp::csv::reader;
+    }
+
+    // DataFrame
+    using easycpp::Column;
+    using easycpp::Agg;
+    using easycpp::DataFrame;
+    using easycpp::GroupBy;
+
+    // Dict
+    using easycpp::ConcurrentDict;
+    using easycpp::FrozenDict;
+    using easycpp::StaticFrozenDict;
+    using easycpp::make_frozen_dict;
+
+    // FileOperator
+    using easycpp::is_exist;
+    using easycpp::is_readable;
+    using easycpp::is_writable;
+    using easycpp::is_executable;
+    using easycpp::check_permission;
+    using easycpp::FileNotExistError;
+    using easycpp::FilePermissionError;
+    using easycpp::FileWriteError;
+    using easycpp::FileUnknownError;
+    using easycpp::File;
+    using easycpp::open;
+    using easycpp::MappedFile;
+    using easycpp::mmap;
+    using easycpp::ByteWriter;
+    using easycpp::ByteReader;
+    using easycpp::write_record;
+    using easycpp::read_record;
+    using easycpp::sort_file;
+
+    // FuncOptimize
+    using easycpp::print;
+
+    // HdrHistogram
+    using easycpp::HdrPercentile;
+    using easycpp::BasicHdrHistogram;
+    using easycpp::HdrHistogram;
+    using easycpp::AtomicHdrHistogram;
+    using easycpp::HdrScopedTimer;
+    using easycpp::record_timeit;
+    using easycpp::HdrLogWriter;
+    using easycpp::HdrLogReader;
+
+    // Html
+    namespace html {
+        using easycpp::html::escape;
+        using easycpp::html::unescape;
+    }
+
+    // Http
+    namespace http {
+        using easycpp::http::Header;
+        using easycpp::http::Request;
+        using easycpp::http::Response;
+        using easycpp::http::Handler;
+#ifdef __linux__
+        using easycpp::http::Server;
+#endif
+    }
+
+    // List
+    using easycpp::List;
+    using easycpp::AppendList;
+    using easycpp::SpillCodec;
+    using easycpp::SpillList;
+
+    // NDArray
+    using easycpp::DType;
+    using easycpp::itemsize;
+    using easycpp::dtype_of;
+    using easycpp::NDArray;
+
+    // Profile
+    namespace profile {
+        using easycpp::profile::Span;
+        using easycpp::profile::FunctionStats;
+        using easycpp::profile::Stats;
+        using easycpp::profile::is_running;
+        using easycpp::profile::start;
+        using easycpp::profile::stop;
+    }
+
+    // Quantile
+    using easycpp::TDigest;
+    using easycpp::KLL;
+
+    // Sketch
+    namespace sketch {
+        using easycpp::sketch::key_hash;
+        using easycpp::sketch::BloomFilter;
+        using easycpp::sketch::HyperLogLog;
+        using easycpp::sketch::CountMinSketch;
+        using easycpp::sketch::CountSketch;
+    }
+
+    // String
+    using easycpp::String;
+    using easycpp::fixed_string;
+    using easycpp::literals::operator""_s;
+    using easycpp::hash_mix;
+    using easycpp::hash_bytes;
+    using easycpp::hash;
+
+    // System
+    namespace os {
+        using easycpp::os::CpuInfo;
+        using easycpp::os::CacheInfo;
+        using easycpp::os::CpuTopology;
+        using easycpp::os::cpu_topology;
+        using easycpp::os::cpu_count;
+        using easycpp::os::sched_getaffinity;
+        using easycpp::os::sched_setaffinity;
+    }
+
+    // TextIndex
+    using easycpp::BlockCodec;
+    using easycpp::TextSegment;
+    using easycpp::PostingCursor;
+    using easycpp::TextIndex;
+
+    // Threading
+    using easycpp::ThreadPool;
+    namespace threading {
+        using easycpp::threading::ContentionStats;
+        using easycpp::threading::BrokenBarrierError;
+        using easycpp::threading::Lock;
+        using easycpp::threading::RLock;
+        using easycpp::threading::Condition;
+        using easycpp::threading::Semaphore;
+        using easycpp::threading::BoundedSemaphore;
+        using easycpp::threading::Event;
+        using easycpp::threading::Barrier;
+    }
+
+    // Timeit
+    using easycpp::do_not_optimize;
+    using easycpp::TscClock;
+    using easycpp::PerfCounters;
+    using easycpp::PerfEventGroup;
+    using easycpp::TimeitResult;
+    using easycpp::Timer;
+    using easycpp::timeit;
+
+    // Tracemalloc
+    namespace tracemalloc {
+        using easycpp::tracemalloc::Traceback;
+        using easycpp::tracemalloc::Statistic;
+        using easycpp::tracemalloc::StatisticDiff;
+        using easycpp::tracemalloc::Snapshot;
+        using easycpp::tracemalloc::format_frame;
+        using easycpp::tracemalloc::to_json;
+        using easycpp::tracemalloc::start;
+        using easycpp::tracemalloc::stop;
+        using easycpp::tracemalloc::is_tracing;
+        using easycpp::tracemalloc::get_traceback_limit;
+        using easycpp::tracemalloc::get_sample_rate;
+        using easycpp::tracemalloc::get_traced_memory;
+        using easycpp::tracemalloc::reset_peak;
+        using easycpp::tracemalloc::clear_traces;
+        using easycpp::tracemalloc::take_snapshot;
+    }
+
+    // Trie
+    using easycpp::Trie;
+
+    // Urllib
+    namespace urllib {
+        namespace parse {
+            using easycpp::urllib::parse::SplitResult;
+            using easycpp::urllib::parse::urlsplit;
+            using easycpp::urllib::parse::urlunsplit;
+            using easycpp::urllib::parse::quote;
+            using easycpp::urllib::parse::quote_plus;
+            using easycpp::urllib::parse::unquote;
+            using easycpp::urllib::parse::unquote_plus;
+            using easycpp::urllib::parse::parse_qsl;
+            using easycpp::urllib::parse::urlencode;
+        }
+    }
+
+    // Xml
+    namespace xml {
+        using easycpp::xml::unescape;
+        using easycpp::xml::escape;
+        using easycpp::xml::Event;
+        using easycpp::xml::Attribute;
+        using easycpp::xml::PullParser;
+        using easycpp::xml::iterparse;
+        using easycpp::xml::Element;
+        using easycpp::xml::ElementTree;
+    }
+}
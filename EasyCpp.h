@@ -1,11 +1,50 @@
+#pragma once
+
+// Define EASYCPP_LIBRARY when linking against the compiled libeasycpp, which
+// already contains {fmt}. Otherwise every translation unit compiles {fmt} itself.
+#if !defined(FMT_HEADER_ONLY) && !defined(EASYCPP_LIBRARY)
+#define FMT_HEADER_ONLY
+#endif
+
 #ifdef IMPORT_EASYCPP_ALL
+#include <Compress/Base64.h>
+#include <Compress/Tarfile.h>
+#include <Compress/Zipfile.h>
+#include <Compress/Zlib.h>
+#include <Config/Config.h>
+#include <Config/ConfigParser.h>
+#include <Config/Toml.h>
+#include <Config/Yaml.h>
+#include <Csv/Csv.h>
+#include <DataFrame/DataFrame.h>
+#include <Dict/ConcurrentDict.h>
+#include <Dict/FrozenDict.h>
+#include <FileOperator/BinaryIO.h>
 #include <FileOperator/FileOperator.h>
+#include <FileOperator/SortFile.h>
 #include <FuncOptimize/func_io.h>
+#include <HdrHistogram/HdrHistogram.h>
+#include <Html/Html.h>
+#include <Http/Server.h>
+#include <List/AppendList.h>
 #include <List/List.h>
+#include <List/SpillList.h>
+#include <NDArray/NDArray.h>
+#include <Profile/Profile.h>
+#include <Quantile/Quantile.h>
+#include <Sketch/Sketch.h>
+#include <String/Hash.h>
 #include <String/String.h>
 #include <System/System.h>
 #include <System/System.pather.h>
+#include <TextIndex/TextIndex.h>
+#include <Threading/ThreadPool.h>
+#include <Threading/Threading.h>
+#include <Timeit/Timeit.h>
+#include <Tracemalloc/Tracemalloc.h>
+#include <Trie/Trie.h>
+#include <Urllib/Parse.h>
+#include <Xml/Xml.h>
 #endif
 
-#define FMT_HEADER_ONLY
 #define _EASYCPP_VERSION "1.0.0"
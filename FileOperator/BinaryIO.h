@@ -0,0 +1,239 @@
+// EasyCpp - BinaryIO : Compact Binary Serialization Helpers
+// Copyright (C) 2025  C14147
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+/**
+ * @file EasyCpp/FileOperator/BinaryIO.h
+ * @brief This file implements ByteWriter and ByteReader, the little-endian binary encoding
+ *        used by the EasyCpp modules that serialize their state (dumps()/loads()). Buffers can
+ *        be written to and read from a File in one call.
+ */
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+#include <FileOperator/FileOperator.h>
+
+namespace easycpp {
+    /**
+     * @class ByteWriter
+     * @brief Appends fixed-size integers, varints and byte strings to a growing buffer.
+     * Multi-byte values are stored little endian.
+     */
+    class ByteWriter {
+    private:
+        std::string buffer;
+
+    public:
+        /**
+         * @brief Append a trivially copyable value in little-endian byte order.
+         * @param value The value to be appended.
+         */
+        template<typename T>
+        void put(T value) {
+            static_assert(std::is_trivially_copyable_v<T>, "ByteWriter::put needs a trivially copyable type");
+            unsigned char bytes[sizeof(T)];
+            std::memcpy(bytes, &value, sizeof(T));
+            if constexpr (sizeof(T) > 1 && std::is_integral_v<T>) {
+                for (size_t i = 0; i < sizeof(T); ++i) {
+                    bytes[i] = (unsigned char) ((std::make_unsigned_t<T>) value >> (8 * i));
+                }
+            }
+            buffer.append(reinterpret_cast<const char*>(bytes), sizeof(T));
+        }
+
+        /**
+         * @brief Append an unsigned integer as a LEB128 varint (1 to 10 bytes).
+         * @param value The value to be appended.
+         */
+        void put_varint(uint64_t value) {
+            while (value >= 0x80) {
+                buffer += (char) (value | 0x80);
+                value >>= 7;
+            }
+            buffer += (char) value;
+        }
+
+        /**
+         * @brief Append a signed integer as a ZigZag encoded varint.
+         * @param value The value to be appended.
+         */
+        void put_zigzag(int64_t value) {
+            put_varint(((uint64_t) value << 1) ^ (uint64_t) (value >> 63));
+        }
+
+        /**
+         * @brief Append raw bytes.
+         * @param data The bytes.
+         * @param size The number of bytes.
+         */
+        void put_bytes(const void* data, size_t size) {
+            buffer.append(static_cast<const char*>(data), size);
+        }
+
+        /**
+         * @brief Append a length-prefixed byte string.
+         * @param text The bytes.
+         */
+        void put_string(std::string_view text) {
+            put_varint(text.size());
+            buffer.append(text.data(), text.size());
+        }
+
+        /**
+         * @brief Pad the buffer with zero bytes up to a multiple of the alignment.
+         * @param alignment The alignment in bytes.
+         */
+        void align(size_t alignment) {
+            while (buffer.size() % alignment) buffer += '\0';
+        }
+
+        size_t size() const { return buffer.size(); }
+        const std::string& str() const { return buffer; }
+        std::string& bytes() { return buffer; }
+
+        /**
+         * @brief Write the buffer to a file opened in binary mode (WRITE_B).
+         * @param file The destination file.
+         */
+        void save(File* file) const {
+            file->write(buffer.data(), buffer.size());
+        }
+    };
+
+    /**
+     * @class ByteReader
+     * @brief Reads values written by ByteWriter from a byte range it does not own.
+     * Every read checks the remaining length and throws std::invalid_argument on truncated data.
+     */
+    class ByteReader {
+    private:
+        const char* cursor;
+        const char* end;
+
+        void need(size_t size) const {
+            if ((size_t) (end - cursor) < size) throw std::invalid_argument("ByteReader: truncated data");
+        }
+
+    public:
+        ByteReader(const void* data, size_t size)
+            : cursor(static_cast<const char*>(data)), end(static_cast<const char*>(data) + size) {}
+
+        explicit ByteReader(std::string_view bytes) : ByteReader(bytes.data(), bytes.size()) {}
+
+        /**
+         * @brief Read a value written with ByteWriter::put.
+         * @return The value.
+         */
+        template<typename T>
+        T get() {
+            need(sizeof(T));
+            T value;
+            if constexpr (sizeof(T) > 1 && std::is_integral_v<T>) {
+                std::make_unsigned_t<T> bits = 0;
+                for (size_t i = 0; i < sizeof(T); ++i) {
+                    bits |= (std::make_unsigned_t<T>) (unsigned char) cursor[i] << (8 * i);
+                }
+                value = (T) bits;
+            } else {
+                std::memcpy(&value, cursor, sizeof(T));
+            }
+            cursor += sizeof(T);
+            return value;
+        }
+
+        /**
+         * @brief Read a LEB128 varint.
+         * @return The value.
+         */
+        uint64_t get_varint() {
+            uint64_t value = 0;
+            for (int shift = 0; shift < 64; shift += 7) {
+                need(1);
+                unsigned char byte = (unsigned char) *cursor++;
+                value |= (uint64_t) (byte & 0x7F) << shift;
+                if (!(byte & 0x80)) return value;
+            }
+            throw std::invalid_argument("ByteReader: malformed varint");
+        }
+
+        /**
+         * @brief Read a ZigZag encoded varint.
+         * @return The value.
+         */
+        int64_t get_zigzag() {
+            uint64_t value = get_varint();
+            return (int64_t) (value >> 1) ^ -(int64_t) (value & 1);
+        }
+
+        /**
+         * @brief Consume raw bytes without copying them.
+         * @param size The number of bytes.
+         * @return A pointer to the bytes inside the source range.
+         */
+        const char* get_bytes(size_t size) {
+            need(size);
+            const char* data = cursor;
+            cursor += size;
+            return data;
+        }
+
+        /**
+         * @brief Read a length-prefixed byte string without copying it.
+         * @return A view into the source range.
+         */
+        std::string_view get_string() {
+            size_t size = (size_t) get_varint();
+            return std::string_view(get_bytes(size), size);
+        }
+
+        size_t remaining() const { return (size_t) (end - cursor); }
+        const char* position() const { return cursor; }
+    };
+
+    /**
+     * @brief Write a length-prefixed record (8-byte length, then the bytes) to a binary file.
+     * Several records can be written to one file and read back in order with read_record().
+     * @param file The destination file, opened with WRITE_B or APPEND_B.
+     * @param bytes The record.
+     */
+    inline void write_record(File* file, std::string_view bytes) {
+        ByteWriter header;
+        header.put<uint64_t>(bytes.size());
+        header.save(file);
+        file->write(bytes.data(), bytes.size());
+    }
+
+    /**
+     * @brief Read the next record written by write_record().
+     * @param file The source file, opened with READ_B.
+     * @return The record.
+     * @throws std::invalid_argument if the file ends inside the record.
+     */
+    inline std::string read_record(File* file) {
+        char header[8];
+        if (file->read(header, sizeof(header)) != sizeof(header)) throw std::invalid_argument("read_record: truncated data");
+        uint64_t size = ByteReader(header, sizeof(header)).get<uint64_t>();
+        std::string bytes(size, '\0');
+        if (file->read(bytes.data(), size) != size) throw std::invalid_argument("read_record: truncated data");
+        return bytes;
+    }
+}
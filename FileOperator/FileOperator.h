@@ -27,7 +27,7 @@
 #define _FILE_OFFSET_BITS 64
 #endif //_EASYCPP_ALLOW_BIG_FILE_
 
-#ifndef FMT_HEADER_ONLY
+#if !defined(FMT_HEADER_ONLY) && !defined(EASYCPP_LIBRARY)
 #define FMT_HEADER_ONLY
 #endif //FMT_HEADER_ONLY
 
@@ -37,42 +37,63 @@
 #define WRITE_E "w+"
 #define READ_E "r+"
 #define APPEND_E "a+"
+#define WRITE_B "wb"
+#define READ_B "rb"
+#define APPEND_B "ab"
 #define PERMISSION_READ "readable"
 #define PERMISSION_WRITE "writable"
 #define PERMISSION_EXECUTE "executable"
 #define FILE_NOT_PERMISSION "have permission"
 
-#define F_OK 0 /* Check for file existence */
-#define X_OK 1 /* Check for execute permission. */
-#define W_OK 2 /* Check for write permission */
-#define R_OK 4 /* Check for read permission */
-
 #include <cstdio>
+#include <cerrno>
 #include <exception>
+#include <new>
 #include <cstring>
+#ifdef _WIN32
 #include <io.h>
 #include <process.h>
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX /* Keep windows.h from defining the min and max macros */
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 #include <cstdlib>
 
+#ifndef F_OK
+#define F_OK 0 /* Check for file existence */
+#define X_OK 1 /* Check for execute permission. */
+#define W_OK 2 /* Check for write permission */
+#define R_OK 4 /* Check for read permission */
+#endif
+
 namespace easycpp {
 	
-	bool is_exist(const char * filename) {
+	inline bool is_exist(const char * filename) {
 		return access(filename, F_OK) == 0;
 	}
 	
-	bool is_readable(const char * filename) {
+	inline bool is_readable(const char * filename) {
 		return access(filename, R_OK) == 0;
 	}
 	
-	bool is_writable(const char * filename) {
+	inline bool is_writable(const char * filename) {
 		return access(filename, W_OK) == 0;
 	}
 	
-	bool is_executable(const char * filename) {
+	inline bool is_executable(const char * filename) {
 		return access(filename, X_OK) == 0;
 	}
 	
-	bool check_permission(const char * filename) {
+	inline bool check_permission(const char * filename) {
 		return access(filename, R_OK | W_OK) == 0;
 	}
 	
@@ -152,9 +173,97 @@ namespace easycpp {
 			if (write_size != data_size) throw FileWriteError(const_cast<char*>(filename));
 			return write_size;
 		}
+		size_t write(const void * data, size_t size) {
+			size_t write_size = fwrite(data, 1, size, file);
+			if (write_size != size) throw FileWriteError(const_cast<char*>(filename));
+			return write_size;
+		}
+		size_t read(void * buffer, size_t size) {
+			return fread(buffer, 1, size, file);
+		}
 	};
 	
-	File * open(const char * filename, const char * method) {
+	/* A memory mapping of a whole file. The mapping stays valid until the MappedFile is
+	 * deleted; several processes mapping one file share its page cache. It is read-only
+	 * unless opened with READ_E ("r+": writes go to the file) or "c" (copy-on-write:
+	 * writes stay private to the process); then data may be cast to char *. */
+	class MappedFile {
+	public:
+		const char * data;
+		size_t size;
+		char * filename;
+		MappedFile(const char * filename, const char * method = READ) : data(nullptr), size(0) {
+			if (!is_exist(filename)) throw FileNotExistError(const_cast<char*>(filename));
+			this->filename = new char[strlen(filename) + 1];
+			strcpy(this->filename, filename);
+			bool shared_write = strcmp(method, READ_E) == 0;
+			bool private_write = strcmp(method, "c") == 0;
+#ifdef _WIN32
+			HANDLE handle = CreateFileA(filename, shared_write ? GENERIC_READ | GENERIC_WRITE : GENERIC_READ, FILE_SHARE_READ,
+										nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+			if (handle == INVALID_HANDLE_VALUE) fail();
+			LARGE_INTEGER file_size;
+			GetFileSizeEx(handle, &file_size);
+			size = (size_t) file_size.QuadPart;
+			if (size) {
+				HANDLE mapping = CreateFileMappingA(handle, nullptr, shared_write ? PAGE_READWRITE : private_write ? PAGE_WRITECOPY : PAGE_READONLY,
+													0, 0, nullptr);
+				if (mapping) {
+					data = (const char *) MapViewOfFile(mapping, shared_write ? FILE_MAP_WRITE : private_write ? FILE_MAP_COPY : FILE_MAP_READ, 0, 0, 0);
+					CloseHandle(mapping);
+				}
+			}
+			CloseHandle(handle);
+			if (size && !data) fail();
+#else
+			int fd = ::open(filename, shared_write ? O_RDWR : O_RDONLY);
+			if (fd < 0) fail();
+			struct stat info;
+			if (fstat(fd, &info) != 0) {
+				::close(fd);
+				fail();
+			}
+			size = (size_t) info.st_size;
+			if (size) {
+				int protection = shared_write || private_write ? PROT_READ | PROT_WRITE : PROT_READ;
+				void * address = ::mmap(nullptr, size, protection, private_write ? MAP_PRIVATE : MAP_SHARED, fd, 0);
+				data = address == MAP_FAILED ? nullptr : (const char *) address;
+			}
+			::close(fd);
+			if (size && !data) fail();
+#endif
+		}
+		MappedFile(const MappedFile &) = delete;
+		MappedFile & operator=(const MappedFile &) = delete;
+		~MappedFile() {
+#ifdef _WIN32
+			if (data) UnmapViewOfFile(data);
+#else
+			if (data) munmap((void *) data, size);
+#endif
+			delete[] filename;
+		}
+		/* Hint that the range [offset, offset + length) will be read soon, or sequentially. */
+		void will_need(size_t offset, size_t length, bool sequential = false) const {
+#ifndef _WIN32
+			if (!data || offset >= size) return;
+			size_t page = (size_t) sysconf(_SC_PAGESIZE);
+			size_t begin = offset / page * page;
+			length = (length < size - offset ? length : size - offset) + (offset - begin);
+			madvise((void *) (data + begin), length, sequential ? MADV_SEQUENTIAL : MADV_WILLNEED);
+#else
+			(void) offset; (void) length; (void) sequential;
+#endif
+		}
+	private:
+		[[noreturn]] void fail() {
+			FileUnknownError error(filename);
+			delete[] filename;
+			throw error;
+		}
+	};
+	
+	inline File * open(const char * filename, const char * method) {
 		if(strcmp(method, READ) == 0 || strcmp(method, READ_E) == 0){
 			if (!is_exist(filename)) 
 				throw FileNotExistError(const_cast<char*>(filename));
@@ -162,9 +271,18 @@ namespace easycpp {
 				throw FilePermissionError(const_cast<char*>(filename));
 		}
 		FILE * _file;
+#ifdef _WIN32
 		errno_t _err = fopen_s(& _file, filename, method);
+#else
+		_file = fopen(filename, method);
+		int _err = _file ? 0 : errno;
+#endif
 		if (_err != 0) throw FileUnknownError(const_cast<char*>(filename));
 		File* _rtn = new File(_file, filename);
 		return _rtn;
 	}
+	
+	inline MappedFile * mmap(const char * filename, const char * method = READ) {
+		return new MappedFile(filename, method);
+	}
 }
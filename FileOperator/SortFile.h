@@ -0,0 +1,368 @@
+// EasyCpp - SortFile : External Merge Sort of Text Files
+// Copyright (C) 2025  C14147
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+/**
+ * @file EasyCpp/FileOperator/SortFile.h
+ * @brief This file implements sort_file(), which sorts the lines of a file of any size the
+ *        way `LC_ALL=C sort -s` does. The input is cut into runs that fit the memory limit;
+ *        each run is sorted in parallel pieces that are then merged, and written to a
+ *        temporary file. The runs are merged with a loser tree, reading and writing in large
+ *        sequential blocks, in as many passes as the fan-in requires.
+ */
+#pragma once
+#define _EASYCPP_SORTFILE_VERSION "1.0.0"
+
+#include <FileOperator/FileOperator.h>
+#include <Threading/ThreadPool.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace easycpp {
+    namespace sortfile {
+        namespace detail {
+            inline constexpr size_t MAX_FAN_IN = 128;
+            inline constexpr size_t MIN_BUFFER = size_t(64) << 10;
+            inline constexpr size_t MAX_BUFFER = size_t(16) << 20;
+
+            using Key = std::function<std::string_view(std::string_view)>;
+
+            struct Record {
+                std::string_view line;
+                std::string_view key;
+            };
+
+            // Removes the temporary runs, also when sorting fails.
+            struct TemporaryFiles {
+                std::vector<std::string> paths;
+
+                std::string create() {
+                    static std::atomic<uint64_t> counter{0};
+                    uint64_t stamp = (uint64_t) std::chrono::steady_clock::now().time_since_epoch().count();
+                    std::filesystem::path path = std::filesystem::temp_directory_path() /
+                        ("easycpp-sort-" + std::to_string(stamp) + "-" + std::to_string(counter.fetch_add(1)) + ".run");
+                    paths.push_back(path.string());
+                    return paths.back();
+                }
+
+                void remove(const std::string& path) {
+                    std::error_code error;
+                    std::filesystem::remove(path, error);
+                    paths.erase(std::find(paths.begin(), paths.end(), path));
+                }
+
+                ~TemporaryFiles() {
+                    for (const std::string& path : paths) {
+                        std::error_code error;
+                        std::filesystem::remove(path, error);
+                    }
+                }
+            };
+
+            // Collects output in a large buffer so the file sees few, big writes.
+            class Writer {
+            private:
+                std::unique_ptr<File> file;
+                std::string buffer;
+                size_t capacity;
+
+            public:
+                Writer(const std::string& path, size_t capacity) : file(open(path.c_str(), WRITE_B)), capacity(capacity) {
+                    buffer.reserve(capacity);
+                }
+
+                void line(std::string_view text) {
+                    if (buffer.size() + text.size() + 1 > capacity) flush();
+                    if (text.size() + 1 > capacity) {
+                        file->write(text.data(), text.size());
+                        file->write("\n", 1);
+                        return;
+                    }
+                    buffer.append(text.data(), text.size());
+                    buffer += '\n';
+                }
+
+                void flush() {
+                    if (!buffer.empty()) file->write(buffer.data(), buffer.size());
+                    buffer.clear();
+                }
+
+                void close() {
+                    flush();
+                    file.reset();
+                }
+            };
+
+            // Reads a run one line at a time through a large buffer.
+            class Reader {
+            private:
+                std::unique_ptr<File> file;
+                std::string buffer;
+                size_t begin = 0, end = 0;
+                bool eof = false;
+                const Key& key_function;
+
+            public:
+                std::string_view line;
+                std::string_view key;
+                bool done = false;
+
+                Reader(const std::string& path, size_t capacity, const Key& key_function)
+                    : file(open(path.c_str(), READ_B)), buffer(capacity, '\0'), key_function(key_function) {
+                    next();
+                }
+
+                void next() {
+                    for (;;) {
+                        const char* start = buffer.data() + begin;
+                        const char* newline = static_cast<const char*>(std::memchr(start, '\n', end - begin));
+                        if (newline) {
+                            line = std::string_view(start, (size_t) (newline - start));
+                            begin += line.size() + 1;
+                            key = key_function ? key_function(line) : line;
+                            return;
+                        }
+                        if (eof) {
+                            // Runs end every line with '\n', so anything left is an empty tail.
+                            done = true;
+                            return;
+                        }
+                        // Keep the partial line, then fill the rest of the buffer.
+                        std::memmove(buffer.data(), start, end - begin);
+                        end -= begin;
+                        begin = 0;
+                        if (end == buffer.size()) buffer.resize(buffer.size() * 2);
+                        size_t read = file->read(buffer.data() + end, buffer.size() - end);
+                        if (read == 0) eof = true;
+                        end += read;
+                    }
+                }
+            };
+
+            /**
+             * @class LoserTree
+             * @brief Selects the smallest current line of k runs in log2(k) comparisons per
+             * line. Internal node i holds the loser of the match played there, node 0 the
+             * overall winner; ties go to the earlier run, which keeps the merge stable.
+             */
+            class LoserTree {
+            private:
+                std::vector<Reader>& sources;
+                std::vector<size_t> tree;
+                bool reverse;
+                static constexpr size_t EMPTY = SIZE_MAX;
+
+                bool beats(size_t a, size_t b) const {
+                    if (sources[a].done) return false;
+                    if (sources[b].done) return true;
+                    int order = sources[a].key.compare(sources[b].key);
+                    if (reverse) order = -order;
+                    return order < 0 || (order == 0 && a < b);
+                }
+
+                void replay(size_t leaf) {
+                    size_t winner = leaf;
+                    for (size_t node = (leaf + sources.size()) / 2; node > 0; node /= 2) {
+                        if (tree[node] == EMPTY) {
+                            // Still being built: wait here for the other side.
+                            tree[node] = winner;
+                            return;
+                        }
+                        if (beats(tree[node], winner)) std::swap(tree[node], winner);
+                    }
+                    tree[0] = winner;
+                }
+
+            public:
+                LoserTree(std::vector<Reader>& sources, bool reverse) : sources(sources), tree(sources.size(), EMPTY), reverse(reverse) {
+                    if (sources.size() == 1) tree[0] = 0;
+                    for (size_t leaf = 0; leaf < sources.size(); ++leaf) replay(leaf);
+                }
+
+                Reader* top() {
+                    Reader& winner = sources[tree[0]];
+                    return winner.done ? nullptr : &winner;
+                }
+
+                void pop() {
+                    sources[tree[0]].next();
+                    if (sources.size() > 1) replay(tree[0]);
+                }
+            };
+
+            inline void merge(const std::vector<std::string>& runs, const std::string& output, size_t memory_limit, const Key& key, bool reverse) {
+                size_t buffer = std::clamp(memory_limit / (runs.size() + 1), MIN_BUFFER, MAX_BUFFER);
+                std::vector<Reader> sources;
+                sources.reserve(runs.size());
+                for (const std::string& run : runs) sources.emplace_back(run, buffer, key);
+                Writer writer(output, buffer);
+                LoserTree tree(sources, reverse);
+                while (Reader* reader = tree.top()) {
+                    writer.line(reader->line);
+                    tree.pop();
+                }
+                writer.close();
+            }
+
+            // Sort a run: stable-sort one piece per thread, then merge pieces pairwise.
+            inline void sort_records(std::vector<Record>& records, ThreadPool* pool, bool reverse) {
+                auto less = [reverse](const Record& a, const Record& b) { return reverse ? b.key < a.key : a.key < b.key; };
+                size_t pieces = pool ? std::min(pool->size() + 1, std::max<size_t>(1, records.size() / 4096)) : 1;
+                if (pieces <= 1) {
+                    std::stable_sort(records.begin(), records.end(), less);
+                    return;
+                }
+                std::vector<size_t> bounds;
+                for (size_t i = 0; i <= pieces; ++i) bounds.push_back(records.size() * i / pieces);
+                pool->parallel_for(0, pieces, [&](size_t i) {
+                    std::stable_sort(records.begin() + bounds[i], records.begin() + bounds[i + 1], less);
+                });
+                std::vector<Record> scratch(records.size());
+                std::vector<Record>* from = &records;
+                std::vector<Record>* to = &scratch;
+                for (size_t width = 1; width < pieces; width *= 2) {
+                    size_t pairs = (pieces + 2 * width - 1) / (2 * width);
+                    pool->parallel_for(0, pairs, [&](size_t pair) {
+                        size_t first = bounds[pair * 2 * width];
+                        size_t middle = bounds[std::min(pieces, pair * 2 * width + width)];
+                        size_t last = bounds[std::min(pieces, pair * 2 * width + 2 * width)];
+                        std::merge(from->begin() + first, from->begin() + middle, from->begin() + middle, from->begin() + last,
+                                   to->begin() + first, less);
+                    });
+                    std::swap(from, to);
+                }
+                if (from != &records) records.swap(scratch);
+            }
+        }
+    }
+
+    /**
+     * @brief Sort the lines of a text file into another file, as `LC_ALL=C sort -s` does:
+     * bytes are compared unsigned and equal keys keep their input order. Input larger than
+     * memory_limit is sorted in runs that are spilled to the temporary directory and
+     * merged. The output is opened only after the whole input has been read, so input and
+     * output may be the same file. A last line without '\n' gets one.
+     * @param input The file to be sorted.
+     * @param output The file to write.
+     * @param key Maps a line (without '\n') to its sort key, which must be a view into the
+     *        line or into storage that outlives the call. Defaults to the whole line.
+     * @param memory_limit The approximate bytes to use for buffers and line indexes.
+     * @param threads The threads sorting a run: 0 uses ThreadPool::global(), 1 only the
+     *        calling thread.
+     * @param reverse Sort in descending order (still stable).
+     * @throws FileNotExistError and the other FileOperator errors if a file cannot be used.
+     */
+    inline void sort_file(const char* input, const char* output, const sortfile::detail::Key& key = nullptr,
+                          size_t memory_limit = size_t(256) << 20, size_t threads = 0, bool reverse = false) {
+        using namespace sortfile::detail;
+        if (memory_limit < 3 * MIN_BUFFER) memory_limit = 3 * MIN_BUFFER;
+        std::unique_ptr<ThreadPool> own_pool;
+        ThreadPool* pool = nullptr;
+        if (threads == 0) pool = &ThreadPool::global();
+        else if (threads > 1) pool = (own_pool = std::make_unique<ThreadPool>(threads - 1)).get();
+
+        // A third of the budget holds the text of a run, the rest its index and the
+        // scratch space of the parallel merge.
+        size_t run_bytes = memory_limit / 3;
+        std::unique_ptr<File> source(open(input, READ_B));
+        std::string text(run_bytes, '\0');
+        size_t carried = 0;
+        bool eof = false;
+        TemporaryFiles temporary;
+        std::vector<std::string> runs;
+        std::vector<Record> records;
+        bool single = false;
+
+        while (!eof) {
+            size_t filled = carried;
+            while (filled < text.size()) {
+                size_t read = source->read(text.data() + filled, text.size() - filled);
+                if (read == 0) {
+                    eof = true;
+                    break;
+                }
+                filled += read;
+            }
+            // The run ends after the last complete line; the rest starts the next run.
+            size_t cut = filled;
+            if (!eof) {
+                size_t last = std::string_view(text.data(), filled).rfind('\n');
+                if (last == std::string_view::npos) {
+                    // A line longer than the run buffer: make room and keep reading.
+                    carried = filled;
+                    text.resize(text.size() * 2);
+                    continue;
+                }
+                cut = last + 1;
+            }
+
+            records.clear();
+            for (size_t start = 0; start < cut;) {
+                const char* newline = static_cast<const char*>(std::memchr(text.data() + start, '\n', cut - start));
+                size_t stop = newline ? (size_t) (newline - text.data()) : cut;
+                std::string_view line(text.data() + start, stop - start);
+                records.push_back(Record{line, key ? key(line) : line});
+                start = stop + 1;
+            }
+            sort_records(records, pool, reverse);
+
+            single = eof && runs.empty();
+            std::string path = single ? std::string() : temporary.create();
+            if (single) source.reset();
+            Writer writer(single ? std::string(output) : path, std::clamp(run_bytes / 8, MIN_BUFFER, MAX_BUFFER));
+            for (const Record& record : records) writer.line(record.line);
+            writer.close();
+            if (!single) runs.push_back(path);
+
+            carried = filled - cut;
+            std::memmove(text.data(), text.data() + cut, carried);
+        }
+        if (single) return;
+        source.reset();
+        records = std::vector<Record>();
+        text = std::string();
+
+        // Merge MAX_FAN_IN runs at a time until one pass can produce the output.
+        while (runs.size() > MAX_FAN_IN) {
+            std::vector<std::string> merged;
+            for (size_t first = 0; first < runs.size(); first += MAX_FAN_IN) {
+                std::vector<std::string> group(runs.begin() + first, runs.begin() + std::min(runs.size(), first + MAX_FAN_IN));
+                if (group.size() == 1) {
+                    merged.push_back(group[0]);
+                    continue;
+                }
+                std::string path = temporary.create();
+                merge(group, path, memory_limit, key, reverse);
+                for (const std::string& run : group) temporary.remove(run);
+                merged.push_back(path);
+            }
+            runs.swap(merged);
+        }
+        merge(runs, output, memory_limit, key, reverse);
+    }
+}
@@ -19,6 +19,7 @@
  * @file EasyCpp/FuncOptimize/func_io.h
  * @brief This file provides a function to print formatted strings with custom separators and endings.
  */
+#pragma once
 
 #include <String/String.h>
 #include <List/List.h>
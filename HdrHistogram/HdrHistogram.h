@@ -0,0 +1,774 @@
+// EasyCpp - HdrHistogram : High Dynamic Range Latency Histograms
+// Copyright (C) 2025  C14147
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+/**
+ * @file EasyCpp/HdrHistogram/HdrHistogram.h
+ * @brief This file implements HdrHistogram: a fixed-size histogram of integer values (usually
+ *        latencies in nanoseconds) with a configurable number of significant decimal digits over
+ *        a wide range. Recording is a few shifts and one increment, never allocates, and the
+ *        AtomicHdrHistogram variant records from many threads without a lock.
+ *        The bucket layout and the compressed V2 encoding are those of the Java and C
+ *        HdrHistogram libraries, so histograms and interval logs (HdrLogWriter/HdrLogReader)
+ *        can be exchanged with HdrHistogram tooling such as HistogramLogProcessor.
+ */
+#pragma once
+#define _EASYCPP_HDRHISTOGRAM_VERSION "1.0.0"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include <Compress/Base64.h>
+#include <Compress/Zlib.h>
+#include <FileOperator/BinaryIO.h>
+#include <Timeit/Timeit.h>
+
+namespace easycpp {
+    /**
+     * @brief One step of a percentile distribution (see BasicHdrHistogram::percentiles).
+     */
+    struct HdrPercentile {
+        int64_t value;       // Highest value equivalent to the bucket reaching the percentile
+        double percentile;   // 0 to 100
+        int64_t count;       // Number of values less than or equal to value
+    };
+
+    /**
+     * @class BasicHdrHistogram
+     * @brief The histogram, parameterized on its counter type: HdrHistogram uses plain int64_t
+     * counters (one histogram per thread, merged later), AtomicHdrHistogram uses std::atomic
+     * counters updated with relaxed fetch_add, safe to record into from any number of threads.
+     * Values are grouped into buckets whose width doubles with each power of two, each split
+     * into enough sub-buckets to keep the requested significant digits.
+     */
+    template<typename Counter>
+    class BasicHdrHistogram {
+    public:
+        static constexpr bool ATOMIC = !std::is_same_v<Counter, int64_t>;
+
+    private:
+        template<typename> friend class BasicHdrHistogram;
+
+        static constexpr int32_t ENCODING_COOKIE = 0x1c849303 | 0x10;
+        static constexpr int32_t COMPRESSED_COOKIE = 0x1c849304 | 0x10;
+
+        int64_t lowest, highest;
+        int digits;
+        int unit_magnitude;
+        int sub_bucket_half_count_magnitude;
+        int64_t sub_bucket_count, sub_bucket_half_count, sub_bucket_mask;
+        int bucket_count;
+        size_t counts_length;
+        int leading_zero_count_base;
+
+        std::unique_ptr<Counter[]> counts;
+        Counter total;
+        Counter min_value;  // Smallest non-zero value recorded
+        Counter max_value;
+
+        static int64_t load(const Counter& counter) {
+            if constexpr (ATOMIC) return counter.load(std::memory_order_relaxed);
+            else return counter;
+        }
+
+        static void store(Counter& counter, int64_t value) {
+            if constexpr (ATOMIC) counter.store(value, std::memory_order_relaxed);
+            else counter = value;
+        }
+
+        int bucket_index(int64_t value) const {
+            return leading_zero_count_base - std::countl_zero((uint64_t) (value | sub_bucket_mask));
+        }
+
+        int64_t sub_bucket_index(int64_t value, int bucket) const {
+            return value >> (bucket + unit_magnitude);
+        }
+
+        size_t index_of(int bucket, int64_t sub_bucket) const {
+            return (size_t) ((((int64_t) bucket + 1) << sub_bucket_half_count_magnitude) + (sub_bucket - sub_bucket_half_count));
+        }
+
+        void init() {
+            if (lowest < 1) throw std::invalid_argument("HdrHistogram: lowest value must be at least 1");
+            if (digits < 0 || digits > 5) throw std::invalid_argument("HdrHistogram: significant digits must be between 0 and 5");
+            if (highest < 2 * lowest) throw std::invalid_argument("HdrHistogram: highest value must be at least twice the lowest");
+            int64_t largest_single_unit = 2 * (int64_t) std::pow(10, digits);
+            int sub_bucket_count_magnitude = (int) std::ceil(std::log2((double) largest_single_unit));
+            sub_bucket_half_count_magnitude = std::max(sub_bucket_count_magnitude, 1) - 1;
+            unit_magnitude = 63 - std::countl_zero((uint64_t) lowest);
+            if (unit_magnitude + sub_bucket_half_count_magnitude > 61) throw std::invalid_argument("HdrHistogram: lowest value too large for the precision");
+            sub_bucket_count = (int64_t) 1 << (sub_bucket_half_count_magnitude + 1);
+            sub_bucket_half_count = sub_bucket_count / 2;
+            sub_bucket_mask = (sub_bucket_count - 1) << unit_magnitude;
+
+            int64_t smallest_untrackable = sub_bucket_count << unit_magnitude;
+            bucket_count = 1;
+            while (smallest_untrackable <= highest) {
+                if (smallest_untrackable > std::numeric_limits<int64_t>::max() / 2) {
+                    ++bucket_count;
+                    break;
+                }
+                smallest_untrackable <<= 1;
+                ++bucket_count;
+            }
+            counts_length = (size_t) (bucket_count + 1) * (size_t) sub_bucket_half_count;
+            leading_zero_count_base = 64 - unit_magnitude - sub_bucket_half_count_magnitude - 1;
+            counts.reset(new Counter[counts_length]);
+            reset();
+        }
+
+        bool same_layout(int64_t other_lowest, int other_digits, size_t other_length) const {
+            return lowest == other_lowest && digits == other_digits && counts_length == other_length;
+        }
+
+        void note_min_max(int64_t value) {
+            if constexpr (ATOMIC) {
+                if (value) {
+                    int64_t current = min_value.load(std::memory_order_relaxed);
+                    while (value < current && !min_value.compare_exchange_weak(current, value, std::memory_order_relaxed)) {}
+                }
+                int64_t current = max_value.load(std::memory_order_relaxed);
+                while (value > current && !max_value.compare_exchange_weak(current, value, std::memory_order_relaxed)) {}
+            } else {
+                if (value && value < min_value) min_value = value;
+                if (value > max_value) max_value = value;
+            }
+        }
+
+    public:
+        /**
+         * @brief Construct an empty histogram.
+         * @param lowest The lowest value that can be told apart from 0 (at least 1).
+         * @param highest The highest value that can be recorded.
+         * @param digits The number of significant decimal digits kept for every value, 0 to 5.
+         * @throws std::invalid_argument if the parameters are inconsistent.
+         */
+        BasicHdrHistogram(int64_t lowest, int64_t highest, int digits) : lowest(lowest), highest(highest), digits(digits) {
+            init();
+        }
+
+        /**
+         * @brief Construct an empty histogram for values 1 to highest.
+         * @param highest The highest value that can be recorded; the default is one hour in nanoseconds.
+         * @param digits The number of significant decimal digits, 0 to 5.
+         */
+        explicit BasicHdrHistogram(int64_t highest = 3600LL * 1000 * 1000 * 1000, int digits = 3) : BasicHdrHistogram(1, highest, digits) {}
+
+        BasicHdrHistogram(const BasicHdrHistogram& other) : BasicHdrHistogram(other.lowest, other.highest, other.digits) {
+            add(other);
+        }
+
+        BasicHdrHistogram& operator=(const BasicHdrHistogram& other) {
+            if (this != &other) {
+                lowest = other.lowest;
+                highest = other.highest;
+                digits = other.digits;
+                init();
+                add(other);
+            }
+            return *this;
+        }
+
+        /**
+         * @brief Record a value. Never allocates or locks.
+         * @param value The value, 0 to highest.
+         * @param count The number of occurrences.
+         * @return false if the value is out of range and was not recorded.
+         */
+        bool record(int64_t value, int64_t count = 1) {
+            if (value < 0) return false;
+            int bucket = bucket_index(value);
+            size_t index = index_of(bucket, sub_bucket_index(value, bucket));
+            if (index >= counts_length) return false;
+            if constexpr (ATOMIC) {
+                counts[index].fetch_add(count, std::memory_order_relaxed);
+                total.fetch_add(count, std::memory_order_relaxed);
+            } else {
+                counts[index] += count;
+                total += count;
+            }
+            note_min_max(value);
+            return true;
+        }
+
+        /**
+         * @brief Record a value, correcting for coordinated omission: when a measurement took longer
+         * than the expected interval between measurements, also record the measurements that a
+         * stalled load generator failed to issue (value - interval, value - 2 * interval, ...).
+         * @param value The value.
+         * @param expected_interval The expected interval between values; 0 disables the correction.
+         * @return false if the value is out of range.
+         */
+        bool record_corrected(int64_t value, int64_t expected_interval) {
+            if (!record(value)) return false;
+            if (expected_interval <= 0) return true;
+            for (int64_t missing = value - expected_interval; missing >= expected_interval; missing -= expected_interval) {
+                record(missing);
+            }
+            return true;
+        }
+
+        /**
+         * @brief Clear all counts.
+         */
+        void reset() {
+            for (size_t i = 0; i < counts_length; ++i) store(counts[i], 0);
+            store(total, 0);
+            store(min_value, std::numeric_limits<int64_t>::max());
+            store(max_value, 0);
+        }
+
+        /**
+         * @brief Add the counts of another histogram (of either counter type).
+         * @param other The other histogram.
+         * @throws std::invalid_argument if a recorded value of other is out of range here.
+         */
+        template<typename OtherCounter>
+        void add(const BasicHdrHistogram<OtherCounter>& other) {
+            if (same_layout(other.lowest, other.digits, other.counts_length)) {
+                for (size_t i = 0; i < counts_length; ++i) {
+                    int64_t count = BasicHdrHistogram<OtherCounter>::load(other.counts[i]);
+                    if (!count) continue;
+                    if constexpr (ATOMIC) counts[i].fetch_add(count, std::memory_order_relaxed);
+                    else counts[i] += count;
+                }
+                if constexpr (ATOMIC) total.fetch_add(other.total_count(), std::memory_order_relaxed);
+                else total += other.total_count();
+                if (other.total_count()) {
+                    note_min_max(BasicHdrHistogram<OtherCounter>::load(other.min_value));
+                    note_min_max(BasicHdrHistogram<OtherCounter>::load(other.max_value));
+                }
+                return;
+            }
+            for (size_t i = 0; i < other.counts_length; ++i) {
+                int64_t count = BasicHdrHistogram<OtherCounter>::load(other.counts[i]);
+                if (count && !record(other.value_at_index(i), count)) {
+                    throw std::invalid_argument("HdrHistogram: value out of range while merging");
+                }
+            }
+        }
+
+        int64_t total_count() const { return load(total); }
+        int64_t lowest_trackable() const { return lowest; }
+        int64_t highest_trackable() const { return highest; }
+        int significant_digits() const { return digits; }
+        int buckets() const { return bucket_count; }
+        int64_t sub_buckets() const { return sub_bucket_count; }
+        size_t memory_size() const { return counts_length * sizeof(Counter); }
+
+        /**
+         * @brief Get the value at a position of the counts array.
+         * @param index The position.
+         * @return The lowest value counted there.
+         */
+        int64_t value_at_index(size_t index) const {
+            int bucket = (int) (index >> sub_bucket_half_count_magnitude) - 1;
+            int64_t sub_bucket = (int64_t) (index & (size_t) (sub_bucket_half_count - 1)) + sub_bucket_half_count;
+            if (bucket < 0) {
+                sub_bucket -= sub_bucket_half_count;
+                bucket = 0;
+            }
+            return sub_bucket << (bucket + unit_magnitude);
+        }
+
+        /**
+         * @brief Get the number of values that share a value's bucket.
+         * @param value The value.
+         * @return The width of the range of values counted together with value.
+         */
+        int64_t equivalent_range(int64_t value) const {
+            int bucket = bucket_index(value);
+            int64_t sub_bucket = sub_bucket_index(value, bucket);
+            return (int64_t) 1 << (unit_magnitude + (sub_bucket >= sub_bucket_count ? bucket + 1 : bucket));
+        }
+
+        int64_t lowest_equivalent(int64_t value) const {
+            int bucket = bucket_index(value);
+            return sub_bucket_index(value, bucket) << (bucket + unit_magnitude);
+        }
+
+        int64_t highest_equivalent(int64_t value) const { return lowest_equivalent(value) + equivalent_range(value) - 1; }
+        int64_t median_equivalent(int64_t value) const { return lowest_equivalent(value) + (equivalent_range(value) >> 1); }
+        bool values_are_equivalent(int64_t a, int64_t b) const { return lowest_equivalent(a) == lowest_equivalent(b); }
+
+        /**
+         * @brief Get the count recorded for a value's bucket.
+         * @param value The value.
+         * @return The count.
+         */
+        int64_t count_at(int64_t value) const {
+            if (value < 0) return 0;
+            int bucket = bucket_index(value);
+            size_t index = index_of(bucket, sub_bucket_index(value, bucket));
+            return index < counts_length ? load(counts[index]) : 0;
+        }
+
+        int64_t min() const {
+            if (total_count() == 0 || count_at(0) > 0) return 0;
+            return lowest_equivalent(load(min_value));
+        }
+
+        int64_t max() const {
+            int64_t value = load(max_value);
+            return value == 0 ? 0 : highest_equivalent(value);
+        }
+
+        /**
+         * @brief Call fn(value, count) for every non-empty bucket in increasing order.
+         * The value is the lowest value of the bucket. Does not allocate.
+         */
+        template<typename Fn>
+        void for_each_recorded(Fn&& fn) const {
+            for (size_t i = 0; i < counts_length; ++i) {
+                int64_t count = load(counts[i]);
+                if (count) fn(value_at_index(i), count);
+            }
+        }
+
+        double mean() const {
+            int64_t n = total_count();
+            if (n == 0) return 0;
+            double sum = 0;
+            for_each_recorded([&](int64_t value, int64_t count) { sum += (double) median_equivalent(value) * (double) count; });
+            return sum / (double) n;
+        }
+
+        double stddev() const {
+            int64_t n = total_count();
+            if (n == 0) return 0;
+            double average = mean(), sum = 0;
+            for_each_recorded([&](int64_t value, int64_t count) {
+                double deviation = (double) median_equivalent(value) - average;
+                sum += deviation * deviation * (double) count;
+            });
+            return std::sqrt(sum / (double) n);
+        }
+
+        /**
+         * @brief Get the value at a percentile.
+         * @param percentile The percentile, 0 to 100.
+         * @return The highest value equivalent to the percentile's bucket (the lowest for 0),
+         * or 0 if the histogram is empty.
+         */
+        int64_t value_at_percentile(double percentile) const {
+            percentile = std::clamp(percentile, 0.0, 100.0);
+            int64_t n = total_count();
+            int64_t target = std::max<int64_t>(1, (int64_t) (percentile / 100.0 * (double) n + 0.5));
+            int64_t cumulative = 0;
+            for (size_t i = 0; i < counts_length; ++i) {
+                cumulative += load(counts[i]);
+                if (cumulative >= target) {
+                    int64_t value = value_at_index(i);
+                    return percentile == 0.0 ? lowest_equivalent(value) : highest_equivalent(value);
+                }
+            }
+            return 0;
+        }
+
+        /**
+         * @brief Walk the distribution at exponentially finer percentile steps towards 100, like
+         * HdrHistogram's percentile iterator: ticks_per_half_distance steps between 0 and 50,
+         * as many between 50 and 75, and so on.
+         * @param ticks_per_half_distance The number of steps per halving of the distance to 100.
+         * @return The steps, ending with the 100th percentile.
+         */
+        std::vector<HdrPercentile> percentiles(int ticks_per_half_distance = 5) const {
+            std::vector<HdrPercentile> result;
+            const int64_t n = total_count();
+            if (n == 0) return result;
+            double level = 0;
+            int64_t cumulative = 0;
+            for (size_t i = 0; i < counts_length; ++i) {
+                int64_t count = load(counts[i]);
+                if (!count) continue;
+                cumulative += count;
+                const int64_t value = highest_equivalent(value_at_index(i));
+                const double reached = 100.0 * (double) cumulative / (double) n;
+                while (level <= reached) {
+                    result.push_back({value, level, cumulative});
+                    if (cumulative == n) {
+                        result.push_back({value, 100.0, cumulative});
+                        return result;
+                    }
+                    double ticks = ticks_per_half_distance * std::pow(2.0, std::floor(std::log2(100.0 / (100.0 - level))) + 1);
+                    level += 100.0 / ticks;
+                }
+            }
+            return result;
+        }
+
+        /**
+         * @brief Print the percentile distribution in HdrHistogram's .hgrm text format.
+         * @param out The stream.
+         * @param ticks_per_half_distance See percentiles().
+         * @param unit_ratio Values are divided by this ratio when printed (1000 prints ns as us).
+         */
+        void output_percentile_distribution(std::ostream& out, int ticks_per_half_distance = 5, double unit_ratio = 1.0) const {
+            char line[160];
+            std::snprintf(line, sizeof(line), "%12s %14s %10s %14s\n\n", "Value", "Percentile", "TotalCount", "1/(1-Percentile)");
+            out << line;
+            for (const HdrPercentile& step : percentiles(ticks_per_half_distance)) {
+                if (step.percentile < 100.0) {
+                    std::snprintf(line, sizeof(line), "%12.*f %2.12f %10lld %14.2f\n", digits, (double) step.value / unit_ratio,
+                                  step.percentile / 100.0, (long long) step.count, 1.0 / (1.0 - step.percentile / 100.0));
+                } else {
+                    std::snprintf(line, sizeof(line), "%12.*f %2.12f %10lld\n", digits, (double) step.value / unit_ratio,
+                                  1.0, (long long) step.count);
+                }
+                out << line;
+            }
+            std::snprintf(line, sizeof(line), "#[Mean    = %12.*f, StdDeviation   = %12.*f]\n", digits, mean() / unit_ratio, digits, stddev() / unit_ratio);
+            out << line;
+            std::snprintf(line, sizeof(line), "#[Max     = %12.*f, Total count    = %12lld]\n", digits, (double) max() / unit_ratio, (long long) total_count());
+            out << line;
+            std::snprintf(line, sizeof(line), "#[Buckets = %12d, SubBuckets     = %12lld]\n", bucket_count, (long long) sub_bucket_count);
+            out << line;
+        }
+
+        /**
+         * @brief Encode the histogram in HdrHistogram's compressed V2 format.
+         * @return The encoded bytes.
+         */
+        std::string encode() const {
+            // Counts are ZigZag LEB128 varints (at most 9 bytes); a negative value is a run of empty buckets.
+            std::string payload;
+            auto put_long = [&payload](int64_t signed_value) {
+                uint64_t value = ((uint64_t) signed_value << 1) ^ (uint64_t) (signed_value >> 63);
+                for (int i = 0; i < 8; ++i) {
+                    if (value < 0x80) {
+                        payload += (char) value;
+                        return;
+                    }
+                    payload += (char) ((value & 0x7F) | 0x80);
+                    value >>= 7;
+                }
+                payload += (char) value;
+            };
+            const int64_t top = load(max_value);
+            const int bucket = bucket_index(top);
+            const size_t limit = total_count() ? index_of(bucket, sub_bucket_index(top, bucket)) + 1 : 0;
+            for (size_t i = 0; i < limit;) {
+                int64_t count = load(counts[i++]);
+                if (count) {
+                    put_long(count);
+                    continue;
+                }
+                int64_t zeros = 1;
+                while (i < limit && load(counts[i]) == 0) {
+                    ++zeros;
+                    ++i;
+                }
+                put_long(zeros > 1 ? -zeros : 0);
+            }
+
+            std::string encoded;
+            auto put_be = [&encoded](uint64_t value, int bytes) {
+                for (int shift = 8 * (bytes - 1); shift >= 0; shift -= 8) encoded += (char) (value >> shift);
+            };
+            put_be((uint32_t) ENCODING_COOKIE, 4);
+            put_be((uint32_t) payload.size(), 4);
+            put_be(0, 4);  // Normalizing index offset
+            put_be((uint32_t) digits, 4);
+            put_be((uint64_t) lowest, 8);
+            put_be((uint64_t) highest, 8);
+            double ratio = 1.0;
+            uint64_t ratio_bits;
+            std::memcpy(&ratio_bits, &ratio, sizeof(ratio));
+            put_be(ratio_bits, 8);
+            encoded += payload;
+
+            std::string compressed = zlib::compress(encoded);
+            std::string result;
+            result.reserve(8 + compressed.size());
+            for (int shift = 24; shift >= 0; shift -= 8) result += (char) ((uint32_t) COMPRESSED_COOKIE >> shift);
+            for (int shift = 24; shift >= 0; shift -= 8) result += (char) ((uint32_t) compressed.size() >> shift);
+            result += compressed;
+            return result;
+        }
+
+        /**
+         * @brief Decode a histogram encoded by encode() or by another HdrHistogram implementation
+         * (V2 format, compressed or not).
+         * @param bytes The encoded bytes.
+         * @return The histogram.
+         * @throws std::invalid_argument if the bytes are not a V2 encoded histogram.
+         */
+        static BasicHdrHistogram decode(std::string_view bytes) {
+            auto get_be = [](std::string_view data, size_t offset, int size) {
+                if (offset + (size_t) size > data.size()) throw std::invalid_argument("HdrHistogram: truncated data");
+                uint64_t value = 0;
+                for (int i = 0; i < size; ++i) value = value << 8 | (unsigned char) data[offset + (size_t) i];
+                return value;
+            };
+            std::string inflated;
+            int32_t cookie = (int32_t) get_be(bytes, 0, 4);
+            if ((cookie & ~0xF0) == (COMPRESSED_COOKIE & ~0xF0)) {
+                size_t length = (size_t) get_be(bytes, 4, 4);
+                if (8 + length > bytes.size()) throw std::invalid_argument("HdrHistogram: truncated data");
+                inflated = zlib::decompress(bytes.substr(8, length));
+                bytes = inflated;
+                cookie = (int32_t) get_be(bytes, 0, 4);
+            }
+            if ((cookie & ~0xF0) != (ENCODING_COOKIE & ~0xF0)) throw std::invalid_argument("HdrHistogram: not a V2 encoded histogram");
+            size_t payload_length = (size_t) get_be(bytes, 4, 4);
+            int32_t offset = (int32_t) get_be(bytes, 8, 4);
+            int digits = (int) get_be(bytes, 12, 4);
+            int64_t lowest = (int64_t) get_be(bytes, 16, 8);
+            int64_t highest = (int64_t) get_be(bytes, 24, 8);
+            if (offset != 0) throw std::invalid_argument("HdrHistogram: normalized (shifted) histograms are not supported");
+            if (40 + payload_length > bytes.size()) throw std::invalid_argument("HdrHistogram: truncated data");
+
+            BasicHdrHistogram histogram(std::max<int64_t>(lowest, 1), std::max<int64_t>(highest, 2 * std::max<int64_t>(lowest, 1)), digits);
+            const unsigned char* p = reinterpret_cast<const unsigned char*>(bytes.data()) + 40;
+            const unsigned char* end = p + payload_length;
+            size_t index = 0;
+            while (p < end) {
+                uint64_t value = 0;
+                int shift = 0;
+                for (;;) {
+                    if (p >= end) throw std::invalid_argument("HdrHistogram: truncated count");
+                    unsigned char byte = *p++;
+                    if (shift == 56) {
+                        value |= (uint64_t) byte << 56;
+                        break;
+                    }
+                    value |= (uint64_t) (byte & 0x7F) << shift;
+                    if (!(byte & 0x80)) break;
+                    shift += 7;
+                }
+                int64_t count = (int64_t) (value >> 1) ^ -(int64_t) (value & 1);
+                if (count < 0) {
+                    // A run of zero counts; negate in unsigned arithmetic so INT64_MIN cannot overflow.
+                    uint64_t run = 0 - (uint64_t) count;
+                    if (index > histogram.counts_length || run > histogram.counts_length - index) {
+                        throw std::invalid_argument("HdrHistogram: zero run out of range");
+                    }
+                    index += (size_t) run;
+                    continue;
+                }
+                if (count) {
+                    if (index >= histogram.counts_length) throw std::invalid_argument("HdrHistogram: count out of range");
+                    if (count > std::numeric_limits<int64_t>::max() - load(histogram.total)) throw std::invalid_argument("HdrHistogram: total count overflows");
+                    int64_t at = histogram.value_at_index(index);
+                    store(histogram.counts[index], count);
+                    if constexpr (ATOMIC) histogram.total.fetch_add(count, std::memory_order_relaxed);
+                    else histogram.total += count;
+                    histogram.note_min_max(at);
+                }
+                ++index;
+            }
+            return histogram;
+        }
+
+        std::string dumps() const { return encode(); }
+        static BasicHdrHistogram loads(std::string_view bytes) { return decode(bytes); }
+        void dump(File* file) const { write_record(file, encode()); }
+        static BasicHdrHistogram load(File* file) { return decode(read_record(file)); }
+
+        /**
+         * @brief Copy the current counts into a plain histogram, e.g. to report from an
+         * AtomicHdrHistogram while other threads keep recording.
+         * @return The copy.
+         */
+        BasicHdrHistogram<int64_t> snapshot() const {
+            BasicHdrHistogram<int64_t> copy(lowest, highest, digits);
+            copy.add(*this);
+            return copy;
+        }
+    };
+
+    using HdrHistogram = BasicHdrHistogram<int64_t>;
+    using AtomicHdrHistogram = BasicHdrHistogram<std::atomic<int64_t>>;
+
+    /**
+     * @class HdrScopedTimer
+     * @brief Records the lifetime of the scope in nanoseconds into a histogram, timed with
+     * TscClock (see Timeit). Usage:
+     *     { HdrScopedTimer timer(latencies); handle(request); }
+     */
+    template<typename Histogram>
+    class HdrScopedTimer {
+    private:
+        Histogram& histogram;
+        uint64_t start;
+
+    public:
+        explicit HdrScopedTimer(Histogram& histogram) : histogram(histogram), start(TscClock::now()) {}
+
+        HdrScopedTimer(const HdrScopedTimer&) = delete;
+        HdrScopedTimer& operator=(const HdrScopedTimer&) = delete;
+
+        ~HdrScopedTimer() {
+            static const double nanoseconds_per_tick = 1e9 / TscClock::frequency();
+            histogram.record((int64_t) ((double) (TscClock::now() - start) * nanoseconds_per_tick));
+        }
+    };
+
+    /**
+     * @brief Record every per-loop time of a timeit() result, in nanoseconds.
+     * @param histogram The histogram.
+     * @param result The timeit result.
+     */
+    template<typename Counter>
+    inline void record_timeit(BasicHdrHistogram<Counter>& histogram, const TimeitResult& result) {
+        for (double seconds : result.samples) histogram.record((int64_t) (seconds * 1e9));
+    }
+
+    /**
+     * @class HdrLogWriter
+     * @brief Writes interval histograms in HdrHistogram's log format (version 1.3): one text line
+     * per interval with its start time, length, maximum and the Base64 encoded compressed histogram.
+     */
+    class HdrLogWriter {
+    private:
+        File* file;
+        double max_unit_ratio;
+
+    public:
+        /**
+         * @param file The destination file, opened for text writing.
+         * @param max_unit_ratio The Interval_Max column is the maximum divided by this ratio
+         * (the default prints nanoseconds as milliseconds, as HdrHistogram does).
+         */
+        explicit HdrLogWriter(File* file, double max_unit_ratio = 1e6) : file(file), max_unit_ratio(max_unit_ratio) {}
+
+        void write_comment(std::string_view comment) {
+            std::string line = "#";
+            line.append(comment);
+            line += '\n';
+            file->write(line.data(), line.size());
+        }
+
+        /**
+         * @brief Write the format version, start time and column legend.
+         * @param start_time The log's start time in seconds since the epoch.
+         */
+        void write_header(double start_time) {
+            char line[128];
+            write_comment("[Histogram log format version 1.3]");
+            std::snprintf(line, sizeof(line), "[StartTime: %.3f (seconds since epoch)]", start_time);
+            write_comment(line);
+            const char* legend = "\"StartTimestamp\",\"Interval_Length\",\"Interval_Max\",\"Interval_Compressed_Histogram\"\n";
+            file->write(legend, std::strlen(legend));
+        }
+
+        /**
+         * @brief Write one interval.
+         * @param histogram The interval's histogram.
+         * @param start The interval start in seconds, relative to the log's start time.
+         * @param length The interval length in seconds.
+         * @param tag An optional tag, for logs that interleave several histograms.
+         */
+        template<typename Counter>
+        void write(const BasicHdrHistogram<Counter>& histogram, double start, double length, std::string_view tag = {}) {
+            std::string line;
+            if (!tag.empty()) {
+                line = "Tag=";
+                line.append(tag);
+                line += ',';
+            }
+            char numbers[96];
+            std::snprintf(numbers, sizeof(numbers), "%.3f,%.3f,%.3f,", start, length, (double) histogram.max() / max_unit_ratio);
+            line += numbers;
+            line += base64::b64encode(histogram.encode());
+            line += '\n';
+            file->write(line.data(), line.size());
+        }
+    };
+
+    /**
+     * @class HdrLogReader
+     * @brief Reads the interval histograms of an HdrHistogram log, e.g. one written by
+     * HdrLogWriter or by the Java HistogramLogWriter.
+     */
+    class HdrLogReader {
+    private:
+        std::string_view text;
+        size_t position = 0;
+        double start = 0;
+
+    public:
+        /**
+         * @param text The whole log; it must outlive the reader.
+         */
+        explicit HdrLogReader(std::string_view text) : text(text) {}
+
+        /**
+         * @brief Get the log's start time, known after the header has been read by next().
+         * @return Seconds since the epoch, or 0 if the log has no StartTime line.
+         */
+        double start_time() const { return start; }
+
+        /**
+         * @brief Read the next interval.
+         * @param histogram Receives the histogram.
+         * @param interval_start Receives the interval start in seconds, if not null.
+         * @param interval_length Receives the interval length in seconds, if not null.
+         * @param tag Receives the tag (empty when untagged), if not null.
+         * @return false at the end of the log.
+         * @throws std::invalid_argument on a malformed line.
+         */
+        bool next(HdrHistogram& histogram, double* interval_start = nullptr, double* interval_length = nullptr, std::string* tag = nullptr) {
+            while (position < text.size()) {
+                size_t end = text.find('\n', position);
+                if (end == std::string_view::npos) end = text.size();
+                std::string_view line = text.substr(position, end - position);
+                position = end + 1;
+                if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+                if (line.empty() || line[0] == '"') continue;
+                if (line[0] == '#') {
+                    constexpr std::string_view START = "#[StartTime: ";
+                    if (line.substr(0, START.size()) == START) start = std::strtod(std::string(line.substr(START.size())).c_str(), nullptr);
+                    continue;
+                }
+                std::string_view found_tag;
+                if (line.substr(0, 4) == "Tag=") {
+                    size_t comma = line.find(',');
+                    if (comma == std::string_view::npos) throw std::invalid_argument("HdrLogReader: malformed line");
+                    found_tag = line.substr(4, comma - 4);
+                    line.remove_prefix(comma + 1);
+                }
+                std::string_view fields[4];
+                for (int i = 0; i < 3; ++i) {
+                    size_t comma = line.find(',');
+                    if (comma == std::string_view::npos) throw std::invalid_argument("HdrLogReader: malformed line");
+                    fields[i] = line.substr(0, comma);
+                    line.remove_prefix(comma + 1);
+                }
+                fields[3] = line;
+                histogram = HdrHistogram::decode(base64::b64decode(fields[3]));
+                if (interval_start) *interval_start = std::strtod(std::string(fields[0]).c_str(), nullptr);
+                if (interval_length) *interval_length = std::strtod(std::string(fields[1]).c_str(), nullptr);
+                if (tag) *tag = std::string(found_tag);
+                return true;
+            }
+            return false;
+        }
+    };
+}
@@ -0,0 +1,272 @@
+// EasyCpp - Html : HTML Escaping
+// Copyright (C) 2025  C14147
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+/**
+ * @file EasyCpp/Html/Html.h
+ * @brief This file implements Python's html.escape and html.unescape. escape() sizes its
+ *        output in one counting pass and then copies the runs between special characters in
+ *        bulk; both passes test 16 bytes at a time with SSE2. unescape() knows the predefined
+ *        XML entities, the ISO 8859-1 (Latin-1) named entities and a few common typographic
+ *        ones, and numeric character references with the HTML5 replacement rules.
+ */
+#pragma once
+#define _EASYCPP_HTML_VERSION "1.0.0"
+
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define _EASYCPP_HTML_SSE2
+#endif
+
+namespace easycpp {
+    namespace html {
+        namespace detail {
+            struct Entity {
+                const char* name;
+                uint32_t code;
+            };
+
+            // Named references; all but the last group are also recognized without ';'.
+            inline constexpr Entity ENTITIES[] = {
+                {"amp", '&'}, {"lt", '<'}, {"gt", '>'}, {"quot", '"'}, {"AMP", '&'}, {"LT", '<'}, {"GT", '>'}, {"QUOT", '"'},
+                {"nbsp", 160}, {"iexcl", 161}, {"cent", 162}, {"pound", 163}, {"curren", 164}, {"yen", 165}, {"brvbar", 166},
+                {"sect", 167}, {"uml", 168}, {"copy", 169}, {"ordf", 170}, {"laquo", 171}, {"not", 172}, {"shy", 173},
+                {"reg", 174}, {"macr", 175}, {"deg", 176}, {"plusmn", 177}, {"sup2", 178}, {"sup3", 179}, {"acute", 180},
+                {"micro", 181}, {"para", 182}, {"middot", 183}, {"cedil", 184}, {"sup1", 185}, {"ordm", 186}, {"raquo", 187},
+                {"frac14", 188}, {"frac12", 189}, {"frac34", 190}, {"iquest", 191}, {"Agrave", 192}, {"Aacute", 193},
+                {"Acirc", 194}, {"Atilde", 195}, {"Auml", 196}, {"Aring", 197}, {"AElig", 198}, {"Ccedil", 199},
+                {"Egrave", 200}, {"Eacute", 201}, {"Ecirc", 202}, {"Euml", 203}, {"Igrave", 204}, {"Iacute", 205},
+                {"Icirc", 206}, {"Iuml", 207}, {"ETH", 208}, {"Ntilde", 209}, {"Ograve", 210}, {"Oacute", 211},
+                {"Ocirc", 212}, {"Otilde", 213}, {"Ouml", 214}, {"times", 215}, {"Oslash", 216}, {"Ugrave", 217},
+                {"Uacute", 218}, {"Ucirc", 219}, {"Uuml", 220}, {"Yacute", 221}, {"THORN", 222}, {"szlig", 223},
+                {"agrave", 224}, {"aacute", 225}, {"acirc", 226}, {"atilde", 227}, {"auml", 228}, {"aring", 229},
+                {"aelig", 230}, {"ccedil", 231}, {"egrave", 232}, {"eacute", 233}, {"ecirc", 234}, {"euml", 235},
+                {"igrave", 236}, {"iacute", 237}, {"icirc", 238}, {"iuml", 239}, {"eth", 240}, {"ntilde", 241},
+                {"ograve", 242}, {"oacute", 243}, {"ocirc", 244}, {"otilde", 245}, {"ouml", 246}, {"divide", 247},
+                {"oslash", 248}, {"ugrave", 249}, {"uacute", 250}, {"ucirc", 251}, {"uuml", 252}, {"yacute", 253},
+                {"thorn", 254}, {"yuml", 255}, {"COPY", 169}, {"REG", 174},
+                {nullptr, 0},
+                {"apos", '\''}, {"ndash", 0x2013}, {"mdash", 0x2014}, {"lsquo", 0x2018}, {"rsquo", 0x2019},
+                {"sbquo", 0x201A}, {"ldquo", 0x201C}, {"rdquo", 0x201D}, {"bdquo", 0x201E}, {"dagger", 0x2020},
+                {"Dagger", 0x2021}, {"bull", 0x2022}, {"hellip", 0x2026}, {"permil", 0x2030}, {"prime", 0x2032},
+                {"lsaquo", 0x2039}, {"rsaquo", 0x203A}, {"euro", 0x20AC}, {"trade", 0x2122}, {"larr", 0x2190},
+                {"uarr", 0x2191}, {"rarr", 0x2192}, {"darr", 0x2193}, {"harr", 0x2194}, {"minus", 0x2212},
+                {"le", 0x2264}, {"ge", 0x2265}, {"ne", 0x2260}, {"infin", 0x221E}, {"ensp", 0x2002}, {"emsp", 0x2003},
+                {"thinsp", 0x2009}, {"zwnj", 0x200C}, {"zwj", 0x200D}, {"lrm", 0x200E}, {"rlm", 0x200F},
+            };
+
+            // Windows-1252 meanings of the C1 controls, used for &#128; to &#159; as in HTML5.
+            inline constexpr uint16_t C1_REPLACEMENTS[32] = {
+                0x20AC, 0x81, 0x201A, 0x0192, 0x201E, 0x2026, 0x2020, 0x2021, 0x02C6, 0x2030, 0x0160, 0x2039, 0x0152, 0x8D, 0x017D, 0x8F,
+                0x90, 0x2018, 0x2019, 0x201C, 0x201D, 0x2022, 0x2013, 0x2014, 0x02DC, 0x2122, 0x0161, 0x203A, 0x0153, 0x9D, 0x017E, 0x0178,
+            };
+
+            inline void append_utf8(std::string& out, uint32_t code) {
+                if (code < 0x80) {
+                    out += (char) code;
+                } else if (code < 0x800) {
+                    out += (char) (0xC0 | (code >> 6));
+                    out += (char) (0x80 | (code & 0x3F));
+                } else if (code < 0x10000) {
+                    out += (char) (0xE0 | (code >> 12));
+                    out += (char) (0x80 | ((code >> 6) & 0x3F));
+                    out += (char) (0x80 | (code & 0x3F));
+                } else {
+                    out += (char) (0xF0 | (code >> 18));
+                    out += (char) (0x80 | ((code >> 12) & 0x3F));
+                    out += (char) (0x80 | ((code >> 6) & 0x3F));
+                    out += (char) (0x80 | (code & 0x3F));
+                }
+            }
+
+            inline constexpr uint32_t DROP = 0xFFFFFFFF;
+
+            // HTML5 handling of numeric references: C1 controls read as Windows-1252, NUL,
+            // surrogates and out-of-range values become U+FFFD, other non-characters are dropped.
+            inline uint32_t replace_invalid(uint32_t code) {
+                if (code >= 0x80 && code <= 0x9F) return C1_REPLACEMENTS[code - 0x80];
+                if (code == 0 || code > 0x10FFFF || (code >= 0xD800 && code <= 0xDFFF)) return 0xFFFD;
+                if ((code >= 0x1 && code <= 0x8) || code == 0xB || (code >= 0xE && code <= 0x1F) || code == 0x7F ||
+                    (code >= 0xFDD0 && code <= 0xFDEF) || (code & 0xFFFE) == 0xFFFE) {
+                    return DROP;
+                }
+                return code;
+            }
+
+            inline size_t extra_length(char c, bool quote) {
+                switch (c) {
+                    case '&': return 4;
+                    case '<': case '>': return 3;
+                    case '"': case '\'': return quote ? 5 : 0;
+                    default: return 0;
+                }
+            }
+
+#ifdef _EASYCPP_HTML_SSE2
+            inline unsigned special_mask(__m128i block, bool quote) {
+                __m128i mask = _mm_or_si128(_mm_cmpeq_epi8(block, _mm_set1_epi8('&')),
+                                            _mm_or_si128(_mm_cmpeq_epi8(block, _mm_set1_epi8('<')), _mm_cmpeq_epi8(block, _mm_set1_epi8('>'))));
+                if (quote) {
+                    mask = _mm_or_si128(mask, _mm_or_si128(_mm_cmpeq_epi8(block, _mm_set1_epi8('"')), _mm_cmpeq_epi8(block, _mm_set1_epi8('\''))));
+                }
+                return (unsigned) _mm_movemask_epi8(mask);
+            }
+#endif
+
+            // First character of [p, end) that escape() replaces, or end.
+            inline const char* find_special(const char* p, const char* end, bool quote) {
+#ifdef _EASYCPP_HTML_SSE2
+                for (; end - p >= 16; p += 16) {
+                    unsigned mask = special_mask(_mm_loadu_si128((const __m128i*) p), quote);
+                    if (mask) return p + std::countr_zero(mask);
+                }
+#endif
+                while (p < end && !extra_length(*p, quote)) ++p;
+                return p;
+            }
+        }
+
+        /**
+         * @brief Replace &, < and > (and " and ' if quote is true) with HTML-safe sequences.
+         * @param s The text.
+         * @param quote Also escape quotes, for attribute values.
+         * @return The escaped text.
+         */
+        inline std::string escape(std::string_view s, bool quote = true) {
+            const char* p = s.data();
+            const char* end = p + s.size();
+            size_t extra = 0;
+            const char* tail = p;
+#ifdef _EASYCPP_HTML_SSE2
+            for (; end - tail >= 16; tail += 16) {
+                unsigned mask = detail::special_mask(_mm_loadu_si128((const __m128i*) tail), quote);
+                for (; mask; mask &= mask - 1) extra += detail::extra_length(tail[std::countr_zero(mask)], quote);
+            }
+#endif
+            for (; tail < end; ++tail) extra += detail::extra_length(*tail, quote);
+            if (!extra) return std::string(s);
+
+            std::string out(s.size() + extra, '\0');
+            char* o = out.data();
+            while (p < end) {
+                const char* q = detail::find_special(p, end, quote);
+                memcpy(o, p, (size_t) (q - p));
+                o += q - p;
+                if (q == end) break;
+                const char* replacement;
+                switch (*q) {
+                    case '&': replacement = "&amp;"; break;
+                    case '<': replacement = "&lt;"; break;
+                    case '>': replacement = "&gt;"; break;
+                    case '"': replacement = "&quot;"; break;
+                    default: replacement = "&#x27;"; break;
+                }
+                size_t length = strlen(replacement);
+                memcpy(o, replacement, length);
+                o += length;
+                p = q + 1;
+            }
+            return out;
+        }
+
+        /**
+         * @brief Replace named and numeric character references with the characters they stand
+         * for. Unknown references are left as they are.
+         * @param s The text.
+         * @return The unescaped text.
+         */
+        inline std::string unescape(std::string_view s) {
+            size_t amp = s.find('&');
+            if (amp == std::string_view::npos) return std::string(s);
+            std::string out(s.substr(0, amp));
+            out.reserve(s.size());
+            size_t i = amp;
+            while (i < s.size()) {
+                if (s[i] != '&') {
+                    size_t next = s.find('&', i);
+                    if (next == std::string_view::npos) next = s.size();
+                    out.append(s, i, next - i);
+                    i = next;
+                    continue;
+                }
+                size_t j = i + 1;
+                if (j < s.size() && s[j] == '#') {
+                    bool hex = j + 1 < s.size() && (s[j + 1] == 'x' || s[j + 1] == 'X');
+                    size_t k = j + (hex ? 2 : 1);
+                    size_t start = k;
+                    uint64_t code = 0;
+                    for (; k < s.size(); ++k) {
+                        char c = s[k];
+                        int digit;
+                        if (c >= '0' && c <= '9') digit = c - '0';
+                        else if (hex && c >= 'a' && c <= 'f') digit = c - 'a' + 10;
+                        else if (hex && c >= 'A' && c <= 'F') digit = c - 'A' + 10;
+                        else break;
+                        if (code <= 0x10FFFF) code = code * (hex ? 16 : 10) + (uint64_t) digit;
+                    }
+                    if (k == start) {
+                        out += '&';
+                        ++i;
+                        continue;
+                    }
+                    if (k < s.size() && s[k] == ';') ++k;
+                    uint32_t replacement = detail::replace_invalid(code > 0x10FFFF ? 0x110000 : (uint32_t) code);
+                    if (replacement != detail::DROP) detail::append_utf8(out, replacement);
+                    i = k;
+                    continue;
+                }
+                size_t k = j;
+                while (k < s.size() && k - j < 32 && !strchr("\t\n\f <&#;", s[k])) ++k;
+                std::string_view name = s.substr(j, k - j);
+                bool terminated = k < s.size() && s[k] == ';';
+                // With ';' the whole name must match; without, the longest legacy name that
+                // prefixes it does (&copy2023 is "©2023").
+                const detail::Entity* best = nullptr;
+                bool legacy = true;
+                for (const detail::Entity& entity : detail::ENTITIES) {
+                    if (!entity.name) {
+                        legacy = false;
+                        continue;
+                    }
+                    size_t length = strlen(entity.name);
+                    if (terminated && name.size() == length && name == entity.name) {
+                        best = &entity;
+                        break;
+                    }
+                    if (legacy && length <= name.size() && name.compare(0, length, entity.name) == 0 &&
+                        (!best || length > strlen(best->name))) {
+                        best = &entity;
+                    }
+                }
+                if (!best) {
+                    out += '&';
+                    ++i;
+                    continue;
+                }
+                detail::append_utf8(out, best->code);
+                size_t length = strlen(best->name);
+                i = j + length + (terminated && length == name.size() ? 1 : 0);
+            }
+            return out;
+        }
+    }
+}
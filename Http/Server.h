@@ -0,0 +1,985 @@
+// EasyCpp - Http : HTTP/1.1 Server for Local Endpoints
+// Copyright (C) 2025  C14147
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+/**
+ * @file EasyCpp/Http/Server.h
+ * @brief This file implements an HTTP/1.1 server in the spirit of Python's http.server, for
+ *        internal endpoints (metrics, health checks, small APIs) on localhost or a Unix socket.
+ *        - Each of the server's threads runs its own epoll reactor. On TCP every reactor has
+ *          its own listening socket bound with SO_REUSEPORT, so the kernel spreads incoming
+ *          connections and reactors share nothing; a Unix socket is shared with EPOLLEXCLUSIVE.
+ *        - Requests are parsed in place: the method, target, headers and body of a Request are
+ *          views into the connection's read buffer, and line ends are found 16 bytes at a time
+ *          with SSE2.
+ *        - Connections are kept alive and pipelined: every complete request in the buffer is
+ *          answered, and the responses leave in one send().
+ *        - Static files are sent with sendfile(2), without copying them through user space.
+ *        Routes are exact paths, frozen into a FrozenDict when the server starts; directories
+ *        are mounted with static_files(). The server itself needs Linux (epoll).
+ */
+#pragma once
+#define _EASYCPP_HTTP_VERSION "1.0.0"
+
+#include <Dict/FrozenDict.h>
+#include <FileOperator/FileOperator.h>
+#include <Urllib/Parse.h>
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cerrno>
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <ctime>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/sendfile.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define _EASYCPP_HTTP_SSE2
+#endif
+
+namespace easycpp {
+    namespace http {
+        namespace detail {
+            constexpr size_t READ_CHUNK = 16384;
+            constexpr size_t MAX_HEADER_BYTES = 65536;
+            constexpr size_t MAX_HEADERS = 100;
+            constexpr int MAX_EVENTS = 256;
+
+            // First occurrence of c in [p, end), or end.
+            inline const char* find_byte(const char* p, const char* end, char c) {
+#ifdef _EASYCPP_HTTP_SSE2
+                __m128i needle = _mm_set1_epi8(c);
+                for (; end - p >= 16; p += 16) {
+                    unsigned mask = (unsigned) _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*) p), needle));
+                    if (mask) return p + std::countr_zero(mask);
+                }
+#endif
+                while (p < end && *p != c) ++p;
+                return p;
+            }
+
+            /**
+             * @brief Find the blank line that ends the header block.
+             * @return The offset just past it, or 0 if the block is not complete yet.
+             */
+            inline size_t find_header_end(const char* data, size_t size, size_t from) {
+                const char* end = data + size;
+                for (const char* p = find_byte(data + from, end, '\n'); p < end; p = find_byte(p + 1, end, '\n')) {
+                    if (p + 1 < end && p[1] == '\n') return (size_t) (p + 2 - data);
+                    if (p + 2 < end && p[1] == '\r' && p[2] == '\n') return (size_t) (p + 3 - data);
+                }
+                return 0;
+            }
+
+            constexpr char lower(char c) {
+                return c >= 'A' && c <= 'Z' ? (char) (c + ('a' - 'A')) : c;
+            }
+
+            inline bool iequals(std::string_view a, std::string_view b) {
+                if (a.size() != b.size()) return false;
+                for (size_t i = 0; i < a.size(); ++i) {
+                    if (lower(a[i]) != lower(b[i])) return false;
+                }
+                return true;
+            }
+
+            inline std::string_view trim(std::string_view s) {
+                while (!s.empty() && (s.front() == ' ' || s.front() == '\t')) s.remove_prefix(1);
+                while (!s.empty() && (s.back() == ' ' || s.back() == '\t' || s.back() == '\r')) s.remove_suffix(1);
+                return s;
+            }
+
+            // Whether a comma-separated header value such as Connection contains a token.
+            inline bool has_token(std::string_view list, std::string_view token) {
+                while (!list.empty()) {
+                    size_t comma = list.find(',');
+                    if (iequals(trim(list.substr(0, comma)), token)) return true;
+                    if (comma == std::string_view::npos) break;
+                    list.remove_prefix(comma + 1);
+                }
+                return false;
+            }
+
+            inline const char* reason(int status) {
+                switch (status) {
+                    case 200: return "OK";
+                    case 201: return "Created";
+                    case 204: return "No Content";
+                    case 301: return "Moved Permanently";
+                    case 302: return "Found";
+                    case 304: return "Not Modified";
+                    case 400: return "Bad Request";
+                    case 401: return "Unauthorized";
+                    case 403: return "Forbidden";
+                    case 404: return "Not Found";
+                    case 405: return "Method Not Allowed";
+                    case 408: return "Request Timeout";
+                    case 413: return "Content Too Large";
+                    case 431: return "Request Header Fields Too Large";
+                    case 500: return "Internal Server Error";
+                    case 501: return "Not Implemented";
+                    case 503: return "Service Unavailable";
+                    case 505: return "HTTP Version Not Supported";
+                    default: return status < 300 ? "OK" : status < 400 ? "Redirect" : status < 500 ? "Client Error" : "Server Error";
+                }
+            }
+
+            inline std::string_view content_type(std::string_view path) {
+                static constexpr std::pair<std::string_view, std::string_view> TYPES[] = {
+                    {".html", "text/html; charset=utf-8"}, {".htm", "text/html; charset=utf-8"},
+                    {".css", "text/css; charset=utf-8"}, {".js", "text/javascript; charset=utf-8"},
+                    {".json", "application/json"}, {".txt", "text/plain; charset=utf-8"},
+                    {".csv", "text/csv; charset=utf-8"}, {".xml", "application/xml"},
+                    {".svg", "image/svg+xml"}, {".png", "image/png"}, {".jpg", "image/jpeg"},
+                    {".jpeg", "image/jpeg"}, {".gif", "image/gif"}, {".ico", "image/x-icon"},
+                    {".wasm", "application/wasm"}, {".pdf", "application/pdf"}, {".gz", "application/gzip"},
+                };
+                size_t dot = path.rfind('.');
+                if (dot == std::string_view::npos || path.find('/', dot) != std::string_view::npos) return "application/octet-stream";
+                std::string_view extension = path.substr(dot);
+                for (const auto& [suffix, type] : TYPES) {
+                    if (iequals(extension, suffix)) return type;
+                }
+                return "application/octet-stream";
+            }
+        }
+
+        /**
+         * @struct Header
+         * @brief A request header, as views into the request buffer.
+         */
+        struct Header {
+            std::string_view name;
+            std::string_view value;
+        };
+
+        /**
+         * @class Request
+         * @brief A parsed request. Every view points into the connection's read buffer and is
+         * valid only while the handler runs; copy what must outlive it.
+         */
+        class Request {
+        public:
+            std::string_view method;
+            std::string_view target;   // as sent, e.g. "/search?q=a%20b"
+            std::string_view path;     // target without the query, still percent-encoded
+            std::string_view query;    // after '?', without it
+            std::string_view version;  // "HTTP/1.1"
+            std::string_view body;
+            std::vector<Header> headers;
+            bool keep_alive = true;
+
+            /**
+             * @brief Get a header value by case-insensitive name.
+             * @return The value, or an empty view if the header is absent.
+             */
+            std::string_view header(std::string_view name) const {
+                for (const Header& header : headers) {
+                    if (detail::iequals(header.name, name)) return header.value;
+                }
+                return std::string_view();
+            }
+
+            /**
+             * @brief Decode the query string, as urllib.parse.parse_qsl().
+             */
+            std::vector<std::pair<std::string, std::string>> query_params(bool keep_blank_values = false) const {
+                return urllib::parse::parse_qsl(query, keep_blank_values);
+            }
+        };
+
+        namespace detail {
+            enum class ParseResult { COMPLETE, INCOMPLETE, INVALID };
+
+            /**
+             * @brief Parse one request at the start of a buffer, in place.
+             * @param data The buffered bytes.
+             * @param size The number of buffered bytes.
+             * @param request Receives the views of the request.
+             * @param consumed Receives the length of the request, head and body.
+             * @param status Receives the status to answer with on INVALID.
+             * @param max_body The largest accepted body.
+             */
+            inline ParseResult parse_request(const char* data, size_t size, Request& request, size_t& consumed, int& status, size_t max_body) {
+                size_t head = find_header_end(data, size, 0);
+                if (head == 0) {
+                    if (size > MAX_HEADER_BYTES) {
+                        status = 431;
+                        return ParseResult::INVALID;
+                    }
+                    return ParseResult::INCOMPLETE;
+                }
+                if (head > MAX_HEADER_BYTES) {
+                    status = 431;
+                    return ParseResult::INVALID;
+                }
+                status = 400;
+                const char* end = data + head;
+                const char* line_end = find_byte(data, end, '\n');
+                std::string_view line = trim(std::string_view(data, (size_t) (line_end - data)));
+                size_t space = line.find(' ');
+                size_t last_space = line.rfind(' ');
+                if (space == std::string_view::npos || last_space == space) return ParseResult::INVALID;
+                request.method = line.substr(0, space);
+                request.target = trim(line.substr(space + 1, last_space - space - 1));
+                request.version = line.substr(last_space + 1);
+                if (request.method.empty() || request.target.empty()) return ParseResult::INVALID;
+                if (request.version.size() != 8 || request.version.substr(0, 5) != "HTTP/") return ParseResult::INVALID;
+                if (request.version.substr(5, 2) != "1." || (request.version[7] != '0' && request.version[7] != '1')) {
+                    status = 505;
+                    return ParseResult::INVALID;
+                }
+
+                request.headers.clear();
+                for (const char* p = line_end + 1; p < end;) {
+                    const char* next = find_byte(p, end, '\n');
+                    std::string_view header(p, (size_t) (next - p));
+                    p = next + 1;
+                    if (!header.empty() && header.back() == '\r') header.remove_suffix(1);
+                    if (header.empty()) break;
+                    size_t colon = header.find(':');
+                    // Obsolete line folding and whitespace before the colon are rejected, as RFC 9112 asks.
+                    if (colon == 0 || colon == std::string_view::npos || header[0] == ' ' || header[0] == '\t' ||
+                        header[colon - 1] == ' ' || header[colon - 1] == '\t') {
+                        return ParseResult::INVALID;
+                    }
+                    if (request.headers.size() == MAX_HEADERS) {
+                        status = 431;
+                        return ParseResult::INVALID;
+                    }
+                    request.headers.push_back({header.substr(0, colon), trim(header.substr(colon + 1))});
+                }
+
+                size_t length = 0;
+                bool has_length = false;
+                for (const Header& header : request.headers) {
+                    if (iequals(header.name, "Transfer-Encoding")) {
+                        status = 501;
+                        return ParseResult::INVALID;
+                    }
+                    if (!iequals(header.name, "Content-Length")) continue;
+                    size_t value = 0;
+                    auto [ptr, error] = std::from_chars(header.value.data(), header.value.data() + header.value.size(), value);
+                    if (error != std::errc() || ptr != header.value.data() + header.value.size() || (has_length && value != length)) {
+                        return ParseResult::INVALID;
+                    }
+                    length = value;
+                    has_length = true;
+                }
+                if (length > max_body) {
+                    status = 413;
+                    return ParseResult::INVALID;
+                }
+                if (size - head < length) return ParseResult::INCOMPLETE;
+                request.body = std::string_view(data + head, length);
+                consumed = head + length;
+
+                std::string_view connection = request.header("Connection");
+                request.keep_alive = request.version[7] == '1' ? !has_token(connection, "close") : has_token(connection, "keep-alive");
+                std::string_view target = request.target;
+                if (target.substr(0, 7) == "http://" || target.substr(0, 8) == "https://") {
+                    // Absolute form, as sent to proxies: keep only the path and query.
+                    size_t slash = target.find('/', target.find("//") + 2);
+                    target = slash == std::string_view::npos ? std::string_view("/") : target.substr(slash);
+                }
+                size_t question = target.find('?');
+                request.path = target.substr(0, question);
+                request.query = question == std::string_view::npos ? std::string_view() : target.substr(question + 1);
+                return ParseResult::COMPLETE;
+            }
+        }
+
+        /**
+         * @class Response
+         * @brief The response a handler fills in. The body is either the body string or, after
+         * send_file(), a file that is sent with sendfile(2).
+         */
+        class Response {
+        private:
+            int file_fd = -1;
+            size_t file_size = 0;
+
+            friend class Server;
+
+            void reset(int code) {
+                if (file_fd >= 0) ::close(file_fd);
+                file_fd = -1;
+                headers.clear();
+                status = code;
+                set_body(detail::reason(code));
+            }
+
+        public:
+            int status = 200;
+            std::vector<std::pair<std::string, std::string>> headers;
+            std::string body;
+
+            Response() = default;
+            Response(const Response&) = delete;
+            Response& operator=(const Response&) = delete;
+
+            ~Response() {
+                if (file_fd >= 0) ::close(file_fd);
+            }
+
+            /**
+             * @brief Add a header. Content-Length, Date and Connection are set by the server.
+             */
+            void set_header(std::string name, std::string value) {
+                headers.emplace_back(std::move(name), std::move(value));
+            }
+
+            /**
+             * @brief Set the body and its Content-Type.
+             */
+            void set_body(std::string content, std::string_view content_type = "text/plain; charset=utf-8") {
+                body = std::move(content);
+                set_header("Content-Type", std::string(content_type));
+            }
+
+            /**
+             * @brief Send a file as the body. Missing files give 404 and unreadable ones 403.
+             * @param path The file.
+             * @return True if the file will be sent.
+             */
+            bool send_file(const std::string& path) {
+                if (file_fd >= 0) {
+                    ::close(file_fd);
+                    file_fd = -1;
+                }
+                if (!is_exist(path.c_str()) || !is_readable(path.c_str())) {
+                    status = is_exist(path.c_str()) ? 403 : 404;
+                    set_body(detail::reason(status));
+                    return false;
+                }
+                int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+                struct stat info;
+                if (fd < 0 || fstat(fd, &info) != 0 || !S_ISREG(info.st_mode)) {
+                    if (fd >= 0) ::close(fd);
+                    status = 404;
+                    set_body(detail::reason(status));
+                    return false;
+                }
+                file_fd = fd;
+                file_size = (size_t) info.st_size;
+                body.clear();
+                set_header("Content-Type", std::string(detail::content_type(path)));
+                return true;
+            }
+        };
+
+        /**
+         * @brief A request handler.
+         */
+        using Handler = std::function<void(const Request&, Response&)>;
+
+#ifdef __linux__
+        /**
+         * @class Server
+         * @brief An HTTP/1.1 server with one epoll reactor per thread.
+         *
+         * @code
+         * easycpp::http::Server server("127.0.0.1", 8080, 4);
+         * server.route("GET", "/health", [](const auto&, auto& response) { response.set_body("ok"); });
+         * server.static_files("/static/", "./public");
+         * server.serve_forever();
+         * @endcode
+         */
+        class Server {
+        private:
+            struct Connection {
+                int fd;
+                std::string in;
+                size_t head = 0;           // start of the unparsed input
+                std::string out;
+                size_t sent = 0;
+                int file_fd = -1;
+                off_t file_offset = 0;
+                size_t file_left = 0;
+                bool close_after = false;  // close once the output is flushed
+                bool peer_closed = false;
+                bool writing = false;      // output is blocked; wait for EPOLLOUT instead of reading
+                int64_t last_active = 0;
+                Request request;
+
+                explicit Connection(int fd) : fd(fd) {}
+
+                ~Connection() {
+                    if (file_fd >= 0) ::close(file_fd);
+                    ::close(fd);
+                }
+            };
+
+            struct Mount {
+                std::string prefix;
+                std::string directory;
+            };
+
+            struct Route {
+                std::vector<std::pair<std::string, Handler>> methods;
+            };
+
+            class Reactor {
+            public:
+                Server& server;
+                int epoll_fd = -1;
+                int listen_fd;
+                int wake_fd = -1;
+                std::vector<std::unique_ptr<Connection>> connections;  // by file descriptor
+                char date[40] = {};
+                time_t date_time = 0;
+                int64_t last_sweep = 0;
+
+                Reactor(Server& server, int listen_fd) : server(server), listen_fd(listen_fd) {
+                    epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+                    wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+                    epoll_event event{};
+                    event.events = EPOLLIN;
+                    event.data.ptr = &wake_fd;
+                    bool ok = epoll_fd >= 0 && wake_fd >= 0 && epoll_ctl(epoll_fd, EPOLL_CTL_ADD, wake_fd, &event) == 0;
+                    event.events = EPOLLIN | (server.unix_path.empty() ? 0u : (uint32_t) EPOLLEXCLUSIVE);
+                    event.data.ptr = &this->listen_fd;
+                    if (!ok || epoll_ctl(epoll_fd, EPOLL_CTL_ADD, listen_fd, &event) != 0) {
+                        int error = errno;
+                        if (epoll_fd >= 0) ::close(epoll_fd);
+                        if (wake_fd >= 0) ::close(wake_fd);
+                        errno = error;
+                        fail("epoll");
+                    }
+                }
+
+                ~Reactor() {
+                    connections.clear();
+                    if (epoll_fd >= 0) ::close(epoll_fd);
+                    if (wake_fd >= 0) ::close(wake_fd);
+                }
+
+                void wake() {
+                    uint64_t one = 1;
+                    ssize_t ignored = ::write(wake_fd, &one, sizeof(one));
+                    (void) ignored;
+                }
+
+                static int64_t now() {
+                    return std::chrono::duration_cast<std::chrono::seconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+                }
+
+                void run() {
+                    epoll_event events[detail::MAX_EVENTS];
+                    while (server.running.load(std::memory_order_acquire)) {
+                        int count = epoll_wait(epoll_fd, events, detail::MAX_EVENTS, 1000);
+                        if (count < 0 && errno != EINTR) break;
+                        for (int i = 0; i < count; ++i) {
+                            void* tag = events[i].data.ptr;
+                            if (tag == &wake_fd) continue;
+                            if (tag == &listen_fd) {
+                                accept_all();
+                                continue;
+                            }
+                            Connection* connection = static_cast<Connection*>(tag);
+                            if (events[i].events & (EPOLLERR | EPOLLHUP) && !(events[i].events & EPOLLIN)) {
+                                close(connection);
+                                continue;
+                            }
+                            connection->last_active = now();
+                            if (events[i].events & EPOLLIN && !receive(connection)) continue;
+                            pump(connection);
+                        }
+                        sweep();
+                    }
+                    connections.clear();
+                }
+
+                void accept_all() {
+                    while (true) {
+                        int fd = accept4(listen_fd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+                        if (fd < 0) return;  // EAGAIN, or another reactor took the connection
+                        if (server.unix_path.empty()) {
+                            int one = 1;
+                            setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+                        }
+                        if ((size_t) fd >= connections.size()) connections.resize((size_t) fd + 1);
+                        connections[(size_t) fd] = std::make_unique<Connection>(fd);
+                        Connection* connection = connections[(size_t) fd].get();
+                        connection->last_active = now();
+                        epoll_event event{};
+                        event.events = EPOLLIN;
+                        event.data.ptr = connection;
+                        if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &event) != 0) connections[(size_t) fd].reset();
+                    }
+                }
+
+                void close(Connection* connection) {
+                    epoll_ctl(epoll_fd, EPOLL_CTL_DEL, connection->fd, nullptr);
+                    connections[(size_t) connection->fd].reset();
+                }
+
+                // Read what is available, but no more than one largest request beyond the unparsed
+                // input; the rest stays in the socket until process() has consumed something.
+                // Returns false if the connection was closed.
+                bool receive(Connection* connection) {
+                    const size_t limit = detail::MAX_HEADER_BYTES + server.max_body_size;
+                    while (true) {
+                        if (connection->in.size() - connection->head > limit) return true;
+                        size_t used = connection->in.size();
+                        connection->in.resize(used + detail::READ_CHUNK);
+                        ssize_t n = ::recv(connection->fd, connection->in.data() + used, detail::READ_CHUNK, 0);
+                        connection->in.resize(used + (n > 0 ? (size_t) n : 0));
+                        if (n > 0) {
+                            if ((size_t) n < detail::READ_CHUNK) return true;
+                            continue;
+                        }
+                        if (n == 0) {
+                            connection->peer_closed = true;
+                            return true;
+                        }
+                        if (errno == EAGAIN || errno == EWOULDBLOCK) return true;
+                        if (errno == EINTR) continue;
+                        close(connection);
+                        return false;
+                    }
+                }
+
+                /**
+                 * @brief Answer every complete request in the input, appending the responses to
+                 * the output. Stops after a response with a file body, which must be sent before
+                 * the responses that follow it.
+                 */
+                void process(Connection* connection) {
+                    while (!connection->close_after && connection->file_fd < 0) {
+                        const char* data = connection->in.data() + connection->head;
+                        size_t size = connection->in.size() - connection->head;
+                        if (size == 0) break;
+                        size_t consumed = 0;
+                        int status = 400;
+                        detail::ParseResult result = detail::parse_request(data, size, connection->request, consumed, status, server.max_body_size);
+                        if (result == detail::ParseResult::INCOMPLETE) break;
+                        if (result == detail::ParseResult::INVALID) {
+                            Response response;
+                            response.status = status;
+                            response.set_body(detail::reason(status));
+                            connection->close_after = true;
+                            write_response(connection, response, false);
+                            break;
+                        }
+                        Response response;
+                        server.dispatch(connection->request, response);
+                        if (!connection->request.keep_alive) connection->close_after = true;
+                        bool keep_alive_1_0 = connection->request.keep_alive && connection->request.version == "HTTP/1.0";
+                        write_response(connection, response, connection->request.method == "HEAD", keep_alive_1_0);
+                        connection->head += consumed;
+                    }
+                    if (connection->head == connection->in.size()) {
+                        connection->in.clear();
+                        connection->head = 0;
+                    } else if (connection->head > 0 && connection->head >= connection->in.size() / 2) {
+                        connection->in.erase(0, connection->head);
+                        connection->head = 0;
+                    }
+                }
+
+                const char* http_date() {
+                    time_t current = time(nullptr);
+                    if (current != date_time) {
+                        struct tm parts;
+                        gmtime_r(&current, &parts);
+                        strftime(date, sizeof(date), "%a, %d %b %Y %H:%M:%S GMT", &parts);
+                        date_time = current;
+                    }
+                    return date;
+                }
+
+                // An HTTP/1.0 client closes by default, so a connection it asked to keep open is confirmed.
+                void write_response(Connection* connection, Response& response, bool head_only, bool keep_alive_1_0 = false) {
+                    std::string& out = connection->out;
+                    size_t length = response.file_fd >= 0 ? response.file_size : response.body.size();
+                    char number[24];
+                    out += "HTTP/1.1 ";
+                    out.append(number, (size_t) (std::to_chars(number, number + sizeof(number), response.status).ptr - number));
+                    out += ' ';
+                    out += detail::reason(response.status);
+                    out += "\r\nServer: EasyCpp\r\nDate: ";
+                    out += http_date();
+                    out += "\r\nContent-Length: ";
+                    out.append(number, (size_t) (std::to_chars(number, number + sizeof(number), length).ptr - number));
+                    if (connection->close_after) out += "\r\nConnection: close";
+                    else if (keep_alive_1_0) out += "\r\nConnection: keep-alive";
+                    for (const auto& [name, value] : response.headers) {
+                        out += "\r\n";
+                        out += name;
+                        out += ": ";
+                        out += value;
+                    }
+                    out += "\r\n\r\n";
+                    if (head_only) return;
+                    if (response.file_fd >= 0) {
+                        connection->file_fd = std::exchange(response.file_fd, -1);
+                        connection->file_offset = 0;
+                        connection->file_left = length;
+                        if (length == 0) {
+                            ::close(connection->file_fd);
+                            connection->file_fd = -1;
+                        }
+                    } else {
+                        out += response.body;
+                    }
+                }
+
+                enum class Flush { DONE, BLOCKED, FAILED };
+
+                Flush flush(Connection* connection) {
+                    while (connection->sent < connection->out.size()) {
+                        int flags = MSG_NOSIGNAL | (connection->file_left ? MSG_MORE : 0);
+                        ssize_t n = ::send(connection->fd, connection->out.data() + connection->sent, connection->out.size() - connection->sent, flags);
+                        if (n < 0) {
+                            if (errno == EINTR) continue;
+                            return errno == EAGAIN || errno == EWOULDBLOCK ? Flush::BLOCKED : Flush::FAILED;
+                        }
+                        connection->sent += (size_t) n;
+                    }
+                    connection->out.clear();
+                    connection->sent = 0;
+                    while (connection->file_left > 0) {
+                        ssize_t n = ::sendfile(connection->fd, connection->file_fd, &connection->file_offset, std::min<size_t>(connection->file_left, 1 << 30));
+                        if (n < 0) {
+                            if (errno == EINTR) continue;
+                            return errno == EAGAIN || errno == EWOULDBLOCK ? Flush::BLOCKED : Flush::FAILED;
+                        }
+                        if (n == 0) return Flush::FAILED;  // the file shrank
+                        connection->file_left -= (size_t) n;
+                    }
+                    if (connection->file_fd >= 0) {
+                        ::close(connection->file_fd);
+                        connection->file_fd = -1;
+                    }
+                    return Flush::DONE;
+                }
+
+                // While output is blocked, stop reading so a pipelining client cannot grow the input without bound.
+                void want_write(Connection* connection, bool enable) {
+                    if (connection->writing == enable) return;
+                    epoll_event event{};
+                    event.events = enable ? EPOLLOUT : EPOLLIN;
+                    event.data.ptr = connection;
+                    epoll_ctl(epoll_fd, EPOLL_CTL_MOD, connection->fd, &event);
+                    connection->writing = enable;
+                }
+
+                // Answer what can be answered and send it, until the socket blocks or the input runs out.
+                void pump(Connection* connection) {
+                    while (true) {
+                        process(connection);
+                        bool held = connection->file_fd >= 0;
+                        Flush result = flush(connection);
+                        if (result == Flush::FAILED) {
+                            close(connection);
+                            return;
+                        }
+                        if (result == Flush::BLOCKED) {
+                            want_write(connection, true);
+                            return;
+                        }
+                        if (connection->close_after || connection->peer_closed) {
+                            close(connection);
+                            return;
+                        }
+                        // A file body held back the requests behind it; answer them now.
+                        if (!held || connection->head == connection->in.size()) break;
+                    }
+                    want_write(connection, false);
+                }
+
+                // Close keep-alive connections that have been idle too long.
+                void sweep() {
+                    int64_t current = now();
+                    if (current == last_sweep) return;
+                    last_sweep = current;
+                    for (auto& connection : connections) {
+                        if (connection && !connection->writing && current - connection->last_active > server.idle_timeout) close(connection.get());
+                    }
+                }
+            };
+
+            std::string address;
+            std::string unix_path;
+            int bound_port = 0;
+            size_t thread_count;
+            std::vector<int> listen_fds;
+            std::vector<std::unique_ptr<Reactor>> reactors;
+            std::vector<std::thread> threads;
+            std::atomic<bool> running{false};
+            bool started = false;
+
+            std::vector<std::pair<std::string, Route>> route_list;
+            FrozenDict<std::string, size_t> route_index;
+            std::vector<Mount> mounts;
+
+            [[noreturn]] static void fail(const std::string& what) {
+                throw std::runtime_error("http: " + what + ": " + std::strerror(errno));
+            }
+
+            int open_listener(int port) {
+                if (!unix_path.empty()) {
+                    int fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+                    if (fd < 0) fail("socket");
+                    sockaddr_un local{};
+                    local.sun_family = AF_UNIX;
+                    if (unix_path.size() >= sizeof(local.sun_path)) throw std::invalid_argument("http: Unix socket path too long");
+                    std::memcpy(local.sun_path, unix_path.c_str(), unix_path.size() + 1);
+                    struct stat info;
+                    if (lstat(unix_path.c_str(), &info) == 0 && S_ISSOCK(info.st_mode)) ::unlink(unix_path.c_str());
+                    if (::bind(fd, (sockaddr*) &local, sizeof(local)) != 0 || ::listen(fd, SOMAXCONN) != 0) {
+                        ::close(fd);
+                        fail("cannot bind " + unix_path);
+                    }
+                    return fd;
+                }
+                sockaddr_storage storage{};
+                socklen_t length;
+                std::string host = address.empty() ? "0.0.0.0" : address == "localhost" ? "127.0.0.1" : address;
+                auto* v4 = (sockaddr_in*) &storage;
+                auto* v6 = (sockaddr_in6*) &storage;
+                if (inet_pton(AF_INET, host.c_str(), &v4->sin_addr) == 1) {
+                    v4->sin_family = AF_INET;
+                    v4->sin_port = htons((uint16_t) port);
+                    length = sizeof(sockaddr_in);
+                } else if (inet_pton(AF_INET6, host.c_str(), &v6->sin6_addr) == 1) {
+                    v6->sin6_family = AF_INET6;
+                    v6->sin6_port = htons((uint16_t) port);
+                    length = sizeof(sockaddr_in6);
+                } else {
+                    throw std::invalid_argument("http: not a numeric address: " + address);
+                }
+                int fd = ::socket(storage.ss_family, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+                if (fd < 0) fail("socket");
+                int one = 1;
+                setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+                setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &one, sizeof(one));
+                if (::bind(fd, (sockaddr*) &storage, length) != 0 || ::listen(fd, SOMAXCONN) != 0) {
+                    int error = errno;
+                    ::close(fd);
+                    errno = error;
+                    fail("cannot bind " + host + ":" + std::to_string(port));
+                }
+                if (port == 0) {
+                    getsockname(fd, (sockaddr*) &storage, &length);
+                    bound_port = ntohs(storage.ss_family == AF_INET ? v4->sin_port : v6->sin6_port);
+                }
+                return fd;
+            }
+
+            void dispatch(const Request& request, Response& response) {
+                try {
+                    auto found = route_index.find(request.path);
+                    if (found != route_index.end()) {
+                        Route& route = route_list[found->second].second;
+                        const Handler* handler = nullptr;
+                        for (const auto& [method, candidate] : route.methods) {
+                            if (method == request.method) handler = &candidate;
+                        }
+                        if (handler == nullptr && request.method == "HEAD") {
+                            for (const auto& [method, candidate] : route.methods) {
+                                if (method == "GET") handler = &candidate;
+                            }
+                        }
+                        if (handler) {
+                            (*handler)(request, response);
+                            return;
+                        }
+                        std::string allow;
+                        for (const auto& [method, candidate] : route.methods) allow += (allow.empty() ? "" : ", ") + method;
+                        response.status = 405;
+                        response.set_header("Allow", allow);
+                        response.set_body(detail::reason(405));
+                        return;
+                    }
+                    for (const Mount& mount : mounts) {
+                        if (request.path.substr(0, mount.prefix.size()) != mount.prefix) continue;
+                        if (request.method != "GET" && request.method != "HEAD") {
+                            response.status = 405;
+                            response.set_header("Allow", "GET, HEAD");
+                            response.set_body(detail::reason(405));
+                            return;
+                        }
+                        serve_file(mount, request, response);
+                        return;
+                    }
+                    response.status = 404;
+                    response.set_body(detail::reason(404));
+                } catch (const std::exception&) {
+                    response.reset(500);
+                }
+            }
+
+            static void serve_file(const Mount& mount, const Request& request, Response& response) {
+                std::string relative = urllib::parse::unquote(request.path.substr(mount.prefix.size()));
+                // Refuse anything that could leave the mounted directory.
+                std::string_view rest = relative;
+                while (!rest.empty()) {
+                    size_t slash = rest.find('/');
+                    std::string_view segment = rest.substr(0, slash);
+                    if (segment == ".." || segment.find('\0') != std::string_view::npos || segment.find('\\') != std::string_view::npos) {
+                        response.status = 404;
+                        response.set_body(detail::reason(404));
+                        return;
+                    }
+                    if (slash == std::string_view::npos) break;
+                    rest.remove_prefix(slash + 1);
+                }
+                if (relative.empty() || relative.back() == '/') relative += "index.html";
+                response.send_file(mount.directory + "/" + relative);
+            }
+
+        public:
+            /**
+             * @brief The largest request body accepted; larger requests get 413.
+             */
+            size_t max_body_size = 16 << 20;
+
+            /**
+             * @brief Seconds an idle keep-alive connection is kept open.
+             */
+            int64_t idle_timeout = 60;
+
+            /**
+             * @brief Create a server and bind its sockets.
+             * @param address A numeric IPv4 or IPv6 address, "localhost", or "unix:/path/to.sock"
+             * for a Unix socket (an existing socket file there is replaced).
+             * @param port The TCP port; 0 picks a free one, see port().
+             * @param threads The number of reactor threads; 0 means one per hardware thread.
+             * @throw std::runtime_error If the address cannot be bound.
+             */
+            explicit Server(std::string address = "127.0.0.1", int port = 8000, size_t threads = 1)
+                : address(std::move(address)), bound_port(port), thread_count(threads ? threads : std::max(1u, std::thread::hardware_concurrency())) {
+                if (this->address.substr(0, 5) == "unix:") unix_path = this->address.substr(5);
+                try {
+                    // Every TCP reactor gets its own SO_REUSEPORT socket; a Unix socket is shared.
+                    size_t sockets = unix_path.empty() ? thread_count : 1;
+                    for (size_t i = 0; i < sockets; ++i) listen_fds.push_back(open_listener(bound_port));
+                } catch (...) {
+                    for (int fd : listen_fds) ::close(fd);
+                    throw;
+                }
+            }
+
+            Server(const Server&) = delete;
+            Server& operator=(const Server&) = delete;
+
+            ~Server() {
+                shutdown();
+                for (auto& thread : threads) {
+                    if (thread.joinable()) thread.join();
+                }
+                for (int fd : listen_fds) ::close(fd);
+                if (!unix_path.empty()) ::unlink(unix_path.c_str());
+            }
+
+            /**
+             * @brief Register a handler for an exact path. HEAD requests fall back to the GET handler.
+             * @param method The method, e.g. "GET" or "POST".
+             * @param path The path, without a query string, e.g. "/metrics".
+             * @param handler The handler. It runs on a reactor thread and must not block for long.
+             * @throw std::runtime_error If the server is already serving.
+             */
+            void route(std::string_view method, std::string path, Handler handler) {
+                if (started) throw std::runtime_error("http: routes must be added before serving");
+                auto it = std::find_if(route_list.begin(), route_list.end(), [&](const auto& entry) { return entry.first == path; });
+                if (it == route_list.end()) {
+                    route_list.emplace_back(std::move(path), Route());
+                    it = route_list.end() - 1;
+                }
+                it->second.methods.emplace_back(std::string(method), std::move(handler));
+            }
+
+            /**
+             * @brief Serve the files below a directory under a URL prefix, e.g.
+             * static_files("/static/", "./public") maps /static/app.js to ./public/app.js.
+             */
+            void static_files(std::string prefix, std::string directory) {
+                if (started) throw std::runtime_error("http: routes must be added before serving");
+                mounts.push_back({std::move(prefix), std::move(directory)});
+            }
+
+            /**
+             * @brief The bound TCP port, useful after binding port 0.
+             */
+            int port() const { return bound_port; }
+
+            /**
+             * @brief Start the reactor threads and return at once.
+             */
+            void start() {
+                if (started) throw std::runtime_error("http: server already started");
+                started = true;
+                std::vector<std::pair<std::string, size_t>> index;
+                for (size_t i = 0; i < route_list.size(); ++i) index.emplace_back(route_list[i].first, i);
+                route_index = FrozenDict<std::string, size_t>(index.begin(), index.end());
+                for (size_t i = 0; i < thread_count; ++i) {
+                    reactors.push_back(std::make_unique<Reactor>(*this, listen_fds[std::min(i, listen_fds.size() - 1)]));
+                }
+                running.store(true, std::memory_order_release);
+                for (auto& reactor : reactors) threads.emplace_back([r = reactor.get()] { r->run(); });
+            }
+
+            /**
+             * @brief Serve until shutdown() is called from another thread or a handler.
+             */
+            void serve_forever() {
+                if (!started) start();
+                for (auto& thread : threads) {
+                    if (thread.joinable()) thread.join();
+                }
+            }
+
+            /**
+             * @brief Ask the reactors to stop; each closes its connections and exits. Safe to call
+             * from any thread, including a handler. Returns without waiting; serve_forever()
+             * returns, and the destructor waits, once they have stopped.
+             */
+            void shutdown() {
+                if (!running.exchange(false)) return;
+                for (auto& reactor : reactors) reactor->wake();
+            }
+        };
+#endif
+    }
+}
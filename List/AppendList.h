@@ -0,0 +1,320 @@
+// EasyCpp - AppendList : A Concurrent Append-Only List
+// Copyright (C) 2025  C14147
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+/**
+ * @file EasyCpp/List/AppendList.h
+ * @brief This file implements AppendList, a typed list that many threads append to at once,
+ *        e.g. to collect the results of parallel workers without a lock or a final merge.
+ *        An append reserves its index with one atomic increment, constructs the element in
+ *        place and marks the slot ready; it never waits for another thread, so append is
+ *        wait-free. Elements live in segments whose sizes double (32, 64, 128, ...), so the
+ *        segment and offset of an index are found with a few bit operations and existing
+ *        elements never move: references stay valid while other threads keep appending.
+ *        Readers see the published prefix, the longest run of ready elements from index 0,
+ *        and may index and iterate it concurrently with appends.
+ */
+#pragma once
+#define _EASYCPP_APPENDLIST_VERSION "1.0.0"
+
+#include <List/List.h>
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace easycpp {
+    namespace appendlist {
+        namespace detail {
+            constexpr unsigned FIRST_SHIFT = 5;
+            constexpr size_t FIRST_SEGMENT = size_t(1) << FIRST_SHIFT;
+            constexpr size_t MAX_SEGMENTS = 64 - FIRST_SHIFT;
+
+            constexpr size_t segment_of(size_t index) {
+                return (size_t) std::bit_width(index + FIRST_SEGMENT) - 1 - FIRST_SHIFT;
+            }
+
+            constexpr size_t segment_start(size_t segment) {
+                return (FIRST_SEGMENT << segment) - FIRST_SEGMENT;
+            }
+
+            constexpr size_t segment_size(size_t segment) {
+                return FIRST_SEGMENT << segment;
+            }
+        }
+    }
+
+    /**
+     * @class AppendList
+     * @brief A list that supports wait-free append() from many threads at once.
+     * @tparam T The element type.
+     *
+     * Only append(), emplace(), extend() and the read methods may run concurrently; clear() and
+     * destruction need exclusive access. If an element's constructor throws, its index stays
+     * reserved but never becomes ready, and the published prefix ends before it.
+     */
+    template<typename T>
+    class AppendList {
+    private:
+        struct Segment {
+            T* items;
+            std::unique_ptr<std::atomic<bool>[]> ready;
+
+            explicit Segment(size_t size)
+                : items(static_cast<T*>(::operator new(size * sizeof(T), std::align_val_t(alignof(T))))),
+                  ready(new std::atomic<bool>[size]()) {}
+
+            ~Segment() {
+                ::operator delete(items, std::align_val_t(alignof(T)));
+            }
+        };
+
+        std::atomic<Segment*> segments[appendlist::detail::MAX_SEGMENTS] = {};
+        alignas(64) std::atomic<size_t> reserved{0};
+        alignas(64) mutable std::atomic<size_t> published{0};
+
+        /**
+         * @brief Get a segment, allocating it if this thread is the first to need it. Threads
+         * that race to allocate it install one copy with a compare-exchange and the losers free
+         * theirs, so no thread waits for another.
+         */
+        Segment* segment(size_t index) {
+            std::atomic<Segment*>& slot = segments[index];
+            Segment* current = slot.load(std::memory_order_acquire);
+            if (current) return current;
+            Segment* fresh = new Segment(appendlist::detail::segment_size(index));
+            if (slot.compare_exchange_strong(current, fresh, std::memory_order_acq_rel, std::memory_order_acquire)) return fresh;
+            delete fresh;
+            return current;
+        }
+
+        template<typename... Args>
+        void construct(size_t index, Args&&... args) {
+            size_t s = appendlist::detail::segment_of(index);
+            size_t offset = index - appendlist::detail::segment_start(s);
+            Segment* seg = segment(s);
+            new (seg->items + offset) T(std::forward<Args>(args)...);
+            seg->ready[offset].store(true, std::memory_order_release);
+        }
+
+        bool is_ready(size_t index) const {
+            size_t s = appendlist::detail::segment_of(index);
+            Segment* seg = segments[s].load(std::memory_order_acquire);
+            return seg && seg->ready[index - appendlist::detail::segment_start(s)].load(std::memory_order_acquire);
+        }
+
+        const T& item(size_t index) const {
+            size_t s = appendlist::detail::segment_of(index);
+            return segments[s].load(std::memory_order_acquire)->items[index - appendlist::detail::segment_start(s)];
+        }
+
+        void destroy() {
+            size_t count = reserved.load(std::memory_order_relaxed);
+            for (size_t s = 0; s < appendlist::detail::MAX_SEGMENTS; ++s) {
+                Segment* seg = segments[s].load(std::memory_order_relaxed);
+                if (seg == nullptr) continue;
+                size_t start = appendlist::detail::segment_start(s);
+                size_t end = std::min(count, start + appendlist::detail::segment_size(s));
+                for (size_t index = start; index < end; ++index) {
+                    if (seg->ready[index - start].load(std::memory_order_relaxed)) seg->items[index - start].~T();
+                }
+                delete seg;
+                segments[s].store(nullptr, std::memory_order_relaxed);
+            }
+        }
+
+    public:
+        using value_type = T;
+
+        /**
+         * @class const_iterator
+         * @brief Iterates a published prefix; a range-for loop visits the prefix published
+         * when it starts, while appends continue.
+         */
+        class const_iterator {
+        private:
+            const AppendList* list = nullptr;
+            size_t index = 0;
+
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = T;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const T*;
+            using reference = const T&;
+
+            const_iterator() = default;
+            const_iterator(const AppendList* list, size_t index) : list(list), index(index) {}
+
+            reference operator*() const { return list->item(index); }
+            pointer operator->() const { return &list->item(index); }
+            const_iterator& operator++() { ++index; return *this; }
+            const_iterator operator++(int) { const_iterator old = *this; ++index; return old; }
+            bool operator==(const const_iterator& other) const { return index == other.index; }
+            bool operator!=(const const_iterator& other) const { return index != other.index; }
+        };
+
+        /**
+         * @brief Construct an empty AppendList.
+         */
+        AppendList() = default;
+
+        AppendList(std::initializer_list<T> init) {
+            extend(init.begin(), init.end());
+        }
+
+        AppendList(const AppendList&) = delete;
+        AppendList& operator=(const AppendList&) = delete;
+
+        ~AppendList() {
+            destroy();
+        }
+
+        /**
+         * @brief Append an element. Wait-free; safe to call from any number of threads.
+         * @param value The element.
+         * @return The element's index.
+         */
+        size_t append(const T& value) {
+            return emplace(value);
+        }
+
+        size_t append(T&& value) {
+            return emplace(std::move(value));
+        }
+
+        /**
+         * @brief Construct an element in place at the end of the list.
+         * @param args The constructor arguments.
+         * @return The element's index.
+         */
+        template<typename... Args>
+        size_t emplace(Args&&... args) {
+            size_t index = reserved.fetch_add(1, std::memory_order_relaxed);
+            if (appendlist::detail::segment_of(index) >= appendlist::detail::MAX_SEGMENTS) throw std::length_error("AppendList: too many elements");
+            construct(index, std::forward<Args>(args)...);
+            return index;
+        }
+
+        /**
+         * @brief Append a range of elements at consecutive indices, reserving them all with one
+         * atomic increment.
+         * @param first The first element.
+         * @param last One past the last element.
+         * @return The index of the first appended element.
+         */
+        template<typename It>
+        size_t extend(It first, It last) {
+            size_t count = (size_t) std::distance(first, last);
+            size_t start = reserved.fetch_add(count, std::memory_order_relaxed);
+            if (count > 0 && appendlist::detail::segment_of(start + count - 1) >= appendlist::detail::MAX_SEGMENTS) {
+                throw std::length_error("AppendList: too many elements");
+            }
+            for (size_t index = start; first != last; ++first, ++index) construct(index, *first);
+            return start;
+        }
+
+        template<typename Range>
+        size_t extend(const Range& range) {
+            return extend(std::begin(range), std::end(range));
+        }
+
+        /**
+         * @brief The length of the published prefix: every element below it is ready. Advances
+         * the shared prefix over elements that have become ready since the last call.
+         */
+        size_t size() const {
+            size_t current = published.load(std::memory_order_acquire);
+            size_t end = current;
+            size_t limit = reserved.load(std::memory_order_acquire);
+            while (end < limit && is_ready(end)) ++end;
+            if (end == current) return current;
+            // Another reader may have moved further already; keep the larger prefix.
+            while (current < end && !published.compare_exchange_weak(current, end, std::memory_order_acq_rel, std::memory_order_acquire)) {}
+            return std::max(current, end);
+        }
+
+        bool empty() const { return size() == 0; }
+
+        /**
+         * @brief The number of indices handed out so far, including elements still being
+         * constructed.
+         */
+        size_t reserved_size() const {
+            return reserved.load(std::memory_order_acquire);
+        }
+
+        /**
+         * @brief Access an element of the published prefix without a bounds check.
+         */
+        const T& operator[](size_t index) const {
+            return item(index);
+        }
+
+        T& operator[](size_t index) {
+            return const_cast<T&>(item(index));
+        }
+
+        /**
+         * @brief Access an element, or any element that is ready even if an earlier one is not.
+         * @throw std::out_of_range If the element is not ready.
+         */
+        const T& at(size_t index) const {
+            if (index >= reserved.load(std::memory_order_acquire) || !is_ready(index)) throw std::out_of_range("AppendList: index out of range");
+            return item(index);
+        }
+
+        /**
+         * @brief Copy the published prefix into a vector.
+         */
+        std::vector<T> to_vector() const {
+            std::vector<T> result;
+            result.reserve(size());
+            for (const T& value : *this) result.push_back(value);
+            return result;
+        }
+
+        /**
+         * @brief Copy the published prefix into a List.
+         */
+        List to_list() const {
+            List result;
+            for (const T& value : *this) result.append(value);
+            return result;
+        }
+
+        /**
+         * @brief Remove every element. Not safe while other threads use the list.
+         */
+        void clear() {
+            destroy();
+            reserved.store(0, std::memory_order_relaxed);
+            published.store(0, std::memory_order_relaxed);
+        }
+
+        const_iterator begin() const { return const_iterator(this, 0); }
+        const_iterator end() const { return const_iterator(this, size()); }
+    };
+}
@@ -20,7 +20,10 @@
  * @brief This file implements a custom List class in C++.
  * The List class can store elements of multiple types using std::any and records the type information
  * of each element. It provides methods similar to Python's list data type.
+ * The first EASYCPP_LIST_INLINE_CAPACITY elements (8 by default) and their type tags are stored inside
+ * the List object itself, so short Lists never touch the heap for their element storage.
  */
+#pragma once
 
 #include <iostream>
 #include <vector>
@@ -29,6 +32,11 @@
 #include <algorithm>
 #include <optional>
 #include <string>
+#include <List/SmallVector.h>
+
+#ifndef EASYCPP_LIST_INLINE_CAPACITY
+#define EASYCPP_LIST_INLINE_CAPACITY 8
+#endif
 
 /**
  * @class List
@@ -37,8 +45,15 @@
 namespace easycpp {
     class List {
     private:
-        std::vector<std::any> data;  // Vector to store the actual elements
-        std::vector<const std::type_info*> types;  // Vector to store the type information of each element
+        /**
+         * @brief An element together with its type information.
+         */
+        struct Element {
+            std::any value;
+            const std::type_info* type;
+        };
+
+        SmallVector<Element, EASYCPP_LIST_INLINE_CAPACITY> elements;  // Elements, inline up to the inline capacity
 
     public:
         /**
@@ -50,14 +65,23 @@ namespace easycpp {
          * @brief Copy constructor. Creates a new list with the same elements and type information as the given list.
          * @param other The list to be copied.
          */
-        List(const List& other) : data(other.data), types(other.types) {}
+        List(const List& other) : elements(other.elements) {}
+
+        /**
+         * @brief Move constructor. Takes over the elements of the given list.
+         * @param other The list to be moved from. It is left empty.
+         */
+        List(List&& other) noexcept : elements(std::move(other.elements)) {}
+
+        List& operator=(const List& other) = default;
+        List& operator=(List&& other) noexcept = default;
 
         /**
          * @brief Get the number of elements in the list.
          * @return The size of the list.
          */
         size_t size() const {
-            return data.size();
+            return elements.size();
         }
 
         /**
@@ -65,7 +89,7 @@ namespace easycpp {
          * @return true if the list is empty, false otherwise.
          */
         bool empty() const {
-            return data.empty();
+            return elements.empty();
         }
 
         /**
@@ -75,8 +99,7 @@ namespace easycpp {
          */
         template<typename T>
         void append(const T& value) {
-            data.push_back(std::any(value));
-            types.push_back(&typeid(T));
+            elements.push_back(Element{std::any(value), &typeid(T)});
         }
 
         /**
@@ -84,8 +107,7 @@ namespace easycpp {
          * @param other The list whose elements will be appended to this list.
          */
         void extend(const List& other) {
-            data.insert(data.end(), other.data.begin(), other.data.end());
-            types.insert(types.end(), other.types.begin(), other.types.end());
+            elements.append(other.elements.begin(), other.elements.end());
         }
 
         /**
@@ -96,9 +118,8 @@ namespace easycpp {
          */
         template<typename T>
         void insert(size_t index, const T& value) {
-            if (index <= data.size()) {
-                data.insert(data.begin() + index, std::any(value));
-                types.insert(types.begin() + index, &typeid(T));
+            if (index <= elements.size()) {
+                elements.insert(index, Element{std::any(value), &typeid(T)});
             }
         }
 
@@ -109,13 +130,11 @@ namespace easycpp {
          */
         template<typename T>
         void remove(const T& value) {
-            auto it = std::find_if(data.begin(), data.end(), [&](const std::any& element) {
-                return std::any_cast<T>(&element) && *std::any_cast<T>(&element) == value;
+            auto it = std::find_if(elements.begin(), elements.end(), [&](const Element& element) {
+                return std::any_cast<T>(&element.value) && *std::any_cast<T>(&element.value) == value;
             });
-            if (it != data.end()) {
-                size_t index = std::distance(data.begin(), it);
-                data.erase(it);
-                types.erase(types.begin() + index);
+            if (it != elements.end()) {
+                elements.erase(it - elements.begin());
             }
         }
 
@@ -128,15 +147,14 @@ namespace easycpp {
          */
         std::any pop(std::optional<size_t> index = std::nullopt) {
             if (!index.has_value()) {
-                if (data.empty()) {
+                if (elements.empty()) {
                     throw std::out_of_range("List is empty, cannot pop.");
                 }
-                index = data.size() - 1;
+                index = elements.size() - 1;
             }
-            if (index.value() < data.size()) {
-                std::any value = data[index.value()];
-                data.erase(data.begin() + index.value());
-                types.erase(types.begin() + index.value());
+            if (index.value() < elements.size()) {
+                std::any value = std::move(elements[index.value()].value);
+                elements.erase(index.value());
                 return value;
             }
             throw std::out_of_range("Index out of range");
@@ -146,8 +164,7 @@ namespace easycpp {
          * @brief Remove all elements from the list.
          */
         void clear() {
-            data.clear();
-            types.clear();
+            elements.clear();
         }
 
         /**
@@ -160,8 +177,9 @@ namespace easycpp {
          */
         template<typename T>
         size_t index(const T& value, size_t start = 0) const {
-            for (size_t i = start; i < data.size(); ++i) {
-                if (*types[i] == typeid(T) && std::any_cast<T>(&data[i]) && *std::any_cast<T>(&data[i]) == value) {
+            for (size_t i = start; i < elements.size(); ++i) {
+                const Element& element = elements[i];
+                if (*element.type == typeid(T) && std::any_cast<T>(&element.value) && *std::any_cast<T>(&element.value) == value) {
                     return i;
                 }
             }
@@ -177,8 +195,8 @@ namespace easycpp {
         template<typename T>
         size_t count(const T& value) const {
             size_t count = 0;
-            for (size_t i = 0; i < data.size(); ++i) {
-                if (*types[i] == typeid(T) && std::any_cast<T>(&data[i]) && *std::any_cast<T>(&data[i]) == value) {
+            for (const Element& element : elements) {
+                if (*element.type == typeid(T) && std::any_cast<T>(&element.value) && *std::any_cast<T>(&element.value) == value) {
                     ++count;
                 }
             }
@@ -189,28 +207,28 @@ namespace easycpp {
          * @brief Reverse the order of the elements in the list.
          */
         void reverse() {
-            std::reverse(data.begin(), data.end());
-            std::reverse(types.begin(), types.end());
+            std::reverse(elements.begin(), elements.end());
         }
 
         std::string join(const std::string& separator) const {
             std::string result;
-            for (size_t i = 0; i < data.size(); ++i) {
+            for (size_t i = 0; i < elements.size(); ++i) {
                 if (i > 0) {
                     result += separator;
                 }
-                if (this->data[i].has_value()) {
-                    if (this->types[i] == &typeid(int)) {
-                        result += std::to_string(std::any_cast<int>(this->data[i]));
-                    } else if (this->types[i] == &typeid(double)) {
-                        result += std::to_string(std::any_cast<double>(this->data[i]));
-                    } else if (this->types[i] == &typeid(std::string)) {
-                        result += std::any_cast<std::string>(this->data[i]);
+                const Element& element = this->elements[i];
+                if (element.value.has_value()) {
+                    if (element.type == &typeid(int)) {
+                        result += std::to_string(std::any_cast<int>(element.value));
+                    } else if (element.type == &typeid(double)) {
+                        result += std::to_string(std::any_cast<double>(element.value));
+                    } else if (element.type == &typeid(std::string)) {
+                        result += std::any_cast<std::string>(element.value);
                     } else {
                         result += "(" ;
-                        result += (this->types[i]->name());
+                        result += (element.type->name());
                         result += " at " ;
-                        result += std::to_string((long long)&this->data[i]);
+                        result += std::to_string((long long)&element.value);
                         result += ")";
                     } 
                 } else result = "";
@@ -227,8 +245,8 @@ namespace easycpp {
          */
         template<typename T>
         T get(size_t index) const {
-            if (index < data.size() && *types[index] == typeid(T)) {
-                return std::any_cast<T>(data[index]);
+            if (index < elements.size() && *elements[index].type == typeid(T)) {
+                return std::any_cast<T>(elements[index].value);
             }
             throw std::bad_any_cast();
         }
@@ -239,7 +257,7 @@ namespace easycpp {
          * @return A reference to the element at the specified index.
          */
         std::any& operator[](size_t index) {
-            return data[index];
+            return elements[index].value;
         }
 
         /**
@@ -248,7 +266,7 @@ namespace easycpp {
          * @return A const reference to the element at the specified index.
          */
         const std::any& operator[](size_t index) const {
-            return data[index];
+            return elements[index].value;
         }
 
         /**
@@ -259,19 +277,20 @@ namespace easycpp {
          */
         friend std::ostream& operator<<(std::ostream& os, const List& list) {
             os << "[";
-            for (size_t i = 0; i < list.data.size(); ++i) {
+            for (size_t i = 0; i < list.elements.size(); ++i) {
                 if (i > 0) {
                     os << ", ";
                 }
-                if (list.data[i].has_value()) {
-                    if (list.types[i] == &typeid(int)) {
-                        os << std::any_cast<int>(list.data[i]);
-                    } else if (list.types[i] == &typeid(double)) {
-                        os << std::any_cast<double>(list.data[i]);
-                    } else if (list.types[i] == &typeid(std::string)) {
-                        os << std::any_cast<std::string>(list.data[i]);
+                const Element& element = list.elements[i];
+                if (element.value.has_value()) {
+                    if (element.type == &typeid(int)) {
+                        os << std::any_cast<int>(element.value);
+                    } else if (element.type == &typeid(double)) {
+                        os << std::any_cast<double>(element.value);
+                    } else if (element.type == &typeid(std::string)) {
+                        os << std::any_cast<std::string>(element.value);
                     } else {
-                        os << "(" <<list.types[i]->name() << " at " << &list.data[i]<<")";
+                        os << "(" <<element.type->name() << " at " << &element.value<<")";
                     }
                 } else {
                     os << "";
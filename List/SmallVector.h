@@ -0,0 +1,262 @@
+// EasyCpp - SmallVector : A Vector With Inline Storage
+// Copyright (C) 2025  Li Zhengyi
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+/**
+ * @file EasyCpp/List/SmallVector.h
+ * @brief This file implements SmallVector, a vector that keeps its first N elements inside
+ * the object itself and only moves them to the heap when it grows beyond N.
+ */
+#pragma once
+
+#include <Tracemalloc/Tracemalloc.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <initializer_list>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace easycpp {
+    /**
+     * @class SmallVector
+     * @brief A contiguous container with inline capacity for N elements.
+     * Creating, filling (up to N elements) and destroying a SmallVector performs no heap allocation.
+     * @tparam T The element type.
+     * @tparam N The number of elements stored inline.
+     */
+    template<typename T, size_t N>
+    class SmallVector {
+        static_assert(N > 0, "SmallVector needs an inline capacity of at least one element");
+
+    private:
+        alignas(T) unsigned char storage[N * sizeof(T)];  // Inline buffer for the first N elements
+        T* ptr;                                           // Points to storage or to a heap buffer
+        size_t count;
+        size_t cap;
+
+        T* inline_data() {
+            return reinterpret_cast<T*>(storage);
+        }
+
+        void grow(size_t min_capacity) {
+            size_t new_capacity = std::max(min_capacity, cap * 2);
+            T* buffer = static_cast<T*>(::operator new(new_capacity * sizeof(T)));
+            tracemalloc::detail::allocated(buffer, new_capacity * sizeof(T), "List");
+            std::uninitialized_move(ptr, ptr + count, buffer);
+            std::destroy(ptr, ptr + count);
+            release();
+            ptr = buffer;
+            cap = new_capacity;
+        }
+
+        void release() {
+            if (!is_inline()) {
+                tracemalloc::detail::freed(ptr);
+                ::operator delete(ptr);
+            }
+        }
+
+    public:
+        using value_type = T;
+        using iterator = T*;
+        using const_iterator = const T*;
+
+        /**
+         * @brief Default constructor. Initializes an empty vector using the inline buffer.
+         */
+        SmallVector() : ptr(inline_data()), count(0), cap(N) {}
+
+        /**
+         * @brief Construct a vector from a list of values.
+         * @param values The initial elements.
+         */
+        SmallVector(std::initializer_list<T> values) : SmallVector() {
+            reserve(values.size());
+            for (const T& value : values) push_back(value);
+        }
+
+        /**
+         * @brief Copy constructor.
+         * @param other The vector to be copied.
+         */
+        SmallVector(const SmallVector& other) : SmallVector() {
+            reserve(other.count);
+            std::uninitialized_copy(other.ptr, other.ptr + other.count, ptr);
+            count = other.count;
+        }
+
+        /**
+         * @brief Move constructor. Steals the heap buffer, or moves the inline elements one by one.
+         * @param other The vector to be moved from. It is left empty.
+         */
+        SmallVector(SmallVector&& other) noexcept(std::is_nothrow_move_constructible_v<T>) : SmallVector() {
+            if (other.is_inline()) {
+                std::uninitialized_move(other.ptr, other.ptr + other.count, ptr);
+                count = other.count;
+                other.clear();
+            } else {
+                ptr = other.ptr;
+                count = other.count;
+                cap = other.cap;
+                other.ptr = other.inline_data();
+                other.count = 0;
+                other.cap = N;
+            }
+        }
+
+        ~SmallVector() {
+            clear();
+            release();
+        }
+
+        SmallVector& operator=(const SmallVector& other) {
+            if (this != &other) {
+                clear();
+                reserve(other.count);
+                std::uninitialized_copy(other.ptr, other.ptr + other.count, ptr);
+                count = other.count;
+            }
+            return *this;
+        }
+
+        SmallVector& operator=(SmallVector&& other) noexcept(std::is_nothrow_move_constructible_v<T>) {
+            if (this == &other) return *this;
+            clear();
+            if (other.is_inline()) {
+                std::uninitialized_move(other.ptr, other.ptr + other.count, ptr);
+                count = other.count;
+                other.clear();
+            } else {
+                release();
+                ptr = other.ptr;
+                count = other.count;
+                cap = other.cap;
+                other.ptr = other.inline_data();
+                other.count = 0;
+                other.cap = N;
+            }
+            return *this;
+        }
+
+        /**
+         * @brief Check whether the elements are still stored inside the object.
+         * @return true if no heap buffer is in use.
+         */
+        bool is_inline() const {
+            return ptr == reinterpret_cast<const T*>(storage);
+        }
+
+        size_t size() const { return count; }
+        size_t capacity() const { return cap; }
+        bool empty() const { return count == 0; }
+
+        T* data() { return ptr; }
+        const T* data() const { return ptr; }
+        iterator begin() { return ptr; }
+        iterator end() { return ptr + count; }
+        const_iterator begin() const { return ptr; }
+        const_iterator end() const { return ptr + count; }
+
+        T& operator[](size_t index) { return ptr[index]; }
+        const T& operator[](size_t index) const { return ptr[index]; }
+        T& back() { return ptr[count - 1]; }
+        const T& back() const { return ptr[count - 1]; }
+
+        /**
+         * @brief Make room for at least the given number of elements.
+         * @param new_capacity The requested capacity.
+         */
+        void reserve(size_t new_capacity) {
+            if (new_capacity > cap) grow(new_capacity);
+        }
+
+        /**
+         * @brief Construct an element in place at the end.
+         * @param args The constructor arguments.
+         * @return A reference to the new element.
+         */
+        template<typename... Args>
+        T& emplace_back(Args&&... args) {
+            if (count == cap) {
+                // Construct first: args may refer to an element that grow() would move.
+                T value(std::forward<Args>(args)...);
+                grow(count + 1);
+                new (ptr + count) T(std::move(value));
+            } else {
+                new (ptr + count) T(std::forward<Args>(args)...);
+            }
+            return ptr[count++];
+        }
+
+        void push_back(const T& value) { emplace_back(value); }
+        void push_back(T&& value) { emplace_back(std::move(value)); }
+
+        /**
+         * @brief Insert an element before the given position.
+         * @param index The position, at most size().
+         * @param value The element to be inserted.
+         */
+        void insert(size_t index, T value) {
+            emplace_back(std::move(value));
+            std::rotate(ptr + index, ptr + count - 1, ptr + count);
+        }
+
+        /**
+         * @brief Append a range of elements.
+         * @param first The beginning of the range.
+         * @param last The end of the range.
+         */
+        void append(const T* first, const T* last) {
+            size_t extra = (size_t) (last - first);
+            if (count + extra > cap) {
+                // Copy through a temporary in case the range aliases this vector.
+                SmallVector copy;
+                copy.reserve(extra);
+                for (const T* it = first; it != last; ++it) copy.push_back(*it);
+                grow(count + extra);
+                std::uninitialized_move(copy.begin(), copy.end(), ptr + count);
+            } else {
+                std::uninitialized_copy(first, last, ptr + count);
+            }
+            count += extra;
+        }
+
+        /**
+         * @brief Remove the element at the given position.
+         * @param index The position of the element.
+         */
+        void erase(size_t index) {
+            std::move(ptr + index + 1, ptr + count, ptr + index);
+            pop_back();
+        }
+
+        void pop_back() {
+            std::destroy_at(ptr + --count);
+        }
+
+        /**
+         * @brief Destroy all elements. The capacity is kept.
+         */
+        void clear() {
+            std::destroy(ptr, ptr + count);
+            count = 0;
+        }
+    };
+}
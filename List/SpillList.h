@@ -0,0 +1,522 @@
+// EasyCpp - SpillList : A List That Spills to Disk Beyond a Memory Budget
+// Copyright (C) 2025  C14147
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+/**
+ * @file EasyCpp/List/SpillList.h
+ * @brief This file implements SpillList, a typed list for data that may not fit in memory.
+ *        Elements are kept in segments; when the segments held in memory exceed the memory
+ *        budget, the least recently used ones are encoded with ByteWriter and appended to a
+ *        temporary file, and read back through a memory mapping when they are needed again.
+ *        Iterating reads spilled segments straight from the mapping, prefetching the next
+ *        one, without pulling them back into memory. A segment read back and not modified
+ *        is evicted again without being rewritten; a modified one is rewritten in place when
+ *        it still fits, and otherwise moves to a free range of the file (first fit, with
+ *        released ranges merged) or to its end, so the file stays close to the spilled data.
+ */
+#pragma once
+#define _EASYCPP_SPILLLIST_VERSION "1.0.0"
+
+#include <FileOperator/BinaryIO.h>
+#include <FileOperator/FileOperator.h>
+#include <String/String.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace easycpp {
+    /**
+     * @struct SpillCodec
+     * @brief How SpillList encodes an element and estimates its memory. Trivially copyable
+     * types, std::string, String and types with dumps()/loads() are handled; specialize it
+     * for other types.
+     */
+    template<typename T>
+    struct SpillCodec {
+        static constexpr bool serializable = requires(T& value) { value.dumps(); T::loads(std::string_view()); };
+
+        static void write(ByteWriter& writer, const T& value) {
+            if constexpr (std::is_same_v<T, std::string>) {
+                writer.put_string(value);
+            } else if constexpr (std::is_same_v<T, String>) {
+                writer.put_string(std::string_view((const char*) value, value.len()));
+            } else if constexpr (serializable) {
+                // HyperLogLog::dumps() compacts its buffers first, which does not change its value.
+                writer.put_string(const_cast<T&>(value).dumps());
+            } else {
+                static_assert(std::is_trivially_copyable_v<T>, "SpillList needs a SpillCodec specialization for this type");
+                writer.put_bytes(&value, sizeof(T));
+            }
+        }
+
+        static T read(ByteReader& reader) {
+            if constexpr (std::is_same_v<T, std::string>) {
+                return std::string(reader.get_string());
+            } else if constexpr (std::is_same_v<T, String>) {
+                std::string_view text = reader.get_string();
+                return String(text.data(), text.size());
+            } else if constexpr (serializable) {
+                return T::loads(reader.get_string());
+            } else {
+                T value;
+                std::memcpy(&value, reader.get_bytes(sizeof(T)), sizeof(T));
+                return value;
+            }
+        }
+
+        static size_t bytes(const T& value) {
+            if constexpr (std::is_same_v<T, std::string>) {
+                return sizeof(T) + (value.capacity() > 15 ? value.capacity() + 1 : 0);
+            } else if constexpr (std::is_same_v<T, String>) {
+                return sizeof(T) + value.len() + 1;
+            } else {
+                (void) value;
+                return sizeof(T);
+            }
+        }
+    };
+
+    /**
+     * @class SpillList
+     * @brief A list of T that keeps at most about memory_budget bytes in memory and spills
+     * the rest to a temporary file. Reading an element of a spilled segment brings the whole
+     * segment back, possibly spilling another. Unlike std::vector, any access may invalidate
+     * iterators, and elements are returned by value.
+     * @tparam T The element type, encoded with SpillCodec<T>.
+     */
+    template<typename T>
+    class SpillList {
+    private:
+        struct Segment {
+            std::vector<T> items;   // The elements while the segment is in memory
+            size_t count = 0;
+            size_t bytes = 0;       // Estimated memory of items
+            bool hot = true;
+            bool dirty = true;      // No up-to-date copy in the spill file
+            uint64_t offset = 0;
+            uint64_t length = 0;
+            uint64_t capacity = 0;  // Bytes of the spill file reserved at offset, 0 if none
+            uint64_t last_use = 0;
+        };
+
+        struct Extent {
+            uint64_t offset;
+            uint64_t length;
+        };
+
+        mutable std::vector<Segment> segments;
+        std::vector<size_t> starts;    // The index of the first element of each segment
+        size_t total = 0;
+        size_t budget;
+        size_t segment_bytes;
+        mutable size_t hot_bytes = 0;
+        mutable uint64_t clock = 0;
+
+        std::string spill_path;
+        mutable std::unique_ptr<File> spill_file;
+        mutable uint64_t spill_size = 0;
+        mutable std::vector<Extent> free_extents;  // Released ranges of the spill file, sorted by offset
+        mutable std::unique_ptr<MappedFile> spill_map;
+
+        static std::string temporary_path(const char* directory) {
+            static std::atomic<uint64_t> counter{0};
+            std::filesystem::path base = directory ? std::filesystem::path(directory) : std::filesystem::temp_directory_path();
+            uint64_t stamp = (uint64_t) std::chrono::steady_clock::now().time_since_epoch().count();
+            return (base / ("easycpp-spill-" + std::to_string(stamp) + "-" + std::to_string(counter.fetch_add(1)) + ".bin")).string();
+        }
+
+        const char* map_range(uint64_t offset, uint64_t length) const {
+            if (!spill_map || spill_map->size < offset + length) {
+                fflush(spill_file->file);
+                spill_map.reset();
+                spill_map = std::make_unique<MappedFile>(spill_path.c_str());
+            }
+            return spill_map->data + offset;
+        }
+
+        std::vector<T> decode(const Segment& segment) const {
+            ByteReader reader(map_range(segment.offset, segment.length), (size_t) segment.length);
+            std::vector<T> items;
+            items.reserve(segment.count);
+            for (size_t i = 0; i < segment.count; ++i) items.push_back(SpillCodec<T>::read(reader));
+            return items;
+        }
+
+        // Take length bytes from the first free range that is large enough, else from the end.
+        uint64_t allocate(uint64_t length) const {
+            for (auto it = free_extents.begin(); it != free_extents.end(); ++it) {
+                if (it->length < length) continue;
+                uint64_t offset = it->offset;
+                it->offset += length;
+                it->length -= length;
+                if (!it->length) free_extents.erase(it);
+                return offset;
+            }
+            uint64_t offset = spill_size;
+            spill_size += length;
+            return offset;
+        }
+
+        // Give a segment's range back, merged with its free neighbours; a range that ends the
+        // file shortens it instead.
+        void release(Segment& segment) const {
+            if (!segment.capacity) return;
+            Extent extent{segment.offset, segment.capacity};
+            segment.capacity = 0;
+            auto next = std::lower_bound(free_extents.begin(), free_extents.end(), extent.offset,
+                                         [](const Extent& free, uint64_t offset) { return free.offset < offset; });
+            if (next != free_extents.end() && extent.offset + extent.length == next->offset) {
+                extent.length += next->length;
+                next = free_extents.erase(next);
+            }
+            if (next != free_extents.begin() && std::prev(next)->offset + std::prev(next)->length == extent.offset) {
+                extent.offset = std::prev(next)->offset;
+                extent.length += std::prev(next)->length;
+                next = free_extents.erase(std::prev(next));
+            }
+            if (extent.offset + extent.length == spill_size) spill_size = extent.offset;
+            else free_extents.insert(next, extent);
+        }
+
+        void evict(Segment& segment) const {
+            if (segment.dirty) {
+                ByteWriter writer;
+                for (const T& item : segment.items) SpillCodec<T>::write(writer, item);
+                if (writer.size() > segment.capacity) {
+                    release(segment);
+                    segment.offset = allocate(writer.size());
+                    segment.capacity = writer.size();
+                }
+                if (!spill_file) spill_file.reset(open(spill_path.c_str(), WRITE_B));
+#ifdef _WIN32
+                int moved = _fseeki64(spill_file->file, (long long) segment.offset, SEEK_SET);
+#else
+                int moved = fseeko(spill_file->file, (off_t) segment.offset, SEEK_SET);
+#endif
+                if (moved != 0) throw FileWriteError(spill_file->filename);
+                writer.save(spill_file.get());
+                // The range may already be mapped; make the mapping see the new bytes.
+                fflush(spill_file->file);
+                segment.length = writer.size();
+                segment.dirty = false;
+            }
+            std::vector<T>().swap(segment.items);
+            segment.hot = false;
+            hot_bytes -= segment.bytes;
+            segment.bytes = 0;
+        }
+
+        // Spill the least recently used segments, except keep and the tail, until the
+        // segments in memory fit the budget.
+        void enforce_budget(size_t keep) const {
+            while (hot_bytes > budget) {
+                Segment* victim = nullptr;
+                for (size_t i = 0; i + 1 < segments.size(); ++i) {
+                    Segment& segment = segments[i];
+                    if (i != keep && segment.hot && segment.count && (!victim || segment.last_use < victim->last_use)) victim = &segment;
+                }
+                if (!victim) return;
+                evict(*victim);
+            }
+        }
+
+        Segment& load(size_t index) const {
+            Segment& segment = segments[index];
+            segment.last_use = ++clock;
+            if (!segment.hot) {
+                map_range(segment.offset, segment.length);
+                spill_map->will_need((size_t) segment.offset, (size_t) segment.length, true);
+                segment.items = decode(segment);
+                segment.hot = true;
+                segment.bytes = 0;
+                for (const T& item : segment.items) segment.bytes += SpillCodec<T>::bytes(item);
+                hot_bytes += segment.bytes;
+                enforce_budget(index);
+            }
+            return segment;
+        }
+
+        size_t locate(size_t index) const {
+            if (index >= total) throw std::out_of_range("SpillList index out of range");
+            return (size_t) (std::upper_bound(starts.begin(), starts.end(), index) - starts.begin()) - 1;
+        }
+
+        Segment& tail() {
+            if (segments.empty() || (segments.back().count && segments.back().bytes >= segment_bytes && segments.back().hot)) {
+                segments.emplace_back();
+                starts.push_back(total);
+            }
+            return load(segments.size() - 1);
+        }
+
+        template<typename U>
+        void push(U&& value) {
+            Segment& segment = tail();
+            size_t bytes = SpillCodec<T>::bytes(value);
+            segment.items.push_back(std::forward<U>(value));
+            segment.bytes += bytes;
+            segment.dirty = true;
+            ++segment.count;
+            ++total;
+            hot_bytes += bytes;
+            enforce_budget(segments.size() - 1);
+        }
+
+    public:
+        /**
+         * @class const_iterator
+         * @brief A forward iterator over the elements. Spilled segments are decoded from
+         * the mapping as the iterator reaches them and the next one is prefetched.
+         */
+        class const_iterator {
+        private:
+            const SpillList* list = nullptr;
+            size_t segment = 0;
+            size_t position = 0;
+            std::shared_ptr<const std::vector<T>> spilled;
+            const std::vector<T>* items = nullptr;
+
+            void enter() {
+                items = nullptr;
+                spilled.reset();
+                while (segment < list->segments.size() && !list->segments[segment].count) ++segment;
+                if (segment >= list->segments.size()) return;
+                const Segment& current = list->segments[segment];
+                if (current.hot) {
+                    items = &current.items;
+                    return;
+                }
+                spilled = std::make_shared<const std::vector<T>>(list->decode(current));
+                items = spilled.get();
+                for (size_t next = segment + 1; next < list->segments.size(); ++next) {
+                    const Segment& ahead = list->segments[next];
+                    if (ahead.hot) continue;
+                    list->spill_map->will_need((size_t) ahead.offset, (size_t) ahead.length);
+                    break;
+                }
+            }
+
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = T;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const T*;
+            using reference = const T&;
+
+            const_iterator() = default;
+
+            const_iterator(const SpillList* list, size_t segment) : list(list), segment(segment) {
+                enter();
+            }
+
+            reference operator*() const { return (*items)[position]; }
+            pointer operator->() const { return &(*items)[position]; }
+
+            const_iterator& operator++() {
+                if (++position >= items->size()) {
+                    position = 0;
+                    ++segment;
+                    enter();
+                }
+                return *this;
+            }
+
+            const_iterator operator++(int) {
+                const_iterator old = *this;
+                ++*this;
+                return old;
+            }
+
+            bool operator==(const const_iterator& other) const {
+                return segment == other.segment && position == other.position;
+            }
+
+            bool operator!=(const const_iterator& other) const {
+                return !(*this == other);
+            }
+        };
+
+        /**
+         * @brief Create an empty list.
+         * @param memory_budget The bytes of elements to keep in memory, estimated with
+         *        SpillCodec<T>::bytes(). Defaults to 256 MiB.
+         * @param spill_directory Where the spill file is created; the system temporary
+         *        directory by default. The file is only created when something is spilled.
+         * @throws std::invalid_argument if memory_budget is 0.
+         */
+        explicit SpillList(size_t memory_budget = size_t(256) << 20, const char* spill_directory = nullptr)
+            : budget(memory_budget), segment_bytes(std::clamp<size_t>(memory_budget / 8, std::min<size_t>(memory_budget, 4096), size_t(64) << 20)),
+              spill_path(temporary_path(spill_directory)) {
+            if (memory_budget == 0) throw std::invalid_argument("SpillList memory budget must be positive");
+        }
+
+        SpillList(const SpillList&) = delete;
+        SpillList& operator=(const SpillList&) = delete;
+
+        SpillList(SpillList&& other) noexcept
+            : segments(std::move(other.segments)), starts(std::move(other.starts)), total(std::exchange(other.total, 0)),
+              budget(other.budget), segment_bytes(other.segment_bytes), hot_bytes(std::exchange(other.hot_bytes, 0)),
+              clock(other.clock), spill_path(std::exchange(other.spill_path, std::string())), spill_file(std::move(other.spill_file)),
+              spill_size(std::exchange(other.spill_size, 0)), free_extents(std::move(other.free_extents)),
+              spill_map(std::move(other.spill_map)) {
+            other.segments.clear();
+            other.starts.clear();
+        }
+
+        /**
+         * @brief Delete the spill file.
+         */
+        ~SpillList() {
+            spill_map.reset();
+            spill_file.reset();
+            if (!spill_path.empty()) {
+                std::error_code error;
+                std::filesystem::remove(spill_path, error);
+            }
+        }
+
+        /**
+         * @brief Get the number of elements.
+         */
+        size_t size() const { return total; }
+
+        /**
+         * @brief Check if the list is empty.
+         */
+        bool empty() const { return total == 0; }
+
+        /**
+         * @brief Get the estimated bytes of the elements held in memory.
+         */
+        size_t memory_usage() const { return hot_bytes; }
+
+        /**
+         * @brief Get the bytes of the spill file in use, including free ranges between spilled
+         * segments.
+         */
+        size_t spilled_bytes() const { return (size_t) spill_size; }
+
+        /**
+         * @brief Append an element.
+         * @param value The element.
+         */
+        void append(const T& value) { push(value); }
+        void append(T&& value) { push(std::move(value)); }
+
+        /**
+         * @brief Append every element of a range.
+         * @param first The beginning of the range.
+         * @param last The end of the range.
+         */
+        template<typename Iterator>
+        void extend(Iterator first, Iterator last) {
+            for (; first != last; ++first) push(*first);
+        }
+
+        /**
+         * @brief Get a copy of the element at the given index, reading its segment back
+         * if it was spilled.
+         * @param index The index.
+         * @return The element.
+         * @throws std::out_of_range if the index is out of range.
+         */
+        T get(size_t index) const {
+            size_t segment = locate(index);
+            return load(segment).items[index - starts[segment]];
+        }
+
+        T operator[](size_t index) const { return get(index); }
+
+        /**
+         * @brief Replace the element at the given index.
+         * @param index The index.
+         * @param value The new element.
+         * @throws std::out_of_range if the index is out of range.
+         */
+        void set(size_t index, const T& value) {
+            size_t position = locate(index);
+            Segment& segment = load(position);
+            T& item = segment.items[index - starts[position]];
+            size_t old_bytes = SpillCodec<T>::bytes(item), new_bytes = SpillCodec<T>::bytes(value);
+            item = value;
+            segment.bytes = segment.bytes - old_bytes + new_bytes;
+            hot_bytes = hot_bytes - old_bytes + new_bytes;
+            segment.dirty = true;
+            enforce_budget(position);
+        }
+
+        /**
+         * @brief Remove and return the last element.
+         * @return The element.
+         * @throws std::out_of_range if the list is empty.
+         */
+        T pop() {
+            if (total == 0) throw std::out_of_range("SpillList is empty, cannot pop.");
+            while (!segments.back().count) {
+                release(segments.back());
+                segments.pop_back();
+                starts.pop_back();
+            }
+            Segment& segment = load(segments.size() - 1);
+            size_t bytes = SpillCodec<T>::bytes(segment.items.back());
+            T value = std::move(segment.items.back());
+            segment.items.pop_back();
+            segment.bytes -= bytes;
+            hot_bytes -= bytes;
+            segment.dirty = true;
+            --segment.count;
+            --total;
+            if (!segment.count && segments.size() > 1) {
+                release(segment);
+                segments.pop_back();
+                starts.pop_back();
+            }
+            return value;
+        }
+
+        /**
+         * @brief Remove every element and truncate the spill file.
+         */
+        void clear() {
+            segments.clear();
+            starts.clear();
+            total = 0;
+            hot_bytes = 0;
+            spill_map.reset();
+            spill_file.reset();
+            spill_size = 0;
+            free_extents.clear();
+            std::error_code error;
+            std::filesystem::remove(spill_path, error);
+        }
+
+        const_iterator begin() const { return const_iterator(this, 0); }
+        const_iterator end() const { return const_iterator(this, segments.size()); }
+    };
+}
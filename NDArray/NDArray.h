@@ -0,0 +1,590 @@
+// EasyCpp - NDArray : A Typed N-Dimensional Array
+// Copyright (C) 2025  C14147
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+/**
+ * @file EasyCpp/NDArray/NDArray.h
+ * @brief This file implements NDArray, a contiguous C-order array with a runtime dtype,
+ *        similar to numpy.ndarray. The buffer is 64-byte aligned and reference counted,
+ *        so copies of an NDArray are views of the same data (use copy() for a deep copy).
+ *        Arrays are exchanged with NumPy through .npy and .npz files; load() can map a
+ *        .npy file instead of reading it, so the data pointer aims into the page cache.
+ */
+#pragma once
+#define _EASYCPP_NDARRAY_VERSION "1.0.0"
+
+#include <Compress/Zipfile.h>
+#include <Compress/Zlib.h>
+#include <FileOperator/FileOperator.h>
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <new>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace easycpp {
+    /**
+     * @brief The element types an NDArray can hold.
+     */
+    enum class DType {
+        BOOL, INT8, INT16, INT32, INT64, UINT8, UINT16, UINT32, UINT64, FLOAT32, FLOAT64
+    };
+
+    /**
+     * @brief Get the size of one element of the given dtype.
+     * @param dtype The element type.
+     * @return The element size in bytes.
+     */
+    inline size_t itemsize(DType dtype) {
+        switch (dtype) {
+            case DType::BOOL: case DType::INT8: case DType::UINT8: return 1;
+            case DType::INT16: case DType::UINT16: return 2;
+            case DType::INT32: case DType::UINT32: case DType::FLOAT32: return 4;
+            default: return 8;
+        }
+    }
+
+    /**
+     * @brief Map a C++ element type to its DType.
+     */
+    template<typename T> struct dtype_of;
+    template<> struct dtype_of<bool> { static constexpr DType value = DType::BOOL; };
+    template<> struct dtype_of<int8_t> { static constexpr DType value = DType::INT8; };
+    template<> struct dtype_of<int16_t> { static constexpr DType value = DType::INT16; };
+    template<> struct dtype_of<int32_t> { static constexpr DType value = DType::INT32; };
+    template<> struct dtype_of<int64_t> { static constexpr DType value = DType::INT64; };
+    template<> struct dtype_of<uint8_t> { static constexpr DType value = DType::UINT8; };
+    template<> struct dtype_of<uint16_t> { static constexpr DType value = DType::UINT16; };
+    template<> struct dtype_of<uint32_t> { static constexpr DType value = DType::UINT32; };
+    template<> struct dtype_of<uint64_t> { static constexpr DType value = DType::UINT64; };
+    template<> struct dtype_of<float> { static constexpr DType value = DType::FLOAT32; };
+    template<> struct dtype_of<double> { static constexpr DType value = DType::FLOAT64; };
+
+    /**
+     * @class NDArray
+     * @brief A C-contiguous array with a shape and a runtime element type.
+     */
+    class NDArray {
+    public:
+        static constexpr size_t ALIGNMENT = 64;
+
+    private:
+        std::shared_ptr<void> buffer;   // Owner of the memory (heap block, or any other owner)
+        unsigned char* ptr = nullptr;   // First element
+        std::vector<size_t> dims;
+        DType type = DType::FLOAT64;
+
+        template<typename T>
+        void check_type() const {
+            if (dtype_of<std::remove_cv_t<T>>::value != type) {
+                throw std::invalid_argument("NDArray: element type does not match the dtype");
+            }
+        }
+
+        struct NpyHeader {
+            DType dtype;
+            std::vector<size_t> shape;
+            bool fortran_order = false;
+            bool swap = false;  // Stored in the other byte order
+            size_t data_offset = 0;
+        };
+
+        static std::string npy_descr(DType dtype) {
+            static constexpr const char* KINDS[] = {"b1", "i1", "i2", "i4", "i8", "u1", "u2", "u4", "u8", "f4", "f8"};
+            char order = itemsize(dtype) == 1 ? '|' : std::endian::native == std::endian::little ? '<' : '>';
+            return std::string(1, order) + KINDS[(int) dtype];
+        }
+
+        // The magic string, version, header length and the header dict, padded with spaces
+        // so that the data starts at a multiple of ALIGNMENT.
+        static std::string npy_header(DType dtype, const std::vector<size_t>& shape) {
+            std::string dict = "{'descr': '" + npy_descr(dtype) + "', 'fortran_order': False, 'shape': (";
+            for (size_t i = 0; i < shape.size(); ++i) dict += (i ? ", " : "") + std::to_string(shape[i]);
+            dict += shape.size() == 1 ? ",), }" : "), }";
+            size_t prefix = dict.size() + 1 < 65536 - ALIGNMENT ? 10 : 12;
+            size_t total = (prefix + dict.size() + 1 + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+            dict.append(total - prefix - dict.size() - 1, ' ');
+            dict += '\n';
+            std::string header("\x93NUMPY", 6);
+            header += (char) (prefix == 10 ? 1 : 2);
+            header += '\0';
+            size_t length = dict.size();
+            for (size_t i = 0; i < prefix - 8; ++i) header += (char) (length >> (8 * i));
+            return header + dict;
+        }
+
+        [[noreturn]] static void fail(const char* what) {
+            throw std::invalid_argument(std::string("NDArray: ") + what);
+        }
+
+        static NpyHeader parse_npy_header(const char* data, size_t size) {
+            if (size < 10 || std::memcmp(data, "\x93NUMPY", 6) != 0) fail("not a .npy file");
+            int major = (unsigned char) data[6];
+            if (major < 1 || major > 3) fail("unsupported .npy format version");
+            size_t prefix = major == 1 ? 10 : 12;
+            if (size < prefix) fail("truncated .npy header");
+            size_t length = 0;
+            for (size_t i = prefix - 1; i >= 8; --i) length = length << 8 | (unsigned char) data[i];
+            if (size - prefix < length) fail("truncated .npy header");
+            std::string_view text(data + prefix, length);
+
+            NpyHeader header;
+            header.data_offset = prefix + length;
+            bool have_descr = false, have_shape = false;
+            size_t i = 0;
+            auto skip = [&] {
+                while (i < text.size() && (text[i] == ' ' || text[i] == '\t' || text[i] == '\n')) ++i;
+            };
+            auto expect = [&](char c) {
+                skip();
+                if (i >= text.size() || text[i] != c) fail("invalid .npy header");
+                ++i;
+            };
+            auto quoted = [&] {
+                skip();
+                if (i >= text.size() || (text[i] != '\'' && text[i] != '"')) fail("invalid .npy header");
+                size_t end = text.find(text[i], i + 1);
+                if (end == std::string_view::npos) fail("invalid .npy header");
+                std::string_view value = text.substr(i + 1, end - i - 1);
+                i = end + 1;
+                return value;
+            };
+            expect('{');
+            for (;;) {
+                skip();
+                if (i < text.size() && text[i] == '}') break;
+                std::string_view key = quoted();
+                expect(':');
+                skip();
+                if (key == "descr") {
+                    std::string_view descr = quoted();
+                    static constexpr const char* KINDS[] = {"b1", "i1", "i2", "i4", "i8", "u1", "u2", "u4", "u8", "f4", "f8"};
+                    if (descr.size() != 3 || !std::strchr("<>|=", descr[0])) fail("unsupported dtype");
+                    int kind = -1;
+                    for (int k = 0; k < 11; ++k) {
+                        if (descr.substr(1) == KINDS[k]) kind = k;
+                    }
+                    if (kind < 0) throw std::invalid_argument("NDArray: unsupported dtype '" + std::string(descr) + "'");
+                    header.dtype = (DType) kind;
+                    bool little = descr[0] == '<' || (descr[0] == '=' && std::endian::native == std::endian::little);
+                    header.swap = descr[0] != '|' && descr[0] != '=' && little != (std::endian::native == std::endian::little) &&
+                                  itemsize(header.dtype) > 1;
+                    have_descr = true;
+                } else if (key == "fortran_order") {
+                    if (text.substr(i, 4) == "True") header.fortran_order = true, i += 4;
+                    else if (text.substr(i, 5) == "False") header.fortran_order = false, i += 5;
+                    else fail("invalid .npy header");
+                } else if (key == "shape") {
+                    expect('(');
+                    for (;;) {
+                        skip();
+                        if (i < text.size() && text[i] == ')') break;
+                        if (i >= text.size() || text[i] < '0' || text[i] > '9') fail("invalid .npy header");
+                        size_t value = 0;
+                        while (i < text.size() && text[i] >= '0' && text[i] <= '9') value = value * 10 + (size_t) (text[i++] - '0');
+                        header.shape.push_back(value);
+                        skip();
+                        if (i < text.size() && text[i] == ',') ++i;
+                    }
+                    ++i;
+                    have_shape = true;
+                } else {
+                    fail("invalid .npy header");
+                }
+                skip();
+                if (i < text.size() && text[i] == ',') ++i;
+            }
+            if (!have_descr || !have_shape) fail("invalid .npy header");
+            return header;
+        }
+
+        // Build an array from the bytes of a .npy file. With an owner the array is a view of
+        // the bytes, otherwise they are copied (and converted to C order and native endian).
+        // Misaligned data is copied too if copy_unaligned is set.
+        static NDArray from_npy(const char* data, size_t size, std::shared_ptr<void> owner, bool copy_unaligned = false) {
+            NpyHeader header = parse_npy_header(data, size);
+            size_t item = itemsize(header.dtype);
+            size_t count = 1;
+            for (size_t dim : header.shape) {
+                if (dim && count > SIZE_MAX / dim) fail("invalid .npy shape");
+                count *= dim;
+            }
+            if ((size - header.data_offset) / item < count) fail(".npy data is truncated");
+            const char* start = data + header.data_offset;
+            bool transposed = header.fortran_order && header.shape.size() > 1;
+            if (owner && copy_unaligned && (uintptr_t) start % item) owner.reset();
+            if (owner) {
+                if (transposed) throw std::invalid_argument("NDArray: cannot memory-map a Fortran-order array");
+                if (header.swap) throw std::invalid_argument("NDArray: cannot memory-map data in non-native byte order");
+                if ((uintptr_t) start % item) throw std::invalid_argument("NDArray: .npy data is not aligned for mapping");
+                return NDArray(std::move(owner), const_cast<char*>(start), std::move(header.shape), header.dtype);
+            }
+            NDArray result(header.shape, header.dtype);
+            if (!transposed) {
+                if (count) std::memcpy(result.ptr, start, count * item);
+            } else {
+                // Walk the C-order positions, tracking the matching Fortran-order offset.
+                size_t n = header.shape.size();
+                std::vector<size_t> index(n, 0), stride(n);
+                for (size_t k = 0, s = 1; k < n; ++k) stride[k] = s, s *= header.shape[k];
+                size_t offset = 0;
+                for (size_t c = 0; c < count; ++c) {
+                    std::memcpy(result.ptr + c * item, start + offset * item, item);
+                    for (size_t k = n; k-- > 0;) {
+                        offset += stride[k];
+                        if (++index[k] < header.shape[k]) break;
+                        offset -= stride[k] * header.shape[k];
+                        index[k] = 0;
+                    }
+                }
+            }
+            if (header.swap) {
+                for (size_t c = 0; c < count; ++c) std::reverse(result.ptr + c * item, result.ptr + (c + 1) * item);
+            }
+            return result;
+        }
+
+        static void put_le(std::string& out, uint64_t value, int bytes) {
+            for (int i = 0; i < bytes; ++i) out += (char) (value >> (8 * i));
+        }
+
+    public:
+        /**
+         * @brief Default constructor. Initializes an empty 1-D float64 array.
+         */
+        NDArray() : dims{0} {}
+
+        /**
+         * @brief Allocate an uninitialized array.
+         * @param shape The shape of the array.
+         * @param dtype The element type.
+         */
+        NDArray(std::vector<size_t> shape, DType dtype) : dims(std::move(shape)), type(dtype) {
+            size_t bytes = nbytes();
+            void* memory = ::operator new(bytes ? bytes : 1, std::align_val_t(ALIGNMENT));
+            buffer = std::shared_ptr<void>(memory, [](void* p) { ::operator delete(p, std::align_val_t(ALIGNMENT)); });
+            ptr = static_cast<unsigned char*>(memory);
+        }
+
+        /**
+         * @brief Wrap memory owned by someone else, e.g. a memory-mapped file.
+         * @param owner Keeps the memory alive for as long as the array (and its views) exist.
+         * @param data The first element.
+         * @param shape The shape of the array.
+         * @param dtype The element type.
+         */
+        NDArray(std::shared_ptr<void> owner, void* data, std::vector<size_t> shape, DType dtype)
+            : buffer(std::move(owner)), ptr(static_cast<unsigned char*>(data)), dims(std::move(shape)), type(dtype) {}
+
+        /**
+         * @brief Create an array filled with zeros.
+         * @param shape The shape of the array.
+         * @param dtype The element type.
+         * @return The new array.
+         */
+        static NDArray zeros(std::vector<size_t> shape, DType dtype = DType::FLOAT64) {
+            NDArray result(std::move(shape), dtype);
+            std::memset(result.ptr, 0, result.nbytes());
+            return result;
+        }
+
+        /**
+         * @brief Create a 1-D array from a vector.
+         * @param values The elements.
+         * @return The new array.
+         */
+        template<typename T>
+        static NDArray from_vector(const std::vector<T>& values) {
+            NDArray result({values.size()}, dtype_of<T>::value);
+            if constexpr (std::is_same_v<T, bool>) {
+                for (size_t i = 0; i < values.size(); ++i) result.data<bool>()[i] = values[i];
+            } else if (!values.empty()) {
+                std::memcpy(result.ptr, values.data(), values.size() * sizeof(T));
+            }
+            return result;
+        }
+
+        DType dtype() const { return type; }
+        const std::vector<size_t>& shape() const { return dims; }
+        size_t ndim() const { return dims.size(); }
+
+        /**
+         * @brief Get the number of elements.
+         * @return The product of the shape.
+         */
+        size_t size() const {
+            return std::accumulate(dims.begin(), dims.end(), (size_t) 1, std::multiplies<size_t>());
+        }
+
+        /**
+         * @brief Get the size of the data in bytes.
+         * @return size() times the element size.
+         */
+        size_t nbytes() const {
+            return size() * itemsize(type);
+        }
+
+        void* raw() { return ptr; }
+        const void* raw() const { return ptr; }
+
+        /**
+         * @brief Get a typed pointer to the first element.
+         * @tparam T The element type, which must match dtype().
+         * @return The data pointer.
+         * @throws std::invalid_argument if T does not match the dtype.
+         */
+        template<typename T>
+        T* data() {
+            check_type<T>();
+            return reinterpret_cast<T*>(ptr);
+        }
+
+        template<typename T>
+        const T* data() const {
+            check_type<T>();
+            return reinterpret_cast<const T*>(ptr);
+        }
+
+        /**
+         * @brief Access an element by its flat (C-order) index.
+         * @tparam T The element type, which must match dtype().
+         * @param index The flat index.
+         * @return A reference to the element.
+         * @throws std::out_of_range if the index is out of range.
+         */
+        template<typename T>
+        T& at(size_t index) {
+            if (index >= size()) throw std::out_of_range("NDArray index out of range");
+            return data<T>()[index];
+        }
+
+        template<typename T>
+        const T& at(size_t index) const {
+            if (index >= size()) throw std::out_of_range("NDArray index out of range");
+            return data<T>()[index];
+        }
+
+        /**
+         * @brief Give the array a new shape with the same number of elements (a view).
+         * @param shape The new shape.
+         * @return A view with the new shape.
+         * @throws std::invalid_argument if the number of elements differs.
+         */
+        NDArray reshape(std::vector<size_t> shape) const {
+            NDArray result(*this);
+            result.dims = std::move(shape);
+            if (result.size() != size()) throw std::invalid_argument("NDArray: cannot reshape to a different size");
+            return result;
+        }
+
+        /**
+         * @brief Load an array from a NumPy .npy file.
+         * @param filename The file path.
+         * @param mmap_mode nullptr to read the data into memory, or map the file instead:
+         * "r" read-only (writing through the array crashes), "r+" writes go to the file,
+         * "c" copy-on-write (writes stay in this process). A mapped array is a view into the
+         * mapping, which lasts as long as the array or any of its views.
+         * @return The array.
+         * @throws std::invalid_argument if the file is not a .npy file, has an unsupported
+         * dtype, or cannot be mapped (Fortran order or non-native byte order).
+         */
+        static NDArray load(const char* filename, const char* mmap_mode = nullptr) {
+            if (mmap_mode && std::strcmp(mmap_mode, "r") != 0 && std::strcmp(mmap_mode, "r+") != 0 && std::strcmp(mmap_mode, "c") != 0) {
+                throw std::invalid_argument("NDArray: mmap_mode must be \"r\", \"r+\" or \"c\"");
+            }
+            auto mapping = std::make_shared<MappedFile>(filename, mmap_mode ? mmap_mode : READ);
+            return from_npy(mapping->data, mapping->size, mmap_mode ? mapping : nullptr);
+        }
+
+        /**
+         * @brief Save the array to a NumPy .npy file (format 1.0, or 2.0 for huge headers).
+         * The header is padded so that the data starts at a multiple of 64 bytes, which keeps
+         * the data aligned when the file is mapped by load().
+         * @param filename The file path.
+         */
+        void save(const char* filename) const {
+            std::string header = npy_header(type, dims);
+            std::unique_ptr<File> file(open(filename, WRITE_B));
+            file->write(header.data(), header.size());
+            if (nbytes()) file->write(ptr, nbytes());
+        }
+
+        /**
+         * @brief Save several arrays to an uncompressed NumPy .npz archive. Each array is
+         * written straight from its buffer as the zip member "<name>.npy"; members are padded
+         * so their data is 64-byte aligned in the archive.
+         * @param filename The file path.
+         * @param arrays The names and arrays, in archive order.
+         */
+        static void savez(const char* filename, const std::vector<std::pair<std::string, NDArray>>& arrays) {
+            static constexpr uint64_t LIMIT = 0xFFFFFFFF;
+            static constexpr uint16_t DOS_DATE = 1 << 5 | 1;  // 1980-01-01, for reproducible archives
+            std::unique_ptr<File> file(open(filename, WRITE_B));
+            std::string directory;
+            uint64_t offset = 0;
+            for (const auto& [key, array] : arrays) {
+                std::string name = key + ".npy";
+                std::string header = npy_header(array.type, array.dims);
+                uint64_t size = header.size() + array.nbytes();
+                uint32_t crc = zlib::crc32(header.data(), header.size());
+                crc = zlib::crc32(array.ptr, array.nbytes(), crc);
+                bool utf8 = std::any_of(name.begin(), name.end(), [](char c) { return (unsigned char) c >= 0x80; });
+                bool large = size >= LIMIT;
+
+                std::string extra;
+                if (large) {
+                    put_le(extra, 1, 2);
+                    put_le(extra, 16, 2);
+                    put_le(extra, size, 8);
+                    put_le(extra, size, 8);
+                }
+                // Pad with an alignment field (as zipalign does) so the member starts at a
+                // multiple of ALIGNMENT; the .npy header keeps the array data aligned.
+                size_t start = (size_t) (offset + 30 + name.size() + extra.size() + 4);
+                size_t padding = (ALIGNMENT - start % ALIGNMENT) % ALIGNMENT;
+                put_le(extra, 0xD935, 2);
+                put_le(extra, padding, 2);
+                extra.append(padding, '\0');
+
+                std::string local;
+                put_le(local, 0x04034B50, 4);
+                put_le(local, large ? 45 : 20, 2);
+                put_le(local, utf8 ? 0x800 : 0, 2);
+                put_le(local, 0, 2);
+                put_le(local, 0, 2);
+                put_le(local, DOS_DATE, 2);
+                put_le(local, crc, 4);
+                put_le(local, large ? LIMIT : size, 4);
+                put_le(local, large ? LIMIT : size, 4);
+                put_le(local, name.size(), 2);
+                put_le(local, extra.size(), 2);
+                local += name;
+                local += extra;
+                file->write(local.data(), local.size());
+                file->write(header.data(), header.size());
+                if (array.nbytes()) file->write(array.ptr, array.nbytes());
+
+                std::string zip64;
+                if (large) put_le(zip64, size, 8), put_le(zip64, size, 8);
+                if (offset >= LIMIT) put_le(zip64, offset, 8);
+                put_le(directory, 0x02014B50, 4);
+                put_le(directory, 3 << 8 | 45, 2);
+                put_le(directory, zip64.empty() ? 20 : 45, 2);
+                put_le(directory, utf8 ? 0x800 : 0, 2);
+                put_le(directory, 0, 2);
+                put_le(directory, 0, 2);
+                put_le(directory, DOS_DATE, 2);
+                put_le(directory, crc, 4);
+                put_le(directory, large ? LIMIT : size, 4);
+                put_le(directory, large ? LIMIT : size, 4);
+                put_le(directory, name.size(), 2);
+                put_le(directory, zip64.empty() ? 0 : zip64.size() + 4, 2);
+                put_le(directory, 0, 2);
+                put_le(directory, 0, 2);
+                put_le(directory, 0, 2);
+                put_le(directory, (uint64_t) 0100644 << 16, 4);
+                put_le(directory, std::min(offset, LIMIT), 4);
+                directory += name;
+                if (!zip64.empty()) {
+                    put_le(directory, 1, 2);
+                    put_le(directory, zip64.size(), 2);
+                    directory += zip64;
+                }
+                offset += local.size() + size;
+            }
+
+            uint64_t count = arrays.size();
+            std::string end;
+            if (count >= 0xFFFF || offset >= LIMIT || directory.size() >= LIMIT) {
+                put_le(end, 0x06064B50, 4);
+                put_le(end, 44, 8);
+                put_le(end, 45, 2);
+                put_le(end, 45, 2);
+                put_le(end, 0, 4);
+                put_le(end, 0, 4);
+                put_le(end, count, 8);
+                put_le(end, count, 8);
+                put_le(end, directory.size(), 8);
+                put_le(end, offset, 8);
+                put_le(end, 0x07064B50, 4);
+                put_le(end, 0, 4);
+                put_le(end, offset + directory.size(), 8);
+                put_le(end, 1, 4);
+            }
+            put_le(end, 0x06054B50, 4);
+            put_le(end, 0, 4);
+            put_le(end, std::min<uint64_t>(count, 0xFFFF), 2);
+            put_le(end, std::min<uint64_t>(count, 0xFFFF), 2);
+            put_le(end, std::min<uint64_t>(directory.size(), LIMIT), 4);
+            put_le(end, std::min(offset, LIMIT), 4);
+            put_le(end, 0, 2);
+            file->write(directory.data(), directory.size());
+            file->write(end.data(), end.size());
+        }
+
+        /**
+         * @brief Load the arrays of a NumPy .npz archive.
+         * @param filename The file path.
+         * @param mmap_mode nullptr to copy every array into memory (checking CRCs), or "r"
+         * to make arrays stored uncompressed views into the read-only mapped archive.
+         * Compressed members (savez_compressed), and members whose data is not aligned to
+         * the element size (NumPy does not align them; savez() does), are copied instead.
+         * @return The names (without ".npy") and arrays, in archive order.
+         */
+        static std::vector<std::pair<std::string, NDArray>> load_npz(const char* filename, const char* mmap_mode = nullptr) {
+            if (mmap_mode && std::strcmp(mmap_mode, "r") != 0) throw std::invalid_argument("NDArray: .npz files can only be mapped read-only");
+            auto archive = std::make_shared<zipfile::ZipFile>(filename);
+            std::vector<std::pair<std::string, NDArray>> arrays;
+            arrays.reserve(archive->infolist().size());
+            for (const zipfile::ZipInfo& info : archive->infolist()) {
+                std::string name(info.filename);
+                if (name.size() >= 4 && name.compare(name.size() - 4, 4, ".npy") == 0) name.resize(name.size() - 4);
+                if (info.compress_type == zipfile::ZIP_STORED) {
+                    std::string_view bytes = archive->view(info);
+                    if (!mmap_mode && zlib::crc32(bytes.data(), bytes.size()) != info.CRC) {
+                        throw std::invalid_argument("NDArray: Bad CRC-32 for file '" + std::string(info.filename) + "'");
+                    }
+                    arrays.emplace_back(std::move(name), from_npy(bytes.data(), bytes.size(), mmap_mode ? archive : nullptr, true));
+                } else {
+                    std::string bytes = archive->open(info).read();
+                    arrays.emplace_back(std::move(name), from_npy(bytes.data(), bytes.size(), nullptr));
+                }
+            }
+            return arrays;
+        }
+
+        /**
+         * @brief Make a deep copy that owns its own buffer.
+         * @return The copy.
+         */
+        NDArray copy() const {
+            NDArray result(dims, type);
+            if (nbytes()) std::memcpy(result.ptr, ptr, nbytes());
+            return result;
+        }
+    };
+}
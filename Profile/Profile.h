@@ -0,0 +1,446 @@
+// EasyCpp - Profile : Sampling CPU Profiler
+// Copyright (C) 2025  C14147
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+/**
+ * @file EasyCpp/Profile/Profile.h
+ * @brief This file implements a sampling CPU profiler in the spirit of Python's cProfile,
+ *        to be switched on and off in a running program. While running, an ITIMER_PROF
+ *        timer sends SIGPROF at the chosen frequency of consumed CPU time; the handler
+ *        appends the interrupted thread's stack and its open Spans to that thread's chunk
+ *        of a preallocated buffer, without locks or allocation. stop() symbolizes the
+ *        stacks and returns Stats, which prints a pstats-style table and writes the
+ *        collapsed-stack format read by flamegraph.pl. Unlike perf_event_open(), SIGPROF
+ *        needs no privileges. Symbols need -rdynamic, as for tracemalloc. ThreadPool
+ *        tasks run under the innermost Span of the thread that queued them.
+ */
+#pragma once
+#define _EASYCPP_PROFILE_VERSION "1.0.0"
+
+#include <Tracemalloc/Tracemalloc.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#if defined(_EASYCPP_TRACEMALLOC_HAS_BACKTRACE) && (defined(__linux__) || defined(__APPLE__))
+#define _EASYCPP_PROFILE_SUPPORTED 1
+#include <signal.h>
+#include <sys/time.h>
+#include <ucontext.h>
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+// Thread-locals read by the signal handler must not be allocated lazily.
+#define _EASYCPP_PROFILE_TLS thread_local __attribute__((tls_model("initial-exec")))
+#else
+#define _EASYCPP_PROFILE_TLS thread_local
+#endif
+
+namespace easycpp {
+    namespace profile {
+        namespace detail {
+            inline constexpr size_t MAX_DEPTH = 64;
+            inline constexpr size_t MAX_SPANS = 16;
+            inline constexpr size_t CHUNK_WORDS = 2048;
+
+            // A chunk is owned by one thread: words[0] counts the words used after it. A
+            // sample is a header word (frames | spans << 8) followed by the span names and
+            // the frames, innermost first.
+            struct Session {
+                std::unique_ptr<uint64_t[]> buffer;
+                size_t chunks = 0;
+                std::atomic<size_t> next_chunk{0};
+                std::atomic<size_t> dropped{0};
+                double interval = 0;
+            };
+
+            inline std::atomic<bool> active{false};
+            inline std::atomic<int> in_handler{0};
+            inline std::atomic<uint64_t> generation{0};
+            inline Session* session = nullptr;
+
+            inline _EASYCPP_PROFILE_TLS uint64_t* chunk = nullptr;
+            inline _EASYCPP_PROFILE_TLS uint64_t chunk_generation = 0;
+            inline _EASYCPP_PROFILE_TLS const char* spans[MAX_SPANS];
+            inline _EASYCPP_PROFILE_TLS size_t span_depth = 0;
+
+            // The innermost open Span of the calling thread, or nullptr.
+            inline const char* current_span() {
+                return span_depth ? spans[std::min(span_depth, MAX_SPANS) - 1] : nullptr;
+            }
+
+            inline std::mutex& control() {
+                static std::mutex mutex;
+                return mutex;
+            }
+
+#ifdef _EASYCPP_PROFILE_SUPPORTED
+            inline struct sigaction previous_action;
+
+            inline void* interrupted_pc(void* context) {
+                const ucontext_t* uc = static_cast<const ucontext_t*>(context);
+                (void) uc;
+#if defined(__linux__) && defined(__x86_64__)
+                return reinterpret_cast<void*>(uc->uc_mcontext.gregs[REG_RIP]);
+#elif defined(__linux__) && defined(__aarch64__)
+                return reinterpret_cast<void*>(uc->uc_mcontext.pc);
+#else
+                return nullptr;
+#endif
+            }
+
+            inline void take_sample(void* context) {
+                Session* current = session;
+                uint64_t current_generation = generation.load(std::memory_order_relaxed);
+                void* frames[MAX_DEPTH + 4];
+                int captured = backtrace(frames, (int) (MAX_DEPTH + 4));
+                // Skip the handler and the signal trampoline: start at the interrupted pc.
+                size_t first = 0;
+                void* pc = interrupted_pc(context);
+                while (pc && first < (size_t) captured && frames[first] != pc) ++first;
+                if (!pc || first == (size_t) captured) first = std::min<size_t>(2, (size_t) captured);
+                size_t depth = std::min(MAX_DEPTH, (size_t) captured - first);
+                size_t span_count = std::min(span_depth, MAX_SPANS);
+                size_t words = 1 + span_count + depth;
+
+                if (chunk_generation != current_generation) {
+                    chunk = nullptr;
+                    chunk_generation = current_generation;
+                }
+                if (!chunk || chunk[0] + 1 + words > CHUNK_WORDS) {
+                    size_t index = current->next_chunk.fetch_add(1, std::memory_order_relaxed);
+                    if (index >= current->chunks) {
+                        chunk = nullptr;
+                        current->dropped.fetch_add(1, std::memory_order_relaxed);
+                        return;
+                    }
+                    chunk = current->buffer.get() + index * CHUNK_WORDS;
+                    chunk[0] = 0;
+                }
+                uint64_t* out = chunk + 1 + chunk[0];
+                *out++ = (uint64_t) depth | (uint64_t) span_count << 8;
+                for (size_t i = 0; i < span_count; ++i) *out++ = (uint64_t) reinterpret_cast<uintptr_t>(spans[i]);
+                for (size_t i = 0; i < depth; ++i) *out++ = (uint64_t) reinterpret_cast<uintptr_t>(frames[first + i]);
+                chunk[0] += words;
+            }
+
+            inline void handler(int, siginfo_t*, void* context) {
+                int saved_errno = errno;
+                in_handler.fetch_add(1);
+                if (active.load()) take_sample(context);
+                in_handler.fetch_sub(1);
+                errno = saved_errno;
+            }
+#endif
+        }
+
+        /**
+         * @class Span
+         * @brief Label the code running while it is alive. Samples taken on this thread
+         * carry the names of the open spans, outermost first, and flame graphs show them
+         * above the native frames. Costs two thread-local stores when not profiling.
+         */
+        class Span {
+        public:
+            /**
+             * @brief Open a span.
+             * @param name The label; it must outlive the profiling session (a literal).
+             */
+            explicit Span(const char* name) {
+                if (detail::span_depth < detail::MAX_SPANS) detail::spans[detail::span_depth] = name;
+                // The name must be in place before a signal can see the new depth, and the
+                // depth stored before the labelled code runs.
+                std::atomic_signal_fence(std::memory_order_seq_cst);
+                ++detail::span_depth;
+                std::atomic_signal_fence(std::memory_order_seq_cst);
+            }
+
+            Span(const Span&) = delete;
+            Span& operator=(const Span&) = delete;
+
+            ~Span() {
+                std::atomic_signal_fence(std::memory_order_seq_cst);
+                --detail::span_depth;
+            }
+        };
+
+        /**
+         * @struct FunctionStats
+         * @brief The samples of one function.
+         */
+        struct FunctionStats {
+            std::string function;
+            size_t self = 0;        ///< Samples in which the function was running.
+            size_t cumulative = 0;  ///< Samples in which it was on the stack.
+        };
+
+        /**
+         * @class Stats
+         * @brief A finished profile, like pstats.Stats.
+         */
+        class Stats {
+        private:
+            std::vector<std::pair<std::vector<std::string>, size_t>> collapsed_stacks;
+            size_t samples = 0;
+            size_t lost = 0;
+            double seconds_per_sample = 0;
+
+            friend Stats stop();
+
+        public:
+            /**
+             * @brief Get the number of samples taken.
+             */
+            size_t total_samples() const { return samples; }
+
+            /**
+             * @brief Get the number of samples lost because the buffer was full.
+             */
+            size_t dropped() const { return lost; }
+
+            /**
+             * @brief Get the CPU time a sample stands for, in seconds.
+             */
+            double interval() const { return seconds_per_sample; }
+
+            /**
+             * @brief Get the distinct stacks, root first (spans, then functions), with the
+             * number of samples of each.
+             */
+            const std::vector<std::pair<std::vector<std::string>, size_t>>& stacks() const { return collapsed_stacks; }
+
+            /**
+             * @brief Get the samples per function, most self samples first. Spans count as
+             * functions named "[name]".
+             */
+            std::vector<FunctionStats> functions() const {
+                std::unordered_map<std::string, FunctionStats> table;
+                for (const auto& [stack, count] : collapsed_stacks) {
+                    std::set<std::string> seen;
+                    for (const std::string& frame : stack) {
+                        FunctionStats& entry = table[frame];
+                        entry.function = frame;
+                        // A recursive function counts once per sample.
+                        if (seen.insert(frame).second) entry.cumulative += count;
+                    }
+                    if (!stack.empty()) table[stack.back()].self += count;
+                }
+                std::vector<FunctionStats> result;
+                for (auto& entry : table) result.push_back(std::move(entry.second));
+                std::sort(result.begin(), result.end(), [](const FunctionStats& a, const FunctionStats& b) {
+                    if (a.self != b.self) return a.self > b.self;
+                    if (a.cumulative != b.cumulative) return a.cumulative > b.cumulative;
+                    return a.function < b.function;
+                });
+                return result;
+            }
+
+            /**
+             * @brief Write the stacks in the collapsed format of flamegraph.pl: one line per
+             * stack, frames root first separated by ';', then a space and the sample count.
+             * @return The text.
+             */
+            std::string collapsed() const {
+                std::string out;
+                for (const auto& [stack, count] : collapsed_stacks) {
+                    for (size_t i = 0; i < stack.size(); ++i) {
+                        if (i) out += ';';
+                        for (char c : stack[i]) out += c == ';' ? ':' : c;
+                    }
+                    out += ' ' + std::to_string(count) + '\n';
+                }
+                return out;
+            }
+
+            /**
+             * @brief Print a table of the functions with the most self time, as
+             * pstats.Stats.print_stats() does.
+             * @param limit The number of rows; 0 prints all.
+             * @param out The stream.
+             */
+            void print_stats(size_t limit = 20, std::ostream& out = std::cout) const {
+                std::vector<FunctionStats> rows = functions();
+                if (limit && rows.size() > limit) rows.resize(limit);
+                char line[128];
+                std::snprintf(line, sizeof(line), "         %zu samples in %.3f seconds (%zu dropped)\n\n",
+                              samples, (double) samples * seconds_per_sample, lost);
+                out << line << "   tottime  percent   cumtime  percent  function\n";
+                double total = samples ? (double) samples : 1.0;
+                for (const FunctionStats& row : rows) {
+                    std::snprintf(line, sizeof(line), "%10.3f %7.1f%% %9.3f %7.1f%%  ",
+                                  (double) row.self * seconds_per_sample, 100.0 * (double) row.self / total,
+                                  (double) row.cumulative * seconds_per_sample, 100.0 * (double) row.cumulative / total);
+                    out << line << row.function << '\n';
+                }
+            }
+        };
+
+        /**
+         * @brief Check whether the profiler is running.
+         */
+        inline bool is_running() {
+            return detail::active.load();
+        }
+
+        /**
+         * @brief Start sampling every thread of the process.
+         * @param frequency The samples per second of CPU time.
+         * @param buffer_size The bytes reserved for samples; when they run out, further
+         *        samples are dropped and counted.
+         * @throws std::invalid_argument if frequency is not in [1; 1000000].
+         * @throws std::runtime_error if the profiler is running, the timer cannot be set,
+         *         or the platform has no SIGPROF.
+         */
+        inline void start(int frequency = 99, size_t buffer_size = size_t(32) << 20) {
+#ifdef _EASYCPP_PROFILE_SUPPORTED
+            if (frequency < 1 || frequency > 1000000) throw std::invalid_argument("profile: frequency must be in [1; 1000000]");
+            std::lock_guard<std::mutex> lock(detail::control());
+            if (detail::active.load()) throw std::runtime_error("profile: already running");
+
+            auto session = std::make_unique<detail::Session>();
+            session->chunks = std::max<size_t>(1, buffer_size / (detail::CHUNK_WORDS * sizeof(uint64_t)));
+            // Left uninitialized, so pages are only committed as threads claim chunks.
+            session->buffer.reset(new uint64_t[session->chunks * detail::CHUNK_WORDS]);
+            session->interval = 1.0 / frequency;
+            // The first backtrace() loads the unwinder, which must not happen in the handler.
+            void* warm[4];
+            backtrace(warm, 4);
+
+            detail::session = session.release();
+            detail::generation.fetch_add(1);
+            struct sigaction action {};
+            action.sa_sigaction = detail::handler;
+            action.sa_flags = SA_SIGINFO | SA_RESTART;
+            sigemptyset(&action.sa_mask);
+            if (sigaction(SIGPROF, &action, &detail::previous_action) != 0) {
+                delete detail::session;
+                detail::session = nullptr;
+                throw std::runtime_error("profile: cannot install the SIGPROF handler");
+            }
+            detail::active.store(true);
+
+            struct itimerval timer {};
+            long usec = std::max(1L, 1000000L / frequency);
+            timer.it_interval.tv_sec = usec / 1000000;
+            timer.it_interval.tv_usec = usec % 1000000;
+            timer.it_value = timer.it_interval;
+            if (setitimer(ITIMER_PROF, &timer, nullptr) != 0) {
+                detail::active.store(false);
+                sigaction(SIGPROF, &detail::previous_action, nullptr);
+                delete detail::session;
+                detail::session = nullptr;
+                throw std::runtime_error("profile: cannot start the profiling timer");
+            }
+#else
+            (void) frequency;
+            (void) buffer_size;
+            throw std::runtime_error("profile: sampling is not supported on this platform");
+#endif
+        }
+
+        /**
+         * @brief Stop sampling and symbolize what was collected.
+         * @return The profile.
+         * @throws std::runtime_error if the profiler is not running.
+         */
+        inline Stats stop() {
+            std::lock_guard<std::mutex> lock(detail::control());
+            if (!detail::active.load()) throw std::runtime_error("profile: not running");
+            Stats stats;
+#ifdef _EASYCPP_PROFILE_SUPPORTED
+            struct itimerval timer {};
+            setitimer(ITIMER_PROF, &timer, nullptr);
+            detail::active.store(false);
+            while (detail::in_handler.load()) std::this_thread::yield();
+            // A signal still pending must not reach the default action, which kills the process.
+            struct sigaction restore = detail::previous_action;
+            if (!(restore.sa_flags & SA_SIGINFO) && restore.sa_handler == SIG_DFL) {
+                restore = {};
+                restore.sa_handler = SIG_IGN;
+                sigemptyset(&restore.sa_mask);
+            }
+            sigaction(SIGPROF, &restore, nullptr);
+
+            std::unique_ptr<detail::Session> session(detail::session);
+            detail::session = nullptr;
+            stats.seconds_per_sample = session->interval;
+            stats.lost = session->dropped.load();
+
+            // Count identical raw stacks first, so every address is symbolized once.
+            std::map<std::vector<uint64_t>, size_t> raw;
+            size_t used = std::min(session->next_chunk.load(), session->chunks);
+            for (size_t index = 0; index < used; ++index) {
+                const uint64_t* chunk = session->buffer.get() + index * detail::CHUNK_WORDS;
+                const uint64_t* word = chunk + 1;
+                const uint64_t* end = word + chunk[0];
+                while (word < end) {
+                    size_t depth = (size_t) (*word & 0xFF), span_count = (size_t) (*word >> 8 & 0xFF);
+                    ++raw[std::vector<uint64_t>(word, word + 1 + span_count + depth)];
+                    word += 1 + span_count + depth;
+                    ++stats.samples;
+                }
+            }
+
+            std::unordered_map<uint64_t, std::string> names;
+            auto function_name = [&names](uint64_t address, bool leaf) -> const std::string& {
+                // A return address may lie past the end of its function; look up the call.
+                uint64_t lookup = leaf ? address : address - 1;
+                auto it = names.find(lookup);
+                if (it != names.end()) return it->second;
+                std::string name, offset, module;
+                if (!tracemalloc::detail::symbolize(reinterpret_cast<const void*>((uintptr_t) lookup), name, offset, &module)) {
+                    // Unexported functions of one file are merged under its name, as perf does.
+                    size_t slash = module.find_last_of('/');
+                    if (slash != std::string::npos) module.erase(0, slash + 1);
+                    if (module.empty()) {
+                        char hex[32];
+                        std::snprintf(hex, sizeof(hex), "0x%llx", (unsigned long long) address);
+                        module = hex;
+                    }
+                    name = "[" + module + "]";
+                }
+                return names.emplace(lookup, std::move(name)).first->second;
+            };
+            std::map<std::vector<std::string>, size_t> merged;
+            for (const auto& [sample, count] : raw) {
+                size_t depth = (size_t) (sample[0] & 0xFF), span_count = (size_t) (sample[0] >> 8 & 0xFF);
+                std::vector<std::string> stack;
+                for (size_t i = 0; i < span_count; ++i) {
+                    stack.push_back(std::string("[") + reinterpret_cast<const char*>((uintptr_t) sample[1 + i]) + "]");
+                }
+                for (size_t i = depth; i-- > 0;) stack.push_back(function_name(sample[1 + span_count + i], i == 0));
+                merged[std::move(stack)] += count;
+            }
+            stats.collapsed_stacks.assign(merged.begin(), merged.end());
+#endif
+            return stats;
+        }
+    }
+}
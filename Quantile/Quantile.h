@@ -0,0 +1,498 @@
+// EasyCpp - Quantile : Streaming Quantile Sketches
+// Copyright (C) 2025  C14147
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+/**
+ * @file EasyCpp/Quantile/Quantile.h
+ * @brief This file implements two fixed-memory sketches that estimate quantiles of a stream of
+ *        doubles without keeping the values:
+ *        - TDigest: very accurate near the tails (p99, p99.9), size set by a compression factor,
+ *        - KLL: uniform rank error with a provable bound, size set by k.
+ *        Both buffer insertions and merge them in batches, can be merged with sketches built
+ *        elsewhere, and serialize with dumps()/loads() or dump()/load() on a File.
+ */
+#pragma once
+#define _EASYCPP_QUANTILE_VERSION "1.0.0"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <FileOperator/BinaryIO.h>
+
+namespace easycpp {
+    /**
+     * @class TDigest
+     * @brief A merging t-digest. Values are appended to a buffer; when it is full, buffer and
+     * centroids are sorted together and merged into at most about `compression` centroids, keeping
+     * centroids small near q = 0 and q = 1 (the arcsine scale function), so tail quantiles stay
+     * accurate. Insertion is O(1) amortized.
+     *
+     * The const queries merge pending buffered values first. That merge runs under an internal
+     * mutex, so any number of threads may query the same digest at once; add(), compress(),
+     * merge() and assignment still need exclusive access.
+     */
+    class TDigest {
+    public:
+        struct Centroid {
+            double mean;
+            double weight;
+
+            bool operator<(const Centroid& other) const { return mean < other.mean; }
+        };
+
+    private:
+        static constexpr double PI = 3.14159265358979323846;
+
+        double compression;
+        // Merged lazily by the const queries, guarded by flush_lock there.
+        mutable std::vector<Centroid> centroids;
+        mutable std::vector<Centroid> buffer;
+        size_t buffer_limit;
+        mutable double total = 0;
+        double minimum = std::numeric_limits<double>::infinity();
+        double maximum = -std::numeric_limits<double>::infinity();
+        mutable std::mutex flush_lock;
+
+        double scale(double q) const {
+            return compression / (2 * PI) * std::asin(2 * q - 1);
+        }
+
+        double scale_inverse(double k) const {
+            return (std::sin(k * 2 * PI / compression) + 1) / 2;
+        }
+
+        void merge_buffer() const {
+            if (buffer.empty()) return;
+            for (const Centroid& c : centroids) buffer.push_back(c);
+            std::sort(buffer.begin(), buffer.end());
+            double weight = 0;
+            for (const Centroid& c : buffer) weight += c.weight;
+            total = weight;
+
+            centroids.clear();
+            Centroid current = buffer[0];
+            double before = 0;  // Weight of the centroids already emitted
+            double limit = total * scale_inverse(scale(0) + 1);
+            for (size_t i = 1; i < buffer.size(); ++i) {
+                const Centroid& next = buffer[i];
+                if (before + current.weight + next.weight <= limit) {
+                    current.weight += next.weight;
+                    current.mean += (next.mean - current.mean) * next.weight / current.weight;
+                } else {
+                    before += current.weight;
+                    centroids.push_back(current);
+                    limit = total * scale_inverse(scale(before / total) + 1);
+                    current = next;
+                }
+            }
+            centroids.push_back(current);
+            buffer.clear();
+        }
+
+        // Once one query has merged the buffer, the others find it empty and only read.
+        void flush() const {
+            std::lock_guard<std::mutex> lock(flush_lock);
+            merge_buffer();
+        }
+
+    public:
+        /**
+         * @brief Construct an empty digest.
+         * @param compression The accuracy parameter; about 2 * compression centroids are kept.
+         * @throws std::invalid_argument if compression is below 10.
+         */
+        explicit TDigest(double compression = 100) : compression(compression) {
+            if (!(compression >= 10)) throw std::invalid_argument("TDigest: compression must be at least 10");
+            buffer_limit = (size_t) (5 * compression);
+            buffer.reserve(buffer_limit);
+        }
+
+        /**
+         * @brief Add a value.
+         * @param value The value; NaN is ignored.
+         * @param weight The number of occurrences.
+         */
+        void add(double value, double weight = 1) {
+            if (std::isnan(value) || !(weight > 0)) return;
+            buffer.push_back({value, weight});
+            minimum = std::min(minimum, value);
+            maximum = std::max(maximum, value);
+            if (buffer.size() >= buffer_limit) compress();
+        }
+
+        TDigest(const TDigest& other) : compression(other.compression), buffer_limit(other.buffer_limit) {
+            *this = other;
+        }
+
+        TDigest& operator=(const TDigest& other) {
+            if (this == &other) return *this;
+            other.flush();
+            compression = other.compression;
+            buffer_limit = other.buffer_limit;
+            centroids = other.centroids;
+            buffer.clear();
+            buffer.reserve(buffer_limit);
+            total = other.total;
+            minimum = other.minimum;
+            maximum = other.maximum;
+            return *this;
+        }
+
+        /**
+         * @brief Merge the buffered values into the centroids.
+         */
+        void compress() {
+            merge_buffer();
+        }
+
+        /**
+         * @brief Add all values summarized by another digest.
+         * @param other The other digest, which other threads may be querying meanwhile.
+         */
+        void merge(const TDigest& other) {
+            other.flush();
+            std::vector<Centroid> merged = other.centroids;
+            for (const Centroid& c : merged) buffer.push_back(c);
+            minimum = std::min(minimum, other.minimum);
+            maximum = std::max(maximum, other.maximum);
+            compress();
+        }
+
+        /**
+         * @brief Estimate a quantile.
+         * @param q The quantile, 0 to 1.
+         * @return The estimated value, or NaN if the digest is empty.
+         */
+        double quantile(double q) const {
+            flush();
+            if (centroids.empty()) return std::numeric_limits<double>::quiet_NaN();
+            q = std::clamp(q, 0.0, 1.0);
+            if (centroids.size() == 1) return centroids[0].mean;
+            const double rank = q * total;
+            // Each centroid's weight is centered on its mean; interpolate between neighbouring centers.
+            double left = centroids[0].weight / 2;
+            if (rank < left) return minimum + (centroids[0].mean - minimum) * rank / left;
+            for (size_t i = 0; i + 1 < centroids.size(); ++i) {
+                double gap = (centroids[i].weight + centroids[i + 1].weight) / 2;
+                if (rank < left + gap) {
+                    return centroids[i].mean + (centroids[i + 1].mean - centroids[i].mean) * (rank - left) / gap;
+                }
+                left += gap;
+            }
+            double tail = total - left;
+            const double last = centroids.back().mean;
+            return tail > 0 ? last + (maximum - last) * std::min(1.0, (rank - left) / tail) : last;
+        }
+
+        /**
+         * @brief Estimate the fraction of values less than or equal to a value.
+         * @param value The value.
+         * @return The fraction, 0 to 1.
+         */
+        double cdf(double value) const {
+            flush();
+            if (centroids.empty()) return std::numeric_limits<double>::quiet_NaN();
+            if (value < minimum) return 0;
+            if (value >= maximum) return 1;
+            double left = 0;
+            double previous_mean = minimum, previous_rank = 0;
+            for (const Centroid& c : centroids) {
+                double center = left + c.weight / 2;
+                if (value < c.mean) {
+                    return (previous_rank + (center - previous_rank) * (value - previous_mean) / (c.mean - previous_mean)) / total;
+                }
+                previous_mean = c.mean;
+                previous_rank = center;
+                left += c.weight;
+            }
+            return (previous_rank + (total - previous_rank) * (value - previous_mean) / (maximum - previous_mean)) / total;
+        }
+
+        double count() const { flush(); return total; }
+        double min() const { return minimum; }
+        double max() const { return maximum; }
+        size_t centroid_count() const { flush(); return centroids.size(); }
+
+        std::string dumps() const {
+            flush();
+            ByteWriter writer;
+            writer.put<uint32_t>(0x44544345);  // "ECTD"
+            writer.put<double>(compression);
+            writer.put<double>(minimum);
+            writer.put<double>(maximum);
+            writer.put_varint(centroids.size());
+            for (const Centroid& c : centroids) {
+                writer.put<double>(c.mean);
+                writer.put<double>(c.weight);
+            }
+            return writer.str();
+        }
+
+        static TDigest loads(std::string_view bytes) {
+            ByteReader reader(bytes);
+            if (reader.get<uint32_t>() != 0x44544345) throw std::invalid_argument("TDigest: not a serialized TDigest");
+            TDigest digest(reader.get<double>());
+            digest.minimum = reader.get<double>();
+            digest.maximum = reader.get<double>();
+            digest.centroids.resize((size_t) reader.get_varint());
+            for (Centroid& c : digest.centroids) {
+                c.mean = reader.get<double>();
+                c.weight = reader.get<double>();
+                digest.total += c.weight;
+            }
+            return digest;
+        }
+
+        void dump(File* file) const { write_record(file, dumps()); }
+        static TDigest load(File* file) { return loads(read_record(file)); }
+    };
+
+    /**
+     * @class KLL
+     * @brief The KLL quantile sketch. Values enter level 0; a full level is sorted and every other
+     * element (odd or even positions, chosen at random) is promoted to the next level with double
+     * weight. Level capacities shrink geometrically from k at the top, so the sketch keeps
+     * O(k) values and the rank error is about 1.7 / k with high probability, for any input.
+     */
+    class KLL {
+    private:
+        static constexpr double DECAY = 2.0 / 3.0;
+
+        uint32_t k;
+        std::vector<std::vector<double>> levels;
+        uint64_t n = 0;
+        size_t retained_count = 0;
+        size_t capacity_limit = 0;  // Sum of level capacities, updated when a level is added
+        uint64_t random_state;
+        double minimum = std::numeric_limits<double>::infinity();
+        double maximum = -std::numeric_limits<double>::infinity();
+
+        size_t capacity(size_t level) const {
+            size_t depth = levels.size() - level - 1;
+            return std::max<size_t>(2, (size_t) std::ceil(k * std::pow(DECAY, (double) depth)));
+        }
+
+        void update_capacity() {
+            capacity_limit = 0;
+            for (size_t level = 0; level < levels.size(); ++level) capacity_limit += capacity(level);
+        }
+
+        bool coin() {
+            random_state += 0x9E3779B97F4A7C15ULL;
+            uint64_t z = random_state;
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+            return (z ^ (z >> 31)) & 1;
+        }
+
+        void compact() {
+            while (retained_count >= capacity_limit) {
+                for (size_t level = 0; level < levels.size(); ++level) {
+                    if (levels[level].size() < capacity(level)) continue;
+                    if (level + 1 == levels.size()) {
+                        levels.emplace_back();
+                        update_capacity();
+                    }
+                    std::vector<double>& items = levels[level];
+                    std::sort(items.begin(), items.end());
+                    // An odd element out stays behind so the promoted weight is exact.
+                    double leftover = 0;
+                    bool has_leftover = items.size() % 2;
+                    if (has_leftover) {
+                        leftover = items.back();
+                        items.pop_back();
+                    }
+                    std::vector<double>& next = levels[level + 1];
+                    for (size_t i = coin() ? 1 : 0; i < items.size(); i += 2) next.push_back(items[i]);
+                    retained_count -= items.size() / 2;
+                    items.clear();
+                    if (has_leftover) items.push_back(leftover);
+                    break;
+                }
+            }
+        }
+
+        std::vector<std::pair<double, uint64_t>> weighted() const {
+            std::vector<std::pair<double, uint64_t>> items;
+            items.reserve(retained_count);
+            for (size_t level = 0; level < levels.size(); ++level) {
+                for (double value : levels[level]) items.emplace_back(value, (uint64_t) 1 << level);
+            }
+            std::sort(items.begin(), items.end());
+            return items;
+        }
+
+    public:
+        /**
+         * @brief Construct an empty sketch.
+         * @param k The accuracy parameter; the normalized rank error is about 1.7 / k.
+         * @param seed The seed of the compaction coin flips.
+         * @throws std::invalid_argument if k is below 8.
+         */
+        explicit KLL(uint32_t k = 200, uint64_t seed = 0x5eed) : k(k), levels(1), random_state(seed) {
+            if (k < 8) throw std::invalid_argument("KLL: k must be at least 8");
+            levels[0].reserve(k);
+            update_capacity();
+        }
+
+        /**
+         * @brief Add a value.
+         * @param value The value; NaN is ignored.
+         */
+        void add(double value) {
+            if (std::isnan(value)) return;
+            levels[0].push_back(value);
+            ++n;
+            ++retained_count;
+            minimum = std::min(minimum, value);
+            maximum = std::max(maximum, value);
+            if (levels[0].size() >= capacity(0)) compact();
+        }
+
+        /**
+         * @brief Add all values summarized by another sketch. The error bound of the result is the
+         * same as for a sketch built from the combined stream.
+         * @param other The other sketch.
+         * @throws std::invalid_argument if the k parameters differ.
+         */
+        void merge(const KLL& other) {
+            if (other.k != k) throw std::invalid_argument("KLL: cannot merge sketches with different k");
+            if (other.levels.size() > levels.size()) {
+                levels.resize(other.levels.size());
+                update_capacity();
+            }
+            for (size_t level = 0; level < other.levels.size(); ++level) {
+                levels[level].insert(levels[level].end(), other.levels[level].begin(), other.levels[level].end());
+            }
+            n += other.n;
+            retained_count += other.retained_count;
+            minimum = std::min(minimum, other.minimum);
+            maximum = std::max(maximum, other.maximum);
+            compact();
+        }
+
+        /**
+         * @brief Estimate a quantile.
+         * @param q The quantile, 0 to 1.
+         * @return The estimated value, or NaN if the sketch is empty.
+         */
+        double quantile(double q) const {
+            if (n == 0) return std::numeric_limits<double>::quiet_NaN();
+            if (q <= 0) return minimum;
+            if (q >= 1) return maximum;
+            auto items = weighted();
+            uint64_t weight = 0;
+            for (const auto& item : items) weight += item.second;
+            const double rank = q * (double) weight;
+            uint64_t seen = 0;
+            for (const auto& [value, item_weight] : items) {
+                seen += item_weight;
+                if ((double) seen > rank) return value;
+            }
+            return maximum;
+        }
+
+        /**
+         * @brief Estimate several quantiles with a single pass over the sketch.
+         * @param qs The quantiles, each 0 to 1.
+         * @return The estimated values, in the order of qs.
+         */
+        std::vector<double> quantiles(const std::vector<double>& qs) const {
+            std::vector<double> result(qs.size(), std::numeric_limits<double>::quiet_NaN());
+            if (n == 0) return result;
+            auto items = weighted();
+            std::vector<uint64_t> cumulative(items.size());
+            uint64_t weight = 0;
+            for (size_t i = 0; i < items.size(); ++i) cumulative[i] = weight += items[i].second;
+            for (size_t i = 0; i < qs.size(); ++i) {
+                if (qs[i] <= 0) { result[i] = minimum; continue; }
+                if (qs[i] >= 1) { result[i] = maximum; continue; }
+                double rank = qs[i] * (double) weight;
+                size_t index = std::upper_bound(cumulative.begin(), cumulative.end(), (uint64_t) rank) - cumulative.begin();
+                result[i] = index < items.size() ? items[index].first : maximum;
+            }
+            return result;
+        }
+
+        /**
+         * @brief Estimate the fraction of values less than or equal to a value.
+         * @param value The value.
+         * @return The fraction, 0 to 1.
+         */
+        double cdf(double value) const {
+            if (n == 0) return std::numeric_limits<double>::quiet_NaN();
+            uint64_t below = 0, weight = 0;
+            for (size_t level = 0; level < levels.size(); ++level) {
+                for (double item : levels[level]) {
+                    weight += (uint64_t) 1 << level;
+                    if (item <= value) below += (uint64_t) 1 << level;
+                }
+            }
+            return (double) below / (double) weight;
+        }
+
+        uint64_t count() const { return n; }
+        double min() const { return minimum; }
+        double max() const { return maximum; }
+        size_t retained() const { return retained_count; }
+
+        std::string dumps() const {
+            ByteWriter writer;
+            writer.put<uint32_t>(0x4c4b4345);  // "ECKL"
+            writer.put<uint32_t>(k);
+            writer.put<uint64_t>(n);
+            writer.put<uint64_t>(random_state);
+            writer.put<double>(minimum);
+            writer.put<double>(maximum);
+            writer.put_varint(levels.size());
+            for (const auto& level : levels) {
+                writer.put_varint(level.size());
+                for (double value : level) writer.put<double>(value);
+            }
+            return writer.str();
+        }
+
+        static KLL loads(std::string_view bytes) {
+            ByteReader reader(bytes);
+            if (reader.get<uint32_t>() != 0x4c4b4345) throw std::invalid_argument("KLL: not a serialized KLL");
+            KLL sketch(reader.get<uint32_t>());
+            sketch.n = reader.get<uint64_t>();
+            sketch.random_state = reader.get<uint64_t>();
+            sketch.minimum = reader.get<double>();
+            sketch.maximum = reader.get<double>();
+            sketch.levels.resize((size_t) reader.get_varint());
+            for (auto& level : sketch.levels) {
+                level.resize((size_t) reader.get_varint());
+                for (double& value : level) value = reader.get<double>();
+                sketch.retained_count += level.size();
+            }
+            if (sketch.levels.empty()) sketch.levels.resize(1);
+            sketch.update_capacity();
+            return sketch;
+        }
+
+        void dump(File* file) const { write_record(file, dumps()); }
+        static KLL load(File* file) { return loads(read_record(file)); }
+    };
+}
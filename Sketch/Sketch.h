@@ -0,0 +1,690 @@
+// EasyCpp - Sketch : Probabilistic Membership, Cardinality and Frequency Sketches
+// Copyright (C) 2025  C14147
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+/**
+ * @file EasyCpp/Sketch/Sketch.h
+ * @brief This file implements fixed-memory probabilistic sketches:
+ *        - BloomFilter: a blocked Bloom filter whose probes touch one 64-byte cache line,
+ *        - HyperLogLog: HyperLogLog++ style distinct counting with a sparse representation,
+ *        - CountMinSketch and CountSketch: frequency estimation.
+ *        Every sketch can be merged with another one of the same configuration (e.g. built by
+ *        another thread or process) and serialized with dumps()/loads() or dump()/load() on a File.
+ *        Keys are hashed with easycpp::hash; add_hash() accepts a precomputed hash.
+ */
+#pragma once
+#define _EASYCPP_SKETCH_VERSION "1.0.0"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+#include <FileOperator/BinaryIO.h>
+#include <String/Hash.h>
+#include <String/String.h>
+
+namespace easycpp {
+    namespace sketch {
+        /**
+         * @brief Hash a key with the EasyCpp hash.
+         */
+        inline uint64_t key_hash(std::string_view key) { return hash(key); }
+        inline uint64_t key_hash(const char* key) { return hash(std::string_view(key)); }
+        inline uint64_t key_hash(const std::string& key) { return hash(std::string_view(key)); }
+        inline uint64_t key_hash(const String& key) { return key.hash(); }
+        template<typename T, typename = std::enable_if_t<std::is_arithmetic_v<T>>>
+        inline uint64_t key_hash(T key) { return hash(key); }
+
+        inline void check_magic(ByteReader& reader, uint32_t magic, const char* name) {
+            if (reader.get<uint32_t>() != magic) throw std::invalid_argument(std::string(name) + ": not a serialized " + name);
+        }
+
+        /**
+         * @brief Validate the dimensions of a serialized counter matrix. Columns are picked with a
+         * 32-bit multiply, so the width must fit in 32 bits, and every counter takes at least one
+         * byte, so width * depth cannot exceed what is left of the input.
+         * @throws std::invalid_argument if the dimensions are impossible.
+         */
+        inline void check_dimensions(const ByteReader& reader, uint64_t width, uint64_t depth, const char* name) {
+            if (width == 0 || depth == 0 || width > 0xFFFFFFFFULL || depth > reader.remaining() / width) {
+                throw std::invalid_argument(std::string(name) + ": bad dimensions");
+            }
+        }
+
+        /**
+         * @class BloomFilter
+         * @brief A blocked Bloom filter. Each key selects one 512-bit block (a cache line) and sets
+         * `rounds` bits in each of its eight 64-bit words, so a probe costs a single cache miss and
+         * the eight word tests of a round run as vector operations (AVX2 when available).
+         * The constructor picks the number of rounds (k = 8 * rounds probes) and the number of
+         * blocks that reach the requested false positive rate with the fewest bits.
+         */
+        class BloomFilter {
+        public:
+            static constexpr size_t WORDS = 8;        // 64-bit words per block
+            static constexpr unsigned MAX_ROUNDS = 8; // At most 64 probes per key
+
+        private:
+            struct alignas(64) Block {
+                uint64_t words[WORDS];
+            };
+
+            std::vector<Block> blocks;
+            unsigned rounds = 1;
+
+            static constexpr uint32_t SALT[WORDS] = {
+                0x47b6137bU, 0x44974d91U, 0x8824ad5bU, 0xa2b7289dU,
+                0x705495c7U, 0x2df1424bU, 0x9efc4947U, 0x5c6bfb31U
+            };
+
+            size_t block_of(uint64_t h) const {
+                return (size_t) (((h >> 32) * (uint64_t) blocks.size()) >> 32);
+            }
+
+            // The 32-bit key of a round. Round 0 uses the low half of the hash directly; later
+            // rounds remix the whole hash so their bits are independent of the earlier ones.
+            static uint32_t round_key(uint64_t h, unsigned round) {
+                if (round == 0) return (uint32_t) h;
+                uint64_t x = h + round * 0x9e3779b97f4a7c15ULL;
+                x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+                x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+                return (uint32_t) (x ^ (x >> 31));
+            }
+
+            static void make_mask(uint32_t key, uint64_t* mask) {
+                for (size_t i = 0; i < WORDS; ++i) mask[i] = 1ULL << ((uint32_t) (key * SALT[i]) >> 26);
+            }
+
+            // Expected false positive rate of a blocked filter: the keys per block follow a Poisson
+            // distribution, and a key with r rounds must find r set bits in each of the eight words.
+            static double expected_fpp(double keys_per_block, unsigned r) {
+                double total = 0.0;
+                double weight = std::exp(-keys_per_block);
+                size_t limit = (size_t) (keys_per_block + 12.0 * std::sqrt(keys_per_block) + 32.0);
+                for (size_t j = 0; j <= limit; ++j) {
+                    if (j > 0) weight *= keys_per_block / (double) j;
+                    double bit_set = 1.0 - std::pow(63.0 / 64.0, (double) (j * r));
+                    total += weight * std::pow(bit_set, (double) (WORDS * r));
+                }
+                return total;
+            }
+
+        public:
+            /**
+             * @brief Size a filter for an expected number of keys and false positive rate.
+             * @param expected_items The number of distinct keys that will be added.
+             * @param fpp The target false positive probability.
+             * @throws std::invalid_argument if fpp is not between 0 and 1.
+             */
+            explicit BloomFilter(size_t expected_items = 1000000, double fpp = 0.01) {
+                if (!(fpp > 0.0 && fpp < 1.0)) throw std::invalid_argument("BloomFilter: fpp must be between 0 and 1");
+                double items = (double) std::max<size_t>(expected_items, 1);
+                // A classic filter needs -ln(fpp) / ln(2)^2 bits per key; blocking needs somewhat more.
+                // For each number of rounds grow the size until the model meets the target, and keep
+                // the smallest.
+                double classic = -items * std::log(fpp) / (std::log(2.0) * std::log(2.0));
+                size_t best = 0;
+                for (unsigned r = 1; r <= MAX_ROUNDS; ++r) {
+                    size_t count = std::max<size_t>(1, (size_t) std::ceil(classic / 512.0));
+                    while (expected_fpp(items / (double) count, r) > fpp) count += count / 32 + 1;
+                    if (best == 0 || count < best) {
+                        best = count;
+                        rounds = r;
+                    }
+                }
+                blocks.resize(best);
+                std::memset(blocks.data(), 0, blocks.size() * sizeof(Block));
+            }
+
+            /**
+             * @brief Add a precomputed 64-bit hash.
+             * @param h The hash.
+             */
+            void add_hash(uint64_t h) {
+                uint64_t mask[WORDS];
+                Block& block = blocks[block_of(h)];
+                for (unsigned r = 0; r < rounds; ++r) {
+                    make_mask(round_key(h, r), mask);
+                    for (size_t i = 0; i < WORDS; ++i) block.words[i] |= mask[i];
+                }
+            }
+
+            /**
+             * @brief Test a precomputed 64-bit hash.
+             * @param h The hash.
+             * @return false if the key was definitely never added.
+             */
+            bool contains_hash(uint64_t h) const {
+                const Block& block = blocks[block_of(h)];
+#if defined(__AVX2__)
+                const __m256i salt = _mm256_setr_epi32((int) SALT[0], (int) SALT[1], (int) SALT[2], (int) SALT[3],
+                                                       (int) SALT[4], (int) SALT[5], (int) SALT[6], (int) SALT[7]);
+                const __m256i one = _mm256_set1_epi64x(1);
+                const __m256i w0 = _mm256_load_si256((const __m256i*) block.words);
+                const __m256i w1 = _mm256_load_si256((const __m256i*) (block.words + 4));
+                for (unsigned r = 0; r < rounds; ++r) {
+                    const __m256i key = _mm256_set1_epi32((int) round_key(h, r));
+                    __m256i bit = _mm256_srli_epi32(_mm256_mullo_epi32(key, salt), 26);
+                    __m256i low = _mm256_sllv_epi64(one, _mm256_cvtepu32_epi64(_mm256_castsi256_si128(bit)));
+                    __m256i high = _mm256_sllv_epi64(one, _mm256_cvtepu32_epi64(_mm256_extracti128_si256(bit, 1)));
+                    __m256i miss = _mm256_or_si256(_mm256_andnot_si256(w0, low), _mm256_andnot_si256(w1, high));
+                    if (!_mm256_testz_si256(miss, miss)) return false;
+                }
+                return true;
+#else
+                uint64_t mask[WORDS];
+                for (unsigned r = 0; r < rounds; ++r) {
+                    make_mask(round_key(h, r), mask);
+                    uint64_t miss = 0;
+                    for (size_t i = 0; i < WORDS; ++i) miss |= mask[i] & ~block.words[i];
+                    if (miss != 0) return false;
+                }
+                return true;
+#endif
+            }
+
+            template<typename Key>
+            void add(const Key& key) { add_hash(key_hash(key)); }
+
+            template<typename Key>
+            bool contains(const Key& key) const { return contains_hash(key_hash(key)); }
+
+            /**
+             * @brief Get the size of the filter.
+             * @return The number of bits.
+             */
+            size_t bit_count() const { return blocks.size() * 512; }
+
+            /**
+             * @brief Get the number of bits set per key.
+             */
+            size_t hash_count() const { return rounds * WORDS; }
+
+            /**
+             * @brief Add all keys of another filter of the same configuration (bitwise OR).
+             * @param other The other filter.
+             * @throws std::invalid_argument if the sizes or hash counts differ.
+             */
+            void merge(const BloomFilter& other) {
+                if (other.blocks.size() != blocks.size() || other.rounds != rounds) {
+                    throw std::invalid_argument("BloomFilter: cannot merge filters of different configurations");
+                }
+                for (size_t b = 0; b < blocks.size(); ++b) {
+                    for (size_t i = 0; i < WORDS; ++i) blocks[b].words[i] |= other.blocks[b].words[i];
+                }
+            }
+
+            std::string dumps() const {
+                ByteWriter writer;
+                writer.put<uint32_t>(0x46424345);  // "ECBF"
+                writer.put<uint32_t>(rounds);
+                writer.put<uint64_t>(blocks.size());
+                for (const Block& block : blocks) {
+                    for (uint64_t word : block.words) writer.put<uint64_t>(word);
+                }
+                return writer.str();
+            }
+
+            static BloomFilter loads(std::string_view bytes) {
+                ByteReader reader(bytes);
+                check_magic(reader, 0x46424345, "BloomFilter");
+                BloomFilter filter(1);
+                filter.rounds = reader.get<uint32_t>();
+                if (filter.rounds < 1 || filter.rounds > MAX_ROUNDS) throw std::invalid_argument("BloomFilter: bad hash count");
+                uint64_t count = reader.get<uint64_t>();
+                if (count == 0 || count > reader.remaining() / sizeof(Block)) throw std::invalid_argument("BloomFilter: bad block count");
+                filter.blocks.resize((size_t) count);
+                for (Block& block : filter.blocks) {
+                    for (uint64_t& word : block.words) word = reader.get<uint64_t>();
+                }
+                return filter;
+            }
+
+            void dump(File* file) const { write_record(file, dumps()); }
+            static BloomFilter load(File* file) { return loads(read_record(file)); }
+        };
+
+        /**
+         * @class HyperLogLog
+         * @brief Distinct counting with 2^p registers (HyperLogLog++).
+         * Small sets are kept in a sparse list of (25-bit index, rank) entries, which is nearly exact,
+         * and converted to dense 8-bit registers once that list would be larger. Dense estimates use
+         * Ertl's improved estimator, which needs no empirical bias tables. The relative standard
+         * error is about 1.04 / sqrt(2^p).
+         */
+        class HyperLogLog {
+        public:
+            static constexpr unsigned SPARSE_P = 25;
+
+        private:
+            unsigned p;
+            bool sparse = true;
+            std::vector<uint8_t> registers;       // Dense mode: one rank per register
+            std::vector<uint32_t> entries;        // Sparse mode: sorted, unique index << 6 | rank
+            std::vector<uint32_t> staging;        // Sparse mode: unsorted recent entries
+
+            static uint8_t rank_of(uint64_t bits, unsigned width) {
+                // Position of the first 1 bit in the top `width` bits of `bits`, 1-based.
+                uint8_t rank = 1;
+                for (uint64_t probe = 1ULL << 63; rank <= width && !(bits & probe); probe >>= 1) ++rank;
+                return rank;
+            }
+
+            size_t sparse_limit() const {
+                // Convert when the sparse list would take more memory than the dense registers.
+                return std::max<size_t>(16, ((size_t) 1 << p) / 4);
+            }
+
+            void compact() {
+                if (staging.empty()) return;
+                std::sort(staging.begin(), staging.end());
+                std::vector<uint32_t> merged;
+                merged.reserve(entries.size() + staging.size());
+                std::merge(entries.begin(), entries.end(), staging.begin(), staging.end(), std::back_inserter(merged));
+                staging.clear();
+                // Keep the highest rank per index: entries sort by index, then rank.
+                entries.clear();
+                for (size_t i = 0; i < merged.size(); ++i) {
+                    if (i + 1 < merged.size() && merged[i] >> 6 == merged[i + 1] >> 6) continue;
+                    entries.push_back(merged[i]);
+                }
+                if (entries.size() > sparse_limit()) to_dense();
+            }
+
+            void to_dense() {
+                registers.assign((size_t) 1 << p, 0);
+                const unsigned extra = SPARSE_P - p;
+                for (uint32_t entry : entries) set_dense_from_sparse(entry, extra);
+                for (uint32_t entry : staging) set_dense_from_sparse(entry, extra);
+                entries.clear();
+                entries.shrink_to_fit();
+                staging.clear();
+                staging.shrink_to_fit();
+                sparse = false;
+            }
+
+            void set_dense_from_sparse(uint32_t entry, unsigned extra) {
+                uint32_t index = entry >> 6;
+                uint32_t low = index & ((1u << extra) - 1);
+                uint8_t rank = low ? rank_of((uint64_t) low << (64 - extra), extra) : (uint8_t) (extra + (entry & 63));
+                uint8_t& slot = registers[index >> extra];
+                slot = std::max(slot, rank);
+            }
+
+            static double sigma(double x) {
+                if (x == 1.0) return std::numeric_limits<double>::infinity();
+                double y = 1.0, z = x;
+                for (;;) {
+                    x *= x;
+                    double previous = z;
+                    z += x * y;
+                    y += y;
+                    if (z == previous) return z;
+                }
+            }
+
+            static double tau(double x) {
+                if (x == 0.0 || x == 1.0) return 0.0;
+                double y = 1.0, z = 1.0 - x;
+                for (;;) {
+                    x = std::sqrt(x);
+                    double previous = z;
+                    y *= 0.5;
+                    z -= (1.0 - x) * (1.0 - x) * y;
+                    if (z == previous) return z / 3.0;
+                }
+            }
+
+        public:
+            /**
+             * @brief Construct an empty sketch.
+             * @param precision The number of index bits p, 4 to 18.
+             * @throws std::invalid_argument if the precision is out of range.
+             */
+            explicit HyperLogLog(unsigned precision = 14) : p(precision) {
+                if (p < 4 || p > 18) throw std::invalid_argument("HyperLogLog: precision must be between 4 and 18");
+            }
+
+            unsigned precision() const { return p; }
+            bool is_sparse() const { return sparse; }
+
+            /**
+             * @brief Add a precomputed 64-bit hash.
+             * @param h The hash.
+             */
+            void add_hash(uint64_t h) {
+                if (sparse) {
+                    uint32_t index = (uint32_t) (h >> (64 - SPARSE_P));
+                    staging.push_back(index << 6 | rank_of(h << SPARSE_P, 64 - SPARSE_P));
+                    if (staging.size() >= std::max<size_t>(64, entries.size() / 2)) compact();
+                    return;
+                }
+                uint8_t& slot = registers[h >> (64 - p)];
+                slot = std::max(slot, rank_of(h << p, 64 - p));
+            }
+
+            template<typename Key>
+            void add(const Key& key) { add_hash(key_hash(key)); }
+
+            /**
+             * @brief Estimate the number of distinct keys added.
+             * @return The estimate.
+             */
+            double count() {
+                if (sparse) {
+                    compact();
+                    if (sparse) {
+                        // Linear counting over the 2^25 sparse registers.
+                        double m = (double) (1u << SPARSE_P);
+                        return m * std::log(m / (m - (double) entries.size()));
+                    }
+                }
+                const unsigned q = 64 - p;
+                const double m = (double) registers.size();
+                std::vector<double> histogram(q + 2, 0.0);
+                for (uint8_t rank : registers) histogram[rank] += 1.0;
+                double z = m * tau(1.0 - histogram[q + 1] / m);
+                for (unsigned k = q; k >= 1; --k) z = 0.5 * (z + histogram[k]);
+                z += m * sigma(histogram[0] / m);
+                return 0.5 / std::log(2.0) * m * m / z;
+            }
+
+            /**
+             * @brief Add all keys counted by another sketch with the same precision.
+             * @param other The other sketch.
+             * @throws std::invalid_argument if the precisions differ.
+             */
+            void merge(const HyperLogLog& other) {
+                if (other.p != p) throw std::invalid_argument("HyperLogLog: cannot merge sketches of different precision");
+                if (other.sparse) {
+                    if (sparse) {
+                        staging.insert(staging.end(), other.entries.begin(), other.entries.end());
+                        staging.insert(staging.end(), other.staging.begin(), other.staging.end());
+                        compact();
+                    } else {
+                        for (uint32_t entry : other.entries) set_dense_from_sparse(entry, SPARSE_P - p);
+                        for (uint32_t entry : other.staging) set_dense_from_sparse(entry, SPARSE_P - p);
+                    }
+                    return;
+                }
+                if (sparse) to_dense();
+                for (size_t i = 0; i < registers.size(); ++i) registers[i] = std::max(registers[i], other.registers[i]);
+            }
+
+            std::string dumps() {
+                compact();
+                ByteWriter writer;
+                writer.put<uint32_t>(0x4c484345);  // "ECHL"
+                writer.put<uint8_t>((uint8_t) p);
+                writer.put<uint8_t>(sparse ? 1 : 0);
+                if (sparse) {
+                    // Sorted entries compress well as varint deltas.
+                    writer.put_varint(entries.size());
+                    uint32_t previous = 0;
+                    for (uint32_t entry : entries) {
+                        writer.put_varint(entry - previous);
+                        previous = entry;
+                    }
+                } else {
+                    writer.put_bytes(registers.data(), registers.size());
+                }
+                return writer.str();
+            }
+
+            static HyperLogLog loads(std::string_view bytes) {
+                ByteReader reader(bytes);
+                check_magic(reader, 0x4c484345, "HyperLogLog");
+                HyperLogLog sketch(reader.get<uint8_t>());
+                sketch.sparse = reader.get<uint8_t>() != 0;
+                if (sketch.sparse) {
+                    // Entries are strictly increasing, with an index below 2^25 and a rank that
+                    // rank_of() can produce for the remaining 39 bits.
+                    uint64_t size = reader.get_varint();
+                    if (size > reader.remaining()) throw std::invalid_argument("HyperLogLog: bad entry count");
+                    sketch.entries.resize((size_t) size);
+                    const uint64_t limit = 1ULL << (SPARSE_P + 6);
+                    uint64_t previous = 0;
+                    for (uint32_t& entry : sketch.entries) {
+                        uint64_t delta = reader.get_varint();
+                        if (delta == 0 || delta >= limit || previous + delta >= limit) throw std::invalid_argument("HyperLogLog: bad sparse entry");
+                        previous += delta;
+                        uint64_t rank = previous & 63;
+                        if (rank < 1 || rank > 64 - SPARSE_P + 1) throw std::invalid_argument("HyperLogLog: bad sparse entry");
+                        entry = (uint32_t) previous;
+                    }
+                } else {
+                    const char* data = reader.get_bytes((size_t) 1 << sketch.p);
+                    sketch.registers.assign(data, data + ((size_t) 1 << sketch.p));
+                    for (uint8_t rank : sketch.registers) {
+                        if (rank > 64 - sketch.p + 1) throw std::invalid_argument("HyperLogLog: bad register rank");
+                    }
+                }
+                return sketch;
+            }
+
+            void dump(File* file) { write_record(file, dumps()); }
+            static HyperLogLog load(File* file) { return loads(read_record(file)); }
+        };
+
+        /**
+         * @class CountMinSketch
+         * @brief Frequency estimation with depth rows of width counters. Estimates never undercount;
+         * with width = ceil(e / epsilon) and depth = ceil(ln(1 / delta)) the overcount is at most
+         * epsilon * total with probability 1 - delta. Conservative update (the default) only raises
+         * the counters that are below the new estimate, which reduces the overcount considerably.
+         * Merging adds counters; for conservatively updated sketches the result is still an upper
+         * bound, but looser than a sketch built from the combined stream.
+         */
+        class CountMinSketch {
+        private:
+            size_t width, depth;
+            bool conservative;
+            std::vector<uint64_t> counters;
+            uint64_t total = 0;
+
+            size_t column(uint64_t h, size_t row) const {
+                uint64_t mixed = (uint64_t) (uint32_t) h + (uint64_t) row * ((h >> 32) | 1);
+                return (size_t) ((uint64_t) (uint32_t) hash_mix(mixed) * width >> 32);
+            }
+
+        public:
+            /**
+             * @brief Construct an empty sketch.
+             * @param width The number of counters per row.
+             * @param depth The number of rows.
+             * @param conservative Whether to use conservative update.
+             */
+            CountMinSketch(size_t width = 2048, size_t depth = 5, bool conservative = true)
+                : width(std::max<size_t>(width, 1)), depth(std::max<size_t>(depth, 1)), conservative(conservative),
+                  counters(this->width * this->depth, 0) {}
+
+            /**
+             * @brief Size a sketch for an error bound.
+             * @param epsilon The overcount bound relative to the total count.
+             * @param delta The probability of exceeding the bound.
+             * @return The sketch.
+             */
+            static CountMinSketch with_error(double epsilon, double delta, bool conservative = true) {
+                return CountMinSketch((size_t) std::ceil(std::exp(1.0) / epsilon), (size_t) std::ceil(std::log(1.0 / delta)), conservative);
+            }
+
+            /**
+             * @brief Count occurrences of a precomputed hash.
+             * @param h The hash.
+             * @param count The number of occurrences.
+             */
+            void add_hash(uint64_t h, uint64_t count = 1) {
+                total += count;
+                if (!conservative) {
+                    for (size_t row = 0; row < depth; ++row) counters[row * width + column(h, row)] += count;
+                    return;
+                }
+                uint64_t target = estimate_hash(h) + count;
+                for (size_t row = 0; row < depth; ++row) {
+                    uint64_t& counter = counters[row * width + column(h, row)];
+                    counter = std::max(counter, target);
+                }
+            }
+
+            /**
+             * @brief Estimate the count of a precomputed hash.
+             * @param h The hash.
+             * @return The estimate, never below the true count.
+             */
+            uint64_t estimate_hash(uint64_t h) const {
+                uint64_t result = std::numeric_limits<uint64_t>::max();
+                for (size_t row = 0; row < depth; ++row) result = std::min(result, counters[row * width + column(h, row)]);
+                return result;
+            }
+
+            template<typename Key>
+            void add(const Key& key, uint64_t count = 1) { add_hash(key_hash(key), count); }
+
+            template<typename Key>
+            uint64_t estimate(const Key& key) const { return estimate_hash(key_hash(key)); }
+
+            uint64_t total_count() const { return total; }
+
+            /**
+             * @brief Add the counters of a sketch with the same dimensions.
+             * @param other The other sketch.
+             * @throws std::invalid_argument if the dimensions differ.
+             */
+            void merge(const CountMinSketch& other) {
+                if (other.width != width || other.depth != depth) throw std::invalid_argument("CountMinSketch: cannot merge sketches of different dimensions");
+                for (size_t i = 0; i < counters.size(); ++i) counters[i] += other.counters[i];
+                total += other.total;
+            }
+
+            std::string dumps() const {
+                ByteWriter writer;
+                writer.put<uint32_t>(0x4d434345);  // "ECCM"
+                writer.put<uint64_t>(width);
+                writer.put<uint64_t>(depth);
+                writer.put<uint8_t>(conservative ? 1 : 0);
+                writer.put_varint(total);
+                for (uint64_t counter : counters) writer.put_varint(counter);
+                return writer.str();
+            }
+
+            static CountMinSketch loads(std::string_view bytes) {
+                ByteReader reader(bytes);
+                check_magic(reader, 0x4d434345, "CountMinSketch");
+                uint64_t width = reader.get<uint64_t>();
+                uint64_t depth = reader.get<uint64_t>();
+                bool conservative = reader.get<uint8_t>() != 0;
+                check_dimensions(reader, width, depth, "CountMinSketch");
+                CountMinSketch sketch((size_t) width, (size_t) depth, conservative);
+                sketch.total = reader.get_varint();
+                for (uint64_t& counter : sketch.counters) counter = reader.get_varint();
+                return sketch;
+            }
+
+            void dump(File* file) const { write_record(file, dumps()); }
+            static CountMinSketch load(File* file) { return loads(read_record(file)); }
+        };
+
+        /**
+         * @class CountSketch
+         * @brief Frequency estimation with signed counters: every row adds +count or -count and
+         * the estimate is the median over rows. Unlike Count-Min it is unbiased (it can undercount),
+         * supports negative updates, and merges exactly by adding counters.
+         */
+        class CountSketch {
+        private:
+            size_t width, depth;
+            std::vector<int64_t> counters;
+
+            void locate(uint64_t h, size_t row, size_t& index, int64_t& sign) const {
+                uint64_t mixed = hash_mix(h + (uint64_t) (row + 1) * 0x9E3779B97F4A7C15ULL);
+                index = row * width + (size_t) (((mixed & 0xFFFFFFFFu) * width) >> 32);
+                sign = (mixed >> 63) ? -1 : 1;
+            }
+
+        public:
+            CountSketch(size_t width = 2048, size_t depth = 5)
+                : width(std::max<size_t>(width, 1)), depth(std::max<size_t>(depth, 1)), counters(this->width * this->depth, 0) {}
+
+            void add_hash(uint64_t h, int64_t count = 1) {
+                for (size_t row = 0; row < depth; ++row) {
+                    size_t index;
+                    int64_t sign;
+                    locate(h, row, index, sign);
+                    counters[index] += sign * count;
+                }
+            }
+
+            int64_t estimate_hash(uint64_t h) const {
+                std::vector<int64_t> values(depth);
+                for (size_t row = 0; row < depth; ++row) {
+                    size_t index;
+                    int64_t sign;
+                    locate(h, row, index, sign);
+                    values[row] = sign * counters[index];
+                }
+                std::nth_element(values.begin(), values.begin() + depth / 2, values.end());
+                int64_t upper = values[depth / 2];
+                if (depth % 2) return upper;
+                return (*std::max_element(values.begin(), values.begin() + depth / 2) + upper) / 2;
+            }
+
+            template<typename Key>
+            void add(const Key& key, int64_t count = 1) { add_hash(key_hash(key), count); }
+
+            template<typename Key>
+            int64_t estimate(const Key& key) const { return estimate_hash(key_hash(key)); }
+
+            void merge(const CountSketch& other) {
+                if (other.width != width || other.depth != depth) throw std::invalid_argument("CountSketch: cannot merge sketches of different dimensions");
+                for (size_t i = 0; i < counters.size(); ++i) counters[i] += other.counters[i];
+            }
+
+            std::string dumps() const {
+                ByteWriter writer;
+                writer.put<uint32_t>(0x53434345);  // "ECCS"
+                writer.put<uint64_t>(width);
+                writer.put<uint64_t>(depth);
+                for (int64_t counter : counters) writer.put_zigzag(counter);
+                return writer.str();
+            }
+
+            static CountSketch loads(std::string_view bytes) {
+                ByteReader reader(bytes);
+                check_magic(reader, 0x53434345, "CountSketch");
+                uint64_t width = reader.get<uint64_t>();
+                uint64_t depth = reader.get<uint64_t>();
+                check_dimensions(reader, width, depth, "CountSketch");
+                CountSketch sketch((size_t) width, (size_t) depth);
+                for (int64_t& counter : sketch.counters) counter = reader.get_zigzag();
+                return sketch;
+            }
+
+            void dump(File* file) const { write_record(file, dumps()); }
+            static CountSketch load(File* file) { return loads(read_record(file)); }
+        };
+    }
+}
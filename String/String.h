@@ -28,12 +28,55 @@
 #define str easycpp::String
 #endif
 
+#if !defined(FMT_HEADER_ONLY) && !defined(EASYCPP_LIBRARY)
+#define FMT_HEADER_ONLY
+#endif //FMT_HEADER_ONLY
+
 #include <iostream>
 #include <cstring>
 #include <algorithm>
+#include <string>
+#include <string_view>
+#include <String/Hash.h>
+#include <Tracemalloc/Tracemalloc.h>
 #include <Packages/fmt/format.h>
 
 namespace easycpp{
+    /**
+     * @struct fixed_string
+     * @brief A string literal held by value, usable in constant expressions and as a template
+     * argument. Its length and hash are known at compile time.
+     * @tparam N The size of the literal, including the terminating null character.
+     */
+    template<size_t N>
+    struct fixed_string {
+        char chars[N] {};
+
+        constexpr fixed_string(const char (&str)[N]) {
+            for (size_t i = 0; i < N; ++i) chars[i] = str[i];
+        }
+
+        constexpr size_t len() const { return N - 1; }
+        constexpr const char* c_str() const { return chars; }
+        constexpr std::string_view view() const { return std::string_view(chars, N - 1); }
+        constexpr operator std::string_view() const { return view(); }
+
+        /**
+         * @brief The EasyCpp hash of the characters; equal to String::hash() of the same text.
+         */
+        constexpr uint64_t hash(uint64_t seed = 0) const { return hash_bytes(chars, N - 1, seed); }
+
+        template<size_t M>
+        constexpr bool operator==(const fixed_string<M>& other) const { return view() == other.view(); }
+    };
+
+    class String;
+
+    inline namespace literals {
+        template<fixed_string S>
+        String operator""_s();
+    }
+
     /**
      * @class String
      * @brief A custom string class that provides similar functionality to Python's str type.
@@ -42,6 +85,33 @@ namespace easycpp{
     private:
         char* data;
         size_t length;
+        // Non-null for a borrowed literal (see operator""_s): data then points at static storage
+        // that is never written or freed, and this points at its compile-time hash.
+        const uint64_t* literal_hash = nullptr;
+
+        String(const char* literal, size_t size, const uint64_t* hash)
+            : data(const_cast<char*>(literal)), length(size), literal_hash(hash) {}
+
+        template<fixed_string S>
+        friend String literals::operator""_s();
+
+        /**
+         * @brief Copy a borrowed literal into owned memory before it is modified.
+         */
+        void own() {
+            if (literal_hash == nullptr) return;
+            char* copy = new char[length + 1];
+            std::memcpy(copy, data, length + 1);
+            tracemalloc::detail::allocated(copy, length + 1, "String");
+            data = copy;
+            literal_hash = nullptr;
+        }
+
+        void release() {
+            if (literal_hash != nullptr) return;
+            tracemalloc::detail::freed(data);
+            delete[] data;
+        }
 
     public:
         /**
@@ -58,28 +128,44 @@ namespace easycpp{
                 length = 0;
                 data = new char[1];
                 data[0] = '\0';
+                tracemalloc::detail::allocated(data, 1, "String");
             } else {
                 length = std::strlen(str);
                 data = new char[length + 1];
                 std::strcpy(data, str);
+                tracemalloc::detail::allocated(data, length + 1, "String");
             }
         }
 
+        /**
+         * @brief Initialize the string with size bytes of str, which may include NUL characters.
+         * @param str The characters.
+         * @param size The number of characters.
+         */
+        String(const char* str, size_t size) : length(size) {
+            data = new char[size + 1];
+            if (size) std::memcpy(data, str, size);
+            data[size] = '\0';
+            tracemalloc::detail::allocated(data, size + 1, "String");
+        }
+
         /**
          * @brief Copy constructor. Creates a new String object as a copy of another.
+         * Copies of a borrowed literal borrow the same static storage and allocate nothing.
          * @param other The String object to copy from.
          */
-        String(const String& other) {
-            length = other.length;
+        String(const String& other) : data(other.data), length(other.length), literal_hash(other.literal_hash) {
+            if (literal_hash != nullptr || other.data == nullptr) return;
             data = new char[length + 1];
-            std::strcpy(data, other.data);
+            std::memcpy(data, other.data, length + 1);
+            tracemalloc::detail::allocated(data, length + 1, "String");
         }
 
         /**
          * @brief Destructor. Frees the memory allocated for the string.
          */
         ~String() {
-            delete[] data;
+            release();
         }
 
         /**
@@ -89,14 +175,25 @@ namespace easycpp{
          */
         String& operator=(const String& other) {
             if (this != &other) {
-                delete[] data;
-                length = other.length;
-                data = new char[length + 1];
-                std::strcpy(data, other.data);
+                String copy(other);
+                release();
+                data = copy.data;
+                length = copy.length;
+                literal_hash = copy.literal_hash;
+                copy.data = nullptr;
+                copy.literal_hash = nullptr;
             }
             return *this;
         }
 
+        /**
+         * @brief Check whether the string borrows static literal storage instead of owning a copy.
+         * @return true for Strings made by operator""_s (and their unmodified copies).
+         */
+        bool is_literal() const {
+            return literal_hash != nullptr;
+        }
+
         /**
          * @brief Overloaded assignment operator. Assigns the value of a C-style string.
          * @param str The C-style string to assign from.
@@ -122,12 +219,23 @@ namespace easycpp{
             return length;
         }
 
+        /**
+         * @brief Computes the EasyCpp hash of the string, see String/Hash.h.
+         * @param seed The seed. Defaults to 0.
+         * @return The 64-bit hash of the characters.
+         */
+        uint64_t hash(uint64_t seed = 0) const {
+            if (literal_hash != nullptr && seed == 0) return *literal_hash;
+            return hash_bytes(data, length, seed);
+        }
+
         /**
          * @brief Converts the string to uppercase.
          * @return A new String object with all characters in uppercase.
          */
         String upper() const {
             String result(*this);
+            result.own();
             for (size_t i = 0; i < length; ++i) {
                 result.data[i] = std::toupper(result.data[i]);
             }
@@ -140,6 +248,7 @@ namespace easycpp{
          */
         String lower() const {
             String result(*this);
+            result.own();
             for (size_t i = 0; i < length; ++i) {
                 result.data[i] = std::tolower(result.data[i]);
             }
@@ -212,16 +321,24 @@ namespace easycpp{
         
         /**
          * @brief Formats the string using the fmt library.
+         * The arguments are only packed here; the formatting itself happens in the
+         * non-template vformat(), so each call site instantiates very little code.
          * @tparam Args The types of the arguments to be used for formatting.
          * @param args The arguments to be used for formatting.
          * @return A new String object with the formatted string.
          */
         template<typename... Args>
-        String format(Args&&... args) const {
-			if(typeid(Args) == easycpp::String){
-				args... = (STRING_FOMATER)args...;
-			}
-            std::string formatted = fmt::format(std::string(data), std::forward<Args>(args)...);
+        String format(const Args&... args) const {
+            return vformat(fmt::make_format_args(args...));
+        }
+
+        /**
+         * @brief Formats the string with an already packed argument list.
+         * @param args The packed arguments, see fmt::make_format_args.
+         * @return A new String object with the formatted string.
+         */
+        String vformat(fmt::format_args args) const {
+            std::string formatted = fmt::vformat(fmt::string_view(data, length), args);
             return String(formatted.c_str());
         }
 
@@ -267,4 +384,42 @@ namespace easycpp{
             return result;
         }
     };
-}    
+
+#ifdef EASYCPP_LIBRARY
+    // Common instantiations are compiled once into libeasycpp (see EasyCpp.cpp).
+    extern template String String::format<int>(const int&) const;
+    extern template String String::format<long long>(const long long&) const;
+    extern template String String::format<size_t>(const size_t&) const;
+    extern template String String::format<double>(const double&) const;
+    extern template String String::format<const char*>(const char* const&) const;
+    extern template String String::format<String>(const String&) const;
+    extern template String String::format<std::string>(const std::string&) const;
+    extern template String String::format<const char*, const char*>(const char* const&, const char* const&) const;
+#endif //EASYCPP_LIBRARY
+
+    inline namespace literals {
+        /**
+         * @brief A String literal that borrows its static storage: "EasyCpp"_s allocates and copies
+         * nothing, and its length and hash are computed at compile time. The String makes its own
+         * copy only when it is modified.
+         * @tparam S The literal.
+         * @return A String borrowing the literal.
+         */
+        template<fixed_string S>
+        String operator""_s() {
+            static constexpr uint64_t literal_hash = S.hash();
+            return String(S.chars, S.len(), &literal_hash);
+        }
+    }
+}
+
+/**
+ * @brief fmt formatter for easycpp::String, so Strings can be passed to format() directly.
+ */
+template<>
+struct fmt::formatter<easycpp::String> : fmt::formatter<fmt::string_view> {
+    auto format(const easycpp::String& str, fmt::format_context& ctx) const {
+        const char* data = str;
+        return fmt::formatter<fmt::string_view>::format(fmt::string_view(data, str.len()), ctx);
+    }
+};
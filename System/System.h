@@ -0,0 +1,356 @@
+// EasyCpp - System : Operating System Queries
+// Copyright (C) 2025  C14147
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+/**
+ * @file EasyCpp/System/System.h
+ * @brief This file holds a small part of Python's os module: cpu_count() and the
+ *        sched_getaffinity()/sched_setaffinity() pair, plus cpu_topology(), which reads
+ *        sockets, cores, SMT siblings, NUMA nodes and caches from sysfs. ThreadPool uses the
+ *        topology to place its workers.
+ */
+#pragma once
+#define _EASYCPP_SYSTEM_VERSION "1.0.0"
+
+#include <algorithm>
+#include <cstddef>
+#include <fstream>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+namespace easycpp {
+    namespace os {
+        /**
+         * @struct CpuInfo
+         * @brief One logical CPU.
+         */
+        struct CpuInfo {
+            int cpu = 0;                ///< The logical CPU number.
+            int core = 0;               ///< The core id, unique within a socket.
+            int socket = 0;             ///< The physical package id.
+            int node = 0;               ///< The NUMA node.
+            std::vector<int> siblings;  ///< The logical CPUs sharing the core, this one included.
+        };
+
+        /**
+         * @struct CacheInfo
+         * @brief One cache and the CPUs that share it.
+         */
+        struct CacheInfo {
+            int level = 0;                      ///< 1 for L1, 2 for L2, ...
+            std::string type;                   ///< "Data", "Instruction" or "Unified".
+            size_t size = 0;                    ///< The size in bytes.
+            size_t line_size = 0;               ///< The coherency line size in bytes.
+            std::vector<int> shared_cpu_list;   ///< The logical CPUs sharing this cache.
+        };
+
+        /**
+         * @struct CpuTopology
+         * @brief The online CPUs of the machine, grouped the way the hardware groups them.
+         */
+        struct CpuTopology {
+            std::vector<CpuInfo> cpus;              ///< The online CPUs, by number.
+            std::vector<CacheInfo> caches;          ///< Every distinct cache, by level.
+            std::vector<std::vector<int>> nodes;    ///< The online CPUs of each NUMA node.
+
+            /**
+             * @brief Get the number of physical packages.
+             */
+            size_t sockets() const {
+                std::vector<int> ids;
+                for (const CpuInfo& info : cpus) ids.push_back(info.socket);
+                std::sort(ids.begin(), ids.end());
+                return (size_t) (std::unique(ids.begin(), ids.end()) - ids.begin());
+            }
+
+            /**
+             * @brief Get the number of physical cores.
+             */
+            size_t cores() const {
+                std::vector<std::pair<int, int>> ids;
+                for (const CpuInfo& info : cpus) ids.emplace_back(info.socket, info.core);
+                std::sort(ids.begin(), ids.end());
+                return (size_t) (std::unique(ids.begin(), ids.end()) - ids.begin());
+            }
+
+            /**
+             * @brief Get the number of logical CPUs.
+             */
+            size_t threads() const {
+                return cpus.size();
+            }
+
+            /**
+             * @brief Look up a logical CPU.
+             * @param id The CPU number.
+             * @return Its description.
+             * @throws std::out_of_range if the CPU is not online.
+             */
+            const CpuInfo& cpu(int id) const {
+                auto it = std::lower_bound(cpus.begin(), cpus.end(), id, [](const CpuInfo& info, int value) { return info.cpu < value; });
+                if (it == cpus.end() || it->cpu != id) throw std::out_of_range("os: cpu " + std::to_string(id) + " is not online");
+                return *it;
+            }
+
+            /**
+             * @brief Order the CPUs for compact placement: the SMT siblings of a core first,
+             * then the other cores of the same node, then the next node. Threads placed in
+             * this order share caches and memory as much as possible.
+             * @return The CPU numbers.
+             */
+            std::vector<int> compact() const {
+                std::vector<const CpuInfo*> order;
+                for (const CpuInfo& info : cpus) order.push_back(&info);
+                std::sort(order.begin(), order.end(), [](const CpuInfo* a, const CpuInfo* b) {
+                    return std::tie(a->socket, a->node, a->core, a->cpu) < std::tie(b->socket, b->node, b->core, b->cpu);
+                });
+                std::vector<int> result;
+                for (const CpuInfo* info : order) result.push_back(info->cpu);
+                return result;
+            }
+
+            /**
+             * @brief Order the CPUs for scatter placement: one CPU of each core, alternating
+             * between nodes, before any second SMT sibling. Threads placed in this order get
+             * the most cores and memory bandwidth.
+             * @return The CPU numbers.
+             */
+            std::vector<int> scatter() const {
+                // Rank every CPU by (sibling index, core index within its node, node).
+                std::map<int, std::map<std::pair<int, int>, int>> core_index;
+                for (int cpu : compact()) {
+                    const CpuInfo& info = this->cpu(cpu);
+                    auto& cores = core_index[info.node];
+                    cores.emplace(std::make_pair(info.socket, info.core), (int) cores.size());
+                }
+                std::vector<std::tuple<int, int, int, int>> keys;
+                for (const CpuInfo& info : cpus) {
+                    int sibling = (int) (std::find(info.siblings.begin(), info.siblings.end(), info.cpu) - info.siblings.begin());
+                    keys.emplace_back(sibling, core_index[info.node][{info.socket, info.core}], info.node, info.cpu);
+                }
+                std::sort(keys.begin(), keys.end());
+                std::vector<int> result;
+                for (const auto& key : keys) result.push_back(std::get<3>(key));
+                return result;
+            }
+        };
+
+        namespace detail {
+            inline bool read_line(const std::string& path, std::string& line) {
+                std::ifstream file(path);
+                if (!file || !std::getline(file, line)) return false;
+                while (!line.empty() && (line.back() == '\n' || line.back() == ' ')) line.pop_back();
+                return true;
+            }
+
+            inline int read_int(const std::string& path, int fallback) {
+                std::string line;
+                if (!read_line(path, line)) return fallback;
+                try {
+                    return std::stoi(line);
+                } catch (const std::exception&) {
+                    return fallback;
+                }
+            }
+
+            /**
+             * @brief Parse a sysfs CPU list such as "0-3,8-11".
+             */
+            inline std::vector<int> parse_cpu_list(const std::string& text) {
+                std::vector<int> cpus;
+                size_t start = 0;
+                while (start < text.size()) {
+                    size_t end = text.find(',', start);
+                    if (end == std::string::npos) end = text.size();
+                    std::string part = text.substr(start, end - start);
+                    size_t dash = part.find('-');
+                    try {
+                        if (dash == std::string::npos) {
+                            if (!part.empty()) cpus.push_back(std::stoi(part));
+                        } else {
+                            int first = std::stoi(part.substr(0, dash)), last = std::stoi(part.substr(dash + 1));
+                            for (int cpu = first; cpu <= last; ++cpu) cpus.push_back(cpu);
+                        }
+                    } catch (const std::exception&) {
+                        return {};
+                    }
+                    start = end + 1;
+                }
+                std::sort(cpus.begin(), cpus.end());
+                cpus.erase(std::unique(cpus.begin(), cpus.end()), cpus.end());
+                return cpus;
+            }
+
+            /**
+             * @brief Parse a sysfs size such as "48K" or "2M".
+             */
+            inline size_t parse_size(const std::string& text) {
+                size_t value = 0, i = 0;
+                for (; i < text.size() && text[i] >= '0' && text[i] <= '9'; ++i) value = value * 10 + (size_t) (text[i] - '0');
+                if (i < text.size()) {
+                    switch (text[i]) {
+                        case 'K': return value << 10;
+                        case 'M': return value << 20;
+                        case 'G': return value << 30;
+                    }
+                }
+                return value;
+            }
+
+            inline CpuTopology read_topology() {
+                CpuTopology topology;
+                const std::string root = "/sys/devices/system/cpu/";
+                std::string line;
+                std::vector<int> online;
+                if (read_line(root + "online", line)) online = parse_cpu_list(line);
+                if (online.empty()) {
+                    // No sysfs: every CPU is its own core on one socket and one node.
+                    int count = (int) std::max(1u, std::thread::hardware_concurrency());
+                    for (int cpu = 0; cpu < count; ++cpu) online.push_back(cpu);
+                }
+                for (int cpu : online) {
+                    std::string base = root + "cpu" + std::to_string(cpu) + "/";
+                    CpuInfo info;
+                    info.cpu = cpu;
+                    info.core = read_int(base + "topology/core_id", cpu);
+                    info.socket = std::max(0, read_int(base + "topology/physical_package_id", 0));
+                    if (read_line(base + "topology/thread_siblings_list", line)) info.siblings = parse_cpu_list(line);
+                    if (std::find(info.siblings.begin(), info.siblings.end(), cpu) == info.siblings.end()) info.siblings = {cpu};
+                    topology.cpus.push_back(std::move(info));
+
+                    for (int index = 0;; ++index) {
+                        std::string cache = base + "cache/index" + std::to_string(index) + "/";
+                        CacheInfo entry;
+                        entry.level = read_int(cache + "level", 0);
+                        if (entry.level == 0) break;
+                        read_line(cache + "type", entry.type);
+                        if (read_line(cache + "size", line)) entry.size = parse_size(line);
+                        entry.line_size = (size_t) std::max(0, read_int(cache + "coherency_line_size", 0));
+                        if (read_line(cache + "shared_cpu_list", line)) entry.shared_cpu_list = parse_cpu_list(line);
+                        if (entry.shared_cpu_list.empty()) entry.shared_cpu_list = {cpu};
+                        // A shared cache is listed under every CPU sharing it; keep it once.
+                        auto owner = std::find_if(entry.shared_cpu_list.begin(), entry.shared_cpu_list.end(),
+                                                  [&](int other) { return std::binary_search(online.begin(), online.end(), other); });
+                        if (owner != entry.shared_cpu_list.end() && *owner != cpu) continue;
+                        topology.caches.push_back(std::move(entry));
+                    }
+                }
+                std::stable_sort(topology.caches.begin(), topology.caches.end(),
+                                 [](const CacheInfo& a, const CacheInfo& b) { return a.level < b.level; });
+
+                std::vector<int> nodes;
+                if (read_line("/sys/devices/system/node/online", line)) nodes = parse_cpu_list(line);
+                for (int node : nodes) {
+                    std::vector<int> cpus;
+                    if (read_line("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist", line)) cpus = parse_cpu_list(line);
+                    std::vector<int> present;
+                    for (int cpu : cpus) {
+                        auto it = std::lower_bound(topology.cpus.begin(), topology.cpus.end(), cpu,
+                                                   [](const CpuInfo& info, int value) { return info.cpu < value; });
+                        if (it == topology.cpus.end() || it->cpu != cpu) continue;
+                        it->node = (int) topology.nodes.size();
+                        present.push_back(cpu);
+                    }
+                    // Memory-only nodes have no CPUs to place work on.
+                    if (!present.empty()) topology.nodes.push_back(std::move(present));
+                }
+                if (topology.nodes.empty()) {
+                    topology.nodes.emplace_back();
+                    for (CpuInfo& info : topology.cpus) {
+                        info.node = 0;
+                        topology.nodes[0].push_back(info.cpu);
+                    }
+                }
+                return topology;
+            }
+        }
+
+        /**
+         * @brief Get the CPU topology of the machine. sysfs is read on the first call only.
+         * Off Linux, or without sysfs, every CPU counts as its own core on a single socket
+         * and NUMA node. Nodes are numbered in order from 0, skipping those without CPUs.
+         * @return The topology.
+         */
+        inline const CpuTopology& cpu_topology() {
+            static const CpuTopology topology = detail::read_topology();
+            return topology;
+        }
+
+        /**
+         * @brief Get the number of logical CPUs in the system, as os.cpu_count() does.
+         * @return The number of online CPUs.
+         */
+        inline size_t cpu_count() {
+            return cpu_topology().threads();
+        }
+
+        /**
+         * @brief Get the CPUs a thread may run on, as os.sched_getaffinity() does.
+         * @param pid The thread id; 0 means the calling thread.
+         * @return The CPU numbers, ascending. Off Linux, every CPU.
+         * @throws std::runtime_error if the mask cannot be read.
+         */
+        inline std::vector<int> sched_getaffinity(int pid = 0) {
+            std::vector<int> cpus;
+#ifdef __linux__
+            cpu_set_t mask;
+            CPU_ZERO(&mask);
+            if (::sched_getaffinity(pid, sizeof(mask), &mask) != 0) throw std::runtime_error("os: sched_getaffinity failed");
+            for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+                if (CPU_ISSET(cpu, &mask)) cpus.push_back(cpu);
+            }
+#else
+            (void) pid;
+            for (const CpuInfo& info : cpu_topology().cpus) cpus.push_back(info.cpu);
+#endif
+            return cpus;
+        }
+
+        /**
+         * @brief Restrict a thread to the given CPUs, as os.sched_setaffinity() does.
+         * Off Linux this does nothing.
+         * @param pid The thread id; 0 means the calling thread.
+         * @param cpus The CPU numbers.
+         * @throws std::invalid_argument if cpus is empty or holds an invalid number.
+         * @throws std::runtime_error if the mask cannot be set.
+         */
+        inline void sched_setaffinity(int pid, const std::vector<int>& cpus) {
+            if (cpus.empty()) throw std::invalid_argument("os: empty cpu set");
+#ifdef __linux__
+            cpu_set_t mask;
+            CPU_ZERO(&mask);
+            for (int cpu : cpus) {
+                if (cpu < 0 || cpu >= CPU_SETSIZE) throw std::invalid_argument("os: invalid cpu " + std::to_string(cpu));
+                CPU_SET(cpu, &mask);
+            }
+            if (::sched_setaffinity(pid, sizeof(mask), &mask) != 0) throw std::runtime_error("os: sched_setaffinity failed");
+#else
+            (void) pid;
+            for (int cpu : cpus) {
+                if (cpu < 0) throw std::invalid_argument("os: invalid cpu " + std::to_string(cpu));
+            }
+#endif
+        }
+    }
+}
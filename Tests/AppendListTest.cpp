@@ -0,0 +1,97 @@
+// Stress: threads append and extend while a reader walks the published prefix. Every element
+// arrives exactly once, references stay put, and a throwing constructor ends the prefix.
+#include <List/AppendList.h>
+
+#include "Check.h"
+
+#include <algorithm>
+#include <atomic>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace easycpp;
+
+namespace {
+    struct Fragile {
+        std::string text;
+
+        explicit Fragile(const std::string& text) : text(text) {
+            if (text == "throw") throw std::runtime_error("Fragile");
+        }
+    };
+}
+
+int main() {
+    const int THREADS = 8;
+    const int PER_THREAD = 20000;
+
+    AppendList<std::string> list;
+    list.append("first");
+    const std::string* first = &list[0];
+    std::atomic<bool> done{false};
+    std::thread reader([&] {
+        size_t last = 0;
+        while (!done.load()) {
+            size_t size = list.size();
+            CHECK(size >= last);
+            last = size;
+            size_t walked = 0;
+            for (const std::string& value : list) {
+                CHECK(!value.empty());
+                ++walked;
+            }
+            CHECK(walked >= size);
+        }
+    });
+    std::vector<std::thread> writers;
+    for (int t = 0; t < THREADS; ++t) {
+        writers.emplace_back([&list, t] {
+            for (int i = 0; i < PER_THREAD; ++i) {
+                if (i % 100 == 0) {
+                    std::vector<std::string> batch;
+                    for (int j = 0; j < 10; ++j) batch.push_back("b" + std::to_string(t) + ":" + std::to_string(i) + ":" + std::to_string(j));
+                    list.extend(batch);
+                } else {
+                    list.emplace("a" + std::to_string(t) + ":" + std::to_string(i));
+                }
+            }
+        });
+    }
+    for (std::thread& writer : writers) writer.join();
+    done = true;
+    reader.join();
+
+    const size_t expected = 1 + (size_t) THREADS * (PER_THREAD - PER_THREAD / 100 + PER_THREAD / 100 * 10);
+    CHECK(list.size() == expected && list.reserved_size() == expected);
+    CHECK(&list[0] == first && *first == "first");
+    std::vector<std::string> values = list.to_vector();
+    std::sort(values.begin(), values.end());
+    CHECK(std::adjacent_find(values.begin(), values.end()) == values.end());
+    CHECK(std::binary_search(values.begin(), values.end(), "a7:19999"));
+    CHECK(std::binary_search(values.begin(), values.end(), "b3:100:9"));
+
+    // Extended ranges are contiguous even when other threads append at the same time.
+    for (size_t i = 0; i < list.size(); ++i) {
+        if (list[i].rfind(":0", list[i].size() - 2) == list[i].size() - 2 && list[i][0] == 'b') {
+            std::string stem = list[i].substr(0, list[i].size() - 1);
+            for (int j = 1; j < 10; ++j) CHECK(list[i + (size_t) j] == stem + std::to_string(j));
+        }
+    }
+
+    list.clear();
+    CHECK(list.empty() && list.begin() == list.end());
+    list.append("again");
+    CHECK(list.size() == 1 && list.at(0) == "again");
+    CHECK_THROWS(list.at(1), std::out_of_range);
+
+    AppendList<Fragile> fragile;
+    fragile.emplace("a");
+    CHECK_THROWS(fragile.emplace("throw"), std::runtime_error);
+    fragile.emplace("c");
+    CHECK(fragile.size() == 1 && fragile.reserved_size() == 3);
+    CHECK(fragile.at(2).text == "c");
+    CHECK_THROWS(fragile.at(1), std::out_of_range);
+    return 0;
+}
@@ -0,0 +1,78 @@
+// EasyCpp - Tests : Check Macros
+// Copyright (C) 2025  C14147
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+/**
+ * @file EasyCpp/Tests/Check.h
+ * @brief This file holds the checks the tests use. Unlike assert() they stay active in
+ *        release builds, and a failure prints its location and exits with status 1.
+ *        TempDir gives a test a scratch directory that is removed when it ends.
+ */
+#pragma once
+
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <random>
+#include <string>
+
+#define CHECK(condition)                                                                     \
+    do {                                                                                     \
+        if (!(condition)) {                                                                  \
+            std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition); \
+            std::exit(1);                                                                    \
+        }                                                                                    \
+    } while (0)
+
+#define CHECK_THROWS(expression, exception)                                                   \
+    do {                                                                                      \
+        bool thrown = false;                                                                  \
+        try {                                                                                 \
+            expression;                                                                       \
+        } catch (const exception&) {                                                          \
+            thrown = true;                                                                    \
+        }                                                                                     \
+        if (!thrown) {                                                                        \
+            std::fprintf(stderr, "%s:%d: %s did not throw %s\n", __FILE__, __LINE__, #expression, #exception); \
+            std::exit(1);                                                                     \
+        }                                                                                     \
+    } while (0)
+
+namespace easycpp {
+    namespace test {
+        /**
+         * @class TempDir
+         * @brief A fresh directory below the system temporary directory.
+         */
+        class TempDir {
+        public:
+            std::filesystem::path path;
+
+            explicit TempDir(const std::string& name) {
+                path = std::filesystem::temp_directory_path() / ("easycpp_" + name + "_" + std::to_string(std::random_device()()));
+                std::filesystem::remove_all(path);
+                std::filesystem::create_directories(path);
+            }
+
+            ~TempDir() {
+                std::error_code error;
+                std::filesystem::remove_all(path, error);
+            }
+
+            std::filesystem::path operator/(const std::string& name) const { return path / name; }
+        };
+    }
+}
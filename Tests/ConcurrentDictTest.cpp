@@ -0,0 +1,143 @@
+// Stress: writers, lock-free readers, incremental resizes, compute() and clear() running at once.
+// Run it under ASan/UBSan and TSAN as well; it checks the final contents itself.
+#include <Dict/ConcurrentDict.h>
+#include <Tracemalloc/Tracemalloc.h>
+
+#include "Check.h"
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace easycpp;
+
+namespace {
+    const int THREADS = 4;
+    const int KEYS = 20000;
+
+    template<typename Body>
+    void run(int count, Body body) {
+        std::vector<std::thread> threads;
+        for (int t = 0; t < count; ++t) threads.emplace_back(body, t);
+        for (std::thread& thread : threads) thread.join();
+    }
+
+    // Disjoint inserts from a tiny table, so every writer helps with many resizes, while readers
+    // check that whatever they see is a complete value.
+    void test_insert_resize() {
+        ConcurrentDict<std::string, int> dict(0, 4);
+        std::atomic<bool> done{false};
+        std::thread reader([&] {
+            while (!done.load()) {
+                for (int k = 0; k < KEYS * THREADS; k += 101) {
+                    std::optional<int> value = dict.get(std::to_string(k));
+                    if (value) CHECK(*value == 2 * k);
+                }
+                for (const auto& [key, value] : dict.items()) CHECK(value == 2 * std::stoi(key));
+            }
+        });
+        run(THREADS, [&](int t) {
+            for (int k = t; k < KEYS * THREADS; k += THREADS) CHECK(dict.insert(std::to_string(k), 2 * k));
+        });
+        done = true;
+        reader.join();
+
+        CHECK(dict.size() == (size_t) KEYS * THREADS);
+        for (int k = 0; k < KEYS * THREADS; ++k) CHECK(dict.get(std::to_string(k), -1) == 2 * k);
+        CHECK(!dict.insert("7", 0) && dict.at("7") == 14);
+        CHECK(dict.keys().size() == (size_t) KEYS * THREADS);
+    }
+
+    // compute() and get_or_insert_with() are atomic per key.
+    void test_counters() {
+        ConcurrentDict<int, long> dict(0, 4);
+        std::atomic<int> made{0};
+        const int ROUNDS = 5000, COUNTERS = 97;
+        run(THREADS, [&](int t) {
+            for (int i = 0; i < ROUNDS; ++i) {
+                int key = (i * 31 + t) % COUNTERS;
+                dict.compute(key, [](const long* value) { return std::optional<long>(value ? *value + 1 : 1); });
+                dict.get_or_insert_with(1000 + key, [&] {
+                    made.fetch_add(1);
+                    return 0L;
+                });
+            }
+        });
+        long total = 0;
+        for (int key = 0; key < COUNTERS; ++key) total += dict.at(key);
+        CHECK(total == (long) ROUNDS * THREADS);
+        CHECK(made.load() == COUNTERS);
+
+        // compute() returning nullopt removes.
+        run(THREADS, [&](int t) {
+            for (int key = t; key < COUNTERS; key += THREADS) CHECK(!dict.compute(key, [](const long*) { return std::optional<long>(); }));
+        });
+        CHECK(dict.size() == (size_t) COUNTERS);
+    }
+
+    // Writers set, overwrite and erase overlapping keys while another thread clears the dict.
+    // Afterwards every key holds a value its owner wrote, or is absent.
+    void test_churn() {
+        ConcurrentDict<int, std::string> dict(0, 4);
+        std::atomic<bool> done{false};
+        std::thread clearer([&] {
+            while (!done.load()) {
+                dict.clear();
+                std::this_thread::yield();
+            }
+        });
+        run(THREADS, [&](int t) {
+            for (int i = 0; i < KEYS; ++i) {
+                int key = i % 512;
+                switch (i % 4) {
+                    case 0: dict.set(key, std::string(64, (char) ('a' + t))); break;
+                    case 1: dict.erase(key); break;
+                    case 2: dict.pop(key + 1); break;
+                    default: {
+                        std::optional<std::string> value = dict.get(key);
+                        if (value) CHECK(value->size() == 64 && (*value)[0] == (*value)[63]);
+                    }
+                }
+            }
+        });
+        done = true;
+        clearer.join();
+        size_t count = 0;
+        for (const auto& [key, value] : dict.items()) {
+            CHECK(key >= 0 && key < 512 && value.size() == 64);
+            ++count;
+        }
+        CHECK(count == dict.size());
+        dict.clear();
+        CHECK(dict.empty() && dict.items().empty());
+    }
+
+    size_t traced_dict_bytes() {
+        size_t size = 0;
+        for (const auto& statistic : tracemalloc::take_snapshot().statistics()) {
+            if (statistic.domain == "Dict") size += statistic.size;
+        }
+        return size;
+    }
+
+    // The table and the nodes are reported to tracemalloc under "Dict" and forgotten on free.
+    void test_tracemalloc() {
+        tracemalloc::start();
+        {
+            ConcurrentDict<int, int> dict(1000);
+            for (int i = 0; i < 1000; ++i) dict.set(i, i);
+            CHECK(traced_dict_bytes() >= 1000 * (sizeof(int) * 2 + sizeof(void*)));
+        }
+        CHECK(traced_dict_bytes() == 0);
+        tracemalloc::stop();
+    }
+}
+
+int main() {
+    test_insert_resize();
+    test_counters();
+    test_churn();
+    test_tracemalloc();
+    return 0;
+}
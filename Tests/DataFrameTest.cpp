@@ -0,0 +1,35 @@
+// CSV type inference must respect quoting and keep empty rows of a single column, and grouping
+// an empty table must not touch its (null) data. In JSON Lines a repeated key keeps its last value.
+#include <DataFrame/DataFrame.h>
+
+#include "Check.h"
+
+#include <cmath>
+
+using namespace easycpp;
+
+int main() {
+    DataFrame codes = DataFrame::from_csv("id,zip\n\"007\",\"01234\"\n\"42\",\"99999\"\n");
+    CHECK(codes["id"].kind() == Column::STRING && codes["id"].string(0) == "007");
+    CHECK(codes["zip"].kind() == Column::STRING && codes["zip"].string(0) == "01234");
+
+    DataFrame mixed = DataFrame::from_csv("a,b\n1,x\n\n2,\"3\"\n");
+    CHECK(mixed.num_rows() == 2);
+    CHECK(mixed["a"].kind() == Column::INT64);
+    CHECK(mixed["b"].kind() == Column::STRING && mixed["b"].string(1) == "3");
+
+    DataFrame single = DataFrame::from_csv("value\n1\n\n3\n");
+    CHECK(single.num_rows() == 3);
+    CHECK(single["value"].kind() == Column::FLOAT64 && single["value"].is_null(1) && single["value"].number(2) == 3);
+
+    DataFrame empty = DataFrame::from_csv("k,v\n");
+    CHECK(empty.num_rows() == 0);
+    DataFrame grouped = empty.groupby({"k"}).agg({{"v", Agg::SUM}});
+    CHECK(grouped.num_rows() == 0);
+
+    DataFrame lines = DataFrame::from_json_lines("{\"a\": \"x\", \"b\": 1, \"a\": 2}\n{\"a\": 3, \"a\": 4}\n");
+    CHECK(lines.columns() == std::vector<std::string>({"a", "b"}));
+    CHECK(lines["a"].kind() == Column::INT64 && lines["a"].int64_data()[0] == 2 && lines["a"].int64_data()[1] == 4);
+    CHECK(lines["b"].is_null(1));
+    return 0;
+}
@@ -0,0 +1,67 @@
+// encode()/decode() round trips, and decode() rejects crafted payloads whose zero runs or counts
+// leave the histogram's range instead of overflowing the bucket index.
+#include <HdrHistogram/HdrHistogram.h>
+
+#include "Check.h"
+
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+using namespace easycpp;
+
+namespace {
+    void put_be(std::string& out, uint64_t value, int bytes) {
+        for (int shift = 8 * (bytes - 1); shift >= 0; shift -= 8) out += (char) (value >> shift);
+    }
+
+    void put_long(std::string& out, int64_t signed_value) {
+        uint64_t value = ((uint64_t) signed_value << 1) ^ (uint64_t) (signed_value >> 63);
+        for (int i = 0; i < 8; ++i) {
+            if (value < 0x80) {
+                out += (char) value;
+                return;
+            }
+            out += (char) ((value & 0x7F) | 0x80);
+            value >>= 7;
+        }
+        out += (char) value;
+    }
+
+    // An uncompressed V2 encoding of a 1..1000000, 3 digit histogram with the given counts.
+    std::string encoding(std::initializer_list<int64_t> counts) {
+        std::string payload;
+        for (int64_t count : counts) put_long(payload, count);
+        std::string out;
+        put_be(out, 0x1c849313, 4);
+        put_be(out, payload.size(), 4);
+        put_be(out, 0, 4);
+        put_be(out, 3, 4);
+        put_be(out, 1, 8);
+        put_be(out, 1000000, 8);
+        put_be(out, 0x3ff0000000000000ULL, 8);  // 1.0
+        return out + payload;
+    }
+}
+
+int main() {
+    HdrHistogram histogram(1, 1000000, 3);
+    for (int64_t value = 1; value <= 1000000; value += 997) histogram.record(value, value % 7 + 1);
+    HdrHistogram decoded = HdrHistogram::decode(histogram.encode());
+    CHECK(decoded.total_count() == histogram.total_count());
+    CHECK(decoded.value_at_percentile(99.0) == histogram.value_at_percentile(99.0));
+
+    HdrHistogram plain = HdrHistogram::decode(encoding({-10, 5, 0, 2}));
+    CHECK(plain.total_count() == 7 && plain.count_at(10) == 5 && plain.count_at(12) == 2);
+
+    const int64_t min = std::numeric_limits<int64_t>::min();
+    const int64_t max = std::numeric_limits<int64_t>::max();
+    CHECK_THROWS(HdrHistogram::decode(encoding({min, 1})), std::invalid_argument);
+    // Two runs whose sum wraps the index back into range.
+    CHECK_THROWS(HdrHistogram::decode(encoding({-max, min + 2, 1})), std::invalid_argument);
+    CHECK_THROWS(HdrHistogram::decode(encoding({-100000000, 1})), std::invalid_argument);
+    CHECK_THROWS(HdrHistogram::decode(encoding({max, max})), std::invalid_argument);
+    CHECK_THROWS(HdrHistogram::decode(encoding({1}).substr(0, 39)), std::invalid_argument);
+    return 0;
+}
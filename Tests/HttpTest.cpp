@@ -0,0 +1,231 @@
+// The request parser on well-formed, partial and malformed input, then a live server:
+// keep-alive (including HTTP/1.0), pipelining across a file response, static files and errors.
+#include <Http/Server.h>
+
+#include "Check.h"
+
+#include <fstream>
+#include <string>
+#include <string_view>
+
+using namespace easycpp;
+
+namespace {
+    http::detail::ParseResult parse(std::string_view text, http::Request& request, size_t& consumed, int& status) {
+        return http::detail::parse_request(text.data(), text.size(), request, consumed, status, 1 << 20);
+    }
+
+    void test_parser() {
+        using http::detail::ParseResult;
+        http::Request request;
+        size_t consumed = 0;
+        int status = 0;
+
+        std::string_view text = "POST /a%20b?x=1&y=two HTTP/1.1\r\nHost: h\r\nContent-Length: 3\r\nX-Key:  v \r\n\r\nabcGET";
+        CHECK(parse(text, request, consumed, status) == ParseResult::COMPLETE);
+        CHECK(consumed == text.size() - 3);
+        CHECK(request.method == "POST" && request.path == "/a%20b" && request.query == "x=1&y=two");
+        CHECK(request.body == "abc" && request.header("x-key") == "v" && request.header("missing").empty());
+        CHECK(request.keep_alive);
+        CHECK(request.query_params()[1].second == "two");
+
+        // Every strict prefix is incomplete, not an error.
+        for (size_t i = 0; i < text.size() - 3; ++i) CHECK(parse(text.substr(0, i), request, consumed, status) == ParseResult::INCOMPLETE);
+
+        CHECK(parse("GET / HTTP/1.0\r\n\r\n", request, consumed, status) == ParseResult::COMPLETE && !request.keep_alive);
+        CHECK(parse("GET / HTTP/1.0\r\nConnection: Keep-Alive\r\n\r\n", request, consumed, status) == ParseResult::COMPLETE && request.keep_alive);
+        CHECK(parse("GET / HTTP/1.1\r\nConnection: close\r\n\r\n", request, consumed, status) == ParseResult::COMPLETE && !request.keep_alive);
+        CHECK(parse("GET http://host:80/p?q HTTP/1.1\n\n", request, consumed, status) == ParseResult::COMPLETE && request.path == "/p");
+
+        auto error = [&](std::string_view input) {
+            status = 0;
+            return parse(input, request, consumed, status) == ParseResult::INVALID ? status : 0;
+        };
+        CHECK(error("garbage\r\n\r\n") == 400);
+        CHECK(error("GET / HTTP/2.0\r\n\r\n") == 505);
+        CHECK(error("GET / HTTP/1.1\r\nBad Header : x\r\n\r\n") == 400);
+        CHECK(error("GET / HTTP/1.1\r\n folded\r\n\r\n") == 400);
+        CHECK(error("GET / HTTP/1.1\r\nContent-Length: 1x\r\n\r\n") == 400);
+        CHECK(error("GET / HTTP/1.1\r\nContent-Length: 1\r\nContent-Length: 2\r\n\r\n") == 400);
+        CHECK(error("POST / HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n") == 501);
+        CHECK(error("POST / HTTP/1.1\r\nContent-Length: 99999999\r\n\r\n") == 413);
+        CHECK(error("GET / HTTP/1.1\r\n" + std::string(70000, 'a')) == 431);
+        CHECK(error("GET / HTTP/1.1\r\nX-Big: " + std::string(70000, 'a') + "\r\n\r\n") == 431);
+    }
+
+#ifdef __linux__
+    class Client {
+    public:
+        int fd;
+
+        explicit Client(int port) {
+            fd = ::socket(AF_INET, SOCK_STREAM, 0);
+            sockaddr_in address{};
+            address.sin_family = AF_INET;
+            address.sin_port = htons((uint16_t) port);
+            inet_pton(AF_INET, "127.0.0.1", &address.sin_addr);
+            CHECK(::connect(fd, (sockaddr*) &address, sizeof(address)) == 0);
+        }
+
+        explicit Client(const std::string& path) {
+            fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+            sockaddr_un address{};
+            address.sun_family = AF_UNIX;
+            std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+            CHECK(::connect(fd, (sockaddr*) &address, sizeof(address)) == 0);
+        }
+
+        ~Client() { ::close(fd); }
+
+        void send(std::string_view data) {
+            CHECK(::send(fd, data.data(), data.size(), MSG_NOSIGNAL) == (ssize_t) data.size());
+        }
+
+        // Read until count complete responses have arrived, or until the server closes. The
+        // last one has no body if it answers a HEAD request.
+        std::string receive(size_t count = 1, bool last_is_head = false) {
+            std::string data;
+            char chunk[65536];
+            while (responses(data, count, last_is_head) < count) {
+                ssize_t n = ::recv(fd, chunk, sizeof(chunk), 0);
+                if (n <= 0) break;
+                data.append(chunk, (size_t) n);
+            }
+            return data;
+        }
+
+        bool closed() {
+            char byte;
+            timeval timeout{5, 0};
+            setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+            return ::recv(fd, &byte, 1, 0) == 0;
+        }
+
+    private:
+        static size_t responses(const std::string& data, size_t expected, bool last_is_head) {
+            size_t count = 0, position = 0;
+            while (true) {
+                size_t head = data.find("\r\n\r\n", position);
+                if (head == std::string::npos) return count;
+                size_t length_at = data.find("Content-Length: ", position);
+                size_t length = last_is_head && count + 1 == expected ? 0 : std::stoul(data.substr(length_at + 16));
+                if (data.size() < head + 4 + length) return count;
+                position = head + 4 + length;
+                ++count;
+            }
+        }
+    };
+
+    size_t occurrences(const std::string& text, std::string_view word) {
+        size_t count = 0;
+        for (size_t at = text.find(word); at != std::string::npos; at = text.find(word, at + 1)) ++count;
+        return count;
+    }
+
+    void test_server() {
+        test::TempDir temp("http");
+        std::ofstream(temp / "a.txt") << "file body";
+        std::ofstream(temp / "index.html") << "<p>index</p>";
+        std::string big(3 << 20, 'x');
+        std::ofstream(temp / "big.bin", std::ios::binary) << big;
+
+        http::Server server("127.0.0.1", 0, 2);
+        server.route("GET", "/hello", [](const http::Request& request, http::Response& response) {
+            response.set_body("hello " + std::string(request.header("X-Name")));
+        });
+        server.route("POST", "/echo", [](const http::Request& request, http::Response& response) {
+            response.set_body(std::string(request.body));
+        });
+        server.route("GET", "/boom", [](const http::Request&, http::Response&) { throw std::runtime_error("boom"); });
+        server.static_files("/static/", temp.path.string());
+        server.start();
+        CHECK_THROWS(server.route("GET", "/late", nullptr), std::runtime_error);
+
+        {
+            Client client(server.port());
+            client.send("GET /hello HTTP/1.1\r\nX-Name: a\r\n\r\n");
+            CHECK(client.receive().find("hello a") != std::string::npos);
+
+            // Pipelined, with a file response in the middle that is sent with sendfile().
+            client.send("GET /hello HTTP/1.1\r\n\r\nGET /static/a.txt HTTP/1.1\r\n\r\n"
+                        "POST /echo HTTP/1.1\r\nContent-Length: 4\r\n\r\nechoHEAD /static/ HTTP/1.1\r\n\r\n");
+            std::string replies = client.receive(4, true);
+            CHECK(occurrences(replies, "HTTP/1.1 200 OK") == 4);
+            CHECK(replies.find("file body") < replies.find("echo"));
+            CHECK(replies.find("Content-Length: 12") != std::string::npos && replies.find("index") == std::string::npos);
+
+            client.send("DELETE /hello HTTP/1.1\r\n\r\n");
+            std::string reply = client.receive();
+            CHECK(reply.find("405") != std::string::npos && reply.find("Allow: GET") != std::string::npos);
+            client.send("GET /boom HTTP/1.1\r\n\r\n");
+            CHECK(client.receive().find("500 Internal Server Error") != std::string::npos);
+            client.send("GET /static/../Http/Server.h HTTP/1.1\r\n\r\n");
+            CHECK(client.receive().find("404") != std::string::npos);
+            client.send("GET /static/%2e%2e/a.txt HTTP/1.1\r\nConnection: close\r\n\r\n");
+            reply = client.receive();
+            CHECK(reply.find("404") != std::string::npos && reply.find("Connection: close") != std::string::npos);
+            CHECK(client.closed());
+        }
+        {
+            // HTTP/1.0 keeps the connection only when asked, and says so.
+            Client client(server.port());
+            client.send("GET /hello HTTP/1.0\r\nConnection: keep-alive\r\n\r\n");
+            CHECK(client.receive().find("Connection: keep-alive") != std::string::npos);
+            client.send("GET /hello HTTP/1.0\r\n\r\n");
+            CHECK(client.receive().find("Connection: close") != std::string::npos);
+            CHECK(client.closed());
+        }
+        {
+            // A header block over the limit is refused even when it arrives complete.
+            Client client(server.port());
+            std::string request = "GET /hello HTTP/1.1\r\n";
+            for (int i = 0; i < 100; ++i) request += "X-Pad-" + std::to_string(i) + ": " + std::string(700, 'p') + "\r\n";
+            client.send(request + "\r\n");
+            CHECK(client.receive().find("431") != std::string::npos);
+            CHECK(client.closed());
+        }
+        {
+            // A request that arrives a byte at a time.
+            Client client(server.port());
+            for (char c : std::string_view("POST /echo HTTP/1.1\r\nContent-Length: 3\r\n\r\nxyz")) client.send(std::string_view(&c, 1));
+            CHECK(client.receive().find("\r\n\r\nxyz") != std::string::npos);
+        }
+        {
+            Client client(server.port());
+            client.send("GET /static/big.bin HTTP/1.1\r\n\r\n");
+            std::string reply = client.receive();
+            CHECK(reply.size() > big.size() && reply.compare(reply.size() - big.size(), big.size(), big) == 0);
+            client.send("GET /hello HTTP/2.0\r\n\r\n");
+            CHECK(client.receive().find("505") != std::string::npos);
+            CHECK(client.closed());
+        }
+        server.shutdown();
+        server.serve_forever();
+
+        // A Unix socket, shut down from a handler.
+        std::string path = (temp / "server.sock").string();
+        {
+            http::Server local("unix:" + path, 0, 2);
+            local.route("GET", "/stop", [&](const http::Request&, http::Response& response) {
+                response.set_body("stopping");
+                local.shutdown();
+            });
+            local.start();
+            Client client(path);
+            client.send("GET /stop HTTP/1.1\r\n\r\n");
+            CHECK(client.receive().find("stopping") != std::string::npos);
+            local.serve_forever();
+        }
+        CHECK(!std::filesystem::exists(path));
+        CHECK_THROWS(http::Server("not an address", 0), std::invalid_argument);
+    }
+#endif
+}
+
+int main() {
+    test_parser();
+#ifdef __linux__
+    test_server();
+#endif
+    return 0;
+}
@@ -0,0 +1,35 @@
+// Const queries on a shared TDigest merge its buffer lazily; concurrent readers must agree.
+#include <Quantile/Quantile.h>
+
+#include "Check.h"
+
+#include <cmath>
+#include <thread>
+#include <vector>
+
+using namespace easycpp;
+
+int main() {
+    for (int round = 0; round < 20; ++round) {
+        TDigest digest;
+        for (int i = 0; i < 100000 + round * 37; ++i) digest.add(i % 1000);
+        const TDigest& shared = digest;
+        std::vector<double> medians(4);
+        std::vector<std::thread> readers;
+        for (size_t t = 0; t < medians.size(); ++t) {
+            readers.emplace_back([&, t] {
+                medians[t] = shared.quantile(0.5);
+                CHECK(shared.count() == 100000 + round * 37);
+                CHECK(std::abs(shared.cdf(500) - 0.5) < 0.01);
+            });
+        }
+        for (std::thread& reader : readers) reader.join();
+        for (double median : medians) CHECK(median == medians[0] && std::abs(median - 500) < 10);
+
+        TDigest copy = shared;
+        copy.merge(shared);
+        CHECK(copy.count() == 2 * shared.count());
+        CHECK(TDigest::loads(shared.dumps()).centroid_count() == shared.centroid_count());
+    }
+    return 0;
+}
@@ -0,0 +1,90 @@
+// BloomFilter sizing: the measured false positive rate stays below the requested one, down to
+// rates that need more than eight probes per key. Sketches survive a dumps()/loads() round trip,
+// and loads() rejects malformed input instead of trusting it.
+#include <Sketch/Sketch.h>
+
+#include "Check.h"
+
+#include <cstdint>
+#include <stdexcept>
+
+using namespace easycpp;
+
+int main() {
+    const uint64_t items = 50000;
+    const uint64_t queries = 4000000;
+    for (double fpp : {0.05, 1e-3, 1e-5}) {
+        sketch::BloomFilter filter(items, fpp);
+        for (uint64_t i = 0; i < items; ++i) filter.add(i);
+        for (uint64_t i = 0; i < items; ++i) CHECK(filter.contains(i));
+        uint64_t hits = 0;
+        for (uint64_t i = items; i < items + queries; ++i) hits += filter.contains(i);
+        // Allow for sampling noise at the smallest rate (about 40 expected hits).
+        CHECK((double) hits / (double) queries <= fpp * 1.3);
+        if (fpp == 1e-5) CHECK(filter.hash_count() > 8);
+
+        sketch::BloomFilter copy = sketch::BloomFilter::loads(filter.dumps());
+        CHECK(copy.bit_count() == filter.bit_count() && copy.hash_count() == filter.hash_count());
+        for (uint64_t i = 0; i < items; i += 97) CHECK(copy.contains(i));
+        copy.merge(filter);
+    }
+
+    sketch::BloomFilter small(1000, 0.1), strict(1000, 1e-6);
+    CHECK_THROWS(small.merge(strict), std::invalid_argument);
+    CHECK_THROWS(sketch::BloomFilter(10, 0.0), std::invalid_argument);
+    CHECK_THROWS(sketch::BloomFilter(10, 1.0), std::invalid_argument);
+    CHECK_THROWS(sketch::BloomFilter::loads(small.dumps().substr(0, 100)), std::invalid_argument);
+
+    sketch::HyperLogLog sparse(12), dense(4);
+    sketch::CountMinSketch cms(64, 3);
+    sketch::CountSketch cs(64, 3);
+    for (uint64_t i = 0; i < 1000; ++i) {
+        sparse.add(i);
+        dense.add(i);
+        cms.add(i % 10);
+        cs.add(i % 10);
+    }
+    CHECK(sketch::HyperLogLog::loads(sparse.dumps()).count() == sparse.count());
+    CHECK(sketch::HyperLogLog::loads(dense.dumps()).count() == dense.count());
+    CHECK(sketch::CountMinSketch::loads(cms.dumps()).estimate(3) == cms.estimate(3));
+    CHECK(sketch::CountSketch::loads(cs.dumps()).estimate(3) == cs.estimate(3));
+
+    auto hll = [](uint8_t precision, bool is_sparse) {
+        ByteWriter writer;
+        writer.put<uint32_t>(0x4c484345);
+        writer.put<uint8_t>(precision);
+        writer.put<uint8_t>(is_sparse ? 1 : 0);
+        return writer;
+    };
+    ByteWriter rank = hll(4, false);
+    for (int i = 0; i < 16; ++i) rank.put<uint8_t>(i == 5 ? 200 : 1);
+    CHECK_THROWS(sketch::HyperLogLog::loads(rank.str()), std::invalid_argument);
+    ByteWriter index = hll(12, true);
+    index.put_varint(1);
+    index.put_varint(0xffffffff);
+    CHECK_THROWS(sketch::HyperLogLog::loads(index.str()), std::invalid_argument);
+    ByteWriter unsorted = hll(12, true);
+    unsorted.put_varint(2);
+    unsorted.put_varint(5 << 6 | 1);
+    unsorted.put_varint(0);
+    CHECK_THROWS(sketch::HyperLogLog::loads(unsorted.str()), std::invalid_argument);
+    ByteWriter count = hll(12, true);
+    count.put_varint(1ULL << 60);
+    CHECK_THROWS(sketch::HyperLogLog::loads(count.str()), std::invalid_argument);
+
+    auto matrix = [](uint32_t magic, uint64_t width, uint64_t depth) {
+        ByteWriter writer;
+        writer.put<uint32_t>(magic);
+        writer.put<uint64_t>(width);
+        writer.put<uint64_t>(depth);
+        if (magic == 0x4d434345) writer.put<uint8_t>(1);
+        for (int i = 0; i < 8; ++i) writer.put<uint8_t>(0);
+        return writer.str();
+    };
+    CHECK_THROWS(sketch::CountMinSketch::loads(matrix(0x4d434345, 1ULL << 63, 2)), std::invalid_argument);
+    CHECK_THROWS(sketch::CountMinSketch::loads(matrix(0x4d434345, 1000, 1000)), std::invalid_argument);
+    CHECK_THROWS(sketch::CountMinSketch::loads(matrix(0x4d434345, 0, 5)), std::invalid_argument);
+    CHECK_THROWS(sketch::CountSketch::loads(matrix(0x53434345, 1ULL << 63, 2)), std::invalid_argument);
+    CHECK(sketch::CountSketch::loads(matrix(0x53434345, 4, 2)).estimate(1) == 0);
+    return 0;
+}
@@ -0,0 +1,71 @@
+// Rewriting spilled segments must reuse the spill file instead of growing it without bound,
+// and the list must keep returning what was stored, byte for byte.
+#include <List/SpillList.h>
+
+#include "Check.h"
+
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace easycpp;
+
+int main() {
+    test::TempDir temp("spilllist");
+    std::mt19937 random(42);
+
+    // Fixed-size elements: every rewrite fits the segment's old range.
+    {
+        SpillList<int> list(4096, temp.path.string().c_str());
+        std::vector<int> mirror;
+        for (int i = 0; i < 10000; ++i) list.append(i), mirror.push_back(i);
+        for (int round = 0; round < 50000; ++round) {
+            size_t index = random() % mirror.size();
+            list.set(index, (int) random());
+            mirror[index] = list.get(index);
+        }
+        CHECK(list.spilled_bytes() <= 2 * mirror.size() * sizeof(int));
+        size_t i = 0;
+        for (int value : list) CHECK(value == mirror[i++]);
+        CHECK(i == mirror.size());
+    }
+
+    // Strings whose length changes: segments move, and released ranges are reused.
+    {
+        SpillList<std::string> list(20 << 10, temp.path.string().c_str());
+        std::vector<std::string> mirror;
+        auto make = [&] { return std::string(random() % 200, (char) ('a' + random() % 26)); };
+        for (int i = 0; i < 5000; ++i) {
+            mirror.push_back(make());
+            list.append(mirror.back());
+        }
+        for (int round = 0; round < 20000; ++round) {
+            size_t index = random() % mirror.size();
+            mirror[index] = make();
+            list.set(index, mirror[index]);
+        }
+        size_t live = 0;
+        for (const std::string& value : mirror) live += value.size() + 2;
+        CHECK(list.spilled_bytes() <= 3 * live);
+        for (size_t i = 0; i < mirror.size(); i += 7) CHECK(list.get(i) == mirror[i]);
+        while (list.size() > 100) {
+            CHECK(list.pop() == mirror.back());
+            mirror.pop_back();
+        }
+        size_t i = 0;
+        for (const std::string& value : list) CHECK(value == mirror[i++]);
+    }
+
+    // Strings with embedded NUL bytes come back whole after a spill.
+    {
+        SpillList<String> list(1024, temp.path.string().c_str());
+        const std::string text("a\0b\0\0c", 6);
+        for (int i = 0; i < 2000; ++i) list.append(String(text.data(), text.size()));
+        CHECK(list.spilled_bytes() > 0);
+        for (size_t i = 0; i < list.size(); i += 13) {
+            String value = list.get(i);
+            CHECK(value.len() == text.size() && std::string((const char*) value, value.len()) == text);
+        }
+    }
+    return 0;
+}
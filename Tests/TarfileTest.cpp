@@ -0,0 +1,135 @@
+// Extraction must stay inside the destination directory: symbolic links planted by the archive
+// (or already present) cannot be used to write or hard-link outside it, and special members
+// never replace existing files.
+#include <Compress/Tarfile.h>
+
+#include "Check.h"
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <sys/stat.h>
+
+using namespace easycpp;
+
+namespace {
+    std::string header(const std::string& name, char type, const std::string& data = "", const std::string& linkname = "",
+                       unsigned mode = 0644) {
+        std::string block(512, '\0');
+        auto put = [&](size_t offset, const std::string& text) { block.replace(offset, text.size(), text); };
+        char number[16];
+        put(0, name);
+        std::snprintf(number, sizeof(number), "%07o", mode);
+        put(100, number);
+        put(108, "0000000");
+        put(116, "0000000");
+        std::snprintf(number, sizeof(number), "%011o", (unsigned) data.size());
+        put(124, number);
+        put(136, "00000000000");
+        block[156] = type;
+        put(157, linkname);
+        put(257, std::string("ustar\0" "00", 8));
+        put(148, "        ");
+        unsigned sum = 0;
+        for (unsigned char c : block) sum += c;
+        std::snprintf(number, sizeof(number), "%06o", sum);
+        put(148, std::string(number, 7));
+        std::string padded = data;
+        padded.resize((data.size() + 511) / 512 * 512, '\0');
+        return block + padded;
+    }
+
+    std::string write_archive(const std::filesystem::path& path, const std::string& members) {
+        std::ofstream(path, std::ios::binary) << members << std::string(1024, '\0');
+        return path.string();
+    }
+
+    std::string read(const std::filesystem::path& path) {
+        std::ifstream file(path, std::ios::binary);
+        std::stringstream buffer;
+        buffer << file.rdbuf();
+        return buffer.str();
+    }
+}
+
+int main() {
+    test::TempDir temp("tarfile");
+    std::filesystem::path outside = temp / "outside";
+    std::filesystem::path root = temp / "root";
+    std::filesystem::create_directories(outside);
+    std::filesystem::create_directories(root);
+    std::ofstream(outside / "secret.txt") << "secret";
+
+    // An absolute symbolic link followed by a member written through it.
+    std::string escape = write_archive(temp / "escape.tar",
+        header("esc", tarfile::SYMTYPE, "", outside.string()) + header("esc/pwn.txt", tarfile::REGTYPE, "pwned"));
+    {
+        tarfile::TarFile archive(escape.c_str());
+        CHECK_THROWS(archive.extract("esc", root.string().c_str()), std::invalid_argument);
+        CHECK(!std::filesystem::is_symlink(root / "esc"));
+        CHECK_THROWS(archive.extractall(root.string().c_str()), std::invalid_argument);
+        CHECK(!std::filesystem::exists(outside / "pwn.txt"));
+    }
+
+    // The same member below a link that is already in the destination.
+    std::filesystem::remove_all(root);
+    std::filesystem::create_directories(root);
+    std::filesystem::create_directory_symlink(outside, root / "esc");
+    {
+        tarfile::TarFile archive(escape.c_str());
+        CHECK_THROWS(archive.extract("esc/pwn.txt", root.string().c_str()), std::invalid_argument);
+        CHECK_THROWS(archive.extractall(root.string().c_str()), std::invalid_argument);
+        CHECK(!std::filesystem::exists(outside / "pwn.txt"));
+    }
+
+    // Relative links that climb out, and hard links that resolve outside through a link.
+    std::filesystem::remove(root / "esc");
+    std::string climb = write_archive(temp / "climb.tar",
+        header("a/up", tarfile::SYMTYPE, "", "../../outside") + header("hard", tarfile::LNKTYPE, "", "ln/secret.txt"));
+    {
+        tarfile::TarFile archive(climb.c_str());
+        std::filesystem::create_directories(root / "a");
+        CHECK_THROWS(archive.extract("a/up", root.string().c_str()), std::invalid_argument);
+        std::filesystem::create_directory_symlink(outside, root / "ln");
+        CHECK_THROWS(archive.extract("hard", root.string().c_str()), std::invalid_argument);
+        CHECK(!std::filesystem::exists(root / "hard"));
+        CHECK(std::filesystem::hard_link_count(outside / "secret.txt") == 1);
+    }
+
+    // A well-behaved archive still extracts, with links inside the tree and without setuid.
+    std::filesystem::remove_all(root);
+    std::string good = write_archive(temp / "good.tar",
+        header("dir", tarfile::DIRTYPE, "", "", 0755) + header("dir/run.sh", tarfile::REGTYPE, "#!/bin/sh\n", "", 04755) +
+        header("dir/link", tarfile::SYMTYPE, "", "run.sh") + header("top", tarfile::SYMTYPE, "", "dir/../dir/run.sh") +
+        header("hard", tarfile::LNKTYPE, "", "dir/run.sh"));
+    {
+        tarfile::TarFile archive(good.c_str());
+        archive.extractall(root.string().c_str());
+        CHECK(read(root / "dir/run.sh") == "#!/bin/sh\n");
+        CHECK(read(root / "dir/link") == "#!/bin/sh\n");
+        CHECK(read(root / "top") == "#!/bin/sh\n");
+        CHECK(read(root / "hard") == "#!/bin/sh\n");
+        struct stat info;
+        CHECK(::stat((root / "dir/run.sh").c_str(), &info) == 0);
+        CHECK((info.st_mode & 07777) == 0755);
+
+        // Extracting over a previous extraction replaces links instead of writing through them.
+        archive.extract("dir/link", root.string().c_str());
+        CHECK(std::filesystem::is_symlink(root / "dir/link"));
+    }
+
+    // Devices and FIFOs are refused by extract() and skipped by extractall(); neither removes
+    // what is already at their path.
+    std::ofstream(root / "victim") << "keep";
+    std::string special = write_archive(temp / "special.tar",
+        header("victim", tarfile::FIFOTYPE) + header("dir/run.sh", tarfile::CHRTYPE));
+    {
+        tarfile::TarFile archive(special.c_str());
+        CHECK_THROWS(archive.extract("victim", root.string().c_str()), std::invalid_argument);
+        archive.extractall(root.string().c_str());
+        CHECK(read(root / "victim") == "keep");
+        CHECK(read(root / "dir/run.sh") == "#!/bin/sh\n");
+    }
+    return 0;
+}
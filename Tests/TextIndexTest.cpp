@@ -0,0 +1,63 @@
+// Saving an index over the files it was loaded from must not disturb its mapped segments, and
+// documents can be added as string literals, views and Strings. Corrupt segments are rejected.
+#include <TextIndex/TextIndex.h>
+
+#include "Check.h"
+
+#include <string>
+#include <string_view>
+
+using namespace easycpp;
+
+namespace {
+    void put32(std::string& bytes, size_t at, uint32_t value) {
+        for (int i = 0; i < 4; ++i) bytes[at + i] = (char) (value >> (8 * i));
+    }
+
+    // Two documents and the terms "a" and "b": the term offsets start at byte 48, the term
+    // blocks at 64, the block metadata at 80.
+    void test_corrupt_segment() {
+        TextSegment::Postings a{{0, 1}, {1, 2}}, b{{1}, {1}};
+        std::string good = TextSegment::encode(0, {3, 3}, {{"a", &a}, {"b", &b}});
+        CHECK(TextSegment::from_bytes(good)->decode(1).docs == std::vector<uint32_t>({1}));
+
+        std::string bytes = good;
+        put32(bytes, 52, 5);
+        CHECK_THROWS(TextSegment::from_bytes(bytes), std::invalid_argument);
+        bytes = good;
+        put32(bytes, 56, 1000);
+        CHECK_THROWS(TextSegment::from_bytes(bytes), std::invalid_argument);
+        bytes = good;
+        put32(bytes, 76, 7);
+        CHECK_THROWS(TextSegment::from_bytes(bytes), std::invalid_argument);
+        bytes = good;
+        put32(bytes, 84, 1000);
+        CHECK_THROWS(TextSegment::from_bytes(bytes), std::invalid_argument);
+        CHECK_THROWS(TextSegment::from_bytes(good.substr(0, good.size() - 1)), std::invalid_argument);
+    }
+}
+
+int main() {
+    test_corrupt_segment();
+    test::TempDir temp("textindex");
+    std::string prefix = (temp / "index").string();
+    {
+        TextIndex index(2);
+        index.add(std::string_view("the quick brown fox"));
+        index.add(std::string_view("jumps over the lazy dog"));
+        index.add(String("a quick brown dog"));
+        index.save(prefix.c_str());
+    }
+
+    TextIndex index = TextIndex::load(prefix.c_str(), 2);
+    index.add("another quick document");
+    index.save(prefix.c_str());
+    CHECK(index.search_and("quick") == std::vector<uint32_t>({0, 2, 3}));
+    CHECK(index.search_and("brown dog") == std::vector<uint32_t>({2}));
+
+    TextIndex reloaded = TextIndex::load(prefix.c_str());
+    CHECK(reloaded.search_and("quick") == std::vector<uint32_t>({0, 2, 3}));
+    CHECK(reloaded.search_or("lazy document") == std::vector<uint32_t>({1, 3}));
+    CHECK(!std::filesystem::exists(prefix + ".manifest.tmp"));
+    return 0;
+}
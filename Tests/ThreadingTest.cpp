@@ -0,0 +1,120 @@
+// The threading primitives: Condition over a Lock and over an RLock (notify, notify_all,
+// timeouts, recursion restored after wait), and Semaphore, Event and Barrier handoffs.
+#include <Threading/Threading.h>
+
+#include "Check.h"
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace easycpp;
+
+namespace {
+    double elapsed_since(std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    // A producer/consumer queue count guarded by the condition; works for either lock type.
+    template<typename LockType>
+    void test_condition() {
+        LockType lock;
+        threading::Condition condition(lock);
+        int items = 0, consumed = 0;
+        const int TOTAL = 2000;
+        std::vector<std::thread> consumers;
+        for (int t = 0; t < 3; ++t) {
+            consumers.emplace_back([&] {
+                for (;;) {
+                    std::lock_guard<threading::Condition> guard(condition);
+                    condition.wait_for([&] { return items > 0 || consumed == TOTAL; });
+                    if (consumed == TOTAL) return;
+                    --items;
+                    if (++consumed == TOTAL) condition.notify_all();
+                }
+            });
+        }
+        for (int i = 0; i < TOTAL; ++i) {
+            std::lock_guard<threading::Condition> guard(condition);
+            ++items;
+            condition.notify();
+        }
+        for (std::thread& consumer : consumers) consumer.join();
+        CHECK(items == 0 && consumed == TOTAL);
+
+        // A wait that nobody notifies times out after roughly its timeout.
+        condition.acquire();
+        auto start = std::chrono::steady_clock::now();
+        CHECK(!condition.wait(0.05));
+        double waited = elapsed_since(start);
+        CHECK(waited >= 0.04 && waited < 5);
+        CHECK(!condition.wait_for([] { return false; }, 0.02));
+        condition.release();
+    }
+
+    void test_rlock_condition() {
+        threading::RLock lock;
+        threading::Condition condition(lock);
+        bool ready = false;
+        lock.acquire();
+        lock.acquire();
+        std::thread notifier([&] {
+            // Acquirable only because wait() released both recursion levels.
+            std::lock_guard<threading::RLock> guard(lock);
+            ready = true;
+            condition.notify();
+        });
+        CHECK(condition.wait_for([&] { return ready; }, 10));
+        notifier.join();
+        // Both levels are held again: two releases are needed, and a third fails.
+        lock.release();
+        lock.release();
+        CHECK_THROWS(lock.release(), std::runtime_error);
+        CHECK_THROWS(condition.wait(0.01), std::runtime_error);
+    }
+
+    void test_others() {
+        threading::Semaphore semaphore(0);
+        std::atomic<int> passed{0};
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 4; ++t) threads.emplace_back([&] {
+            semaphore.acquire();
+            passed.fetch_add(1);
+        });
+        CHECK(!semaphore.acquire(true, 0.01));
+        semaphore.release(4);
+        for (std::thread& thread : threads) thread.join();
+        CHECK(passed.load() == 4);
+        threading::BoundedSemaphore bounded(1);
+        CHECK_THROWS(bounded.release(), std::invalid_argument);
+
+        threading::Event event;
+        CHECK(!event.wait(0.01));
+        std::thread setter([&] { event.set(); });
+        CHECK(event.wait(10) && event.is_set());
+        setter.join();
+
+        std::atomic<int> actions{0};
+        threading::Barrier barrier(3, [&] { actions.fetch_add(1); });
+        std::atomic<int> index_sum{0};
+        threads.clear();
+        for (int t = 0; t < 3; ++t) threads.emplace_back([&] {
+            for (int round = 0; round < 50; ++round) index_sum.fetch_add((int) barrier.wait());
+        });
+        for (std::thread& thread : threads) thread.join();
+        CHECK(actions.load() == 50 && index_sum.load() == 50 * 3);
+        threading::Barrier lonely(2);
+        CHECK_THROWS(lonely.wait(0.01), threading::BrokenBarrierError);
+    }
+}
+
+int main() {
+    test_condition<threading::Lock>();
+    test_condition<threading::RLock>();
+    test_rlock_condition();
+    test_others();
+    return 0;
+}
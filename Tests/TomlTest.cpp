@@ -0,0 +1,44 @@
+// Numbers, dates and escapes are typed and checked by their TOML syntax, as tomllib does:
+// integers that do not fit are errors rather than floats, and malformed tokens are refused.
+#include <Config/Toml.h>
+
+#include "Check.h"
+
+#include <cmath>
+#include <stdexcept>
+#include <string>
+
+using namespace easycpp;
+
+namespace {
+    config::Type type_of(const std::string& value) {
+        return toml::loads("a = " + value + "\n")["a"].type();
+    }
+}
+
+int main() {
+    toml::Document doc = toml::loads(
+        "int = 1_000\nneg = -9223372036854775808\nhex = 0xdead_BEEF\noct = 0o755\nbin = 0b1_0\n"
+        "f1 = 1e5\nf2 = -3.14_15\nf3 = 6.02E+2_3\nf4 = 0.5e-1_0\nf5 = -inf\n"
+        "d1 = 1979-05-27\nd2 = 2000-02-29T07:32:00Z\nd3 = 1979-05-27 00:32:00.999-07:00\nd4 = 07:32:00\n"
+        "s = \"caf\\u00e9 \\U0001F600\"\n");
+    CHECK(doc["int"].as_int() == 1000 && doc["neg"].as_int() == INT64_MIN);
+    CHECK(doc["hex"].as_int() == 0xdeadbeef && doc["oct"].as_int() == 0755 && doc["bin"].as_int() == 2);
+    for (const char* key : {"f1", "f2", "f3", "f4", "f5"}) CHECK(doc[key].type() == config::Type::FLOAT);
+    CHECK(doc["f1"].as_double() == 1e5 && std::isinf(doc["f5"].as_double()));
+    for (const char* key : {"d1", "d2", "d3", "d4"}) CHECK(doc[key].type() == config::Type::DATETIME);
+    CHECK(doc["s"].as_string() == "caf\xc3\xa9 \xf0\x9f\x98\x80");
+    CHECK(type_of("9223372036854775807") == config::Type::INTEGER);
+
+    const char* invalid[] = {
+        "9223372036854775808", "99999999999999999999", "-9223372036854775809", "0x1_0000_0000_0000_0000",
+        "1_", "1__0", "_1", "0x_1", "+0x1", "01", "1.", "1.e5", ".5", "1e", "1e_5", "1._5", "1.5_", "1e5_",
+        "1979-13-45", "1979-02-29", "1979-05-27T25:00:00", "1979-05-27T07:60:00", "07:32", "1979-05-27T07:32:00+24:00",
+        "\"\\uD800\"", "\"\\uDFFF\"", "\"\\U00110000\"", "\"\\u12\"",
+    };
+    for (const char* value : invalid) CHECK_THROWS(type_of(value), std::invalid_argument);
+
+    // Escapes in YAML and the other loaders share the decoder, which also refuses surrogates.
+    CHECK_THROWS(config::detail::decode_escapes("\\ud83d", false), std::invalid_argument);
+    return 0;
+}
@@ -0,0 +1,30 @@
+// Prefix iteration with an empty prefix on a one-leaf trie, and keys with embedded NUL bytes.
+#include <Trie/Trie.h>
+
+#include "Check.h"
+
+#include <string>
+#include <string_view>
+
+using namespace easycpp;
+
+int main() {
+    Trie<int> single;
+    single.insert(std::string_view("only"), 1);
+    int visited = 0;
+    single.for_each([&](std::string_view key, int& value) { visited += key == "only" && value == 1; });
+    CHECK(visited == 1);
+    CHECK(single.keys_with_prefix(std::string_view()).size() == 1);
+
+    Trie<int> binary;
+    std::string a("ab\0cd", 5), b("ab\0ce", 5);
+    binary.insert(std::string_view(a), 1);
+    binary.insert(std::string_view(b), 2);
+    binary.insert(std::string_view("abz"), 3);
+    std::vector<String> keys = binary.keys_with_prefix(std::string_view("ab\0c", 4));
+    CHECK(keys.size() == 2);
+    CHECK(std::string_view((const char*) keys[0], keys[0].len()) == a);
+    CHECK(std::string_view((const char*) keys[1], keys[1].len()) == b);
+    CHECK(binary.keys_with_prefix(std::string_view("ab"), 1).size() == 1);
+    return 0;
+}
@@ -0,0 +1,68 @@
+// PullParser reading a file in small blocks: every event's views are its own, so an accessor
+// never returns a view into a block that a refill has since replaced. Attribute values are
+// normalized and checked as expat does.
+#include <Xml/Xml.h>
+
+#include "Check.h"
+
+#include <fstream>
+#include <string>
+
+using namespace easycpp;
+
+int main() {
+    test::TempDir temp("xml");
+    std::string document = "<root>";
+    for (int i = 0; i < 200; ++i) {
+        document += "<item id=\"" + std::to_string(i) + "\">text &amp; more " + std::to_string(i) + "</item>";
+        document += "<empty/>\n";
+    }
+    document += "</root>";
+    std::string path = (temp / "doc.xml").string();
+    std::ofstream(path, std::ios::binary) << document;
+
+    for (size_t block_size : {1, 7, 16, 64}) {
+        auto parser = xml::iterparse(path.c_str(), block_size);
+        int items = 0, empties = 0;
+        std::string expected;
+        while (parser->next()) {
+            switch (parser->event()) {
+                case xml::Event::START:
+                    CHECK(parser->raw_text().empty());
+                    if (parser->name() == "item") {
+                        CHECK(parser->attribute("id") != nullptr);
+                        expected = "text & more " + std::to_string(items);
+                    }
+                    break;
+                case xml::Event::TEXT:
+                    CHECK(parser->name().empty());
+                    CHECK(parser->attributes().empty());
+                    if (!parser->is_whitespace()) CHECK(parser->text() == expected);
+                    break;
+                case xml::Event::END:
+                    CHECK(parser->raw_text().empty() && !parser->has_entities());
+                    CHECK(parser->attributes().empty());
+                    items += parser->name() == "item";
+                    empties += parser->name() == "empty";
+                    break;
+                default:
+                    break;
+            }
+        }
+        CHECK(items == 200 && empties == 200);
+    }
+
+    std::ofstream(temp / "bad.xml") << "<a><b></b>";
+    auto parser = xml::iterparse((temp / "bad.xml").string().c_str(), 4);
+    CHECK_THROWS(while (parser->next()) {}, std::invalid_argument);
+
+    xml::ElementTree tree = xml::ElementTree::fromstring(
+        "<a x=\"a\tb\nc\r\nd\" y='&#9;&#10;' z=\"plain\">&#x10000;</a>");
+    CHECK(tree.getroot().get("x") == "a b c d");
+    CHECK(tree.getroot().get("y") == "\t\n");
+    CHECK(tree.getroot().get("z") == "plain");
+    const char* invalid[] = {"<a x=\"a<b\"/>", "<a>&#0;</a>", "<a>&#xD800;</a>", "<a x='&#xDFFF;'/>", "<a>&#xFFFE;</a>",
+                             "<a>&#1;</a>", "<a x=\"\x01\"/>"};
+    for (const char* text : invalid) CHECK_THROWS(xml::ElementTree::fromstring(text), std::invalid_argument);
+    return 0;
+}
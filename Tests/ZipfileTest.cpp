@@ -0,0 +1,115 @@
+// Zip extraction stays inside the destination: "..", absolute and drive-letter names are
+// confined, and a symbolic link already in the destination is never written through.
+#include <Compress/Zipfile.h>
+
+#include "Check.h"
+
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace easycpp;
+
+namespace {
+    void put(std::string& out, uint32_t value, int bytes) {
+        for (int i = 0; i < bytes; ++i) out += (char) (value >> (8 * i));
+    }
+
+    // A zip archive of stored members, given as (name, data) pairs.
+    std::string write_archive(const std::filesystem::path& path, const std::vector<std::pair<std::string, std::string>>& members) {
+        std::string out, directory;
+        for (const auto& [name, data] : members) {
+            uint32_t crc = zlib::crc32(data.data(), data.size());
+            uint32_t offset = (uint32_t) out.size();
+            put(out, 0x04034b50, 4);
+            put(out, 20, 2);
+            put(out, 0, 2);   // Flags
+            put(out, 0, 2);   // Stored
+            put(out, 0, 4);   // Time and date
+            put(out, crc, 4);
+            put(out, (uint32_t) data.size(), 4);
+            put(out, (uint32_t) data.size(), 4);
+            put(out, (uint32_t) name.size(), 2);
+            put(out, 0, 2);
+            out += name + data;
+
+            put(directory, 0x02014b50, 4);
+            put(directory, 20, 2);
+            put(directory, 20, 2);
+            put(directory, 0, 2);
+            put(directory, 0, 2);
+            put(directory, 0, 4);
+            put(directory, crc, 4);
+            put(directory, (uint32_t) data.size(), 4);
+            put(directory, (uint32_t) data.size(), 4);
+            put(directory, (uint32_t) name.size(), 2);
+            put(directory, 0, 2);  // Extra
+            put(directory, 0, 2);  // Comment
+            put(directory, 0, 2);  // Disk
+            put(directory, 0, 2);  // Internal attributes
+            put(directory, name.back() == '/' ? 0x10 : 0, 4);
+            put(directory, offset, 4);
+            directory += name;
+        }
+        uint32_t directory_offset = (uint32_t) out.size();
+        out += directory;
+        put(out, 0x06054b50, 4);
+        put(out, 0, 4);
+        put(out, (uint32_t) members.size(), 2);
+        put(out, (uint32_t) members.size(), 2);
+        put(out, (uint32_t) directory.size(), 4);
+        put(out, directory_offset, 4);
+        put(out, 0, 2);
+        std::ofstream(path, std::ios::binary) << out;
+        return path.string();
+    }
+
+    std::string read(const std::filesystem::path& path) {
+        std::ifstream file(path, std::ios::binary);
+        std::stringstream buffer;
+        buffer << file.rdbuf();
+        return buffer.str();
+    }
+}
+
+int main() {
+    test::TempDir temp("zipfile");
+    std::filesystem::path outside = temp / "outside";
+    std::filesystem::path root = temp / "root";
+    std::filesystem::create_directories(outside);
+    std::filesystem::create_directories(root);
+    std::ofstream(outside / "secret.txt") << "secret";
+
+    // Names that try to climb out are confined to root.
+    std::string climb = write_archive(temp / "climb.zip", {{"../../outside/a.txt", "a"}, {"/abs/b.txt", "b"},
+                                                          {"C:\\win\\c.txt", "c"}, {"dir/", ""}, {"dir/./d.txt", "d"}});
+    {
+        zipfile::ZipFile archive(climb.c_str());
+        archive.extractall(root.string().c_str());
+        CHECK(read(root / "outside/a.txt") == "a");
+        CHECK(read(root / "abs/b.txt") == "b");
+        CHECK(read(root / "win/c.txt") == "c");
+        CHECK(read(root / "dir/d.txt") == "d");
+        CHECK(!std::filesystem::exists(outside / "a.txt"));
+    }
+
+    // A directory link already in the destination, and a file link at a member's own path.
+    std::filesystem::remove_all(root);
+    std::filesystem::create_directories(root);
+    std::filesystem::create_directory_symlink(outside, root / "esc");
+    std::filesystem::create_symlink(outside / "secret.txt", root / "secret.txt");
+    std::string escape = write_archive(temp / "escape.zip", {{"esc/pwn.txt", "pwned"}, {"secret.txt", "replaced"}});
+    {
+        zipfile::ZipFile archive(escape.c_str());
+        CHECK_THROWS(archive.extract("esc/pwn.txt", root.string().c_str()), std::invalid_argument);
+        CHECK_THROWS(archive.extractall(root.string().c_str()), std::invalid_argument);
+        CHECK(!std::filesystem::exists(outside / "pwn.txt"));
+
+        archive.extract("secret.txt", root.string().c_str());
+        CHECK(!std::filesystem::is_symlink(root / "secret.txt") && read(root / "secret.txt") == "replaced");
+        CHECK(read(outside / "secret.txt") == "secret");
+    }
+    return 0;
+}
@@ -0,0 +1,860 @@
+// EasyCpp - TextIndex : A Full-Text Inverted Index
+// Copyright (C) 2025  C14147
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+/**
+ * @file EasyCpp/TextIndex/TextIndex.h
+ * @brief This file implements TextIndex, an inverted index over text documents.
+ *        Documents are tokenized into lowercase alphanumeric terms and collected in an
+ *        in-memory segment; flush() seals it into an immutable segment whose posting lists are
+ *        stored in blocks of 128 documents, delta encoded and bit packed in a 4-lane interleaved
+ *        layout that SSE2 unpacks directly. Queries support boolean AND (galloping intersection
+ *        over the block skip data), OR, and BM25 ranking. Segments can be merged, and saved to
+ *        files that are memory-mapped when loaded again.
+ */
+#pragma once
+#define _EASYCPP_TEXTINDEX_VERSION "1.0.0"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <queue>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define _EASYCPP_TEXTINDEX_SSE2 1
+#endif
+
+#include <FileOperator/BinaryIO.h>
+#include <FileOperator/FileOperator.h>
+#include <String/String.h>
+
+namespace easycpp {
+    /**
+     * @class BlockCodec
+     * @brief Bit packing of 128 unsigned integers with a common bit width.
+     * Value i is stored in lane i % 4, so a block of width b is 4 * b 32-bit words, and 4 values
+     * are unpacked at once with one 128-bit shift and mask.
+     */
+    class BlockCodec {
+    public:
+        static constexpr size_t BLOCK = 128;
+
+        /**
+         * @brief Get the number of bits needed for the largest of 128 values.
+         * @param values The values.
+         * @return The bit width, 0 to 32.
+         */
+        static unsigned width(const uint32_t* values) {
+            uint32_t all = 0;
+            for (size_t i = 0; i < BLOCK; ++i) all |= values[i];
+            unsigned bits = 0;
+            while (all) {
+                ++bits;
+                all >>= 1;
+            }
+            return bits;
+        }
+
+        /**
+         * @brief Pack 128 values.
+         * @param in The values, each below 2^bits.
+         * @param bits The bit width.
+         * @param out Receives 4 * bits words.
+         */
+        static void pack(const uint32_t* in, unsigned bits, uint32_t* out) {
+            std::memset(out, 0, 4 * bits * sizeof(uint32_t));
+            for (size_t i = 0; i < BLOCK; ++i) {
+                size_t lane = i & 3, bit = (i >> 2) * bits;
+                size_t word = bit >> 5, shift = bit & 31;
+                out[word * 4 + lane] |= in[i] << shift;
+                if (shift + bits > 32) out[(word + 1) * 4 + lane] |= in[i] >> (32 - shift);
+            }
+        }
+
+        /**
+         * @brief Unpack 128 values.
+         * @param in The 4 * bits packed words.
+         * @param bits The bit width.
+         * @param out Receives the 128 values.
+         */
+        static void unpack(const uint32_t* in, unsigned bits, uint32_t* out) {
+            if (bits == 0) {
+                std::memset(out, 0, BLOCK * sizeof(uint32_t));
+                return;
+            }
+            const uint32_t mask = bits == 32 ? 0xFFFFFFFFu : (1u << bits) - 1;
+#ifdef _EASYCPP_TEXTINDEX_SSE2
+            const __m128i vmask = _mm_set1_epi32((int) mask);
+            for (size_t slot = 0; slot < BLOCK / 4; ++slot) {
+                size_t bit = slot * bits, word = bit >> 5, shift = bit & 31;
+                __m128i value = _mm_srl_epi32(_mm_loadu_si128((const __m128i*) (in + word * 4)), _mm_cvtsi32_si128((int) shift));
+                if (shift + bits > 32) {
+                    __m128i high = _mm_loadu_si128((const __m128i*) (in + (word + 1) * 4));
+                    value = _mm_or_si128(value, _mm_sll_epi32(high, _mm_cvtsi32_si128((int) (32 - shift))));
+                }
+                _mm_storeu_si128((__m128i*) (out + slot * 4), _mm_and_si128(value, vmask));
+            }
+#else
+            for (size_t slot = 0; slot < BLOCK / 4; ++slot) {
+                size_t bit = slot * bits, word = bit >> 5, shift = bit & 31;
+                for (size_t lane = 0; lane < 4; ++lane) {
+                    uint32_t value = in[word * 4 + lane] >> shift;
+                    if (shift + bits > 32) value |= in[(word + 1) * 4 + lane] << (32 - shift);
+                    out[slot * 4 + lane] = value & mask;
+                }
+            }
+#endif
+        }
+    };
+
+    class PostingCursor;
+
+    /**
+     * @class TextSegment
+     * @brief An immutable index segment: term dictionary, document lengths and block-compressed
+     * posting lists in one contiguous byte range, which is either owned or memory mapped.
+     *
+     * Layout (little endian, sections 16-byte aligned): a 32-byte header (magic "ECTI", version,
+     * base document id, document count, term count, block count, total length), the document
+     * lengths, the term offsets and sorted term bytes, per term (document frequency, first block),
+     * per block (last document, data offset in 16-byte units, document bits, frequency bits,
+     * count), and finally the packed blocks.
+     */
+    class TextSegment {
+        friend class PostingCursor;
+
+    public:
+        static constexpr uint32_t MAGIC = 0x49544345;  // "ECTI"
+        static constexpr uint32_t VERSION = 1;
+        static constexpr size_t META_SIZE = 12;
+
+        /**
+         * @brief The postings of one term while a segment is encoded.
+         */
+        struct Postings {
+            std::vector<uint32_t> docs;  // Segment-local document ids, ascending
+            std::vector<uint32_t> freqs;
+        };
+
+    private:
+        std::shared_ptr<const void> owner;
+        const char* bytes = nullptr;
+        size_t length = 0;
+        uint32_t base = 0, docs = 0, terms = 0, blocks = 0;
+        uint64_t total = 0;
+        const uint32_t* doc_lengths = nullptr;
+        const uint32_t* term_offsets = nullptr;
+        const char* term_bytes = nullptr;
+        const uint32_t* term_info = nullptr;
+        const unsigned char* metas = nullptr;
+        const char* data = nullptr;
+
+        static uint32_t load32(const unsigned char* p) {
+            return (uint32_t) p[0] | (uint32_t) p[1] << 8 | (uint32_t) p[2] << 16 | (uint32_t) p[3] << 24;
+        }
+
+        void parse() {
+            ByteReader reader(bytes, length);
+            if (reader.get<uint32_t>() != MAGIC || reader.get<uint32_t>() != VERSION) {
+                throw std::invalid_argument("TextSegment: not a TextIndex segment");
+            }
+            base = reader.get<uint32_t>();
+            docs = reader.get<uint32_t>();
+            terms = reader.get<uint32_t>();
+            blocks = reader.get<uint32_t>();
+            total = reader.get<uint64_t>();
+            auto section = [&](size_t size) {
+                const char* start = reader.get_bytes(size);
+                size_t padding = (16 - (size_t) (reader.position() - bytes) % 16) % 16;
+                reader.get_bytes(std::min(padding, reader.remaining()));
+                return start;
+            };
+            doc_lengths = reinterpret_cast<const uint32_t*>(section(docs * sizeof(uint32_t)));
+            term_offsets = reinterpret_cast<const uint32_t*>(reader.get_bytes(((size_t) terms + 1) * sizeof(uint32_t)));
+            term_bytes = section(term_offsets[terms]);
+            term_info = reinterpret_cast<const uint32_t*>(section((size_t) terms * 2 * sizeof(uint32_t)));
+            metas = reinterpret_cast<const unsigned char*>(section(blocks * META_SIZE));
+            data = reader.position();
+            validate(reader.remaining());
+        }
+
+        // Check every offset the readers follow once, so a corrupt segment cannot send them out of
+        // the mapped bytes later.
+        void validate(size_t data_size) const {
+            auto corrupt = [](const char* what) {
+                throw std::invalid_argument(std::string("TextSegment: corrupt ") + what);
+            };
+            for (uint32_t i = 0; i < terms; ++i) {
+                if (term_offsets[i] > term_offsets[i + 1]) corrupt("term offsets");
+                if (term_info[i * 2] > docs) corrupt("document frequency");
+                uint32_t end = i + 1 < terms ? term_info[(i + 1) * 2 + 1] : blocks;
+                if (term_info[i * 2 + 1] > end || end > blocks) corrupt("term blocks");
+            }
+            for (uint32_t i = 0; i < blocks; ++i) {
+                const unsigned char* meta = metas + i * META_SIZE;
+                unsigned doc_bits = meta[8], freq_bits = meta[9];
+                uint32_t count = (uint32_t) meta[10] | (uint32_t) meta[11] << 8;
+                if (load32(meta) >= docs || doc_bits > 32 || freq_bits > 32 || count == 0 || count > BlockCodec::BLOCK) corrupt("block");
+                if ((uint64_t) load32(meta + 4) * 16 + 16 * (doc_bits + freq_bits) > data_size) corrupt("block offset");
+            }
+        }
+
+    public:
+        /**
+         * @brief Encode a segment.
+         * @param base The global id of the first document.
+         * @param lengths The number of terms of every document.
+         * @param postings The terms in ascending order with their postings.
+         * @return The encoded segment.
+         */
+        static std::string encode(uint32_t base, const std::vector<uint32_t>& lengths,
+                                  const std::vector<std::pair<std::string_view, const Postings*>>& postings) {
+            ByteWriter blob, info, meta, packed;
+            uint64_t total_length = 0;
+            for (uint32_t length : lengths) total_length += length;
+            uint32_t block_count = 0;
+            uint32_t gaps[BlockCodec::BLOCK], freqs[BlockCodec::BLOCK], words[4 * 32];
+            std::vector<uint32_t> offsets;
+            for (const auto& entry : postings) {
+                offsets.push_back((uint32_t) blob.size());
+                blob.put_bytes(entry.first.data(), entry.first.size());
+                const Postings& list = *entry.second;
+                info.put<uint32_t>((uint32_t) list.docs.size());
+                info.put<uint32_t>(block_count);
+                int64_t previous = -1;
+                for (size_t start = 0; start < list.docs.size(); start += BlockCodec::BLOCK) {
+                    size_t count = std::min(BlockCodec::BLOCK, list.docs.size() - start);
+                    for (size_t i = 0; i < BlockCodec::BLOCK; ++i) {
+                        gaps[i] = i < count ? (uint32_t) (list.docs[start + i] - previous - 1) : 0;
+                        freqs[i] = i < count ? list.freqs[start + i] - 1 : 0;
+                        if (i < count) previous = list.docs[start + i];
+                    }
+                    unsigned doc_bits = BlockCodec::width(gaps), freq_bits = BlockCodec::width(freqs);
+                    meta.put<uint32_t>((uint32_t) previous);
+                    meta.put<uint32_t>((uint32_t) (packed.size() / 16));
+                    meta.put<uint8_t>((uint8_t) doc_bits);
+                    meta.put<uint8_t>((uint8_t) freq_bits);
+                    meta.put<uint16_t>((uint16_t) count);
+                    BlockCodec::pack(gaps, doc_bits, words);
+                    packed.put_bytes(words, 16 * doc_bits);
+                    BlockCodec::pack(freqs, freq_bits, words);
+                    packed.put_bytes(words, 16 * freq_bits);
+                    ++block_count;
+                }
+            }
+            offsets.push_back((uint32_t) blob.size());
+
+            ByteWriter out;
+            out.put<uint32_t>(MAGIC);
+            out.put<uint32_t>(VERSION);
+            out.put<uint32_t>(base);
+            out.put<uint32_t>((uint32_t) lengths.size());
+            out.put<uint32_t>((uint32_t) postings.size());
+            out.put<uint32_t>(block_count);
+            out.put<uint64_t>(total_length);
+            for (uint32_t length : lengths) out.put<uint32_t>(length);
+            out.align(16);
+            for (uint32_t offset : offsets) out.put<uint32_t>(offset);
+            out.put_bytes(blob.str().data(), blob.size());
+            out.align(16);
+            out.put_bytes(info.str().data(), info.size());
+            out.align(16);
+            out.put_bytes(meta.str().data(), meta.size());
+            out.align(16);
+            out.put_bytes(packed.str().data(), packed.size());
+            return out.str();
+        }
+
+        /**
+         * @brief Open a segment held in memory.
+         * @param encoded The output of encode().
+         * @return The segment, which owns the bytes.
+         */
+        static std::shared_ptr<const TextSegment> from_bytes(std::string encoded) {
+            auto segment = std::make_shared<TextSegment>();
+            auto storage = std::make_shared<std::string>(std::move(encoded));
+            segment->bytes = storage->data();
+            segment->length = storage->size();
+            segment->owner = storage;
+            segment->parse();
+            return segment;
+        }
+
+        /**
+         * @brief Open a segment file by memory-mapping it.
+         * @param filename The path of the segment file.
+         * @return The segment, which keeps the mapping alive.
+         */
+        static std::shared_ptr<const TextSegment> from_file(const char* filename) {
+            auto segment = std::make_shared<TextSegment>();
+            std::shared_ptr<MappedFile> mapping(mmap(filename));
+            segment->bytes = mapping->data;
+            segment->length = mapping->size;
+            segment->owner = mapping;
+            segment->parse();
+            return segment;
+        }
+
+        uint32_t base_doc() const { return base; }
+        uint32_t doc_count() const { return docs; }
+        uint32_t term_count() const { return terms; }
+        uint64_t total_length() const { return total; }
+        uint32_t doc_length(uint32_t local) const { return doc_lengths[local]; }
+        std::string_view raw() const { return std::string_view(bytes, length); }
+
+        /**
+         * @brief Get a term of the dictionary.
+         * @param index The term index, ordered by term.
+         * @return The term.
+         */
+        std::string_view term(uint32_t index) const {
+            return std::string_view(term_bytes + term_offsets[index], term_offsets[index + 1] - term_offsets[index]);
+        }
+
+        /**
+         * @brief Look up a term with a binary search.
+         * @param word The term.
+         * @return The term index, or -1 if the segment does not contain it.
+         */
+        int64_t find(std::string_view word) const {
+            uint32_t lo = 0, hi = terms;
+            while (lo < hi) {
+                uint32_t mid = lo + (hi - lo) / 2;
+                if (term(mid) < word) lo = mid + 1;
+                else hi = mid;
+            }
+            return lo < terms && term(lo) == word ? (int64_t) lo : -1;
+        }
+
+        uint32_t doc_freq(uint32_t index) const { return term_info[index * 2]; }
+
+        /**
+         * @brief Open the posting list of a term.
+         * @param index The term index.
+         * @return A cursor positioned on the first posting.
+         */
+        PostingCursor postings(uint32_t index) const;
+
+        /**
+         * @brief Decode the complete posting list of a term.
+         * @param index The term index.
+         * @return The postings.
+         */
+        Postings decode(uint32_t index) const;
+    };
+
+    /**
+     * @class PostingCursor
+     * @brief Iterates over the posting list of one term in a segment, one block at a time.
+     * advance() skips whole blocks by galloping over their last document ids, then gallops inside
+     * the decoded block.
+     */
+    class PostingCursor {
+    public:
+        static constexpr uint32_t END = 0xFFFFFFFFu;
+
+    private:
+        const TextSegment* segment = nullptr;
+        uint32_t first = 0, block = 0, block_end = 0;
+        uint32_t docs[BlockCodec::BLOCK];
+        uint32_t freqs[BlockCodec::BLOCK];
+        uint32_t count = 0, pos = 0;
+
+        uint32_t last_doc(uint32_t index) const {
+            return TextSegment::load32(segment->metas + index * TextSegment::META_SIZE);
+        }
+
+        void load(uint32_t index) {
+            block = index;
+            pos = 0;
+            if (index >= block_end) {
+                count = 0;
+                return;
+            }
+            const unsigned char* meta = segment->metas + index * TextSegment::META_SIZE;
+            const uint32_t* words = reinterpret_cast<const uint32_t*>(segment->data + (size_t) TextSegment::load32(meta + 4) * 16);
+            unsigned doc_bits = meta[8], freq_bits = meta[9];
+            count = (uint32_t) meta[10] | (uint32_t) meta[11] << 8;
+            BlockCodec::unpack(words, doc_bits, docs);
+            BlockCodec::unpack(words + 4 * doc_bits, freq_bits, freqs);
+            uint32_t previous = index > first ? last_doc(index - 1) : END;
+            for (uint32_t i = 0; i < count; ++i) {
+                previous += docs[i] + 1;
+                docs[i] = previous;
+                ++freqs[i];
+            }
+        }
+
+    public:
+        PostingCursor() {}
+
+        PostingCursor(const TextSegment* segment, uint32_t first, uint32_t end) : segment(segment), first(first), block_end(end) {
+            load(first);
+        }
+
+        /**
+         * @brief Get the current segment-local document id.
+         * @return The document id, or END when exhausted.
+         */
+        uint32_t doc() const {
+            return pos < count ? docs[pos] : END;
+        }
+
+        /**
+         * @brief Get the term frequency in the current document.
+         * @return The frequency.
+         */
+        uint32_t freq() const {
+            return freqs[pos];
+        }
+
+        /**
+         * @brief Move to the next posting.
+         */
+        void next() {
+            if (++pos >= count && count) load(block + 1);
+        }
+
+        /**
+         * @brief Move to the first posting whose document id is at least target.
+         * @param target The document id.
+         */
+        void advance(uint32_t target) {
+            if (doc() >= target) return;
+            if (docs[count - 1] < target) {
+                // Gallop over the block skip data, then binary search the last step.
+                uint32_t lo = block, step = 1;
+                while (lo + step < block_end && last_doc(lo + step) < target) {
+                    lo += step;
+                    step *= 2;
+                }
+                uint32_t hi = std::min(lo + step, block_end);
+                ++lo;
+                while (lo < hi) {
+                    uint32_t mid = lo + (hi - lo) / 2;
+                    if (last_doc(mid) < target) lo = mid + 1;
+                    else hi = mid;
+                }
+                load(lo);
+                if (!count) return;
+            }
+            uint32_t lo = pos, step = 1;
+            while (lo + step < count && docs[lo + step] < target) {
+                lo += step;
+                step *= 2;
+            }
+            pos = (uint32_t) (std::lower_bound(docs + lo, docs + std::min(lo + step + 1, count), target) - docs);
+        }
+    };
+
+    inline PostingCursor TextSegment::postings(uint32_t index) const {
+        uint32_t first = term_info[index * 2 + 1];
+        uint32_t end = index + 1 < terms ? term_info[(index + 1) * 2 + 1] : blocks;
+        return PostingCursor(this, first, end);
+    }
+
+    inline TextSegment::Postings TextSegment::decode(uint32_t index) const {
+        Postings list;
+        list.docs.reserve(doc_freq(index));
+        list.freqs.reserve(doc_freq(index));
+        for (PostingCursor cursor = postings(index); cursor.doc() != PostingCursor::END; cursor.next()) {
+            list.docs.push_back(cursor.doc());
+            list.freqs.push_back(cursor.freq());
+        }
+        return list;
+    }
+
+    /**
+     * @class TextIndex
+     * @brief A segmented inverted index with boolean and BM25 queries.
+     * Added documents become searchable once their in-memory segment is flushed; add() flushes
+     * automatically every segment_docs documents.
+     */
+    class TextIndex {
+    private:
+        std::unordered_map<std::string, TextSegment::Postings> pending;
+        std::vector<uint32_t> pending_lengths;
+        std::vector<std::shared_ptr<const TextSegment>> segments;
+        size_t segment_docs;
+        uint32_t next_doc = 0;
+        uint64_t total_length = 0;
+
+        std::vector<std::string> query_terms(std::string_view query) const {
+            std::vector<std::string> words;
+            tokenize(query, [&](std::string_view word) {
+                if (std::find(words.begin(), words.end(), word) == words.end()) words.emplace_back(word);
+            });
+            return words;
+        }
+
+        /**
+         * @brief Open the cursors of the query terms in one segment, rarest term first.
+         * @return false if no term occurs, or a term is missing and all terms are required.
+         */
+        static bool open_cursors(const TextSegment& segment, const std::vector<std::string>& words, bool require_all,
+                                 std::vector<PostingCursor>& cursors, std::vector<size_t>& term_of) {
+            cursors.clear();
+            term_of.clear();
+            std::vector<std::pair<uint32_t, size_t>> found;  // (document frequency, query term)
+            std::vector<uint32_t> indices(words.size());
+            for (size_t i = 0; i < words.size(); ++i) {
+                int64_t index = segment.find(words[i]);
+                if (index < 0) {
+                    if (require_all) return false;
+                    continue;
+                }
+                indices[i] = (uint32_t) index;
+                found.emplace_back(segment.doc_freq((uint32_t) index), i);
+            }
+            std::sort(found.begin(), found.end());
+            for (const auto& entry : found) {
+                cursors.push_back(segment.postings(indices[entry.second]));
+                term_of.push_back(entry.second);
+            }
+            return !cursors.empty();
+        }
+
+        /**
+         * @brief Call fn(local document) for every document containing all cursors' terms.
+         * The first cursor (the rarest term) leads; the others gallop to its documents.
+         */
+        template<typename Fn>
+        static void intersect(std::vector<PostingCursor>& cursors, Fn fn) {
+            PostingCursor& lead = cursors[0];
+            while (lead.doc() != PostingCursor::END) {
+                uint32_t target = lead.doc();
+                bool matched = true;
+                for (size_t i = 1; i < cursors.size(); ++i) {
+                    cursors[i].advance(target);
+                    if (cursors[i].doc() != target) {
+                        matched = false;
+                        target = cursors[i].doc();
+                        break;
+                    }
+                }
+                if (matched) {
+                    fn(target);
+                    lead.next();
+                } else {
+                    lead.advance(target);
+                }
+            }
+        }
+
+    public:
+        /**
+         * @brief Construct an empty index.
+         * @param segment_docs The number of documents after which add() flushes a segment.
+         */
+        explicit TextIndex(size_t segment_docs = 100000) : segment_docs(segment_docs ? segment_docs : 1) {}
+
+        /**
+         * @brief Split text into terms: maximal runs of ASCII letters, digits and non-ASCII bytes,
+         * with ASCII letters lowercased.
+         * @param text The text.
+         * @param fn Called with every term.
+         */
+        template<typename Fn>
+        static void tokenize(std::string_view text, Fn&& fn) {
+            std::string word;
+            for (size_t i = 0; i <= text.size(); ++i) {
+                unsigned char c = i < text.size() ? (unsigned char) text[i] : ' ';
+                bool letter = (c >= 'a' && c <= 'z') || (c >= '0' && c <= '9') || c >= 0x80;
+                if (c >= 'A' && c <= 'Z') {
+                    c = (unsigned char) (c - 'A' + 'a');
+                    letter = true;
+                }
+                if (letter) {
+                    word += (char) c;
+                } else if (!word.empty()) {
+                    fn(std::string_view(word));
+                    word.clear();
+                }
+            }
+        }
+
+        /**
+         * @brief Add a document.
+         * @param text The document text.
+         * @return The id of the document, assigned consecutively from 0.
+         */
+        uint32_t add(std::string_view text) {
+            uint32_t local = (uint32_t) pending_lengths.size();
+            uint32_t length = 0;
+            tokenize(text, [&](std::string_view word) {
+                auto it = pending.find(std::string(word));
+                if (it == pending.end()) it = pending.emplace(std::string(word), TextSegment::Postings()).first;
+                TextSegment::Postings& list = it->second;
+                if (list.docs.empty() || list.docs.back() != local) {
+                    list.docs.push_back(local);
+                    list.freqs.push_back(0);
+                }
+                ++list.freqs.back();
+                ++length;
+            });
+            pending_lengths.push_back(length);
+            total_length += length;
+            uint32_t id = next_doc++;
+            if (pending_lengths.size() >= segment_docs) flush();
+            return id;
+        }
+
+        /**
+         * @brief Add a String document.
+         * @param text The document text.
+         * @return The id of the document.
+         */
+        uint32_t add(const String& text) {
+            return add(std::string_view((const char*) text, text.len()));
+        }
+
+        uint32_t add(const char* text) {
+            return add(std::string_view(text));
+        }
+
+        /**
+         * @brief Seal the documents added since the last flush into a searchable segment.
+         */
+        void flush() {
+            if (pending_lengths.empty()) return;
+            std::vector<std::pair<std::string_view, const TextSegment::Postings*>> sorted;
+            sorted.reserve(pending.size());
+            for (const auto& entry : pending) sorted.emplace_back(entry.first, &entry.second);
+            std::sort(sorted.begin(), sorted.end());
+            uint32_t base = next_doc - (uint32_t) pending_lengths.size();
+            segments.push_back(TextSegment::from_bytes(TextSegment::encode(base, pending_lengths, sorted)));
+            pending.clear();
+            pending_lengths.clear();
+        }
+
+        /**
+         * @brief Merge all segments into one. Pending documents are flushed first.
+         */
+        void merge() {
+            flush();
+            if (segments.size() < 2) return;
+            std::map<std::string_view, std::vector<std::pair<size_t, uint32_t>>> terms;
+            std::vector<uint32_t> lengths;
+            for (size_t s = 0; s < segments.size(); ++s) {
+                const TextSegment& segment = *segments[s];
+                for (uint32_t t = 0; t < segment.term_count(); ++t) terms[segment.term(t)].emplace_back(s, t);
+                for (uint32_t d = 0; d < segment.doc_count(); ++d) lengths.push_back(segment.doc_length(d));
+            }
+            uint32_t base = segments.front()->base_doc();
+            std::vector<TextSegment::Postings> merged;
+            merged.reserve(terms.size());
+            std::vector<std::pair<std::string_view, const TextSegment::Postings*>> sorted;
+            for (const auto& entry : terms) {
+                TextSegment::Postings list;
+                for (const auto& location : entry.second) {
+                    const TextSegment& segment = *segments[location.first];
+                    TextSegment::Postings part = segment.decode(location.second);
+                    uint32_t offset = segment.base_doc() - base;
+                    for (uint32_t& doc : part.docs) doc += offset;
+                    list.docs.insert(list.docs.end(), part.docs.begin(), part.docs.end());
+                    list.freqs.insert(list.freqs.end(), part.freqs.begin(), part.freqs.end());
+                }
+                merged.push_back(std::move(list));
+                sorted.emplace_back(entry.first, &merged.back());
+            }
+            auto segment = TextSegment::from_bytes(TextSegment::encode(base, lengths, sorted));
+            segments.clear();
+            segments.push_back(std::move(segment));
+        }
+
+        size_t size() const { return next_doc; }
+        size_t segment_count() const { return segments.size(); }
+
+        /**
+         * @brief Find the documents that contain every term of the query.
+         * @param query The query text, tokenized like the documents.
+         * @return The ascending ids of the matching documents.
+         */
+        std::vector<uint32_t> search_and(std::string_view query) const {
+            std::vector<std::string> words = query_terms(query);
+            std::vector<uint32_t> result;
+            std::vector<PostingCursor> cursors;
+            std::vector<size_t> term_of;
+            for (const auto& segment : segments) {
+                if (words.empty() || !open_cursors(*segment, words, true, cursors, term_of)) continue;
+                uint32_t base = segment->base_doc();
+                intersect(cursors, [&](uint32_t local) { result.push_back(base + local); });
+            }
+            return result;
+        }
+
+        /**
+         * @brief Find the documents that contain at least one term of the query.
+         * @param query The query text, tokenized like the documents.
+         * @return The ascending ids of the matching documents.
+         */
+        std::vector<uint32_t> search_or(std::string_view query) const {
+            std::vector<std::string> words = query_terms(query);
+            std::vector<uint32_t> result;
+            std::vector<PostingCursor> cursors;
+            std::vector<size_t> term_of;
+            std::vector<uint8_t> hits;
+            for (const auto& segment : segments) {
+                if (!open_cursors(*segment, words, false, cursors, term_of)) continue;
+                hits.assign(segment->doc_count(), 0);
+                for (PostingCursor& cursor : cursors) {
+                    for (; cursor.doc() != PostingCursor::END; cursor.next()) hits[cursor.doc()] = 1;
+                }
+                for (uint32_t d = 0; d < hits.size(); ++d) {
+                    if (hits[d]) result.push_back(segment->base_doc() + d);
+                }
+            }
+            return result;
+        }
+
+        /**
+         * @brief Rank documents against a query with Okapi BM25.
+         * @param query The query text, tokenized like the documents.
+         * @param k The number of results.
+         * @param require_all Only rank documents containing every term (AND) instead of any (OR).
+         * @param k1 The BM25 term frequency saturation.
+         * @param b The BM25 length normalization.
+         * @return Up to k (document id, score) pairs, best first.
+         */
+        std::vector<std::pair<uint32_t, double>> rank(std::string_view query, size_t k = 10, bool require_all = false,
+                                                      double k1 = 1.2, double b = 0.75) const {
+            std::vector<std::string> words = query_terms(query);
+            uint64_t docs = 0, length = 0;
+            std::vector<uint64_t> df(words.size(), 0);
+            for (const auto& segment : segments) {
+                docs += segment->doc_count();
+                length += segment->total_length();
+                for (size_t i = 0; i < words.size(); ++i) {
+                    int64_t index = segment->find(words[i]);
+                    if (index >= 0) df[i] += segment->doc_freq((uint32_t) index);
+                }
+            }
+            if (docs == 0 || k == 0) return {};
+            double average = (double) length / (double) docs;
+            std::vector<double> idf(words.size());
+            for (size_t i = 0; i < words.size(); ++i) {
+                idf[i] = std::log(1.0 + ((double) docs - (double) df[i] + 0.5) / ((double) df[i] + 0.5));
+            }
+
+            using Hit = std::pair<double, uint32_t>;
+            std::priority_queue<Hit, std::vector<Hit>, std::greater<Hit>> best;
+            auto offer = [&](uint32_t doc, double score) {
+                if (best.size() < k) best.emplace(score, doc);
+                else if (score > best.top().first) {
+                    best.pop();
+                    best.emplace(score, doc);
+                }
+            };
+            std::vector<PostingCursor> cursors;
+            std::vector<size_t> term_of;
+            std::vector<double> scores;
+            for (const auto& segment : segments) {
+                if (words.empty() || !open_cursors(*segment, words, require_all, cursors, term_of)) continue;
+                auto weight = [&](size_t term, uint32_t local, uint32_t tf) {
+                    double norm = k1 * (1.0 - b + b * (double) segment->doc_length(local) / average);
+                    return idf[term] * (double) tf * (k1 + 1.0) / ((double) tf + norm);
+                };
+                uint32_t base = segment->base_doc();
+                if (require_all) {
+                    intersect(cursors, [&](uint32_t local) {
+                        double score = 0.0;
+                        for (size_t i = 0; i < cursors.size(); ++i) score += weight(term_of[i], local, cursors[i].freq());
+                        offer(base + local, score);
+                    });
+                } else {
+                    scores.assign(segment->doc_count(), 0.0);
+                    for (size_t i = 0; i < cursors.size(); ++i) {
+                        for (PostingCursor& cursor = cursors[i]; cursor.doc() != PostingCursor::END; cursor.next()) {
+                            scores[cursor.doc()] += weight(term_of[i], cursor.doc(), cursor.freq());
+                        }
+                    }
+                    for (uint32_t d = 0; d < scores.size(); ++d) {
+                        if (scores[d] > 0.0) offer(base + d, scores[d]);
+                    }
+                }
+            }
+            std::vector<std::pair<uint32_t, double>> result;
+            for (; !best.empty(); best.pop()) result.emplace_back(best.top().second, best.top().first);
+            std::reverse(result.begin(), result.end());
+            return result;
+        }
+
+        /**
+         * @brief Flush and write every segment to "<prefix>.<n>.seg", plus a "<prefix>.manifest"
+         * listing them, through FileOperator. Each file is written under a temporary name and
+         * renamed into place, so saving to the prefix the index was loaded from leaves the
+         * mapped segments intact.
+         * @param prefix The path prefix of the index files.
+         */
+        void save(const char* prefix) {
+            flush();
+            auto replace = [](const std::string& name, std::string_view data) {
+                std::string temporary = name + ".tmp";
+                {
+                    std::unique_ptr<File> file(open(temporary.c_str(), WRITE_B));
+                    file->write(data.data(), data.size());
+                }
+                std::filesystem::rename(temporary, name);
+            };
+            std::string manifest;
+            for (size_t i = 0; i < segments.size(); ++i) {
+                std::string name = std::string(prefix) + "." + std::to_string(i) + ".seg";
+                replace(name, segments[i]->raw());
+                manifest += name + "\n";
+            }
+            replace(std::string(prefix) + ".manifest", manifest);
+        }
+
+        /**
+         * @brief Open an index written by save(). The segments are memory mapped, not read.
+         * @param prefix The path prefix used with save().
+         * @param segment_docs The flush threshold for documents added afterwards.
+         * @return The index.
+         */
+        static TextIndex load(const char* prefix, size_t segment_docs = 100000) {
+            TextIndex index(segment_docs);
+            File* file = open((std::string(prefix) + ".manifest").c_str(), READ);
+            char* content = file->read_();
+            std::string manifest(content);
+            free(content);
+            delete file;
+            size_t start = 0;
+            while (start < manifest.size()) {
+                size_t end = manifest.find('\n', start);
+                if (end == std::string::npos) end = manifest.size();
+                if (end > start) {
+                    auto segment = TextSegment::from_file(manifest.substr(start, end - start).c_str());
+                    index.next_doc = segment->base_doc() + segment->doc_count();
+                    index.total_length += segment->total_length();
+                    index.segments.push_back(std::move(segment));
+                }
+                start = end + 1;
+            }
+            return index;
+        }
+    };
+}
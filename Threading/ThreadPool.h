@@ -0,0 +1,320 @@
+// EasyCpp - ThreadPool : A Simple Worker Thread Pool
+// Copyright (C) 2025  C14147
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+/**
+ * @file EasyCpp/Threading/ThreadPool.h
+ * @brief This file implements the thread pool used by the parallel parts of EasyCpp.
+ *        It resembles Python's concurrent.futures.ThreadPoolExecutor and adds a
+ *        parallel_for helper in which the calling thread takes part as well. Workers can
+ *        be placed on the CPU topology (compact or scatter, or one pool per NUMA node),
+ *        and buffers can be first touched by the workers so their pages land on the
+ *        workers' nodes.
+ */
+#pragma once
+#define _EASYCPP_THREADPOOL_VERSION "1.0.0"
+
+#include <algorithm>
+#include <Profile/Profile.h>
+#include <System/System.h>
+
+#include <atomic>
+#include <exception>
+#include <condition_variable>
+#include <cstddef>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace easycpp {
+    /**
+     * @class ThreadPool
+     * @brief A fixed set of worker threads that execute submitted tasks in FIFO order.
+     */
+    class ThreadPool {
+    public:
+        /**
+         * @brief Where the workers run.
+         */
+        enum Placement {
+            NONE,       ///< Anywhere; the scheduler decides.
+            COMPACT,    ///< Pinned in os::CpuTopology::compact() order: siblings, then cores, then nodes.
+            SCATTER     ///< Pinned in os::CpuTopology::scatter() order: one per core across nodes first.
+        };
+
+    private:
+        std::vector<std::thread> workers;
+        std::deque<std::function<void()>> tasks;
+        std::mutex mutex;
+        std::condition_variable available;
+        bool stopping = false;
+
+        void start(size_t threads, const std::vector<std::vector<int>>& affinity) {
+            workers.reserve(threads);
+            for (size_t i = 0; i < threads; ++i) {
+                std::vector<int> cpus = affinity.empty() ? std::vector<int>() : affinity[i % affinity.size()];
+                workers.emplace_back([this, cpus] {
+                    if (!cpus.empty()) {
+                        // Placement is a hint: a worker the kernel refuses to pin still runs.
+                        try {
+                            os::sched_setaffinity(0, cpus);
+                        } catch (const std::exception&) {}
+                    }
+                    worker_loop();
+                });
+            }
+        }
+
+        /**
+         * @brief Order the CPUs this process may use as the placement asks.
+         */
+        static std::vector<int> placement_order(Placement placement) {
+            const os::CpuTopology& topology = os::cpu_topology();
+            std::vector<int> order = placement == SCATTER ? topology.scatter() : topology.compact();
+            std::vector<int> allowed = os::sched_getaffinity();
+            std::vector<int> result;
+            for (int cpu : order) {
+                if (std::binary_search(allowed.begin(), allowed.end(), cpu)) result.push_back(cpu);
+            }
+            return result.empty() ? allowed : result;
+        }
+
+        /**
+         * @brief Run fn under the given profile::Span label unless it is already the
+         * innermost one, so that samples on workers keep the label of the queuing thread.
+         */
+        template<typename Fn>
+        static void run_in_span(const char* span, Fn& fn) {
+            if (span && span != profile::detail::current_span()) {
+                profile::Span label(span);
+                fn();
+            } else {
+                fn();
+            }
+        }
+
+        void worker_loop() {
+            for (;;) {
+                std::function<void()> task;
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    available.wait(lock, [this] { return stopping || !tasks.empty(); });
+                    if (tasks.empty()) return;
+                    task = std::move(tasks.front());
+                    tasks.pop_front();
+                }
+                task();
+            }
+        }
+
+    public:
+        /**
+         * @brief Start the given number of worker threads.
+         * @param threads The number of workers. 0 means std::thread::hardware_concurrency(),
+         *        or with a placement, the number of CPUs this process may use.
+         * @param placement NONE leaves the workers unpinned. COMPACT and SCATTER pin worker i
+         *        to the i-th allowed CPU in that order, wrapping around if there are more
+         *        workers than CPUs.
+         */
+        explicit ThreadPool(size_t threads = 0, Placement placement = NONE) {
+            std::vector<std::vector<int>> affinity;
+            if (placement != NONE) {
+                for (int cpu : placement_order(placement)) affinity.push_back({cpu});
+            }
+            if (threads == 0) threads = affinity.empty() ? std::max(1u, std::thread::hardware_concurrency()) : affinity.size();
+            start(threads, affinity);
+        }
+
+        /**
+         * @brief Start workers that may run on the given CPUs only. They are not pinned one
+         * by one, so the scheduler still balances them within the set.
+         * @param cpus The CPU numbers.
+         * @param threads The number of workers. 0 means one per CPU.
+         * @throws std::invalid_argument if cpus is empty.
+         */
+        explicit ThreadPool(const std::vector<int>& cpus, size_t threads = 0) {
+            if (cpus.empty()) throw std::invalid_argument("ThreadPool: empty cpu set");
+            start(threads ? threads : cpus.size(), {cpus});
+        }
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        /**
+         * @brief Finish the queued tasks and join the workers.
+         */
+        ~ThreadPool() {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                stopping = true;
+            }
+            available.notify_all();
+            for (std::thread& worker : workers) worker.join();
+        }
+
+        /**
+         * @brief Get the number of worker threads.
+         * @return The number of workers.
+         */
+        size_t size() const {
+            return workers.size();
+        }
+
+        /**
+         * @brief Schedule a callable and return a future for its result.
+         * @param fn The callable to be executed on a worker.
+         * @return A future holding the result or the exception thrown by fn.
+         */
+        template<typename Fn>
+        auto submit(Fn&& fn) -> std::future<std::invoke_result_t<std::decay_t<Fn>&>> {
+            using Result = std::invoke_result_t<std::decay_t<Fn>&>;
+            auto task = std::make_shared<std::packaged_task<Result()>>(std::forward<Fn>(fn));
+            std::future<Result> result = task->get_future();
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                tasks.emplace_back([task, span = profile::detail::current_span()] { run_in_span(span, *task); });
+            }
+            available.notify_one();
+            return result;
+        }
+
+        /**
+         * @brief Call fn(i) for every i in [begin, end) and wait for all calls to finish.
+         * Indices are handed out dynamically, and the calling thread works on them too, so
+         * parallel_for may safely be nested inside a task of the same pool.
+         * @param begin The first index.
+         * @param end One past the last index.
+         * @param fn The callable invoked with each index.
+         */
+        template<typename Fn>
+        void parallel_for(size_t begin, size_t end, Fn&& fn) {
+            if (begin >= end) return;
+            struct Shared {
+                std::atomic<size_t> next;
+                std::atomic<size_t> done{0};
+                std::exception_ptr error;
+                std::mutex error_mutex;
+            };
+            auto shared = std::make_shared<Shared>();
+            shared->next = begin;
+            size_t total = end - begin;
+            auto body = [shared, end, &fn, span = profile::detail::current_span()] {
+                auto work = [&] {
+                    for (size_t i; (i = shared->next.fetch_add(1)) < end;) {
+                        try {
+                            fn(i);
+                        } catch (...) {
+                            std::lock_guard<std::mutex> lock(shared->error_mutex);
+                            if (!shared->error) shared->error = std::current_exception();
+                        }
+                        shared->done.fetch_add(1, std::memory_order_release);
+                    }
+                };
+                run_in_span(span, work);
+            };
+            size_t helpers = std::min(workers.size(), total - 1);
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                for (size_t i = 0; i < helpers; ++i) tasks.emplace_back(body);
+            }
+            available.notify_all();
+            body();
+            // Wait for the calls still running on helpers. Helpers that start later find no
+            // index left, so nothing waits on queued tasks and nesting cannot deadlock.
+            while (shared->done.load(std::memory_order_acquire) < total) std::this_thread::yield();
+            if (shared->error) std::rethrow_exception(shared->error);
+        }
+
+        /**
+         * @brief Zero a buffer from the workers, in one contiguous slice per worker. Linux
+         * places a page on the NUMA node of the thread that first writes it, so a fresh
+         * buffer touched here ends up on the workers' nodes instead of the caller's. Must
+         * not be called from a task of the same pool.
+         * @param data The buffer.
+         * @param size The size in bytes.
+         */
+        void first_touch(void* data, size_t size) {
+            if (!size) return;
+            constexpr size_t PAGE = 4096;
+            size_t pages = (size + PAGE - 1) / PAGE;
+            size_t slices = std::min(workers.size(), pages);
+            std::vector<std::future<void>> done;
+            done.reserve(slices);
+            for (size_t i = 0; i < slices; ++i) {
+                size_t begin = pages * i / slices * PAGE, end = std::min(size, pages * (i + 1) / slices * PAGE);
+                char* bytes = static_cast<char*>(data);
+                done.push_back(submit([bytes, begin, end] { std::memset(bytes + begin, 0, end - begin); }));
+            }
+            for (auto& slice : done) slice.get();
+        }
+
+        /**
+         * @brief Allocate a zeroed array that is first touched by the workers, so that its
+         * pages are local to them. See first_touch().
+         * @param count The number of elements.
+         * @return The array.
+         */
+        template<typename T>
+        std::unique_ptr<T[]> allocate(size_t count) {
+            static_assert(std::is_trivial_v<T>, "ThreadPool::allocate requires a trivial type");
+            std::unique_ptr<T[]> array(new T[count]);
+            first_touch(array.get(), count * sizeof(T));
+            return array;
+        }
+
+        /**
+         * @brief Get the process-wide pool used by EasyCpp's parallel algorithms.
+         * @return The shared pool, sized to the hardware concurrency.
+         */
+        static ThreadPool& global() {
+            static ThreadPool pool;
+            return pool;
+        }
+
+        /**
+         * @brief Get the process-wide pool of a NUMA node, created on first use with one
+         * worker per CPU of the node that this process may use. Work and buffers handed to
+         * it (see allocate()) stay on that node.
+         * @param node The node, numbered as in os::cpu_topology().nodes.
+         * @return The node's pool.
+         * @throws std::out_of_range if there is no such node.
+         */
+        static ThreadPool& node(size_t node) {
+            static const size_t count = os::cpu_topology().nodes.size();
+            static std::vector<std::unique_ptr<ThreadPool>> pools(count);
+            static std::mutex pools_mutex;
+            if (node >= count) throw std::out_of_range("ThreadPool: no NUMA node " + std::to_string(node));
+            std::lock_guard<std::mutex> lock(pools_mutex);
+            if (!pools[node]) {
+                std::vector<int> allowed = os::sched_getaffinity(), cpus;
+                for (int cpu : os::cpu_topology().nodes[node]) {
+                    if (std::binary_search(allowed.begin(), allowed.end(), cpu)) cpus.push_back(cpu);
+                }
+                pools[node] = std::make_unique<ThreadPool>(cpus.empty() ? allowed : cpus);
+            }
+            return *pools[node];
+        }
+    };
+}
@@ -0,0 +1,718 @@
+// EasyCpp - Threading : Synchronization Primitives
+// Copyright (C) 2025  C14147
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+/**
+ * @file EasyCpp/Threading/Threading.h
+ * @brief This file implements the synchronization primitives of Python's threading module:
+ *        Lock, RLock, Condition, Semaphore, BoundedSemaphore, Event and Barrier. Their state
+ *        is kept in 32-bit words that threads park on with futex(2) on Linux (and with
+ *        std::atomic::wait elsewhere). A contended acquire spins briefly before parking, each
+ *        object occupies its own cache line, and nothing allocates. A ContentionStats block
+ *        can be attached to any of them to count contended waits, spins, parks and time.
+ *        Timeouts are in seconds, as in Python; a negative timeout waits forever.
+ */
+#pragma once
+#define _EASYCPP_THREADING_VERSION "1.0.0"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <stdexcept>
+#include <thread>
+
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define _EASYCPP_THREADING_SSE2
+#endif
+
+namespace easycpp {
+    namespace threading {
+        /**
+         * @struct ContentionStats
+         * @brief Counters filled in by the primitives it is attached to. Only waits that did
+         * not succeed immediately are recorded, so an attached block costs nothing while
+         * uncontended.
+         */
+        struct ContentionStats {
+            std::atomic<uint64_t> contended{0};  // Waits that did not succeed at once
+            std::atomic<uint64_t> spins{0};      // Spin iterations before success or parking
+            std::atomic<uint64_t> parks{0};      // Times a thread went to sleep in the kernel
+            std::atomic<uint64_t> wait_ns{0};    // Total time spent in contended waits
+
+            void reset() {
+                contended = 0;
+                spins = 0;
+                parks = 0;
+                wait_ns = 0;
+            }
+        };
+
+        /**
+         * @brief Raised by Barrier::wait() when the barrier is broken or reset while waiting.
+         */
+        class BrokenBarrierError : public std::runtime_error {
+        public:
+            BrokenBarrierError() : std::runtime_error("threading: broken barrier") {}
+        };
+
+        namespace detail {
+            inline constexpr size_t CACHE_LINE = 64;
+            inline constexpr int SPIN_LIMIT = 100;
+
+            inline void cpu_relax() {
+#ifdef _EASYCPP_THREADING_SSE2
+                _mm_pause();
+#elif defined(__aarch64__)
+                __asm__ __volatile__("yield");
+#endif
+            }
+
+            inline int64_t now_ns() {
+                return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+            }
+
+            // The deadline for a timeout in seconds, or -1 for none.
+            inline int64_t deadline(double timeout) {
+                return timeout < 0 ? -1 : now_ns() + (int64_t) (timeout * 1e9);
+            }
+
+            /**
+             * @brief Sleep while word == expected, until woken or the deadline passes. May
+             * return spuriously.
+             * @return False if the deadline has passed on return.
+             */
+            inline bool park(std::atomic<uint32_t>& word, uint32_t expected, int64_t until) {
+                int64_t left = 0;
+                if (until >= 0) {
+                    left = until - now_ns();
+                    if (left <= 0) return false;
+                }
+#ifdef __linux__
+                struct timespec relative = {(time_t) (left / 1000000000), (long) (left % 1000000000)};
+                syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAIT_PRIVATE, expected, until >= 0 ? &relative : nullptr,
+                        nullptr, 0);
+#else
+                if (until < 0) {
+                    word.wait(expected, std::memory_order_acquire);
+                } else {
+                    // std::atomic::wait has no timeout; poll instead.
+                    std::this_thread::sleep_for(std::chrono::nanoseconds(std::min<int64_t>(left, 50000)));
+                }
+#endif
+                return until < 0 || now_ns() < until;
+            }
+
+            inline void unpark(std::atomic<uint32_t>& word, int count) {
+#ifdef __linux__
+                syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAKE_PRIVATE, count, nullptr, nullptr, 0);
+#else
+                if (count == 1) word.notify_one();
+                else word.notify_all();
+#endif
+            }
+
+            // Records one contended wait into the attached stats, if any, when it goes out
+            // of scope.
+            class Contention {
+            private:
+                ContentionStats* stats;
+                int64_t start = 0;
+
+            public:
+                uint64_t spins = 0;
+                uint64_t parks = 0;
+
+                explicit Contention(ContentionStats* stats) : stats(stats) {
+                    if (stats) start = now_ns();
+                }
+
+                ~Contention() {
+                    if (!stats) return;
+                    stats->contended.fetch_add(1, std::memory_order_relaxed);
+                    stats->spins.fetch_add(spins, std::memory_order_relaxed);
+                    stats->parks.fetch_add(parks, std::memory_order_relaxed);
+                    stats->wait_ns.fetch_add((uint64_t) (now_ns() - start), std::memory_order_relaxed);
+                }
+            };
+
+            // An address unique to the calling thread.
+            inline uintptr_t thread_token() {
+                static thread_local char token;
+                return reinterpret_cast<uintptr_t>(&token);
+            }
+        }
+
+        /**
+         * @class Lock
+         * @brief A non-recursive mutex. The word is 0 when free, 1 when held and 2 when held
+         * with sleepers. A contended acquire spins first; the spin length adapts to how long
+         * past acquisitions had to spin, as glibc's adaptive mutex does.
+         */
+        class alignas(detail::CACHE_LINE) Lock {
+        private:
+            std::atomic<uint32_t> state{0};
+            std::atomic<uint32_t> spin_average{detail::SPIN_LIMIT / 2};
+            ContentionStats* stats = nullptr;
+
+            bool acquire_slow(double timeout) {
+                detail::Contention contention(stats);
+                int average = (int) spin_average.load(std::memory_order_relaxed);
+                int limit = std::min(detail::SPIN_LIMIT * 2, average * 2 + 10);
+                for (int i = 0; i < limit; ++i) {
+                    detail::cpu_relax();
+                    ++contention.spins;
+                    uint32_t expected = 0;
+                    if (state.load(std::memory_order_relaxed) == 0 &&
+                        state.compare_exchange_weak(expected, 1, std::memory_order_acquire, std::memory_order_relaxed)) {
+                        spin_average.store((uint32_t) (average + (i - average) / 8), std::memory_order_relaxed);
+                        return true;
+                    }
+                }
+                spin_average.store((uint32_t) (average + (limit - average) / 8), std::memory_order_relaxed);
+                int64_t until = detail::deadline(timeout);
+                while (state.exchange(2, std::memory_order_acquire) != 0) {
+                    ++contention.parks;
+                    if (!detail::park(state, 2, until)) return false;
+                }
+                return true;
+            }
+
+        public:
+            Lock() = default;
+            Lock(const Lock&) = delete;
+            Lock& operator=(const Lock&) = delete;
+
+            /**
+             * @brief Acquire the lock.
+             * @param blocking If false, return at once when the lock is held.
+             * @param timeout The longest time to wait in seconds, negative for no limit.
+             * @return True if the lock was acquired.
+             */
+            bool acquire(bool blocking = true, double timeout = -1) {
+                uint32_t expected = 0;
+                if (state.compare_exchange_strong(expected, 1, std::memory_order_acquire, std::memory_order_relaxed)) return true;
+                if (!blocking || timeout == 0) return false;
+                return acquire_slow(timeout);
+            }
+
+            /**
+             * @brief Release the lock. Any thread may release it, as in Python.
+             * @throws std::runtime_error if the lock is not held.
+             */
+            void release() {
+                uint32_t previous = state.fetch_sub(1, std::memory_order_release);
+                if (previous == 1) return;
+                if (previous == 0) {
+                    state.fetch_add(1, std::memory_order_relaxed);
+                    throw std::runtime_error("threading: release unlocked lock");
+                }
+                state.store(0, std::memory_order_release);
+                detail::unpark(state, 1);
+            }
+
+            bool locked() const { return state.load(std::memory_order_relaxed) != 0; }
+
+            void set_stats(ContentionStats* stats) { this->stats = stats; }
+
+            // BasicLockable, for std::lock_guard and std::unique_lock.
+            void lock() { acquire(); }
+            bool try_lock() { return acquire(false); }
+            void unlock() { release(); }
+        };
+
+        /**
+         * @class RLock
+         * @brief A reentrant lock: the owning thread may acquire it again and must release it
+         * as many times.
+         */
+        class alignas(detail::CACHE_LINE) RLock {
+        private:
+            friend class Condition;
+
+            Lock inner;
+            std::atomic<uintptr_t> owner{0};
+            uint32_t count = 0;
+
+            bool is_owned() const { return owner.load(std::memory_order_relaxed) == detail::thread_token(); }
+
+            // Condition::wait() releases every recursion level at once and restores them after.
+            uint32_t release_save() {
+                uint32_t depth = count;
+                count = 0;
+                owner.store(0, std::memory_order_relaxed);
+                inner.release();
+                return depth;
+            }
+
+            void acquire_restore(uint32_t depth) {
+                inner.acquire();
+                owner.store(detail::thread_token(), std::memory_order_relaxed);
+                count = depth;
+            }
+
+        public:
+            RLock() = default;
+            RLock(const RLock&) = delete;
+            RLock& operator=(const RLock&) = delete;
+
+            /**
+             * @brief Acquire the lock, or increase the recursion level if this thread owns it.
+             * @param blocking If false, return at once when another thread holds the lock.
+             * @param timeout The longest time to wait in seconds, negative for no limit.
+             * @return True if the lock was acquired.
+             */
+            bool acquire(bool blocking = true, double timeout = -1) {
+                uintptr_t me = detail::thread_token();
+                if (owner.load(std::memory_order_relaxed) == me) {
+                    ++count;
+                    return true;
+                }
+                if (!inner.acquire(blocking, timeout)) return false;
+                owner.store(me, std::memory_order_relaxed);
+                count = 1;
+                return true;
+            }
+
+            /**
+             * @brief Decrease the recursion level and release the lock when it reaches zero.
+             * @throws std::runtime_error if the calling thread does not own the lock.
+             */
+            void release() {
+                if (owner.load(std::memory_order_relaxed) != detail::thread_token()) {
+                    throw std::runtime_error("threading: cannot release un-acquired lock");
+                }
+                if (--count) return;
+                owner.store(0, std::memory_order_relaxed);
+                inner.release();
+            }
+
+            void set_stats(ContentionStats* stats) { inner.set_stats(stats); }
+
+            void lock() { acquire(); }
+            bool try_lock() { return acquire(false); }
+            void unlock() { release(); }
+        };
+
+        /**
+         * @class Condition
+         * @brief A condition variable bound to a Lock or an RLock. wait() and notify() must be
+         * called with the lock held; with an RLock, wait() releases every recursion level and
+         * restores them on wakeup, as in Python. Unlike Python, a Condition created without a
+         * lock uses a (non-recursive) Lock. Waiters sleep on a sequence number that every
+         * notify increments, so a notify between unlocking and sleeping is never lost.
+         */
+        class alignas(detail::CACHE_LINE) Condition {
+        private:
+            Lock own;
+            Lock* mutex = nullptr;       // Exactly one of mutex and reentrant is set
+            RLock* reentrant = nullptr;
+            std::atomic<uint32_t> sequence{0};
+            uint32_t waiters = 0;  // Guarded by the lock
+            ContentionStats* stats = nullptr;
+
+        public:
+            /**
+             * @brief Create a condition with its own lock.
+             */
+            Condition() : mutex(&own) {}
+
+            /**
+             * @brief Create a condition bound to an existing lock.
+             * @param lock The lock; it must outlive the condition.
+             */
+            explicit Condition(Lock& lock) : mutex(&lock) {}
+
+            /**
+             * @brief Create a condition bound to an existing reentrant lock.
+             * @param lock The lock; it must outlive the condition.
+             */
+            explicit Condition(RLock& lock) : reentrant(&lock) {}
+
+            Condition(const Condition&) = delete;
+            Condition& operator=(const Condition&) = delete;
+
+            bool acquire(bool blocking = true, double timeout = -1) {
+                return reentrant ? reentrant->acquire(blocking, timeout) : mutex->acquire(blocking, timeout);
+            }
+
+            void release() {
+                if (reentrant) reentrant->release();
+                else mutex->release();
+            }
+
+            void lock() { acquire(); }
+            void unlock() { release(); }
+
+            /**
+             * @brief Release the lock, sleep until notified or timed out, and reacquire it.
+             * @param timeout The longest time to wait in seconds, negative for no limit.
+             * @return False if the timeout expired.
+             * @throws std::runtime_error if the condition's RLock is not held by this thread.
+             */
+            bool wait(double timeout = -1) {
+                if (reentrant && !reentrant->is_owned()) throw std::runtime_error("threading: cannot wait on un-acquired lock");
+                detail::Contention contention(stats);
+                uint32_t seen = sequence.load(std::memory_order_relaxed);
+                ++waiters;
+                uint32_t depth = 0;
+                if (reentrant) depth = reentrant->release_save();
+                else mutex->release();
+                ++contention.parks;
+                bool in_time = detail::park(sequence, seen, detail::deadline(timeout));
+                if (reentrant) reentrant->acquire_restore(depth);
+                else mutex->acquire();
+                --waiters;
+                return in_time;
+            }
+
+            /**
+             * @brief Wait until a predicate holds.
+             * @param predicate Checked with the lock held, before and after every wakeup.
+             * @param timeout The longest time to wait in seconds, negative for no limit.
+             * @return The last value of the predicate.
+             */
+            template<typename Predicate>
+            bool wait_for(Predicate predicate, double timeout = -1) {
+                int64_t until = detail::deadline(timeout);
+                bool result = predicate();
+                while (!result) {
+                    double left = -1;
+                    if (until >= 0) {
+                        left = (double) (until - detail::now_ns()) / 1e9;
+                        if (left <= 0) break;
+                    }
+                    wait(left);
+                    result = predicate();
+                }
+                return result;
+            }
+
+            /**
+             * @brief Wake up to n waiting threads.
+             * @param n The number of threads.
+             */
+            void notify(int n = 1) {
+                if (!waiters) return;
+                sequence.fetch_add(1, std::memory_order_relaxed);
+                detail::unpark(sequence, n);
+            }
+
+            void notify_all() { notify(INT_MAX); }
+
+            void set_stats(ContentionStats* stats) { this->stats = stats; }
+        };
+
+        /**
+         * @class Semaphore
+         * @brief A counting semaphore. The counter is the futex word itself; release() makes
+         * a system call only when a thread is known to be sleeping.
+         */
+        class alignas(detail::CACHE_LINE) Semaphore {
+        private:
+            std::atomic<uint32_t> value;
+            std::atomic<uint32_t> sleepers{0};
+            ContentionStats* stats = nullptr;
+
+            bool try_take() {
+                uint32_t current = value.load(std::memory_order_relaxed);
+                while (current > 0) {
+                    if (value.compare_exchange_weak(current, current - 1, std::memory_order_acquire, std::memory_order_relaxed)) return true;
+                }
+                return false;
+            }
+
+        public:
+            /**
+             * @brief Create a semaphore.
+             * @param value The initial counter.
+             * @throws std::invalid_argument if value is negative.
+             */
+            explicit Semaphore(int value = 1) : value((uint32_t) value) {
+                if (value < 0) throw std::invalid_argument("threading: semaphore initial value must be >= 0");
+            }
+
+            Semaphore(const Semaphore&) = delete;
+            Semaphore& operator=(const Semaphore&) = delete;
+
+            /**
+             * @brief Decrement the counter, waiting while it is zero.
+             * @param blocking If false, return at once when the counter is zero.
+             * @param timeout The longest time to wait in seconds, negative for no limit.
+             * @return True if the counter was decremented.
+             */
+            bool acquire(bool blocking = true, double timeout = -1) {
+                if (try_take()) return true;
+                if (!blocking || timeout == 0) return false;
+                detail::Contention contention(stats);
+                for (int i = 0; i < detail::SPIN_LIMIT; ++i) {
+                    detail::cpu_relax();
+                    ++contention.spins;
+                    if (try_take()) return true;
+                }
+                int64_t until = detail::deadline(timeout);
+                sleepers.fetch_add(1, std::memory_order_seq_cst);
+                bool taken;
+                while (!(taken = try_take())) {
+                    ++contention.parks;
+                    if (!detail::park(value, 0, until)) break;
+                }
+                sleepers.fetch_sub(1, std::memory_order_relaxed);
+                return taken;
+            }
+
+            /**
+             * @brief Increment the counter by n and wake as many waiters.
+             * @param n The increment.
+             */
+            void release(int n = 1) {
+                if (n < 1) throw std::invalid_argument("threading: n must be one or more");
+                value.fetch_add((uint32_t) n, std::memory_order_seq_cst);
+                if (sleepers.load(std::memory_order_seq_cst)) detail::unpark(value, n);
+            }
+
+            void set_stats(ContentionStats* stats) { this->stats = stats; }
+
+        protected:
+            uint32_t current() const { return value.load(std::memory_order_relaxed); }
+        };
+
+        /**
+         * @class BoundedSemaphore
+         * @brief A semaphore that may not be released above its initial value.
+         */
+        class BoundedSemaphore : public Semaphore {
+        private:
+            uint32_t initial;
+
+        public:
+            explicit BoundedSemaphore(int value = 1) : Semaphore(value), initial((uint32_t) value) {}
+
+            /**
+             * @brief Increment the counter by n.
+             * @param n The increment.
+             * @throws std::invalid_argument if the counter would exceed the initial value.
+             */
+            void release(int n = 1) {
+                if (n >= 1 && current() + (uint32_t) n > initial) throw std::invalid_argument("threading: Semaphore released too many times");
+                Semaphore::release(n);
+            }
+        };
+
+        /**
+         * @class Event
+         * @brief A flag threads can wait for. Bit 0 of the word is the flag, bit 1 is set
+         * while a thread sleeps on it, so set() makes a system call only for sleepers.
+         */
+        class alignas(detail::CACHE_LINE) Event {
+        private:
+            static constexpr uint32_t SET = 1;
+            static constexpr uint32_t SLEEPING = 2;
+
+            std::atomic<uint32_t> state{0};
+            ContentionStats* stats = nullptr;
+
+        public:
+            Event() = default;
+            Event(const Event&) = delete;
+            Event& operator=(const Event&) = delete;
+
+            bool is_set() const { return state.load(std::memory_order_acquire) & SET; }
+
+            /**
+             * @brief Set the flag and wake every waiting thread.
+             */
+            void set() {
+                if (state.exchange(SET, std::memory_order_release) & SLEEPING) detail::unpark(state, INT_MAX);
+            }
+
+            /**
+             * @brief Reset the flag.
+             */
+            void clear() { state.fetch_and(~SET, std::memory_order_relaxed); }
+
+            /**
+             * @brief Wait until the flag is set.
+             * @param timeout The longest time to wait in seconds, negative for no limit.
+             * @return The flag on return, so false means the timeout expired.
+             */
+            bool wait(double timeout = -1) {
+                if (is_set()) return true;
+                if (timeout == 0) return false;
+                detail::Contention contention(stats);
+                for (int i = 0; i < detail::SPIN_LIMIT; ++i) {
+                    detail::cpu_relax();
+                    ++contention.spins;
+                    if (is_set()) return true;
+                }
+                int64_t until = detail::deadline(timeout);
+                for (;;) {
+                    uint32_t current = state.load(std::memory_order_acquire);
+                    if (current & SET) return true;
+                    if (!(current & SLEEPING) && !state.compare_exchange_weak(current, current | SLEEPING, std::memory_order_relaxed)) continue;
+                    ++contention.parks;
+                    if (!detail::park(state, current | SLEEPING, until)) return is_set();
+                }
+            }
+
+            void set_stats(ContentionStats* stats) { this->stats = stats; }
+        };
+
+        /**
+         * @class Barrier
+         * @brief A barrier for a fixed number of threads, following Python's implementation:
+         * the last thread to arrive runs the optional action and releases the others, and
+         * threads of the next round wait until the current one has drained.
+         */
+        class Barrier {
+        private:
+            Condition condition;
+            size_t count_parties;
+            std::function<void()> action;
+            double default_timeout;
+            size_t count = 0;
+            int state = 0;  // 0 filling, 1 draining, -1 resetting, -2 broken
+
+            void break_barrier() {
+                state = -2;
+                condition.notify_all();
+            }
+
+            void enter() {
+                while (state == -1 || state == 1) condition.wait();
+                if (state < 0) throw BrokenBarrierError();
+            }
+
+            void exit() {
+                if (count == 0 && (state == -1 || state == 1)) {
+                    state = 0;
+                    condition.notify_all();
+                }
+            }
+
+        public:
+            /**
+             * @brief Create a barrier.
+             * @param parties The number of threads that must call wait().
+             * @param action Called by one thread when all have arrived, before they are released.
+             * @param timeout The default timeout of wait() in seconds, negative for none.
+             */
+            explicit Barrier(size_t parties, std::function<void()> action = nullptr, double timeout = -1)
+                : count_parties(parties), action(std::move(action)), default_timeout(timeout) {
+                if (parties < 1) throw std::invalid_argument("threading: parties must be >= 1");
+            }
+
+            Barrier(const Barrier&) = delete;
+            Barrier& operator=(const Barrier&) = delete;
+
+            /**
+             * @brief Wait until all parties have called wait().
+             * @param timeout The longest time to wait in seconds; by default the barrier's.
+             * @return A distinct index in [0, parties) for each thread of the round.
+             * @throws BrokenBarrierError if the barrier is or becomes broken or is reset, or the
+             * wait times out (which breaks the barrier).
+             */
+            size_t wait(double timeout = -2) {
+                if (timeout == -2) timeout = default_timeout;
+                condition.acquire();
+                try {
+                    enter();
+                } catch (...) {
+                    condition.release();
+                    throw;
+                }
+                size_t index = count++;
+                bool broken = false;
+                if (index + 1 == count_parties) {
+                    try {
+                        if (action) action();
+                        state = 1;
+                        condition.notify_all();
+                    } catch (...) {
+                        break_barrier();
+                        --count;
+                        exit();
+                        condition.release();
+                        throw;
+                    }
+                } else if (!condition.wait_for([this] { return state != 0; }, timeout)) {
+                    break_barrier();
+                    broken = true;
+                } else if (state < 0) {
+                    broken = true;
+                }
+                --count;
+                exit();
+                condition.release();
+                if (broken) throw BrokenBarrierError();
+                return index;
+            }
+
+            /**
+             * @brief Return the barrier to its initial state. Threads waiting on it receive
+             * BrokenBarrierError.
+             */
+            void reset() {
+                condition.acquire();
+                if (count > 0) {
+                    if (state == 0) state = -1;
+                    else if (state == -2) state = -1;
+                } else {
+                    state = 0;
+                }
+                condition.notify_all();
+                condition.release();
+            }
+
+            /**
+             * @brief Put the barrier into the broken state; current and future wait() calls
+             * throw BrokenBarrierError until reset().
+             */
+            void abort() {
+                condition.acquire();
+                break_barrier();
+                condition.release();
+            }
+
+            size_t parties() const { return count_parties; }
+
+            size_t n_waiting() {
+                condition.acquire();
+                size_t waiting = state == 0 ? count : 0;
+                condition.release();
+                return waiting;
+            }
+
+            bool broken() {
+                condition.acquire();
+                bool result = state == -2;
+                condition.release();
+                return result;
+            }
+        };
+    }
+}
@@ -0,0 +1,473 @@
+// EasyCpp - Timeit : Measure Execution Time of Small Code Snippets
+// Copyright (C) 2025  C14147
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+/**
+ * @file EasyCpp/Timeit/Timeit.h
+ * @brief This file implements a timeit module similar to Python's timeit.
+ *        Timings are taken with a calibrated TSC clock, repeated, and summarized with
+ *        robust statistics (min / median / MAD) after outlier rejection. On Linux the
+ *        hardware counters (cycles, instructions, cache misses, branch misses) can be
+ *        read through perf_event_open as well.
+ */
+#pragma once
+#define _EASYCPP_TIMEIT_VERSION "1.0.0"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <ostream>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define _EASYCPP_TIMEIT_HAS_TSC 1
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+#endif
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace easycpp {
+
+    /**
+     * @brief Prevent the compiler from optimizing away a value computed in a timed loop.
+     * @param value The value that must be considered used.
+     */
+    template<typename T>
+    inline void do_not_optimize(T&& value) {
+#if defined(__GNUC__) || defined(__clang__)
+        asm volatile("" : : "g"(&value) : "memory");
+#else
+        static volatile const void* sink;
+        sink = &value;
+#endif
+    }
+
+    /**
+     * @class TscClock
+     * @brief A monotonic tick clock backed by the time stamp counter when available.
+     * The tick rate is calibrated once against std::chrono::steady_clock. On targets
+     * without a TSC the ticks are steady_clock nanoseconds.
+     */
+    class TscClock {
+    public:
+        /**
+         * @brief Read the current tick count.
+         * @return The current tick count.
+         */
+        static uint64_t now() {
+#ifdef _EASYCPP_TIMEIT_HAS_TSC
+            return __rdtsc();
+#else
+            return (uint64_t) std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+        }
+
+        /**
+         * @brief Get the calibrated number of ticks per second.
+         * @return The tick frequency in Hz.
+         */
+        static double frequency() {
+            static const double hz = calibrate();
+            return hz;
+        }
+
+        /**
+         * @brief Convert a tick delta to seconds.
+         * @param ticks The number of ticks.
+         * @return The duration in seconds.
+         */
+        static double to_seconds(uint64_t ticks) {
+            return (double) ticks / frequency();
+        }
+
+    private:
+        static double calibrate() {
+#ifdef _EASYCPP_TIMEIT_HAS_TSC
+            // Take the best of a few short windows so a preemption does not skew the rate.
+            double best = 0.0;
+            double best_error = 1e300;
+            for (int round = 0; round < 3; ++round) {
+                auto t0 = std::chrono::steady_clock::now();
+                uint64_t c0 = now();
+                auto t1 = t0;
+                while (t1 - t0 < std::chrono::milliseconds(10)) {
+                    t1 = std::chrono::steady_clock::now();
+                }
+                uint64_t c1 = now();
+                double seconds = std::chrono::duration<double>(t1 - t0).count();
+                double hz = (double) (c1 - c0) / seconds;
+                double error = std::fabs(seconds - 0.010);
+                if (error < best_error) {
+                    best_error = error;
+                    best = hz;
+                }
+            }
+            return best;
+#else
+            return 1e9;
+#endif
+        }
+    };
+
+    /**
+     * @struct PerfCounters
+     * @brief Hardware performance counters averaged per loop iteration.
+     * valid is false when the counters are unavailable (non-Linux, or perf_event_paranoid forbids it).
+     */
+    struct PerfCounters {
+        bool valid = false;
+        double cycles = 0.0;
+        double instructions = 0.0;
+        double cache_misses = 0.0;
+        double branch_misses = 0.0;
+
+        /**
+         * @brief Instructions retired per cycle.
+         * @return The IPC, or 0 if no cycles were counted.
+         */
+        double ipc() const {
+            return cycles > 0.0 ? instructions / cycles : 0.0;
+        }
+    };
+
+    /**
+     * @class PerfEventGroup
+     * @brief A group of perf_event_open counters (cycles, instructions, cache misses, branch misses)
+     * for the calling thread. All methods are no-ops when perf events are unavailable.
+     */
+    class PerfEventGroup {
+    public:
+        static constexpr int COUNTERS = 4;
+
+        PerfEventGroup() {
+#if defined(__linux__)
+            const uint64_t configs[COUNTERS] = {
+                PERF_COUNT_HW_CPU_CYCLES,
+                PERF_COUNT_HW_INSTRUCTIONS,
+                PERF_COUNT_HW_CACHE_MISSES,
+                PERF_COUNT_HW_BRANCH_MISSES
+            };
+            for (int i = 0; i < COUNTERS; ++i) {
+                perf_event_attr attr;
+                std::memset(&attr, 0, sizeof(attr));
+                attr.type = PERF_TYPE_HARDWARE;
+                attr.size = sizeof(attr);
+                attr.config = configs[i];
+                attr.disabled = i == 0 ? 1 : 0;
+                attr.exclude_kernel = 1;
+                attr.exclude_hv = 1;
+                attr.read_format = PERF_FORMAT_GROUP;
+                fds[i] = (int) syscall(SYS_perf_event_open, &attr, 0, -1, i == 0 ? -1 : fds[0], 0);
+                if (fds[i] < 0) {
+                    close_all();
+                    return;
+                }
+            }
+#endif
+        }
+
+        PerfEventGroup(const PerfEventGroup&) = delete;
+        PerfEventGroup& operator=(const PerfEventGroup&) = delete;
+
+        ~PerfEventGroup() {
+            close_all();
+        }
+
+        /**
+         * @brief Check whether the counters were opened successfully.
+         * @return true if counters are available.
+         */
+        bool valid() const {
+            return fds[0] >= 0;
+        }
+
+        /**
+         * @brief Reset and start counting.
+         */
+        void start() {
+#if defined(__linux__)
+            if (!valid()) return;
+            ioctl(fds[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+            ioctl(fds[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+#endif
+        }
+
+        /**
+         * @brief Stop counting and read the totals.
+         * @param iterations The number of loop iterations the totals are divided by.
+         * @return The counters per iteration.
+         */
+        PerfCounters stop(size_t iterations) {
+            PerfCounters result;
+#if defined(__linux__)
+            if (!valid()) return result;
+            ioctl(fds[0], PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+            uint64_t values[1 + COUNTERS] = {0};
+            if (::read(fds[0], values, sizeof(values)) != (ssize_t) sizeof(values) || values[0] != COUNTERS) {
+                return result;
+            }
+            double n = iterations ? (double) iterations : 1.0;
+            result.valid = true;
+            result.cycles = (double) values[1] / n;
+            result.instructions = (double) values[2] / n;
+            result.cache_misses = (double) values[3] / n;
+            result.branch_misses = (double) values[4] / n;
+#else
+            (void) iterations;
+#endif
+            return result;
+        }
+
+    private:
+        int fds[COUNTERS] = {-1, -1, -1, -1};
+
+        void close_all() {
+#if defined(__linux__)
+            for (int i = COUNTERS - 1; i >= 0; --i) {
+                if (fds[i] >= 0) ::close(fds[i]);
+                fds[i] = -1;
+            }
+#endif
+        }
+    };
+
+    /**
+     * @struct TimeitResult
+     * @brief The summary of a timeit run. All times are seconds per loop iteration.
+     */
+    struct TimeitResult {
+        size_t number = 0;              // Loop iterations per sample
+        size_t repeat = 0;              // Number of samples taken
+        std::vector<double> samples;    // Per-iteration time of every sample, in measurement order
+        double min = 0.0;
+        double median = 0.0;
+        double mad = 0.0;               // Median absolute deviation of the kept samples
+        double mean = 0.0;
+        size_t outliers = 0;            // Samples rejected before computing median / MAD / mean
+        PerfCounters counters;          // Per-iteration hardware counters of the fastest sample
+
+        /**
+         * @brief Print the result in the style of `python -m timeit`.
+         * @param os The output stream.
+         * @param result The result to be printed.
+         * @return The output stream after printing.
+         */
+        friend std::ostream& operator<<(std::ostream& os, const TimeitResult& result) {
+            os << result.number << " loops, best of " << result.repeat << ": " << format_seconds(result.min)
+               << " per loop (median " << format_seconds(result.median)
+               << " +- " << format_seconds(result.mad) << ", " << result.outliers << " outliers)";
+            if (result.counters.valid) {
+                os << "; " << result.counters.cycles << " cycles, " << result.counters.instructions
+                   << " instructions, " << result.counters.cache_misses << " cache misses, "
+                   << result.counters.branch_misses << " branch misses per loop";
+            }
+            return os;
+        }
+
+    private:
+        static std::string format_seconds(double seconds) {
+            static const char* units[] = {"sec", "msec", "usec", "nsec"};
+            int unit = 0;
+            while (unit < 3 && seconds < 1.0 && seconds != 0.0) {
+                seconds *= 1000.0;
+                ++unit;
+            }
+            char buffer[48];
+            std::snprintf(buffer, sizeof(buffer), "%.3g %s", seconds, units[unit]);
+            return buffer;
+        }
+    };
+
+    /**
+     * @class Timer
+     * @brief Class for timing the execution of a callable, mirroring Python's timeit.Timer.
+     * @tparam Fn The callable type. Its return value (if any) is kept alive with do_not_optimize.
+     */
+    template<typename Fn>
+    class Timer {
+    public:
+        /**
+         * @brief Construct a timer for the given callable.
+         * @param fn The callable to be timed.
+         * @param counters Whether to read hardware performance counters for every sample.
+         */
+        explicit Timer(Fn fn, bool counters = false) : fn(std::move(fn)), counters(counters) {}
+
+        /**
+         * @brief Time number executions of the callable.
+         * @param number The number of loop iterations.
+         * @return The total time in seconds.
+         */
+        double timeit(size_t number = 1000000) {
+            uint64_t start = TscClock::now();
+            run(number);
+            return TscClock::to_seconds(TscClock::now() - start);
+        }
+
+        /**
+         * @brief Call timeit() repeat times.
+         * @param repeat The number of samples.
+         * @param number The number of loop iterations per sample.
+         * @return The total time of every sample in seconds.
+         */
+        std::vector<double> repeat(size_t repeat = 5, size_t number = 1000000) {
+            std::vector<double> result;
+            result.reserve(repeat);
+            for (size_t i = 0; i < repeat; ++i) {
+                result.push_back(timeit(number));
+            }
+            return result;
+        }
+
+        /**
+         * @brief Determine a loop count so that one sample takes at least min_time seconds.
+         * The count follows the 1, 2, 5, 10, 20, 50, ... sequence like Python's autorange().
+         * @param min_time The minimal duration of one sample in seconds.
+         * @return The calibrated loop count.
+         */
+        size_t autorange(double min_time = 0.2) {
+            for (size_t scale = 1;; scale *= 10) {
+                for (size_t factor : {1, 2, 5}) {
+                    size_t number = scale * factor;
+                    if (timeit(number) >= min_time) return number;
+                }
+            }
+        }
+
+        /**
+         * @brief Take repeat samples and summarize them with robust statistics.
+         * Samples further than 3 scaled MADs from the median are rejected as outliers
+         * before median, MAD and mean are computed. min always uses all samples.
+         * @param number The loop count per sample, or 0 to calibrate it with autorange().
+         * @param repeat The number of samples.
+         * @return The summary of the run.
+         */
+        TimeitResult measure(size_t number = 0, size_t repeat = 5) {
+            if (repeat == 0) repeat = 1;
+            if (number == 0) number = autorange();
+            TimeitResult result;
+            result.number = number;
+            result.repeat = repeat;
+            result.samples.reserve(repeat);
+
+            double best = 1e300;
+            for (size_t i = 0; i < repeat; ++i) {
+                PerfCounters sample_counters;
+                double seconds;
+                if (counters) {
+                    PerfEventGroup group;
+                    group.start();
+                    seconds = timeit(number);
+                    sample_counters = group.stop(number);
+                } else {
+                    seconds = timeit(number);
+                }
+                double per_loop = seconds / (double) number;
+                result.samples.push_back(per_loop);
+                if (per_loop < best) {
+                    best = per_loop;
+                    result.counters = sample_counters;
+                }
+            }
+            summarize(result);
+            return result;
+        }
+
+    private:
+        Fn fn;
+        bool counters;
+
+        void run(size_t number) {
+            for (size_t i = 0; i < number; ++i) {
+                if constexpr (std::is_void_v<std::invoke_result_t<Fn&>>) {
+                    fn();
+                } else {
+                    auto value = fn();
+                    do_not_optimize(value);
+                }
+            }
+        }
+
+        static double median_of(std::vector<double> values) {
+            if (values.empty()) return 0.0;
+            size_t mid = values.size() / 2;
+            std::nth_element(values.begin(), values.begin() + mid, values.end());
+            double upper = values[mid];
+            if (values.size() % 2) return upper;
+            double lower = *std::max_element(values.begin(), values.begin() + mid);
+            return (lower + upper) / 2.0;
+        }
+
+        static double mad_of(const std::vector<double>& values, double median) {
+            std::vector<double> deviations;
+            deviations.reserve(values.size());
+            for (double value : values) deviations.push_back(std::fabs(value - median));
+            return median_of(std::move(deviations));
+        }
+
+        static void summarize(TimeitResult& result) {
+            const std::vector<double>& samples = result.samples;
+            result.min = *std::min_element(samples.begin(), samples.end());
+            double median = median_of(samples);
+            double mad = mad_of(samples, median);
+
+            std::vector<double> kept;
+            kept.reserve(samples.size());
+            // 1.4826 scales the MAD to the standard deviation of a normal distribution.
+            double limit = 3.0 * 1.4826 * mad;
+            for (double sample : samples) {
+                if (mad == 0.0 || std::fabs(sample - median) <= limit) kept.push_back(sample);
+            }
+            result.outliers = samples.size() - kept.size();
+
+            result.median = median_of(kept);
+            result.mad = mad_of(kept, result.median);
+            double sum = 0.0;
+            for (double sample : kept) sum += sample;
+            result.mean = sum / (double) kept.size();
+        }
+    };
+
+    /**
+     * @brief Time a callable and summarize the samples, like Python's timeit.repeat().
+     * @param fn The callable to be timed.
+     * @param number The loop count per sample, or 0 to calibrate it automatically.
+     * @param repeat The number of samples.
+     * @param counters Whether to read hardware performance counters (Linux only).
+     * @return The summary of the run.
+     */
+    template<typename Fn>
+    TimeitResult timeit(Fn&& fn, size_t number = 0, size_t repeat = 5, bool counters = false) {
+        Timer<std::decay_t<Fn>> timer(std::forward<Fn>(fn), counters);
+        return timer.measure(number, repeat);
+    }
+}
@@ -0,0 +1,597 @@
+// EasyCpp - Tracemalloc : Sampling Allocation Profiler for EasyCpp Containers
+// Copyright (C) 2025  C14147
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+/**
+ * @file EasyCpp/Tracemalloc/Tracemalloc.h
+ * @brief This file implements a counterpart of Python's tracemalloc module for the memory
+ *        held by EasyCpp containers (String, List, Dict and the Xml arena). Tracing is off
+ *        until start() is called; until then a container allocation costs one relaxed load.
+ *        Allocations can be sampled at a byte rate, as heap profilers do: on average one
+ *        sample is taken per sample_rate bytes, and each sample is weighted so that sizes
+ *        and counts stay unbiased estimates. A sample records the call stack, interned
+ *        into a shared table, and snapshots report live bytes per allocation site, diffs
+ *        between snapshots and JSON output. Stacks are captured with backtrace() where
+ *        the C library has it; link with -rdynamic to get function names in the output.
+ */
+#pragma once
+#define _EASYCPP_TRACEMALLOC_VERSION "1.0.0"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#if defined(__GLIBC__) || defined(__APPLE__)
+#define _EASYCPP_TRACEMALLOC_HAS_BACKTRACE 1
+#include <cxxabi.h>
+#include <execinfo.h>
+#endif
+
+#ifdef _MSC_VER
+#define _EASYCPP_TRACEMALLOC_NOINLINE __declspec(noinline)
+#else
+#define _EASYCPP_TRACEMALLOC_NOINLINE __attribute__((noinline))
+#endif
+
+namespace easycpp {
+    namespace tracemalloc {
+        namespace detail {
+            inline constexpr size_t SHARDS = 64;
+            inline constexpr size_t FILTER_BITS = size_t(1) << 20;
+            inline constexpr size_t MAX_FRAMES = 64;
+
+            // Read on every container allocation and free, so kept out of State.
+            inline std::atomic<bool> tracing{false};
+            inline std::atomic<uint64_t> generation{0};
+            // One bit per hash of a sampled address; most frees miss it and skip the shards.
+            inline std::atomic<uint64_t> filter[FILTER_BITS / 64];
+
+            struct Trace {
+                const char* domain;
+                size_t size;
+                uint32_t stack;
+                double weight;      // 1 / the probability that this allocation was sampled
+            };
+
+            struct Shard {
+                std::mutex mutex;
+                std::unordered_map<const void*, Trace> traces;
+            };
+
+            struct State {
+                std::mutex control;
+                std::atomic<size_t> nframe{1};
+                std::atomic<double> sample_rate{0};
+                std::atomic<double> current{0};
+                std::atomic<double> peak{0};
+                Shard shards[SHARDS];
+                std::mutex stacks_mutex;
+                std::unordered_map<std::string, uint32_t> stack_ids;
+                std::vector<std::vector<void*>> stacks;
+            };
+
+            struct ThreadState {
+                uint64_t generation = 0;
+                int64_t countdown = 0;
+                uint64_t random = 0;
+            };
+
+            inline thread_local ThreadState thread_state;
+
+            inline State& state() {
+                // Never destroyed: containers in static storage may be freed after it would be.
+                static State* instance = new State();
+                return *instance;
+            }
+
+            inline size_t address_hash(const void* ptr) {
+                uint64_t x = (uint64_t) reinterpret_cast<uintptr_t>(ptr);
+                x ^= x >> 33;
+                x *= 0xff51afd7ed558ccdULL;
+                x ^= x >> 33;
+                return (size_t) x;
+            }
+
+            // The bytes until the next sample: exponentially distributed with mean rate.
+            inline int64_t next_countdown(ThreadState& thread, double rate) {
+                if (rate <= 0) return 0;
+                if (!thread.random) {
+                    thread.random = address_hash(&thread) | 1;
+                    thread.random ^= (uint64_t) std::hash<std::thread::id>()(std::this_thread::get_id());
+                    if (!thread.random) thread.random = 1;
+                }
+                thread.random ^= thread.random << 13;
+                thread.random ^= thread.random >> 7;
+                thread.random ^= thread.random << 17;
+                double u = ((double) (thread.random >> 11) + 1.0) / 9007199254740992.0;
+                return (int64_t) (-std::log(u) * rate) + 1;
+            }
+
+            inline uint32_t intern(void* const* frames, size_t count) {
+                State& s = state();
+                std::string key(reinterpret_cast<const char*>(frames), count * sizeof(void*));
+                std::lock_guard<std::mutex> lock(s.stacks_mutex);
+                auto it = s.stack_ids.find(key);
+                if (it != s.stack_ids.end()) return it->second;
+                uint32_t id = (uint32_t) s.stacks.size();
+                s.stacks.emplace_back(frames, frames + count);
+                s.stack_ids.emplace(std::move(key), id);
+                return id;
+            }
+
+            _EASYCPP_TRACEMALLOC_NOINLINE inline void record(const void* ptr, size_t size, const char* domain) {
+                State& s = state();
+                ThreadState& thread = thread_state;
+                double rate = s.sample_rate.load(std::memory_order_relaxed);
+                uint64_t current_generation = generation.load(std::memory_order_acquire);
+                if (thread.generation != current_generation) {
+                    thread.generation = current_generation;
+                    thread.countdown = next_countdown(thread, rate);
+                    if ((thread.countdown -= (int64_t) size) > 0) return;
+                }
+                double weight = 1;
+                if (rate > 0) {
+                    weight = 1 / -std::expm1(-(double) (size ? size : 1) / rate);
+                    thread.countdown = next_countdown(thread, rate);
+                }
+
+                void* frames[MAX_FRAMES + 4];
+                size_t first = 0, count = 0;
+#ifdef _EASYCPP_TRACEMALLOC_HAS_BACKTRACE
+                size_t nframe = std::min(s.nframe.load(std::memory_order_relaxed), MAX_FRAMES);
+                int captured = backtrace(frames, (int) nframe + 4);
+                // Drop record() and anything above it (sanitizers wrap backtrace()).
+                void* caller = __builtin_return_address(0);
+                while (first < (size_t) captured && frames[first] != caller) ++first;
+                if (first == (size_t) captured) first = std::min<size_t>(1, first);
+                count = std::min(nframe, (size_t) captured - first);
+#endif
+                uint32_t stack = intern(frames + first, count);
+
+                Shard& shard = s.shards[address_hash(ptr) % SHARDS];
+                {
+                    std::lock_guard<std::mutex> lock(shard.mutex);
+                    shard.traces[ptr] = Trace{domain, size, stack, weight};
+                }
+                size_t bit = address_hash(ptr) % FILTER_BITS;
+                filter[bit / 64].fetch_or(uint64_t(1) << (bit % 64), std::memory_order_relaxed);
+
+                s.current.fetch_add((double) size * weight, std::memory_order_relaxed);
+                double now = s.current.load(std::memory_order_relaxed), peak = s.peak.load(std::memory_order_relaxed);
+                while (now > peak && !s.peak.compare_exchange_weak(peak, now, std::memory_order_relaxed)) {}
+            }
+
+            _EASYCPP_TRACEMALLOC_NOINLINE inline void forget(const void* ptr) {
+                State& s = state();
+                Shard& shard = s.shards[address_hash(ptr) % SHARDS];
+                double bytes;
+                {
+                    std::lock_guard<std::mutex> lock(shard.mutex);
+                    auto it = shard.traces.find(ptr);
+                    if (it == shard.traces.end()) return;
+                    bytes = (double) it->second.size * it->second.weight;
+                    shard.traces.erase(it);
+                }
+                s.current.fetch_sub(bytes, std::memory_order_relaxed);
+            }
+
+            /**
+             * @brief Called by a container after it allocates memory it will hold.
+             * @param ptr The memory.
+             * @param size The size in bytes.
+             * @param domain The container, a string literal such as "String".
+             */
+            inline void allocated(const void* ptr, size_t size, const char* domain) {
+                if (!tracing.load(std::memory_order_relaxed) || !ptr) return;
+                ThreadState& thread = thread_state;
+                if (thread.generation == generation.load(std::memory_order_relaxed) && (thread.countdown -= (int64_t) size) > 0) return;
+                record(ptr, size, domain);
+            }
+
+            /**
+             * @brief Called by a container before it frees memory reported to allocated().
+             * @param ptr The memory.
+             */
+            inline void freed(const void* ptr) {
+                if (!tracing.load(std::memory_order_relaxed) || !ptr) return;
+                size_t bit = address_hash(ptr) % FILTER_BITS;
+                if (!(filter[bit / 64].load(std::memory_order_relaxed) & (uint64_t(1) << (bit % 64)))) return;
+                forget(ptr);
+            }
+
+            inline void clear() {
+                State& s = state();
+                for (Shard& shard : s.shards) {
+                    std::lock_guard<std::mutex> lock(shard.mutex);
+                    shard.traces.clear();
+                }
+                for (auto& word : filter) word.store(0, std::memory_order_relaxed);
+                s.current.store(0, std::memory_order_relaxed);
+                s.peak.store(0, std::memory_order_relaxed);
+                generation.fetch_add(1, std::memory_order_release);
+            }
+
+            inline void json_string(std::string& out, const std::string& text) {
+                out += '"';
+                for (unsigned char c : text) {
+                    if (c == '"' || c == '\\') {
+                        out += '\\';
+                        out += (char) c;
+                    } else if (c < 0x20) {
+                        char escaped[8];
+                        std::snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+                        out += escaped;
+                    } else {
+                        out += (char) c;
+                    }
+                }
+                out += '"';
+            }
+
+            /**
+             * @brief Find the function containing a code address, for tracemalloc and profile.
+             * @param address The address.
+             * @param name Set to the demangled function name.
+             * @param offset Set to the offset into it, such as "+0x1c".
+             * @param module If given, set to the file of the executable or library.
+             * @return Whether the symbol is known (exported, see -rdynamic).
+             */
+            inline bool symbolize(const void* address, std::string& name, std::string& offset, std::string* module = nullptr) {
+#ifdef _EASYCPP_TRACEMALLOC_HAS_BACKTRACE
+                void* frame = const_cast<void*>(address);
+                char** symbols = backtrace_symbols(&frame, 1);
+                if (!symbols) return false;
+                std::string symbol = symbols[0];
+                std::free(symbols);
+                // glibc writes "module(name+0x1c) [0x...]".
+                size_t open = symbol.find('('), plus = symbol.find('+', open), close = symbol.find(')', open);
+                if (module) *module = symbol.substr(0, std::min(open, symbol.find(' ')));
+                if (open == std::string::npos || plus == std::string::npos || close == std::string::npos || plus > close || plus == open + 1) return false;
+                name = symbol.substr(open + 1, plus - open - 1);
+                offset = symbol.substr(plus, close - plus);
+                int status = 0;
+                char* demangled = abi::__cxa_demangle(name.c_str(), nullptr, nullptr, &status);
+                if (status == 0 && demangled) name = demangled;
+                std::free(demangled);
+                return true;
+#else
+                (void) address;
+                (void) name;
+                (void) offset;
+                (void) module;
+                return false;
+#endif
+            }
+        }
+
+        /**
+         * @brief Describe a code address: the demangled function name and offset when the
+         * symbol is exported (see -rdynamic), otherwise the address.
+         * @param address A return address from a Traceback.
+         * @return The description.
+         */
+        inline std::string format_frame(const void* address) {
+            char hex[32];
+            std::snprintf(hex, sizeof(hex), "%p", address);
+            std::string name, offset;
+            if (!detail::symbolize(address, name, offset)) return hex;
+            return name + offset + " [" + hex + "]";
+        }
+
+        /**
+         * @struct Traceback
+         * @brief The return addresses of an allocation's call stack, most recent first.
+         */
+        struct Traceback {
+            std::vector<void*> frames;
+
+            /**
+             * @brief Describe every frame with format_frame().
+             * @return One line per frame.
+             */
+            std::vector<std::string> format() const {
+                std::vector<std::string> lines;
+                for (void* frame : frames) lines.push_back(format_frame(frame));
+                return lines;
+            }
+
+            bool operator==(const Traceback& other) const { return frames == other.frames; }
+            bool operator<(const Traceback& other) const { return frames < other.frames; }
+        };
+
+        /**
+         * @struct Statistic
+         * @brief The live memory of one allocation site. With sampling, size and count are
+         * estimates.
+         */
+        struct Statistic {
+            Traceback traceback;
+            std::string domain;
+            size_t size = 0;
+            size_t count = 0;
+        };
+
+        /**
+         * @struct StatisticDiff
+         * @brief The live memory of one allocation site in a snapshot and its change since
+         * an older one.
+         */
+        struct StatisticDiff {
+            Traceback traceback;
+            std::string domain;
+            size_t size = 0;
+            int64_t size_diff = 0;
+            size_t count = 0;
+            int64_t count_diff = 0;
+        };
+
+        /**
+         * @brief Format statistics as a JSON array of objects with domain, size, count and
+         * traceback (each frame an object with address and symbol).
+         */
+        inline std::string to_json(const std::vector<Statistic>& statistics);
+
+        /**
+         * @brief Format statistic diffs as a JSON array, like to_json() for statistics, with
+         * size_diff and count_diff added.
+         */
+        inline std::string to_json(const std::vector<StatisticDiff>& diffs);
+
+        /**
+         * @class Snapshot
+         * @brief The traces of the live allocations at the time of take_snapshot().
+         */
+        class Snapshot {
+        private:
+            struct Site {
+                std::string domain;
+                Traceback traceback;
+                double size = 0;
+                double count = 0;
+            };
+
+            std::vector<Site> sites;
+
+            friend Snapshot take_snapshot();
+
+            using Key = std::pair<std::string, Traceback>;
+
+            static bool by_top_frame(const char* key_type) {
+                if (!key_type || std::strcmp(key_type, "traceback") == 0) return false;
+                if (std::strcmp(key_type, "lineno") == 0) return true;
+                throw std::invalid_argument(std::string("tracemalloc: unknown key_type: ") + key_type);
+            }
+
+            std::map<Key, std::pair<double, double>> group(bool top_frame) const {
+                std::map<Key, std::pair<double, double>> groups;
+                for (const Site& site : sites) {
+                    Traceback traceback = site.traceback;
+                    if (top_frame && traceback.frames.size() > 1) traceback.frames.resize(1);
+                    auto& total = groups[{site.domain, std::move(traceback)}];
+                    total.first += site.size;
+                    total.second += site.count;
+                }
+                return groups;
+            }
+
+        public:
+            /**
+             * @brief Get the live memory per allocation site, largest first.
+             * @param key_type "traceback" groups by the whole stack, "lineno" by its most
+             *        recent frame only.
+             * @return The statistics.
+             * @throws std::invalid_argument if key_type is neither.
+             */
+            std::vector<Statistic> statistics(const char* key_type = "traceback") const {
+                std::vector<Statistic> result;
+                for (auto& [key, total] : group(by_top_frame(key_type))) {
+                    result.push_back(Statistic{key.second, key.first, (size_t) std::llround(total.first), (size_t) std::llround(total.second)});
+                }
+                std::stable_sort(result.begin(), result.end(), [](const Statistic& a, const Statistic& b) {
+                    return a.size != b.size ? a.size > b.size : a.count > b.count;
+                });
+                return result;
+            }
+
+            /**
+             * @brief Compare with an older snapshot, as Snapshot.compare_to() does.
+             * @param old The older snapshot.
+             * @param key_type As for statistics().
+             * @return One diff per site present in either snapshot, largest absolute size
+             *         change first.
+             */
+            std::vector<StatisticDiff> compare_to(const Snapshot& old, const char* key_type = "traceback") const {
+                bool top_frame = by_top_frame(key_type);
+                auto now = group(top_frame), before = old.group(top_frame);
+                std::vector<StatisticDiff> result;
+                for (auto& [key, total] : now) {
+                    auto it = before.find(key);
+                    double old_size = it == before.end() ? 0 : it->second.first, old_count = it == before.end() ? 0 : it->second.second;
+                    size_t size = (size_t) std::llround(total.first), count = (size_t) std::llround(total.second);
+                    result.push_back(StatisticDiff{key.second, key.first, size, (int64_t) size - std::llround(old_size),
+                                                   count, (int64_t) count - std::llround(old_count)});
+                }
+                for (auto& [key, total] : before) {
+                    if (now.count(key)) continue;
+                    result.push_back(StatisticDiff{key.second, key.first, 0, -std::llround(total.first), 0, -std::llround(total.second)});
+                }
+                std::stable_sort(result.begin(), result.end(), [](const StatisticDiff& a, const StatisticDiff& b) {
+                    int64_t x = a.size_diff < 0 ? -a.size_diff : a.size_diff, y = b.size_diff < 0 ? -b.size_diff : b.size_diff;
+                    return x != y ? x > y : a.size > b.size;
+                });
+                return result;
+            }
+
+            /**
+             * @brief Format statistics(key_type) as JSON, see to_json().
+             */
+            std::string to_json(const char* key_type = "traceback") const {
+                return tracemalloc::to_json(statistics(key_type));
+            }
+        };
+
+        namespace detail {
+            inline void json_statistic(std::string& out, const Traceback& traceback, const std::string& domain, size_t size, size_t count) {
+                out += "{\"domain\":";
+                json_string(out, domain);
+                out += ",\"size\":" + std::to_string(size) + ",\"count\":" + std::to_string(count) + ",\"traceback\":[";
+                for (size_t i = 0; i < traceback.frames.size(); ++i) {
+                    char hex[32];
+                    std::snprintf(hex, sizeof(hex), "%p", traceback.frames[i]);
+                    out += i ? ",{\"address\":" : "{\"address\":";
+                    json_string(out, hex);
+                    out += ",\"symbol\":";
+                    json_string(out, format_frame(traceback.frames[i]));
+                    out += '}';
+                }
+                out += ']';
+            }
+        }
+
+        inline std::string to_json(const std::vector<Statistic>& statistics) {
+            std::string out = "[";
+            for (size_t i = 0; i < statistics.size(); ++i) {
+                if (i) out += ',';
+                detail::json_statistic(out, statistics[i].traceback, statistics[i].domain, statistics[i].size, statistics[i].count);
+                out += '}';
+            }
+            return out + ']';
+        }
+
+        inline std::string to_json(const std::vector<StatisticDiff>& diffs) {
+            std::string out = "[";
+            for (size_t i = 0; i < diffs.size(); ++i) {
+                if (i) out += ',';
+                detail::json_statistic(out, diffs[i].traceback, diffs[i].domain, diffs[i].size, diffs[i].count);
+                out += ",\"size_diff\":" + std::to_string(diffs[i].size_diff) + ",\"count_diff\":" + std::to_string(diffs[i].count_diff) + '}';
+            }
+            return out + ']';
+        }
+
+        /**
+         * @brief Start tracing container allocations, clearing earlier traces.
+         * @param nframe The number of frames stored per trace, at most 64.
+         * @param sample_rate The mean number of bytes between samples. 0 traces every
+         *        allocation.
+         * @throws std::invalid_argument if nframe is 0 or above 64.
+         */
+        inline void start(size_t nframe = 1, size_t sample_rate = 0) {
+            if (nframe < 1 || nframe > detail::MAX_FRAMES) throw std::invalid_argument("tracemalloc: nframe must be in range [1; 64]");
+            detail::State& s = detail::state();
+            std::lock_guard<std::mutex> lock(s.control);
+            detail::tracing.store(false, std::memory_order_relaxed);
+            s.nframe.store(nframe, std::memory_order_relaxed);
+            s.sample_rate.store((double) sample_rate, std::memory_order_relaxed);
+            detail::clear();
+            detail::tracing.store(true, std::memory_order_release);
+        }
+
+        /**
+         * @brief Stop tracing and clear the traces.
+         */
+        inline void stop() {
+            detail::State& s = detail::state();
+            std::lock_guard<std::mutex> lock(s.control);
+            detail::tracing.store(false, std::memory_order_relaxed);
+            detail::clear();
+        }
+
+        /**
+         * @brief Check whether allocations are being traced.
+         */
+        inline bool is_tracing() {
+            return detail::tracing.load(std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief Get the number of frames stored per trace.
+         */
+        inline size_t get_traceback_limit() {
+            return detail::state().nframe.load(std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief Get the mean number of bytes between samples; 0 if every allocation is traced.
+         */
+        inline size_t get_sample_rate() {
+            return (size_t) detail::state().sample_rate.load(std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief Get the traced memory, as tracemalloc.get_traced_memory() does.
+         * @return The current and the peak size in bytes (estimates when sampling).
+         */
+        inline std::pair<size_t, size_t> get_traced_memory() {
+            detail::State& s = detail::state();
+            double current = std::max(0.0, s.current.load(std::memory_order_relaxed));
+            return {(size_t) std::llround(current), (size_t) std::llround(s.peak.load(std::memory_order_relaxed))};
+        }
+
+        /**
+         * @brief Set the peak of get_traced_memory() to the current size.
+         */
+        inline void reset_peak() {
+            detail::State& s = detail::state();
+            s.peak.store(s.current.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief Clear the traces, keep tracing.
+         */
+        inline void clear_traces() {
+            detail::State& s = detail::state();
+            std::lock_guard<std::mutex> lock(s.control);
+            detail::clear();
+        }
+
+        /**
+         * @brief Take a snapshot of the live traced allocations.
+         * @return The snapshot.
+         * @throws std::runtime_error if tracing is off.
+         */
+        inline Snapshot take_snapshot() {
+            if (!is_tracing()) throw std::runtime_error("the tracemalloc module must be tracing memory allocations to take a snapshot");
+            detail::State& s = detail::state();
+            std::vector<detail::Trace> traces;
+            for (detail::Shard& shard : s.shards) {
+                std::lock_guard<std::mutex> lock(shard.mutex);
+                for (auto& entry : shard.traces) traces.push_back(entry.second);
+            }
+            Snapshot snapshot;
+            std::map<std::pair<uint32_t, const char*>, size_t> index;
+            std::lock_guard<std::mutex> lock(s.stacks_mutex);
+            for (const detail::Trace& trace : traces) {
+                auto [it, inserted] = index.emplace(std::make_pair(trace.stack, trace.domain), snapshot.sites.size());
+                if (inserted) snapshot.sites.push_back({trace.domain, Traceback{s.stacks[trace.stack]}, 0, 0});
+                snapshot.sites[it->second].size += (double) trace.size * trace.weight;
+                snapshot.sites[it->second].count += trace.weight;
+            }
+            return snapshot;
+        }
+    }
+}
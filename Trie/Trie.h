@@ -0,0 +1,777 @@
+// EasyCpp - Trie : Adaptive Radix Tree
+// Copyright (C) 2025  C14147
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+/**
+ * @file EasyCpp/Trie/Trie.h
+ * @brief This file implements Trie, an adaptive radix tree (ART) mapping string keys to values.
+ *        Inner nodes grow and shrink between four layouts (4, 16, 48 and 256 children) so that
+ *        sparse levels stay small and dense levels are a single array index, and chains of
+ *        single-child nodes are compressed into a prefix stored in the node. Besides exact
+ *        lookup it answers longest-prefix matches (routing) and visits all keys under a prefix
+ *        in byte order (autocomplete), which a hash map cannot.
+ */
+#pragma once
+#define _EASYCPP_TRIE_VERSION "1.0.0"
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define _EASYCPP_TRIE_SSE2
+#endif
+
+#include <String/String.h>
+
+namespace easycpp {
+    /**
+     * @class Trie
+     * @brief An ordered map from byte-string keys to values of type V, as an adaptive radix tree.
+     * Lookups cost O(key length) independent of the number of keys. Keys may be prefixes of
+     * other keys. Not thread-safe for concurrent writers.
+     */
+    template<typename V>
+    class Trie {
+    private:
+        static constexpr uint32_t MAX_PREFIX = 12;  // Prefix bytes stored in a node; longer prefixes are checked at the leaf
+
+        enum NodeType : uint8_t { NODE4, NODE16, NODE48, NODE256 };
+
+        struct Leaf {
+            std::string key;
+            V value;
+        };
+
+        struct Node {
+            NodeType type;
+            uint16_t count = 0;
+            uint32_t prefix_length = 0;
+            uint8_t prefix[MAX_PREFIX];
+            Leaf* terminal = nullptr;  // The key that ends exactly after this node's prefix
+
+            explicit Node(NodeType type) : type(type) {}
+        };
+
+        struct Node4 : Node {
+            uint8_t keys[4] = {};
+            void* children[4] = {};
+            Node4() : Node(NODE4) {}
+        };
+
+        struct Node16 : Node {
+            uint8_t keys[16] = {};
+            void* children[16] = {};
+            Node16() : Node(NODE16) {}
+        };
+
+        struct Node48 : Node {
+            uint8_t index[256] = {};  // Slot + 1, or 0 when the byte has no child
+            void* children[48] = {};
+            Node48() : Node(NODE48) {}
+        };
+
+        struct Node256 : Node {
+            void* children[256] = {};
+            Node256() : Node(NODE256) {}
+        };
+
+        // Children are tagged pointers: the low bit marks a Leaf.
+        static bool is_leaf(const void* p) { return (uintptr_t) p & 1; }
+        static Leaf* as_leaf(const void* p) { return (Leaf*) ((uintptr_t) p & ~(uintptr_t) 1); }
+        static void* tag(Leaf* leaf) { return (void*) ((uintptr_t) leaf | 1); }
+
+        void* root = nullptr;
+        size_t count = 0;
+
+        static void* const* find_child(const Node* node, uint8_t byte) {
+            switch (node->type) {
+                case NODE4: {
+                    const Node4* n = static_cast<const Node4*>(node);
+                    for (int i = 0; i < n->count; ++i) {
+                        if (n->keys[i] == byte) return &n->children[i];
+                    }
+                    return nullptr;
+                }
+                case NODE16: {
+                    const Node16* n = static_cast<const Node16*>(node);
+#ifdef _EASYCPP_TRIE_SSE2
+                    __m128i match = _mm_cmpeq_epi8(_mm_set1_epi8((char) byte), _mm_loadu_si128((const __m128i*) n->keys));
+                    unsigned mask = (unsigned) _mm_movemask_epi8(match) & ((1u << n->count) - 1);
+                    return mask ? &n->children[std::countr_zero(mask)] : nullptr;
+#else
+                    for (int i = 0; i < n->count; ++i) {
+                        if (n->keys[i] == byte) return &n->children[i];
+                    }
+                    return nullptr;
+#endif
+                }
+                case NODE48: {
+                    const Node48* n = static_cast<const Node48*>(node);
+                    return n->index[byte] ? &n->children[n->index[byte] - 1] : nullptr;
+                }
+                default: {
+                    const Node256* n = static_cast<const Node256*>(node);
+                    return n->children[byte] ? &n->children[byte] : nullptr;
+                }
+            }
+        }
+
+        static void* mutable_child(Node* node, uint8_t byte, void*** slot) {
+            *slot = const_cast<void**>(find_child(node, byte));
+            return *slot ? **slot : nullptr;
+        }
+
+        static void copy_header(Node* to, const Node* from) {
+            to->count = from->count;
+            to->prefix_length = from->prefix_length;
+            std::memcpy(to->prefix, from->prefix, MAX_PREFIX);
+            to->terminal = from->terminal;
+        }
+
+        static void add_child(void** ref, Node* node, uint8_t byte, void* child) {
+            switch (node->type) {
+                case NODE4: {
+                    Node4* n = static_cast<Node4*>(node);
+                    if (n->count < 4) {
+                        int i = 0;
+                        while (i < n->count && n->keys[i] < byte) ++i;
+                        std::memmove(n->keys + i + 1, n->keys + i, n->count - i);
+                        std::memmove(n->children + i + 1, n->children + i, (n->count - i) * sizeof(void*));
+                        n->keys[i] = byte;
+                        n->children[i] = child;
+                        ++n->count;
+                        return;
+                    }
+                    Node16* grown = new Node16();
+                    copy_header(grown, n);
+                    std::memcpy(grown->keys, n->keys, 4);
+                    std::memcpy(grown->children, n->children, 4 * sizeof(void*));
+                    delete n;
+                    *ref = grown;
+                    add_child(ref, grown, byte, child);
+                    return;
+                }
+                case NODE16: {
+                    Node16* n = static_cast<Node16*>(node);
+                    if (n->count < 16) {
+                        int i = 0;
+                        while (i < n->count && n->keys[i] < byte) ++i;
+                        std::memmove(n->keys + i + 1, n->keys + i, n->count - i);
+                        std::memmove(n->children + i + 1, n->children + i, (n->count - i) * sizeof(void*));
+                        n->keys[i] = byte;
+                        n->children[i] = child;
+                        ++n->count;
+                        return;
+                    }
+                    Node48* grown = new Node48();
+                    copy_header(grown, n);
+                    for (int i = 0; i < 16; ++i) {
+                        grown->children[i] = n->children[i];
+                        grown->index[n->keys[i]] = (uint8_t) (i + 1);
+                    }
+                    delete n;
+                    *ref = grown;
+                    add_child(ref, grown, byte, child);
+                    return;
+                }
+                case NODE48: {
+                    Node48* n = static_cast<Node48*>(node);
+                    if (n->count < 48) {
+                        // Slots are kept dense: removal moves the last slot into the hole.
+                        n->children[n->count] = child;
+                        n->index[byte] = (uint8_t) (n->count + 1);
+                        ++n->count;
+                        return;
+                    }
+                    Node256* grown = new Node256();
+                    copy_header(grown, n);
+                    for (int b = 0; b < 256; ++b) {
+                        if (n->index[b]) grown->children[b] = n->children[n->index[b] - 1];
+                    }
+                    delete n;
+                    *ref = grown;
+                    add_child(ref, grown, byte, child);
+                    return;
+                }
+                default: {
+                    Node256* n = static_cast<Node256*>(node);
+                    n->children[byte] = child;
+                    ++n->count;
+                    return;
+                }
+            }
+        }
+
+        // Replace a node that has a single child and no terminal by that child.
+        static void collapse(void** ref, Node4* node) {
+            void* child = node->children[0];
+            if (!is_leaf(child)) {
+                Node* next = static_cast<Node*>(child);
+                uint8_t merged[MAX_PREFIX];
+                uint32_t length = std::min(node->prefix_length, MAX_PREFIX);
+                std::memcpy(merged, node->prefix, length);
+                if (length < MAX_PREFIX) merged[length++] = node->keys[0];
+                uint32_t rest = std::min(next->prefix_length, MAX_PREFIX - length);
+                std::memcpy(merged + length, next->prefix, rest);
+                std::memcpy(next->prefix, merged, length + rest);
+                next->prefix_length += node->prefix_length + 1;
+            }
+            *ref = child;
+            delete node;
+        }
+
+        static void remove_child(void** ref, Node* node, uint8_t byte) {
+            switch (node->type) {
+                case NODE4: {
+                    Node4* n = static_cast<Node4*>(node);
+                    int i = 0;
+                    while (n->keys[i] != byte) ++i;
+                    std::memmove(n->keys + i, n->keys + i + 1, n->count - i - 1);
+                    std::memmove(n->children + i, n->children + i + 1, (n->count - i - 1) * sizeof(void*));
+                    --n->count;
+                    break;
+                }
+                case NODE16: {
+                    Node16* n = static_cast<Node16*>(node);
+                    int i = 0;
+                    while (n->keys[i] != byte) ++i;
+                    std::memmove(n->keys + i, n->keys + i + 1, n->count - i - 1);
+                    std::memmove(n->children + i, n->children + i + 1, (n->count - i - 1) * sizeof(void*));
+                    if (--n->count == 3) {
+                        Node4* shrunk = new Node4();
+                        copy_header(shrunk, n);
+                        std::memcpy(shrunk->keys, n->keys, 3);
+                        std::memcpy(shrunk->children, n->children, 3 * sizeof(void*));
+                        delete n;
+                        *ref = shrunk;
+                    }
+                    return;
+                }
+                case NODE48: {
+                    Node48* n = static_cast<Node48*>(node);
+                    int slot = n->index[byte] - 1;
+                    n->index[byte] = 0;
+                    int last = --n->count;
+                    if (slot != last) {
+                        n->children[slot] = n->children[last];
+                        for (int b = 0; b < 256; ++b) {
+                            if (n->index[b] == last + 1) {
+                                n->index[b] = (uint8_t) (slot + 1);
+                                break;
+                            }
+                        }
+                    }
+                    n->children[last] = nullptr;
+                    if (n->count == 12) {
+                        Node16* shrunk = new Node16();
+                        copy_header(shrunk, n);
+                        int i = 0;
+                        for (int b = 0; b < 256; ++b) {
+                            if (n->index[b]) {
+                                shrunk->keys[i] = (uint8_t) b;
+                                shrunk->children[i++] = n->children[n->index[b] - 1];
+                            }
+                        }
+                        delete n;
+                        *ref = shrunk;
+                    }
+                    return;
+                }
+                default: {
+                    Node256* n = static_cast<Node256*>(node);
+                    n->children[byte] = nullptr;
+                    if (--n->count == 37) {
+                        Node48* shrunk = new Node48();
+                        copy_header(shrunk, n);
+                        int i = 0;
+                        for (int b = 0; b < 256; ++b) {
+                            if (n->children[b]) {
+                                shrunk->children[i] = n->children[b];
+                                shrunk->index[b] = (uint8_t) ++i;
+                            }
+                        }
+                        delete n;
+                        *ref = shrunk;
+                    }
+                    return;
+                }
+            }
+            after_node4_removal(ref, static_cast<Node4*>(node));
+        }
+
+        static void after_node4_removal(void** ref, Node4* node) {
+            if (node->count == 1 && !node->terminal) {
+                collapse(ref, node);
+            } else if (node->count == 0) {
+                *ref = node->terminal ? tag(node->terminal) : nullptr;
+                delete node;
+            }
+        }
+
+        static const Leaf* minimum(const void* p) {
+            while (p && !is_leaf(p)) {
+                const Node* node = static_cast<const Node*>(p);
+                if (node->terminal) return node->terminal;
+                switch (node->type) {
+                    case NODE4: p = static_cast<const Node4*>(node)->children[0]; break;
+                    case NODE16: p = static_cast<const Node16*>(node)->children[0]; break;
+                    case NODE48: {
+                        const Node48* n = static_cast<const Node48*>(node);
+                        int b = 0;
+                        while (!n->index[b]) ++b;
+                        p = n->children[n->index[b] - 1];
+                        break;
+                    }
+                    default: {
+                        const Node256* n = static_cast<const Node256*>(node);
+                        int b = 0;
+                        while (!n->children[b]) ++b;
+                        p = n->children[b];
+                        break;
+                    }
+                }
+            }
+            return p ? as_leaf(p) : nullptr;
+        }
+
+        // The number of prefix bytes of node matching key from depth on.
+        static uint32_t prefix_match(const Node* node, std::string_view key, size_t depth) {
+            uint32_t limit = (uint32_t) std::min<size_t>(node->prefix_length, key.size() - depth);
+            uint32_t stored = std::min(limit, MAX_PREFIX);
+            uint32_t i = 0;
+            for (; i < stored; ++i) {
+                if (node->prefix[i] != (uint8_t) key[depth + i]) return i;
+            }
+            if (i < limit) {
+                // Bytes beyond MAX_PREFIX are shared by every key below, so read them from any leaf.
+                const std::string& full = minimum(node)->key;
+                for (; i < limit; ++i) {
+                    if (full[depth + i] != key[depth + i]) return i;
+                }
+            }
+            return i;
+        }
+
+        static Leaf* new_leaf(std::string_view key, V&& value) {
+            return new Leaf{std::string(key), std::move(value)};
+        }
+
+        static void destroy(void* p) {
+            if (!p) return;
+            if (is_leaf(p)) {
+                delete as_leaf(p);
+                return;
+            }
+            Node* node = static_cast<Node*>(p);
+            delete node->terminal;
+            switch (node->type) {
+                case NODE4: {
+                    Node4* n = static_cast<Node4*>(node);
+                    for (int i = 0; i < n->count; ++i) destroy(n->children[i]);
+                    delete n;
+                    break;
+                }
+                case NODE16: {
+                    Node16* n = static_cast<Node16*>(node);
+                    for (int i = 0; i < n->count; ++i) destroy(n->children[i]);
+                    delete n;
+                    break;
+                }
+                case NODE48: {
+                    Node48* n = static_cast<Node48*>(node);
+                    for (int i = 0; i < n->count; ++i) destroy(n->children[i]);
+                    delete n;
+                    break;
+                }
+                default: {
+                    Node256* n = static_cast<Node256*>(node);
+                    for (void* child : n->children) destroy(child);
+                    delete n;
+                    break;
+                }
+            }
+        }
+
+        // Visit every leaf below p in key order; stops when fn returns false.
+        template<typename Fn>
+        static bool walk(void* p, Fn& fn) {
+            if (is_leaf(p)) {
+                Leaf* leaf = as_leaf(p);
+                return fn(leaf->key, leaf->value);
+            }
+            Node* node = static_cast<Node*>(p);
+            if (node->terminal && !fn(node->terminal->key, node->terminal->value)) return false;
+            switch (node->type) {
+                case NODE4: {
+                    Node4* n = static_cast<Node4*>(node);
+                    for (int i = 0; i < n->count; ++i) {
+                        if (!walk(n->children[i], fn)) return false;
+                    }
+                    return true;
+                }
+                case NODE16: {
+                    Node16* n = static_cast<Node16*>(node);
+                    for (int i = 0; i < n->count; ++i) {
+                        if (!walk(n->children[i], fn)) return false;
+                    }
+                    return true;
+                }
+                case NODE48: {
+                    Node48* n = static_cast<Node48*>(node);
+                    for (int b = 0; b < 256; ++b) {
+                        if (n->index[b] && !walk(n->children[n->index[b] - 1], fn)) return false;
+                    }
+                    return true;
+                }
+                default: {
+                    Node256* n = static_cast<Node256*>(node);
+                    for (void* child : n->children) {
+                        if (child && !walk(child, fn)) return false;
+                    }
+                    return true;
+                }
+            }
+        }
+
+        static std::string_view view(const String& key) {
+            return std::string_view((const char*) key ? (const char*) key : "", key.len());
+        }
+
+        bool erase_at(void** ref, std::string_view key, size_t depth) {
+            void* p = *ref;
+            if (!p) return false;
+            if (is_leaf(p)) {
+                if (as_leaf(p)->key != key) return false;
+                delete as_leaf(p);
+                *ref = nullptr;
+                return true;
+            }
+            Node* node = static_cast<Node*>(p);
+            if (prefix_match(node, key, depth) != node->prefix_length) return false;
+            depth += node->prefix_length;
+            if (depth == key.size()) {
+                if (!node->terminal) return false;
+                delete node->terminal;
+                node->terminal = nullptr;
+                if (node->type == NODE4) after_node4_removal(ref, static_cast<Node4*>(node));
+                return true;
+            }
+            uint8_t byte = (uint8_t) key[depth];
+            void** slot;
+            void* child = mutable_child(node, byte, &slot);
+            if (!child) return false;
+            if (is_leaf(child)) {
+                if (as_leaf(child)->key != key) return false;
+                delete as_leaf(child);
+                remove_child(ref, node, byte);
+                return true;
+            }
+            return erase_at(slot, key, depth + 1);
+        }
+
+    public:
+        Trie() = default;
+
+        Trie(const Trie&) = delete;
+        Trie& operator=(const Trie&) = delete;
+
+        Trie(Trie&& other) noexcept : root(other.root), count(other.count) {
+            other.root = nullptr;
+            other.count = 0;
+        }
+
+        Trie& operator=(Trie&& other) noexcept {
+            if (this != &other) {
+                destroy(root);
+                root = std::exchange(other.root, nullptr);
+                count = std::exchange(other.count, 0);
+            }
+            return *this;
+        }
+
+        ~Trie() { destroy(root); }
+
+        size_t size() const { return count; }
+        bool empty() const { return count == 0; }
+
+        void clear() {
+            destroy(root);
+            root = nullptr;
+            count = 0;
+        }
+
+        /**
+         * @brief Insert a key, or replace the value of an existing key.
+         * @param key The key.
+         * @param value The value.
+         * @return true if the key was new.
+         */
+        bool insert(std::string_view key, V value) {
+            void** ref = &root;
+            size_t depth = 0;
+            for (;;) {
+                void* p = *ref;
+                if (!p) {
+                    *ref = tag(new_leaf(key, std::move(value)));
+                    ++count;
+                    return true;
+                }
+                if (is_leaf(p)) {
+                    Leaf* existing = as_leaf(p);
+                    if (existing->key == key) {
+                        existing->value = std::move(value);
+                        return false;
+                    }
+                    // Split the leaf: a new node holds the common part of both keys as its prefix.
+                    const std::string& other = existing->key;
+                    size_t common = 0;
+                    while (depth + common < other.size() && depth + common < key.size() && other[depth + common] == key[depth + common]) ++common;
+                    Node4* node = new Node4();
+                    node->prefix_length = (uint32_t) common;
+                    std::memcpy(node->prefix, key.data() + depth, std::min<size_t>(common, MAX_PREFIX));
+                    size_t split = depth + common;
+                    void* self = node;
+                    if (other.size() == split) node->terminal = existing;
+                    else add_child(&self, node, (uint8_t) other[split], p);
+                    Leaf* leaf = new_leaf(key, std::move(value));
+                    if (key.size() == split) node->terminal = leaf;
+                    else add_child(&self, node, (uint8_t) key[split], tag(leaf));
+                    *ref = node;
+                    ++count;
+                    return true;
+                }
+                Node* node = static_cast<Node*>(p);
+                if (node->prefix_length) {
+                    uint32_t matched = prefix_match(node, key, depth);
+                    if (matched < node->prefix_length) {
+                        // The key leaves the compressed path: split the prefix at the mismatch.
+                        Node4* parent = new Node4();
+                        parent->prefix_length = matched;
+                        std::memcpy(parent->prefix, node->prefix, std::min(matched, MAX_PREFIX));
+                        uint8_t edge;
+                        if (node->prefix_length <= MAX_PREFIX) {
+                            edge = node->prefix[matched];
+                            node->prefix_length -= matched + 1;
+                            std::memmove(node->prefix, node->prefix + matched + 1, std::min(node->prefix_length, MAX_PREFIX));
+                        } else {
+                            const std::string& full = minimum(node)->key;
+                            edge = (uint8_t) full[depth + matched];
+                            node->prefix_length -= matched + 1;
+                            std::memcpy(node->prefix, full.data() + depth + matched + 1, std::min(node->prefix_length, MAX_PREFIX));
+                        }
+                        void* self = parent;
+                        add_child(&self, parent, edge, node);
+                        Leaf* leaf = new_leaf(key, std::move(value));
+                        if (key.size() == depth + matched) parent->terminal = leaf;
+                        else add_child(&self, parent, (uint8_t) key[depth + matched], tag(leaf));
+                        *ref = parent;
+                        ++count;
+                        return true;
+                    }
+                    depth += node->prefix_length;
+                }
+                if (depth == key.size()) {
+                    if (node->terminal) {
+                        node->terminal->value = std::move(value);
+                        return false;
+                    }
+                    node->terminal = new_leaf(key, std::move(value));
+                    ++count;
+                    return true;
+                }
+                void** slot;
+                void* child = mutable_child(node, (uint8_t) key[depth], &slot);
+                if (!child) {
+                    add_child(ref, node, (uint8_t) key[depth], tag(new_leaf(key, std::move(value))));
+                    ++count;
+                    return true;
+                }
+                ref = slot;
+                ++depth;
+            }
+        }
+
+        template<typename S, std::enable_if_t<std::is_same_v<S, String>, int> = 0>
+        bool insert(const S& key, V value) { return insert(view(key), std::move(value)); }
+
+        /**
+         * @brief Find the value of a key.
+         * @param key The key.
+         * @return A pointer to the value, or nullptr if the key is absent.
+         */
+        V* find(std::string_view key) const {
+            const void* p = root;
+            size_t depth = 0;
+            while (p) {
+                if (is_leaf(p)) {
+                    Leaf* leaf = as_leaf(p);
+                    return leaf->key == key ? &leaf->value : nullptr;
+                }
+                const Node* node = static_cast<const Node*>(p);
+                if (node->prefix_length) {
+                    // Compare the stored bytes only; the full key is checked at the leaf.
+                    if (key.size() - depth < node->prefix_length) return nullptr;
+                    uint32_t stored = std::min(node->prefix_length, MAX_PREFIX);
+                    if (std::memcmp(node->prefix, key.data() + depth, stored) != 0) return nullptr;
+                    depth += node->prefix_length;
+                }
+                if (depth == key.size()) {
+                    return node->terminal && node->terminal->key == key ? &node->terminal->value : nullptr;
+                }
+                void* const* slot = find_child(node, (uint8_t) key[depth]);
+                p = slot ? *slot : nullptr;
+                ++depth;
+            }
+            return nullptr;
+        }
+
+        template<typename S, std::enable_if_t<std::is_same_v<S, String>, int> = 0>
+        V* find(const S& key) const { return find(view(key)); }
+
+        bool contains(std::string_view key) const { return find(key) != nullptr; }
+        template<typename S, std::enable_if_t<std::is_same_v<S, String>, int> = 0>
+        bool contains(const S& key) const { return find(view(key)) != nullptr; }
+
+        /**
+         * @brief Remove a key.
+         * @param key The key.
+         * @return true if the key was present.
+         */
+        bool erase(std::string_view key) {
+            if (!erase_at(&root, key, 0)) return false;
+            --count;
+            return true;
+        }
+
+        template<typename S, std::enable_if_t<std::is_same_v<S, String>, int> = 0>
+        bool erase(const S& key) { return erase(view(key)); }
+
+        /**
+         * @brief Find the longest stored key that is a prefix of the given key (route matching).
+         * @param key The key.
+         * @param length Receives the length of the matching key, if not null.
+         * @return A pointer to its value, or nullptr if no stored key is a prefix of key.
+         */
+        V* longest_prefix(std::string_view key, size_t* length = nullptr) const {
+            const Leaf* best = nullptr;
+            auto consider = [&](const Leaf* leaf) {
+                if (leaf->key.size() <= key.size() && std::memcmp(leaf->key.data(), key.data(), leaf->key.size()) == 0) best = leaf;
+            };
+            const void* p = root;
+            size_t depth = 0;
+            while (p) {
+                if (is_leaf(p)) {
+                    consider(as_leaf(p));
+                    break;
+                }
+                const Node* node = static_cast<const Node*>(p);
+                if (node->prefix_length) {
+                    if (key.size() - depth < node->prefix_length) break;
+                    uint32_t stored = std::min(node->prefix_length, MAX_PREFIX);
+                    if (std::memcmp(node->prefix, key.data() + depth, stored) != 0) break;
+                    depth += node->prefix_length;
+                }
+                if (node->terminal) consider(node->terminal);
+                if (depth == key.size()) break;
+                void* const* slot = find_child(node, (uint8_t) key[depth]);
+                p = slot ? *slot : nullptr;
+                ++depth;
+            }
+            if (!best) return nullptr;
+            if (length) *length = best->key.size();
+            return &const_cast<Leaf*>(best)->value;
+        }
+
+        template<typename S, std::enable_if_t<std::is_same_v<S, String>, int> = 0>
+        V* longest_prefix(const S& key, size_t* length = nullptr) const { return longest_prefix(view(key), length); }
+
+        /**
+         * @brief Call fn(key, value) for every key starting with prefix, in byte order.
+         * If fn returns bool, returning false stops the iteration.
+         * @param prefix The prefix; empty visits every key.
+         * @param fn The callback, taking (std::string_view, V&).
+         */
+        template<typename Fn>
+        void for_each_prefix(std::string_view prefix, Fn&& fn) const {
+            auto visit = [&fn](std::string_view key, V& value) {
+                if constexpr (std::is_same_v<decltype(fn(key, value)), bool>) return fn(key, value);
+                else {
+                    fn(key, value);
+                    return true;
+                }
+            };
+            void* p = root;
+            size_t depth = 0;
+            while (p) {
+                if (is_leaf(p)) {
+                    Leaf* leaf = as_leaf(p);
+                    if (prefix.empty() || (leaf->key.size() >= prefix.size() && std::memcmp(leaf->key.data(), prefix.data(), prefix.size()) == 0)) {
+                        visit(leaf->key, leaf->value);
+                    }
+                    return;
+                }
+                Node* node = static_cast<Node*>(p);
+                if (node->prefix_length) {
+                    size_t rest = prefix.size() - depth;
+                    uint32_t matched = prefix_match(node, prefix, depth);
+                    if (matched < std::min<size_t>(node->prefix_length, rest)) return;
+                    if (rest <= node->prefix_length) break;
+                    depth += node->prefix_length;
+                }
+                if (depth == prefix.size()) break;
+                void* const* slot = find_child(node, (uint8_t) prefix[depth]);
+                p = slot ? *slot : nullptr;
+                ++depth;
+            }
+            if (p) walk(p, visit);
+        }
+
+        template<typename S, typename Fn, std::enable_if_t<std::is_same_v<S, String>, int> = 0>
+        void for_each_prefix(const S& prefix, Fn&& fn) const { for_each_prefix(view(prefix), std::forward<Fn>(fn)); }
+
+        /**
+         * @brief Call fn(key, value) for every key in byte order.
+         */
+        template<typename Fn>
+        void for_each(Fn&& fn) const { for_each_prefix(std::string_view(), std::forward<Fn>(fn)); }
+
+        /**
+         * @brief List the keys starting with prefix, in byte order (autocomplete).
+         * @param prefix The prefix.
+         * @param limit The maximum number of keys; 0 means no limit.
+         * @return The keys.
+         */
+        std::vector<String> keys_with_prefix(std::string_view prefix, size_t limit = 0) const {
+            std::vector<String> keys;
+            for_each_prefix(prefix, [&](std::string_view key, V&) {
+                keys.emplace_back(key.data(), key.size());
+                return limit == 0 || keys.size() < limit;
+            });
+            return keys;
+        }
+
+        template<typename S, std::enable_if_t<std::is_same_v<S, String>, int> = 0>
+        std::vector<String> keys_with_prefix(const S& prefix, size_t limit = 0) const { return keys_with_prefix(view(prefix), limit); }
+    };
+}
@@ -0,0 +1,416 @@
+// EasyCpp - Urllib : URL Parsing and Quoting
+// Copyright (C) 2025  C14147
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+/**
+ * @file EasyCpp/Urllib/Parse.h
+ * @brief This file implements the parts of Python's urllib.parse used to build and take apart
+ *        URLs: urlsplit/urlunsplit, quote/quote_plus, unquote/unquote_plus, parse_qsl and
+ *        urlencode. urlsplit returns views into the URL. quote() counts the bytes to escape
+ *        first, so the result is allocated once, and copies runs of unreserved characters
+ *        (letters, digits, "_.-~") in bulk; both passes classify 16 bytes at a time with SSE2.
+ */
+#pragma once
+#define _EASYCPP_URLLIB_VERSION "1.0.0"
+
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define _EASYCPP_URLLIB_SSE2
+#endif
+
+namespace easycpp {
+    namespace urllib {
+        namespace parse {
+            namespace detail {
+                inline bool is_unreserved(unsigned char c) {
+                    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_' || c == '.' ||
+                           c == '-' || c == '~';
+                }
+
+#ifdef _EASYCPP_URLLIB_SSE2
+                // Bit i is set if byte i of the block is not unreserved. Bytes >= 0x80 compare
+                // as negative and fall outside every range.
+                inline unsigned reserved_mask(const char* p) {
+                    __m128i block = _mm_loadu_si128((const __m128i*) p);
+                    auto in_range = [&](char low, char high) {
+                        return _mm_and_si128(_mm_cmpgt_epi8(block, _mm_set1_epi8((char) (low - 1))),
+                                             _mm_cmplt_epi8(block, _mm_set1_epi8((char) (high + 1))));
+                    };
+                    __m128i unreserved = _mm_or_si128(_mm_or_si128(in_range('a', 'z'), in_range('A', 'Z')), in_range('0', '9'));
+                    unreserved = _mm_or_si128(unreserved, _mm_or_si128(_mm_cmpeq_epi8(block, _mm_set1_epi8('_')), in_range('-', '.')));
+                    unreserved = _mm_or_si128(unreserved, _mm_cmpeq_epi8(block, _mm_set1_epi8('~')));
+                    return ~(unsigned) _mm_movemask_epi8(unreserved) & 0xFFFF;
+                }
+#endif
+
+                // First byte of [p, end) that is not unreserved, or end.
+                inline const char* find_reserved(const char* p, const char* end) {
+#ifdef _EASYCPP_URLLIB_SSE2
+                    for (; end - p >= 16; p += 16) {
+                        unsigned mask = reserved_mask(p);
+                        if (mask) return p + std::countr_zero(mask);
+                    }
+#endif
+                    while (p < end && is_unreserved((unsigned char) *p)) ++p;
+                    return p;
+                }
+
+                inline std::string quote(std::string_view s, std::string_view safe, bool plus) {
+                    std::array<bool, 256> keep{};
+                    for (char c : safe) keep[(unsigned char) c] = true;
+                    if (plus) keep[' '] = true;  // Becomes '+', same length
+
+                    const char* p = s.data();
+                    const char* end = p + s.size();
+                    size_t escapes = 0;
+                    const char* tail = p;
+#ifdef _EASYCPP_URLLIB_SSE2
+                    for (; end - tail >= 16; tail += 16) {
+                        for (unsigned mask = reserved_mask(tail); mask; mask &= mask - 1) {
+                            escapes += !keep[(unsigned char) tail[std::countr_zero(mask)]];
+                        }
+                    }
+#endif
+                    for (; tail < end; ++tail) escapes += !is_unreserved((unsigned char) *tail) && !keep[(unsigned char) *tail];
+                    if (!escapes && !(plus && memchr(p, ' ', s.size()))) return std::string(s);
+
+                    static constexpr char HEX[] = "0123456789ABCDEF";
+                    std::string out(s.size() + 2 * escapes, '\0');
+                    char* o = out.data();
+                    while (p < end) {
+                        const char* q = find_reserved(p, end);
+                        memcpy(o, p, (size_t) (q - p));
+                        o += q - p;
+                        if (q == end) break;
+                        unsigned char c = (unsigned char) *q;
+                        if (plus && c == ' ') {
+                            *o++ = '+';
+                        } else if (keep[c]) {
+                            *o++ = (char) c;
+                        } else {
+                            *o++ = '%';
+                            *o++ = HEX[c >> 4];
+                            *o++ = HEX[c & 15];
+                        }
+                        p = q + 1;
+                    }
+                    return out;
+                }
+
+                inline int hex_value(char c) {
+                    if (c >= '0' && c <= '9') return c - '0';
+                    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+                    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+                    return -1;
+                }
+
+                inline std::string unquote(std::string_view s, bool plus) {
+                    std::string out;
+                    out.reserve(s.size());
+                    size_t i = 0;
+                    while (i < s.size()) {
+                        size_t next = s.find_first_of(plus ? "%+" : "%", i);
+                        if (next == std::string_view::npos) {
+                            out.append(s, i, std::string_view::npos);
+                            break;
+                        }
+                        out.append(s, i, next - i);
+                        if (s[next] == '+') {
+                            out += ' ';
+                            i = next + 1;
+                            continue;
+                        }
+                        int high = next + 2 < s.size() ? hex_value(s[next + 1]) : -1;
+                        int low = high >= 0 ? hex_value(s[next + 2]) : -1;
+                        if (low < 0) {
+                            out += '%';
+                            i = next + 1;
+                        } else {
+                            out += (char) (high << 4 | low);
+                            i = next + 3;
+                        }
+                    }
+                    return out;
+                }
+            }
+
+            /**
+             * @struct SplitResult
+             * @brief The five components of a URL: scheme://netloc/path?query#fragment. All are
+             * views into the URL passed to urlsplit().
+             */
+            struct SplitResult {
+                std::string_view scheme;
+                std::string_view netloc;
+                std::string_view path;
+                std::string_view query;
+                std::string_view fragment;
+
+                /**
+                 * @brief Get the user name of the netloc ("user" in user:pass@host).
+                 */
+                std::string_view username() const {
+                    size_t at = netloc.rfind('@');
+                    if (at == std::string_view::npos) return std::string_view();
+                    return netloc.substr(0, std::min(netloc.find(':'), at));
+                }
+
+                /**
+                 * @brief Get the password of the netloc ("pass" in user:pass@host).
+                 */
+                std::string_view password() const {
+                    size_t at = netloc.rfind('@');
+                    if (at == std::string_view::npos) return std::string_view();
+                    size_t colon = netloc.substr(0, at).find(':');
+                    return colon == std::string_view::npos ? std::string_view() : netloc.substr(colon + 1, at - colon - 1);
+                }
+
+                /**
+                 * @brief Get the host as written, without user info, port or IPv6 brackets.
+                 * Unlike Python, the host is not lowercased.
+                 */
+                std::string_view hostname() const { return host_and_port().first; }
+
+                /**
+                 * @brief Get the port.
+                 * @return The port, or -1 if the netloc has none.
+                 * @throws std::invalid_argument if the port is not a number in 0-65535.
+                 */
+                int port() const {
+                    std::string_view text = host_and_port().second;
+                    if (text.empty()) return -1;
+                    int value = 0;
+                    for (char c : text) {
+                        if (c < '0' || c > '9') throw std::invalid_argument("urlsplit: port '" + std::string(text) + "' is not a number");
+                        value = value * 10 + (c - '0');
+                        if (value > 65535) throw std::invalid_argument("urlsplit: port out of range 0-65535");
+                    }
+                    return value;
+                }
+
+                /**
+                 * @brief Join the components back into a URL, as urlunsplit().
+                 */
+                std::string geturl() const;
+
+            private:
+                std::pair<std::string_view, std::string_view> host_and_port() const {
+                    size_t at = netloc.rfind('@');
+                    std::string_view host = at == std::string_view::npos ? netloc : netloc.substr(at + 1);
+                    std::string_view port;
+                    size_t open = host.find('[');
+                    if (open != std::string_view::npos) {
+                        std::string_view bracketed = host.substr(open + 1);
+                        size_t close = bracketed.find(']');
+                        std::string_view after = close == std::string_view::npos ? std::string_view() : bracketed.substr(close + 1);
+                        size_t colon = after.find(':');
+                        if (colon != std::string_view::npos) port = after.substr(colon + 1);
+                        host = bracketed.substr(0, close);
+                    } else {
+                        size_t colon = host.find(':');
+                        if (colon != std::string_view::npos) {
+                            port = host.substr(colon + 1);
+                            host = host.substr(0, colon);
+                        }
+                    }
+                    return {host, port};
+                }
+            };
+
+            /**
+             * @brief Split a URL into scheme, netloc, path, query and fragment. The scheme is
+             * returned as written (Python lowercases it); tabs and newlines are not removed.
+             * @param url The URL; the result refers into it.
+             * @param allow_fragments Whether '#' starts a fragment.
+             * @return The components.
+             * @throws std::invalid_argument if the netloc has unbalanced IPv6 brackets.
+             */
+            inline SplitResult urlsplit(std::string_view url, bool allow_fragments = true) {
+                SplitResult result;
+                while (!url.empty() && (unsigned char) url.front() <= ' ') url.remove_prefix(1);
+                size_t colon = url.find(':');
+                if (colon != std::string_view::npos && colon > 0 && ((url[0] | 0x20) >= 'a' && (url[0] | 0x20) <= 'z')) {
+                    bool valid = true;
+                    for (char c : url.substr(0, colon)) {
+                        if (!(((c | 0x20) >= 'a' && (c | 0x20) <= 'z') || (c >= '0' && c <= '9') || c == '+' || c == '-' || c == '.')) {
+                            valid = false;
+                            break;
+                        }
+                    }
+                    if (valid) {
+                        result.scheme = url.substr(0, colon);
+                        url.remove_prefix(colon + 1);
+                    }
+                }
+                if (url.substr(0, 2) == "//") {
+                    size_t end = url.find_first_of("/?#", 2);
+                    if (end == std::string_view::npos) end = url.size();
+                    result.netloc = url.substr(2, end - 2);
+                    url.remove_prefix(end);
+                    bool open = result.netloc.find('[') != std::string_view::npos;
+                    bool close = result.netloc.find(']') != std::string_view::npos;
+                    if (open != close) throw std::invalid_argument("urlsplit: invalid IPv6 URL");
+                }
+                size_t hash = allow_fragments ? url.find('#') : std::string_view::npos;
+                if (hash != std::string_view::npos) {
+                    result.fragment = url.substr(hash + 1);
+                    url = url.substr(0, hash);
+                }
+                size_t question = url.find('?');
+                if (question != std::string_view::npos) {
+                    result.query = url.substr(question + 1);
+                    url = url.substr(0, question);
+                }
+                result.path = url;
+                return result;
+            }
+
+            /**
+             * @brief Join URL components; the inverse of urlsplit().
+             * @return The URL.
+             */
+            inline std::string urlunsplit(std::string_view scheme, std::string_view netloc, std::string_view path,
+                                          std::string_view query = std::string_view(), std::string_view fragment = std::string_view()) {
+                static constexpr std::string_view USES_NETLOC[] = {"ftp",   "http",  "gopher", "nntp",     "telnet", "imap",  "wais",
+                                                                   "file",  "mms",   "https",  "shttp",    "snews",  "prospero",
+                                                                   "rtsp",  "rtspu", "rsync",  "svn",      "svn+ssh", "sftp", "nfs",
+                                                                   "git",   "git+ssh", "ws",   "wss"};
+                bool uses_netloc = false;
+                for (std::string_view known : USES_NETLOC) uses_netloc |= scheme == known;
+                std::string url;
+                url.reserve(scheme.size() + netloc.size() + path.size() + query.size() + fragment.size() + 6);
+                if (!scheme.empty()) {
+                    url.append(scheme);
+                    url += ':';
+                }
+                if (!netloc.empty() || (uses_netloc && path.substr(0, 2) != "//")) {
+                    url += "//";
+                    url.append(netloc);
+                    if (!path.empty() && path[0] != '/') url += '/';
+                }
+                url.append(path);
+                if (!query.empty()) {
+                    url += '?';
+                    url.append(query);
+                }
+                if (!fragment.empty()) {
+                    url += '#';
+                    url.append(fragment);
+                }
+                return url;
+            }
+
+            inline std::string urlunsplit(const SplitResult& parts) {
+                return urlunsplit(parts.scheme, parts.netloc, parts.path, parts.query, parts.fragment);
+            }
+
+            inline std::string SplitResult::geturl() const { return urlunsplit(*this); }
+
+            /**
+             * @brief Percent-encode the bytes of s other than letters, digits, "_.-~" and the
+             * characters in safe.
+             * @param s The text.
+             * @param safe Characters that are not encoded.
+             * @return The encoded text.
+             */
+            inline std::string quote(std::string_view s, std::string_view safe = "/") { return detail::quote(s, safe, false); }
+
+            /**
+             * @brief Like quote(), but spaces become '+' and '/' is encoded by default, for
+             * HTML form values.
+             */
+            inline std::string quote_plus(std::string_view s, std::string_view safe = std::string_view()) {
+                return detail::quote(s, safe, true);
+            }
+
+            /**
+             * @brief Decode %XX escapes. Malformed escapes are left as they are.
+             * @param s The text.
+             * @return The decoded bytes.
+             */
+            inline std::string unquote(std::string_view s) {
+                if (s.find('%') == std::string_view::npos) return std::string(s);
+                return detail::unquote(s, false);
+            }
+
+            /**
+             * @brief Like unquote(), but '+' decodes to a space, for HTML form values.
+             */
+            inline std::string unquote_plus(std::string_view s) {
+                if (s.find_first_of("%+") == std::string_view::npos) return std::string(s);
+                return detail::unquote(s, true);
+            }
+
+            /**
+             * @brief Parse a query string (application/x-www-form-urlencoded) into decoded
+             * name-value pairs, in order.
+             * @param qs The query string.
+             * @param keep_blank_values Keep fields with empty values (and fields without '=').
+             * @param separator The field separator.
+             * @return The pairs.
+             */
+            inline std::vector<std::pair<std::string, std::string>> parse_qsl(std::string_view qs, bool keep_blank_values = false,
+                                                                              char separator = '&') {
+                std::vector<std::pair<std::string, std::string>> result;
+                size_t start = 0;
+                while (start <= qs.size()) {
+                    size_t end = qs.find(separator, start);
+                    if (end == std::string_view::npos) end = qs.size();
+                    std::string_view field = qs.substr(start, end - start);
+                    start = end + 1;
+                    if (field.empty()) continue;
+                    size_t equals = field.find('=');
+                    std::string_view name = field.substr(0, equals);
+                    std::string_view value = equals == std::string_view::npos ? std::string_view() : field.substr(equals + 1);
+                    if (equals == std::string_view::npos && !keep_blank_values) continue;
+                    if (value.empty() && !keep_blank_values) continue;
+                    result.emplace_back(unquote_plus(name), unquote_plus(value));
+                }
+                return result;
+            }
+
+            /**
+             * @brief Encode name-value pairs as a query string, quoting with quote_plus().
+             * @param query A range of pairs whose members convert to std::string_view.
+             * @param safe Characters that are not encoded.
+             * @return The query string.
+             */
+            template<typename Pairs>
+            inline std::string urlencode(const Pairs& query, std::string_view safe = std::string_view()) {
+                std::string out;
+                bool first = true;
+                for (const auto& [name, value] : query) {
+                    if (!first) out += '&';
+                    first = false;
+                    out += quote_plus(std::string_view(name), safe);
+                    out += '=';
+                    out += quote_plus(std::string_view(value), safe);
+                }
+                return out;
+            }
+        }
+    }
+}
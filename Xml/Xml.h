@@ -0,0 +1,837 @@
+// EasyCpp - Xml : Streaming XML Parser
+// Copyright (C) 2025  C14147
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+/**
+ * @file EasyCpp/Xml/Xml.h
+ * @brief This file implements a pull parser for XML, like Python's xml.etree.ElementTree
+ *        iterparse, and an ElementTree DOM built on it. The parser reads a File in blocks, so
+ *        memory stays bounded by the largest token rather than the document; names, attribute
+ *        values and text are string views into the block buffer, and entities are decoded
+ *        only when a value is asked for. Text and attribute values are scanned 16 bytes at a
+ *        time for the bytes that end them ('<', the closing quote) or need decoding ('&', and
+ *        in attribute values the tabs and line breaks that normalize to spaces).
+ *        Namespaces are not resolved: prefixed names are reported as written. DTDs are skipped.
+ */
+#pragma once
+#define _EASYCPP_XML_VERSION "1.0.0"
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define _EASYCPP_XML_SSE2
+#endif
+
+#include <FileOperator/FileOperator.h>
+#include <Tracemalloc/Tracemalloc.h>
+
+namespace easycpp {
+    namespace xml {
+        namespace detail {
+            // First occurrence of a or b in [p, end), or end.
+            inline const char* find_either(const char* p, const char* end, char a, char b) {
+#ifdef _EASYCPP_XML_SSE2
+                const __m128i va = _mm_set1_epi8(a);
+                const __m128i vb = _mm_set1_epi8(b);
+                for (; end - p >= 16; p += 16) {
+                    __m128i block = _mm_loadu_si128((const __m128i*) p);
+                    unsigned mask = (unsigned) _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(block, va), _mm_cmpeq_epi8(block, vb)));
+                    if (mask) return p + std::countr_zero(mask);
+                }
+#endif
+                while (p < end && *p != a && *p != b) ++p;
+                return p;
+            }
+
+            // First byte in [p, end) that ends or affects an attribute value: the quote, '&', '<' or
+            // a control character (tab and line breaks are normalized, others are invalid).
+            inline const char* find_attribute_stop(const char* p, const char* end, char quote) {
+#ifdef _EASYCPP_XML_SSE2
+                const __m128i vquote = _mm_set1_epi8(quote);
+                const __m128i vamp = _mm_set1_epi8('&');
+                const __m128i vlt = _mm_set1_epi8('<');
+                const __m128i vcontrol = _mm_set1_epi8(0x1F);
+                for (; end - p >= 16; p += 16) {
+                    __m128i block = _mm_loadu_si128((const __m128i*) p);
+                    __m128i hit = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(block, vquote), _mm_cmpeq_epi8(block, vamp)),
+                                               _mm_or_si128(_mm_cmpeq_epi8(block, vlt), _mm_cmpeq_epi8(_mm_max_epu8(block, vcontrol), vcontrol)));
+                    unsigned mask = (unsigned) _mm_movemask_epi8(hit);
+                    if (mask) return p + std::countr_zero(mask);
+                }
+#endif
+                while (p < end && *p != quote && *p != '&' && *p != '<' && (unsigned char) *p >= 0x20) ++p;
+                return p;
+            }
+
+            inline bool is_space(char c) { return c == ' ' || c == '\n' || c == '\t' || c == '\r'; }
+
+            inline bool is_name_char(char c) {
+                return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_' || c == ':' ||
+                       c == '-' || c == '.' || (unsigned char) c >= 0x80;
+            }
+
+            inline void append_utf8(std::string& out, uint32_t code) {
+                if (code < 0x80) {
+                    out += (char) code;
+                } else if (code < 0x800) {
+                    out += (char) (0xC0 | (code >> 6));
+                    out += (char) (0x80 | (code & 0x3F));
+                } else if (code < 0x10000) {
+                    out += (char) (0xE0 | (code >> 12));
+                    out += (char) (0x80 | ((code >> 6) & 0x3F));
+                    out += (char) (0x80 | (code & 0x3F));
+                } else {
+                    out += (char) (0xF0 | (code >> 18));
+                    out += (char) (0x80 | ((code >> 12) & 0x3F));
+                    out += (char) (0x80 | ((code >> 6) & 0x3F));
+                    out += (char) (0x80 | (code & 0x3F));
+                }
+            }
+
+            // A bump allocator for trivially destructible objects; memory is freed with the arena.
+            class Arena {
+            private:
+                static constexpr size_t BLOCK_SIZE = 64 * 1024;
+
+                std::vector<std::unique_ptr<char[]>> blocks;
+                char* cursor = nullptr;
+                size_t left = 0;
+
+            public:
+                Arena() = default;
+                Arena(const Arena&) = delete;
+                Arena& operator=(const Arena&) = delete;
+
+                ~Arena() {
+                    for (const auto& block : blocks) tracemalloc::detail::freed(block.get());
+                }
+
+                void* allocate(size_t size, size_t align) {
+                    size_t padding = (align - (reinterpret_cast<uintptr_t>(cursor) & (align - 1))) & (align - 1);
+                    if (!cursor || padding + size > left) {
+                        size_t block = std::max(BLOCK_SIZE, size + align);
+                        blocks.push_back(std::make_unique<char[]>(block));
+                        tracemalloc::detail::allocated(blocks.back().get(), block, "Arena");
+                        cursor = blocks.back().get();
+                        left = block;
+                        padding = (align - (reinterpret_cast<uintptr_t>(cursor) & (align - 1))) & (align - 1);
+                    }
+                    char* result = cursor + padding;
+                    cursor = result + size;
+                    left -= padding + size;
+                    return result;
+                }
+
+                template<typename T>
+                T* make() {
+                    return new (allocate(sizeof(T), alignof(T))) T();
+                }
+
+                template<typename T>
+                T* make_array(size_t count) {
+                    T* array = static_cast<T*>(allocate(sizeof(T) * (count ? count : 1), alignof(T)));
+                    for (size_t k = 0; k < count; ++k) new (array + k) T();
+                    return array;
+                }
+
+                std::string_view copy(std::string_view text) {
+                    if (text.empty()) return std::string_view();
+                    char* data = static_cast<char*>(allocate(text.size(), 1));
+                    memcpy(data, text.data(), text.size());
+                    return std::string_view(data, text.size());
+                }
+            };
+        }
+
+        /**
+         * @brief Replace the predefined entities (&lt; &gt; &amp; &quot; &apos;) and character
+         * references (&#NN; &#xHH;) in text.
+         * @param text The text.
+         * @return The decoded text.
+         * @throws std::invalid_argument on an unknown or malformed entity.
+         */
+        inline std::string unescape(std::string_view text) {
+            std::string out;
+            out.reserve(text.size());
+            const char* p = text.data();
+            const char* end = p + text.size();
+            while (p < end) {
+                const char* amp = static_cast<const char*>(memchr(p, '&', (size_t) (end - p)));
+                if (!amp) {
+                    out.append(p, end);
+                    break;
+                }
+                out.append(p, amp);
+                const char* semicolon = static_cast<const char*>(memchr(amp, ';', (size_t) (end - amp)));
+                if (!semicolon) throw std::invalid_argument("xml: unterminated entity");
+                std::string_view entity(amp + 1, (size_t) (semicolon - amp - 1));
+                if (entity == "lt") out += '<';
+                else if (entity == "gt") out += '>';
+                else if (entity == "amp") out += '&';
+                else if (entity == "quot") out += '"';
+                else if (entity == "apos") out += '\'';
+                else if (entity.size() > 1 && entity[0] == '#') {
+                    bool hex = entity[1] == 'x';
+                    uint32_t code = 0;
+                    size_t digits = 0;
+                    for (char c : entity.substr(hex ? 2 : 1)) {
+                        uint32_t digit;
+                        if (c >= '0' && c <= '9') digit = (uint32_t) (c - '0');
+                        else if (hex && c >= 'a' && c <= 'f') digit = (uint32_t) (c - 'a' + 10);
+                        else if (hex && c >= 'A' && c <= 'F') digit = (uint32_t) (c - 'A' + 10);
+                        else throw std::invalid_argument("xml: malformed character reference &" + std::string(entity) + ";");
+                        code = code * (hex ? 16 : 10) + digit;
+                        if (code > 0x10FFFF) throw std::invalid_argument("xml: character reference out of range");
+                        ++digits;
+                    }
+                    if (!digits) throw std::invalid_argument("xml: malformed character reference &" + std::string(entity) + ";");
+                    // Only characters matching the Char production may be referenced.
+                    bool allowed = code == 0x9 || code == 0xA || code == 0xD || (code >= 0x20 && code <= 0xD7FF) ||
+                                   (code >= 0xE000 && code <= 0xFFFD) || code >= 0x10000;
+                    if (!allowed) throw std::invalid_argument("xml: reference to invalid character &" + std::string(entity) + ";");
+                    detail::append_utf8(out, code);
+                } else {
+                    throw std::invalid_argument("xml: undefined entity &" + std::string(entity) + ";");
+                }
+                p = semicolon + 1;
+            }
+            return out;
+        }
+
+        /**
+         * @brief Escape text for use in XML content or attribute values.
+         * @param text The text.
+         * @return The escaped text.
+         */
+        inline std::string escape(std::string_view text) {
+            std::string out;
+            out.reserve(text.size());
+            for (char c : text) {
+                switch (c) {
+                    case '<': out += "&lt;"; break;
+                    case '>': out += "&gt;"; break;
+                    case '&': out += "&amp;"; break;
+                    case '"': out += "&quot;"; break;
+                    default: out += c;
+                }
+            }
+            return out;
+        }
+
+        enum class Event : uint8_t { START, END, TEXT, COMMENT, PI };
+
+        /**
+         * @brief An attribute of a start tag. The views are valid until the parser advances.
+         */
+        struct Attribute {
+            std::string_view name;
+            std::string_view raw;   // The value as written, entities undecoded
+            bool escaped = false;   // The raw value contains '&', tab, CR or LF, so value() differs
+
+            /**
+             * @brief Get the normalized value: literal tabs and line breaks become spaces (a CR LF
+             * pair one space), then entities are decoded.
+             */
+            std::string value() const {
+                if (!escaped) return std::string(raw);
+                std::string text;
+                text.reserve(raw.size());
+                for (size_t k = 0; k < raw.size(); ++k) {
+                    char c = raw[k];
+                    if (c == '\r' && k + 1 < raw.size() && raw[k + 1] == '\n') continue;
+                    text += c == '\t' || c == '\n' || c == '\r' ? ' ' : c;
+                }
+                return unescape(text);
+            }
+        };
+
+        /**
+         * @class PullParser
+         * @brief A streaming XML tokenizer. Each next() moves to the next event: START (with
+         * attributes), END, TEXT (character data, including CDATA sections), COMMENT or PI.
+         * An empty-element tag <a/> yields START then END. The XML declaration, DOCTYPE and
+         * whitespace outside the root element are skipped. Views returned by name(),
+         * raw_text() and attributes() are valid until the next call to next().
+         */
+        class PullParser {
+        private:
+            static constexpr size_t DEFAULT_BLOCK_SIZE = 256 * 1024;
+
+            enum Status { NEED_DATA, EVENT, SKIPPED, DONE };
+
+            File* file = nullptr;
+            std::unique_ptr<File> owned;
+            size_t block_size = DEFAULT_BLOCK_SIZE;
+            std::string buffer;
+            std::string_view data;
+            size_t pos = 0;
+            bool eof = true;
+            size_t line_base = 1;   // Line number of data[0]
+
+            Event current = Event::TEXT;
+            std::string_view current_name;
+            std::string_view current_text;
+            bool current_escaped = false;
+            bool current_cdata = false;
+            std::vector<Attribute> current_attributes;
+            std::vector<std::string> stack;
+            std::string closing;
+            bool pending_end = false;
+            bool root_closed = false;
+
+            [[noreturn]] void fail(const std::string& message) const {
+                size_t line = line_base;
+                for (size_t k = 0; k < pos && k < data.size(); ++k) line += data[k] == '\n';
+                throw std::invalid_argument("xml: line " + std::to_string(line) + ": " + message);
+            }
+
+            // Drop the consumed part of the buffer and read another block. Reads grow with the
+            // buffer so that a token larger than a block is rescanned a bounded number of times.
+            bool refill() {
+                if (eof) return false;
+                for (size_t k = 0; k < pos; ++k) line_base += buffer[k] == '\n';
+                buffer.erase(0, pos);
+                pos = 0;
+                size_t have = buffer.size();
+                size_t want = std::max(block_size, have);
+                buffer.resize(have + want);
+                size_t got = file->read(buffer.data() + have, want);
+                buffer.resize(have + got);
+                if (got == 0) eof = true;
+                data = buffer;
+                return got > 0 || !eof;
+            }
+
+            size_t find(std::string_view needle, size_t from) const { return data.find(needle, from); }
+
+            bool whitespace(std::string_view text) const {
+                for (char c : text) {
+                    if (!detail::is_space(c)) return false;
+                }
+                return true;
+            }
+
+            Status parse_text() {
+                const char* begin = data.data() + pos;
+                const char* end = data.data() + data.size();
+                const char* p = begin;
+                bool escaped = false;
+                for (;;) {
+                    p = detail::find_either(p, end, '<', '&');
+                    if (p == end || *p == '<') break;
+                    escaped = true;
+                    ++p;
+                }
+                if (p == end && !eof) return NEED_DATA;
+                std::string_view text(begin, (size_t) (p - begin));
+                if (text.empty()) return DONE;
+                pos += text.size();
+                if (stack.empty()) {
+                    if (!whitespace(text)) fail("text outside the root element");
+                    return SKIPPED;
+                }
+                current = Event::TEXT;
+                current_text = text;
+                current_escaped = escaped;
+                current_cdata = false;
+                return EVENT;
+            }
+
+            size_t scan_name(size_t at) const {
+                while (at < data.size() && detail::is_name_char(data[at])) ++at;
+                return at;
+            }
+
+            size_t skip_space(size_t at) const {
+                while (at < data.size() && detail::is_space(data[at])) ++at;
+                return at;
+            }
+
+            Status parse_markup() {
+                size_t left = data.size() - pos;
+                if (left < 2) return eof ? (fail("unexpected end of document"), DONE) : NEED_DATA;
+                char c = data[pos + 1];
+                if (c == '!') {
+                    if (left < 9 && !eof) return NEED_DATA;
+                    if (data.compare(pos, 4, "<!--") == 0) {
+                        size_t close = find("-->", pos + 4);
+                        if (close == std::string_view::npos) return eof ? (fail("unterminated comment"), DONE) : NEED_DATA;
+                        current = Event::COMMENT;
+                        current_text = data.substr(pos + 4, close - pos - 4);
+                        current_escaped = false;
+                        pos = close + 3;
+                        return EVENT;
+                    }
+                    if (data.compare(pos, 9, "<![CDATA[") == 0) {
+                        size_t close = find("]]>", pos + 9);
+                        if (close == std::string_view::npos) return eof ? (fail("unterminated CDATA section"), DONE) : NEED_DATA;
+                        if (stack.empty()) fail("CDATA outside the root element");
+                        current = Event::TEXT;
+                        current_text = data.substr(pos + 9, close - pos - 9);
+                        current_escaped = false;
+                        current_cdata = true;
+                        pos = close + 3;
+                        return EVENT;
+                    }
+                    if (data.compare(pos, 9, "<!DOCTYPE") == 0) {
+                        // Skip the declaration, including an internal subset in brackets.
+                        int depth = 0;
+                        char quote = 0;
+                        for (size_t at = pos + 9; at < data.size(); ++at) {
+                            char d = data[at];
+                            if (quote) {
+                                if (d == quote) quote = 0;
+                            } else if (d == '"' || d == '\'') {
+                                quote = d;
+                            } else if (d == '[') {
+                                ++depth;
+                            } else if (d == ']') {
+                                --depth;
+                            } else if (d == '>' && depth <= 0) {
+                                pos = at + 1;
+                                return SKIPPED;
+                            }
+                        }
+                        return eof ? (fail("unterminated DOCTYPE"), DONE) : NEED_DATA;
+                    }
+                    fail("unsupported markup declaration");
+                }
+                if (c == '?') {
+                    size_t close = find("?>", pos + 2);
+                    if (close == std::string_view::npos) return eof ? (fail("unterminated processing instruction"), DONE) : NEED_DATA;
+                    size_t name_end = scan_name(pos + 2);
+                    std::string_view target = data.substr(pos + 2, name_end - pos - 2);
+                    size_t body = skip_space(name_end);
+                    pos = close + 2;
+                    if (target == "xml") return SKIPPED;
+                    current = Event::PI;
+                    current_name = target;
+                    current_text = data.substr(body, close > body ? close - body : 0);
+                    current_escaped = false;
+                    return EVENT;
+                }
+                if (c == '/') {
+                    size_t name_end = scan_name(pos + 2);
+                    size_t close = skip_space(name_end);
+                    if (close >= data.size()) return eof ? (fail("unterminated end tag"), DONE) : NEED_DATA;
+                    if (data[close] != '>') fail("malformed end tag");
+                    std::string_view name = data.substr(pos + 2, name_end - pos - 2);
+                    if (stack.empty() || stack.back() != name) {
+                        fail("mismatched end tag </" + std::string(name) + ">" + (stack.empty() ? "" : ", expected </" + stack.back() + ">"));
+                    }
+                    stack.pop_back();
+                    root_closed = stack.empty();
+                    current = Event::END;
+                    current_name = name;
+                    pos = close + 1;
+                    return EVENT;
+                }
+                return parse_start_tag();
+            }
+
+            Status parse_start_tag() {
+                size_t name_end = scan_name(pos + 1);
+                if (name_end == pos + 1) {
+                    if (name_end >= data.size() && !eof) return NEED_DATA;
+                    fail("malformed start tag");
+                }
+                current_attributes.clear();
+                size_t at = name_end;
+                bool empty_element = false;
+                for (;;) {
+                    size_t next = skip_space(at);
+                    if (next >= data.size()) return eof ? (fail("unterminated start tag"), DONE) : NEED_DATA;
+                    char d = data[next];
+                    if (d == '>') {
+                        at = next + 1;
+                        break;
+                    }
+                    if (d == '/') {
+                        if (next + 1 >= data.size()) return eof ? (fail("unterminated start tag"), DONE) : NEED_DATA;
+                        if (data[next + 1] != '>') fail("malformed empty-element tag");
+                        at = next + 2;
+                        empty_element = true;
+                        break;
+                    }
+                    if (next == at) fail("missing whitespace between attributes");
+                    size_t attribute_end = scan_name(next);
+                    if (attribute_end == next) fail(std::string("unexpected '") + d + "' in start tag");
+                    size_t equals = skip_space(attribute_end);
+                    size_t quote_at = equals < data.size() ? skip_space(equals + 1) : equals;
+                    if (quote_at >= data.size()) return eof ? (fail("unterminated start tag"), DONE) : NEED_DATA;
+                    if (data[equals] != '=' || (data[quote_at] != '"' && data[quote_at] != '\'')) fail("malformed attribute");
+                    char quote = data[quote_at];
+                    const char* end = data.data() + data.size();
+                    const char* p = data.data() + quote_at + 1;
+                    bool escaped = false;
+                    for (;;) {
+                        p = detail::find_attribute_stop(p, end, quote);
+                        if (p == end || *p == quote) break;
+                        if (*p == '<') fail("'<' in attribute value");
+                        if (*p != '&' && *p != '\t' && *p != '\n' && *p != '\r') fail("invalid character in attribute value");
+                        escaped = true;
+                        ++p;
+                    }
+                    if (p == end) return eof ? (fail("unterminated attribute value"), DONE) : NEED_DATA;
+                    Attribute attribute;
+                    attribute.name = data.substr(next, attribute_end - next);
+                    attribute.raw = std::string_view(data.data() + quote_at + 1, (size_t) (p - data.data() - quote_at - 1));
+                    attribute.escaped = escaped;
+                    for (const Attribute& other : current_attributes) {
+                        if (other.name == attribute.name) fail("duplicate attribute " + std::string(attribute.name));
+                    }
+                    current_attributes.push_back(attribute);
+                    at = (size_t) (p - data.data()) + 1;
+                }
+                if (stack.empty() && root_closed) fail("junk after the root element");
+                current = Event::START;
+                current_name = data.substr(pos + 1, name_end - pos - 1);
+                stack.emplace_back(current_name);
+                pending_end = empty_element;
+                pos = at;
+                return EVENT;
+            }
+
+        public:
+            /**
+             * @brief Parse a document held in memory (for example a MappedFile). Views point
+             * into the text, which must outlive the parser.
+             * @param text The document.
+             */
+            explicit PullParser(std::string_view text) : data(text) {}
+
+            /**
+             * @brief Parse a document read from a File in blocks. The File is not closed.
+             * @param file The file.
+             * @param block_size The number of bytes read at a time.
+             */
+            explicit PullParser(File* file, size_t block_size = DEFAULT_BLOCK_SIZE) :
+                file(file), block_size(block_size ? block_size : DEFAULT_BLOCK_SIZE), eof(false) {}
+
+            /**
+             * @brief Parse a file read in blocks.
+             * @param filename The file.
+             * @param block_size The number of bytes read at a time.
+             * @throws FileNotExistError if the file does not exist.
+             */
+            explicit PullParser(const char* filename, size_t block_size = DEFAULT_BLOCK_SIZE) :
+                PullParser(open(filename, READ_B), block_size) {
+                owned.reset(file);
+            }
+
+            PullParser(const PullParser&) = delete;
+            PullParser& operator=(const PullParser&) = delete;
+
+            /**
+             * @brief Move to the next event.
+             * @return False at the end of the document.
+             * @throws std::invalid_argument if the document is not well-formed.
+             */
+            bool next() {
+                // The previous event's views may point into a buffer that a refill replaces.
+                current_name = std::string_view();
+                current_text = std::string_view();
+                current_escaped = false;
+                current_attributes.clear();
+                if (pending_end) {
+                    pending_end = false;
+                    closing = std::move(stack.back());
+                    stack.pop_back();
+                    root_closed = stack.empty();
+                    current = Event::END;
+                    current_name = closing;
+                    return true;
+                }
+                for (;;) {
+                    size_t start = pos;
+                    Status status = pos < data.size() && data[pos] == '<' ? parse_markup() : parse_text();
+                    if (status == EVENT) return true;
+                    if (status == SKIPPED) continue;
+                    pos = start;
+                    if (status == NEED_DATA && refill()) continue;
+                    if (status == NEED_DATA && pos < data.size()) continue;  // Reached the end of the file: parse what is left
+                    if (!stack.empty()) fail("unclosed element <" + stack.back() + ">");
+                    if (!root_closed) fail("no root element");
+                    return false;
+                }
+            }
+
+            Event event() const { return current; }
+
+            /**
+             * @brief Get the element name (START, END) or target (PI).
+             */
+            std::string_view name() const { return current_name; }
+
+            /**
+             * @brief Get the text of a TEXT, COMMENT or PI event as written, entities undecoded.
+             */
+            std::string_view raw_text() const { return current_text; }
+
+            /**
+             * @brief Get the text of a TEXT event with entities decoded.
+             */
+            std::string text() const { return current_escaped ? unescape(current_text) : std::string(current_text); }
+
+            /**
+             * @brief Whether the text needs entity decoding, i.e. text() differs from raw_text().
+             */
+            bool has_entities() const { return current_escaped; }
+
+            bool is_cdata() const { return current == Event::TEXT && current_cdata; }
+
+            bool is_whitespace() const { return whitespace(current_text); }
+
+            const std::vector<Attribute>& attributes() const { return current_attributes; }
+
+            /**
+             * @brief Get an attribute of the current START event.
+             * @param name The attribute name.
+             * @return The attribute, or nullptr if absent.
+             */
+            const Attribute* attribute(std::string_view name) const {
+                for (const Attribute& attribute : current_attributes) {
+                    if (attribute.name == name) return &attribute;
+                }
+                return nullptr;
+            }
+
+            /**
+             * @brief Get the number of open elements, including the current START element.
+             */
+            size_t depth() const { return stack.size(); }
+        };
+
+        /**
+         * @brief Parse a file event by event, like Python's ElementTree.iterparse.
+         * @param filename The file.
+         * @param block_size The number of bytes read at a time.
+         * @return A parser positioned before the first event.
+         */
+        inline std::unique_ptr<PullParser> iterparse(const char* filename, size_t block_size = 256 * 1024) {
+            return std::make_unique<PullParser>(filename, block_size);
+        }
+
+        /**
+         * @struct Element
+         * @brief An element of an ElementTree. Text is stored decoded; `text` is the character
+         * data before the first child and `tail` the data after the end tag, as in Python.
+         */
+        struct Element {
+            struct Attrib {
+                std::string_view name;
+                std::string_view value;
+            };
+
+            std::string_view tag;
+            std::string_view text;
+            std::string_view tail;
+            const Attrib* attrib = nullptr;
+            size_t attrib_count = 0;
+            Element* parent = nullptr;
+            Element* first_child = nullptr;
+            Element* last_child = nullptr;
+            Element* next = nullptr;
+            size_t child_count = 0;
+
+            size_t size() const { return child_count; }
+
+            /**
+             * @brief Get an attribute value.
+             * @param name The attribute name.
+             * @param fallback The value if the attribute is absent.
+             */
+            std::string_view get(std::string_view name, std::string_view fallback = std::string_view()) const {
+                for (size_t k = 0; k < attrib_count; ++k) {
+                    if (attrib[k].name == name) return attrib[k].value;
+                }
+                return fallback;
+            }
+
+            std::vector<const Element*> children() const {
+                std::vector<const Element*> result;
+                result.reserve(child_count);
+                for (const Element* child = first_child; child; child = child->next) result.push_back(child);
+                return result;
+            }
+
+            /**
+             * @brief Get the first direct child with a tag.
+             * @return The child, or nullptr.
+             */
+            const Element* find(std::string_view child_tag) const {
+                for (const Element* child = first_child; child; child = child->next) {
+                    if (child->tag == child_tag) return child;
+                }
+                return nullptr;
+            }
+
+            std::vector<const Element*> findall(std::string_view child_tag) const {
+                std::vector<const Element*> result;
+                for (const Element* child = first_child; child; child = child->next) {
+                    if (child->tag == child_tag) result.push_back(child);
+                }
+                return result;
+            }
+
+            /**
+             * @brief Get the text of the first direct child with a tag.
+             * @return The text, or the fallback if there is no such child.
+             */
+            std::string_view findtext(std::string_view child_tag, std::string_view fallback = std::string_view()) const {
+                const Element* child = find(child_tag);
+                return child ? child->text : fallback;
+            }
+
+            /**
+             * @brief Get this element and its descendants in document order, optionally only
+             * those with a tag.
+             */
+            std::vector<const Element*> iter(std::string_view match_tag = std::string_view()) const {
+                std::vector<const Element*> result;
+                const Element* node = this;
+                while (node) {
+                    if (match_tag.empty() || node->tag == match_tag) result.push_back(node);
+                    if (node->first_child) {
+                        node = node->first_child;
+                        continue;
+                    }
+                    while (node && node != this && !node->next) node = node->parent;
+                    node = node && node != this ? node->next : nullptr;
+                }
+                return result;
+            }
+
+            /**
+             * @brief Get the concatenated text of this element and its descendants.
+             */
+            std::string itertext() const {
+                std::string out(text);
+                for (const Element* child = first_child; child; child = child->next) {
+                    out += child->itertext();
+                    out.append(child->tail);
+                }
+                return out;
+            }
+        };
+
+        /**
+         * @class ElementTree
+         * @brief An XML document as a tree of Elements. Elements, names and text live in an arena
+         * owned by the tree; comments and processing instructions are dropped.
+         */
+        class ElementTree {
+        private:
+            std::unique_ptr<detail::Arena> arena = std::make_unique<detail::Arena>();
+            Element* root = nullptr;
+
+        public:
+            /**
+             * @brief Build a tree from the remaining events of a parser.
+             * @param parser The parser.
+             * @throws std::invalid_argument if the document is not well-formed.
+             */
+            static ElementTree from_parser(PullParser& parser) {
+                ElementTree tree;
+                detail::Arena& arena = *tree.arena;
+                Element* current = nullptr;
+                Element* last_closed = nullptr;
+                std::string pending;
+                auto flush = [&] {
+                    if (pending.empty()) return;
+                    std::string_view text = arena.copy(pending);
+                    if (last_closed) last_closed->tail = text;
+                    else if (current) current->text = text;
+                    pending.clear();
+                };
+                while (parser.next()) {
+                    switch (parser.event()) {
+                        case Event::START: {
+                            flush();
+                            Element* element = arena.make<Element>();
+                            element->tag = arena.copy(parser.name());
+                            const std::vector<Attribute>& attributes = parser.attributes();
+                            Element::Attrib* attrib = arena.make_array<Element::Attrib>(attributes.size());
+                            for (size_t k = 0; k < attributes.size(); ++k) {
+                                attrib[k].name = arena.copy(attributes[k].name);
+                                attrib[k].value = attributes[k].escaped ? arena.copy(attributes[k].value()) : arena.copy(attributes[k].raw);
+                            }
+                            element->attrib = attrib;
+                            element->attrib_count = attributes.size();
+                            element->parent = current;
+                            if (current) {
+                                if (current->last_child) current->last_child->next = element;
+                                else current->first_child = element;
+                                current->last_child = element;
+                                ++current->child_count;
+                            } else {
+                                tree.root = element;
+                            }
+                            current = element;
+                            last_closed = nullptr;
+                            break;
+                        }
+                        case Event::END:
+                            flush();
+                            last_closed = current;
+                            current = current->parent;
+                            break;
+                        case Event::TEXT:
+                            if (parser.has_entities()) pending += parser.text();
+                            else pending.append(parser.raw_text());
+                            break;
+                        default:
+                            break;
+                    }
+                }
+                return tree;
+            }
+
+            /**
+             * @brief Parse an XML file, reading it in blocks.
+             * @param filename The file.
+             * @throws std::invalid_argument if the document is not well-formed.
+             */
+            static ElementTree parse(const char* filename) {
+                PullParser parser(filename);
+                return from_parser(parser);
+            }
+
+            /**
+             * @brief Parse XML text.
+             * @param text The document.
+             * @throws std::invalid_argument if the document is not well-formed.
+             */
+            static ElementTree fromstring(std::string_view text) {
+                PullParser parser(text);
+                return from_parser(parser);
+            }
+
+            const Element& getroot() const { return *root; }
+        };
+    }
+}
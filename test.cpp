@@ -9,9 +9,9 @@ int main(){
     File* a = open("test.txt","a+");
     a->write(
         esb "hello world, this is a test\n你好\(@^0^@)/，{}！\n" ese
-        .format((STRING_FOMATER)String("EasyCpp")) +
-		String("EasyCpp Version: ") + String(_EASYCPP_VERSION) +
-		String("\nFileOperator Version: {}\nString Version: {}")
+        .format((STRING_FOMATER)"EasyCpp"_s) +
+		"EasyCpp Version: "_s + String(_EASYCPP_VERSION) +
+		"\nFileOperator Version: {}\nString Version: {}"_s
 		.format(_EASYCPP_FILEOPERATOR_VERSION, _EASYCPP_STRING_VERSION)
     );
     String(a->read_());